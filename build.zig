@@ -69,6 +69,29 @@ pub fn build(b: *std.Build) void {
     const bench_step = b.step("bench", "Run benchmarks");
     bench_step.dependOn(&run_bench.step);
 
+    // Command-line tool: String methods over stdin records
+    const cli = b.addExecutable(.{
+        .name = "zstring",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("cli/main.zig"),
+            .target = target,
+            .optimize = optimize,
+            .imports = &.{
+                .{ .name = "zstring", .module = zstring_module },
+            },
+        }),
+    });
+    b.installArtifact(cli);
+
+    const run_cli = b.addRunArtifact(cli);
+    run_cli.stdio = .inherit;
+    if (b.args) |args| run_cli.addArgs(args);
+    const cli_step = b.step("cli", "Run the zstring command-line tool (zig build cli -- <method> [args])");
+    cli_step.dependOn(&run_cli.step);
+
+    const cli_tests = b.addTest(.{ .root_module = cli.root_module });
+    test_step.dependOn(&b.addRunArtifact(cli_tests).step);
+
     // Examples
     const example_char_access = b.addExecutable(.{
         .name = "character_access",
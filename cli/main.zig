@@ -0,0 +1,583 @@
+// zstring - ECMAScript String methods over stdin records
+//
+//   zstring lower | zstring replaceAll foo bar | zstring split , 3
+//
+// Input is cut into records at a delimiter byte (newline by default) and
+// every record goes through one String method with the library's exact
+// semantics. A regular file on stdin is mapped instead of read. Records
+// are handled in batches on a thread pool; batches are written back in
+// input order with writev, and whenever a method returns a slice of its
+// input (trim, split, escapes with nothing to escape, ...) the output
+// points into the input buffer instead of being copied.
+
+const std = @import("std");
+const zstring = @import("zstring");
+const posix = std.posix;
+const Allocator = std.mem.Allocator;
+const ZString = zstring.ZString;
+
+const usage =
+    \\Usage: zstring [options] <method> [args...]
+    \\
+    \\Applies a String.prototype method to every record of stdin.
+    \\
+    \\Methods:
+    \\  toLowerCase (lower)  toUpperCase (upper)  normalize [form]
+    \\  trim  trimStart  trimEnd  padStart <n> [fill]  padEnd <n> [fill]
+    \\  at <i>  charAt <i>  charCodeAt <i>  codePointAt <i>  length
+    \\  indexOf <s> [pos]  lastIndexOf <s> [pos]  includes <s> [pos]
+    \\  startsWith <s> [pos]  endsWith <s> [end]  localeCompare <s>
+    \\  slice <start> [end]  substring <start> [end]  repeat <n>
+    \\  concat <s>...  replace <from> <to>  replaceAll <from> <to>
+    \\  split <sep> [limit]   (one output record per field)
+    \\  isWellFormed  displayWidth  escapeJson  unescapeJson  quoteJson
+    \\  escapeHtml  unescapeHtml  encodeURI  decodeURI
+    \\  encodeURIComponent  decodeURIComponent
+    \\
+    \\Options:
+    \\  -d, --delimiter <c>  Record delimiter byte (default \n; \t and \0 accepted)
+    \\  -z                   NUL-delimited records
+    \\  -j, --jobs <n>       Worker threads (default: one per CPU)
+    \\  --batch <bytes>      Bytes per batch (default 1048576)
+    \\  --stats              Print record count and throughput to stderr
+    \\  -h, --help           Show this help
+    \\
+;
+
+const Method = enum {
+    toLowerCase,
+    toUpperCase,
+    normalize,
+    trim,
+    trimStart,
+    trimEnd,
+    padStart,
+    padEnd,
+    at,
+    charAt,
+    charCodeAt,
+    codePointAt,
+    length,
+    indexOf,
+    lastIndexOf,
+    includes,
+    startsWith,
+    endsWith,
+    localeCompare,
+    slice,
+    substring,
+    repeat,
+    concat,
+    replace,
+    replaceAll,
+    split,
+    isWellFormed,
+    displayWidth,
+    escapeJson,
+    unescapeJson,
+    quoteJson,
+    escapeHtml,
+    unescapeHtml,
+    encodeURI,
+    decodeURI,
+    encodeURIComponent,
+    decodeURIComponent,
+
+    const aliases = std.StaticStringMap(Method).initComptime(.{
+        .{ "lower", .toLowerCase },
+        .{ "upper", .toUpperCase },
+    });
+
+    fn parse(name: []const u8) ?Method {
+        return std.meta.stringToEnum(Method, name) orelse aliases.get(name);
+    }
+
+    /// Minimum and maximum number of arguments
+    fn arity(self: Method) [2]usize {
+        return switch (self) {
+            .normalize => .{ 0, 1 },
+            .padStart, .padEnd => .{ 1, 2 },
+            .at, .charAt, .charCodeAt, .codePointAt, .repeat, .localeCompare => .{ 1, 1 },
+            .indexOf, .lastIndexOf, .includes, .startsWith, .endsWith => .{ 1, 2 },
+            .slice, .substring, .split => .{ 1, 2 },
+            .concat => .{ 0, std.math.maxInt(usize) },
+            .replace, .replaceAll => .{ 2, 2 },
+            else => .{ 0, 0 },
+        };
+    }
+
+    /// Arguments that are integers
+    fn isNumeric(self: Method, arg: usize) bool {
+        return switch (self) {
+            .padStart, .padEnd, .at, .charAt, .charCodeAt, .codePointAt, .repeat => arg == 0,
+            .slice, .substring => true,
+            .indexOf, .lastIndexOf, .includes, .startsWith, .endsWith, .split => arg == 1,
+            else => false,
+        };
+    }
+};
+
+/// A parsed command line
+const Call = struct {
+    method: Method,
+    args: []const [:0]const u8,
+    /// Numeric arguments, by position
+    ints: [2]?isize = .{ null, null },
+    delimiter: u8 = '\n',
+    jobs: ?usize = null,
+    batch_size: usize = 1 << 20,
+    stats: bool = false,
+
+    fn int(self: *const Call, i: usize) isize {
+        return self.ints[i].?;
+    }
+};
+
+fn parseDelimiter(arg: []const u8) !u8 {
+    if (arg.len == 1) return arg[0];
+    if (std.mem.eql(u8, arg, "\\n")) return '\n';
+    if (std.mem.eql(u8, arg, "\\t")) return '\t';
+    if (std.mem.eql(u8, arg, "\\0")) return 0;
+    return error.InvalidDelimiter;
+}
+
+fn parseArgs(args: []const [:0]const u8) !Call {
+    var call = Call{ .method = undefined, .args = &.{} };
+    var i: usize = 0;
+    while (i < args.len and args[i].len > 1 and args[i][0] == '-') : (i += 1) {
+        const opt = args[i];
+        if (std.mem.eql(u8, opt, "-h") or std.mem.eql(u8, opt, "--help")) return error.Help;
+        if (std.mem.eql(u8, opt, "-z")) {
+            call.delimiter = 0;
+        } else if (std.mem.eql(u8, opt, "--stats")) {
+            call.stats = true;
+        } else if (i + 1 < args.len and (std.mem.eql(u8, opt, "-d") or std.mem.eql(u8, opt, "--delimiter"))) {
+            i += 1;
+            call.delimiter = try parseDelimiter(args[i]);
+        } else if (i + 1 < args.len and (std.mem.eql(u8, opt, "-j") or std.mem.eql(u8, opt, "--jobs"))) {
+            i += 1;
+            call.jobs = @max(try std.fmt.parseInt(usize, args[i], 10), 1);
+        } else if (i + 1 < args.len and std.mem.eql(u8, opt, "--batch")) {
+            i += 1;
+            call.batch_size = @max(try std.fmt.parseInt(usize, args[i], 10), 1);
+        } else {
+            return error.UnknownOption;
+        }
+    }
+    if (i == args.len) return error.MissingMethod;
+
+    call.method = Method.parse(args[i]) orelse return error.UnknownMethod;
+    call.args = args[i + 1 ..];
+    const bounds = call.method.arity();
+    if (call.args.len < bounds[0] or call.args.len > bounds[1]) return error.WrongArgumentCount;
+
+    for (call.args, 0..) |arg, n| {
+        if (n < call.ints.len and call.method.isNumeric(n)) call.ints[n] = try std.fmt.parseInt(isize, arg, 10);
+    }
+    return call;
+}
+
+// ============================================================================
+// Batches
+// ============================================================================
+
+/// A run of whole records and the output produced for them
+const Batch = struct {
+    input: []const u8,
+    /// Read buffer holding `input` (null when it points into the mapping)
+    buffer: ?[]u8 = null,
+    arena: std.heap.ArenaAllocator,
+    /// Output as a gather list: slices of `input`, arena memory or literals
+    segments: std.ArrayList(posix.iovec_const) = .{},
+    records: usize = 0,
+    err: ?anyerror = null,
+    done: std.Thread.ResetEvent = .{},
+
+    fn create(allocator: Allocator, input: []const u8, buffer: ?[]u8) !*Batch {
+        const batch = try allocator.create(Batch);
+        batch.* = .{ .input = input, .buffer = buffer, .arena = .init(allocator) };
+        return batch;
+    }
+
+    fn destroy(self: *Batch, allocator: Allocator) void {
+        self.arena.deinit();
+        if (self.buffer) |buf| allocator.free(buf);
+        allocator.destroy(self);
+    }
+
+    /// Appends output, extending the previous segment when contiguous
+    fn emit(self: *Batch, bytes: []const u8) !void {
+        if (bytes.len == 0) return;
+        if (self.segments.items.len > 0) {
+            const last = &self.segments.items[self.segments.items.len - 1];
+            if (last.base + last.len == bytes.ptr) {
+                last.len += bytes.len;
+                return;
+            }
+        }
+        try self.segments.append(self.arena.allocator(), .{ .base = bytes.ptr, .len = bytes.len });
+    }
+
+    fn print(self: *Batch, comptime fmt: []const u8, args: anytype) !void {
+        try self.emit(try std.fmt.allocPrint(self.arena.allocator(), fmt, args));
+    }
+};
+
+fn processBatch(call: *const Call, batch: *Batch) void {
+    processRecords(call, batch) catch |err| {
+        batch.err = err;
+    };
+    batch.done.set();
+}
+
+fn processRecords(call: *const Call, batch: *Batch) !void {
+    const data = batch.input;
+    var pos: usize = 0;
+    while (pos < data.len) {
+        const end = std.mem.indexOfScalarPos(u8, data, pos, call.delimiter);
+        try applyMethod(call, batch, data[pos .. end orelse data.len]);
+        batch.records += 1;
+        const e = end orelse break;
+        // The record's own delimiter keeps unchanged output contiguous
+        try batch.emit(data[e .. e + 1]);
+        pos = e + 1;
+    }
+}
+
+fn boolText(value: bool) []const u8 {
+    return if (value) "true" else "false";
+}
+
+fn applyMethod(call: *const Call, out: *Batch, record: []const u8) !void {
+    const a = out.arena.allocator();
+    const str = ZString.init(record);
+    const args = call.args;
+    const opt: ?isize = if (call.ints[1]) |n| n else null;
+
+    switch (call.method) {
+        .toLowerCase => try out.emit(try str.toLowerCase(a)),
+        .toUpperCase => try out.emit(try str.toUpperCase(a)),
+        .normalize => try out.emit(try str.normalize(a, if (args.len > 0) args[0] else null)),
+        .trim => try out.emit(zstring.trimming.trimmedSlice(record)),
+        .trimStart => try out.emit(try str.trimStart(a)),
+        .trimEnd => try out.emit(try str.trimEnd(a)),
+        .padStart => try out.emit(try str.padStart(a, call.int(0), if (args.len > 1) args[1] else null)),
+        .padEnd => try out.emit(try str.padEnd(a, call.int(0), if (args.len > 1) args[1] else null)),
+        .at => try out.emit(try str.at(a, call.int(0)) orelse "undefined"),
+        .charAt => try out.emit(try str.charAt(a, call.int(0))),
+        .charCodeAt => if (str.charCodeAt(call.int(0))) |unit| try out.print("{d}", .{unit}) else try out.emit("NaN"),
+        .codePointAt => if (str.codePointAt(call.int(0))) |cp| try out.print("{d}", .{cp}) else try out.emit("undefined"),
+        .length => try out.print("{d}", .{str.lengthConst()}),
+        .indexOf => try out.print("{d}", .{str.indexOf(args[0], opt)}),
+        .lastIndexOf => try out.print("{d}", .{str.lastIndexOf(args[0], opt)}),
+        .includes => try out.emit(boolText(str.includes(args[0], opt))),
+        .startsWith => try out.emit(boolText(str.startsWith(args[0], opt))),
+        .endsWith => try out.emit(boolText(str.endsWith(args[0], opt))),
+        .localeCompare => try out.print("{d}", .{str.localeCompare(args[0], null, null)}),
+        .slice => try out.emit(try str.slice(a, call.int(0), opt)),
+        .substring => try out.emit(try str.substring(a, call.int(0), opt)),
+        .repeat => try out.emit(try str.repeat(a, call.int(0))),
+        .concat => {
+            try out.emit(record);
+            for (args) |arg| try out.emit(arg);
+        },
+        .replace => if (std.mem.indexOf(u8, record, args[0])) |i| {
+            try out.emit(record[0..i]);
+            try out.emit(args[1]);
+            try out.emit(record[i + args[0].len ..]);
+        } else {
+            try out.emit(record);
+        },
+        .replaceAll => if (args[0].len == 0) {
+            try insertEverywhere(out, record, args[1]);
+        } else {
+            try out.emit(try str.replaceMany(a, &.{.{ .from = args[0], .to = args[1] }}));
+        },
+        .split => try splitRecord(call, out, record),
+        .isWellFormed => try out.emit(boolText(str.isWellFormed())),
+        .displayWidth => try out.print("{d}", .{str.displayWidth()}),
+        .escapeJson => try out.emit((try str.escapeJson(a)).data),
+        .unescapeJson => try out.emit((try str.unescapeJson(a)).data),
+        .quoteJson => try out.emit(try str.quoteJson(a)),
+        .escapeHtml => try out.emit((try str.escapeHtml(a)).data),
+        .unescapeHtml => try out.emit((try str.unescapeHtml(a)).data),
+        .encodeURI => try out.emit((try str.encodeURI(a)).data),
+        .decodeURI => try out.emit((try str.decodeURI(a)).data),
+        .encodeURIComponent => try out.emit((try str.encodeURIComponent(a)).data),
+        .decodeURIComponent => try out.emit((try str.decodeURIComponent(a)).data),
+    }
+}
+
+/// replaceAll("", rep): `rep` before every character and at the end
+///
+/// JavaScript inserts at every UTF-16 position; astral characters stay
+/// whole here, as in split(""), since UTF-8 cannot hold a lone surrogate.
+fn insertEverywhere(out: *Batch, record: []const u8, replacement: []const u8) !void {
+    var i: usize = 0;
+    while (i < record.len) {
+        const cp_len = std.unicode.utf8ByteSequenceLength(record[i]) catch 1;
+        const end = @min(i + cp_len, record.len);
+        try out.emit(replacement);
+        try out.emit(record[i..end]);
+        i = end;
+    }
+    try out.emit(replacement);
+}
+
+/// split(sep, limit), one output record per field
+///
+/// A non-empty separator yields slices of the record; the empty separator
+/// splits into UTF-16 code units and goes through ZString.split().
+fn splitRecord(call: *const Call, out: *Batch, record: []const u8) !void {
+    const sep = call.args[0];
+    const limit: usize = if (call.ints[1]) |n| @intCast(@max(n, 0)) else std.math.maxInt(usize);
+    const delimiter = std.mem.asBytes(&call.delimiter);
+
+    if (sep.len == 0) {
+        const fields = try ZString.init(record).split(out.arena.allocator(), sep, limit);
+        for (fields, 0..) |field, i| {
+            if (i > 0) try out.emit(delimiter);
+            try out.emit(field);
+        }
+        return;
+    }
+
+    var it = std.mem.splitSequence(u8, record, sep);
+    var count: usize = 0;
+    while (count < limit) : (count += 1) {
+        const field = it.next() orelse break;
+        if (count > 0) try out.emit(delimiter);
+        try out.emit(field);
+    }
+}
+
+// ============================================================================
+// Input
+// ============================================================================
+
+/// Cuts stdin into batches of whole records
+const Reader = struct {
+    allocator: Allocator,
+    file: std.fs.File,
+    delimiter: u8,
+    batch_size: usize,
+    /// Whole input when stdin is a regular file
+    map: ?[]align(std.heap.page_size_min) u8 = null,
+    pos: usize = 0,
+    /// Partial record left over from the previous read
+    carry: std.ArrayList(u8) = .{},
+    eof: bool = false,
+    bytes: u64 = 0,
+
+    fn init(allocator: Allocator, file: std.fs.File, delimiter: u8, batch_size: usize) Reader {
+        var reader = Reader{ .allocator = allocator, .file = file, .delimiter = delimiter, .batch_size = batch_size };
+        const stat = file.stat() catch return reader;
+        if (stat.kind == .file and stat.size > 0) {
+            reader.map = posix.mmap(null, stat.size, posix.PROT.READ, .{ .TYPE = .PRIVATE }, file.handle, 0) catch null;
+            if (reader.map) |m| {
+                posix.madvise(m.ptr, m.len, posix.MADV.SEQUENTIAL) catch {};
+                reader.bytes = m.len;
+            }
+        }
+        return reader;
+    }
+
+    fn deinit(self: *Reader) void {
+        if (self.map) |m| posix.munmap(m);
+        self.carry.deinit(self.allocator);
+    }
+
+    fn next(self: *Reader) !?*Batch {
+        if (self.map) |m| {
+            if (self.pos >= m.len) return null;
+            // Extend to the end of the record the batch boundary falls in
+            const target = @min(self.pos + self.batch_size, m.len);
+            const end = if (std.mem.indexOfScalarPos(u8, m, target - 1, self.delimiter)) |e| e + 1 else m.len;
+            defer self.pos = end;
+            return try Batch.create(self.allocator, m[self.pos..end], null);
+        }
+        return self.readBatch();
+    }
+
+    /// Reads until the buffer is full, or a short read leaves at least one
+    /// whole record (so interactive input is not held back)
+    fn readBatch(self: *Reader) !?*Batch {
+        if (self.eof and self.carry.items.len == 0) return null;
+
+        var buf = try self.allocator.alloc(u8, @max(self.batch_size, self.carry.items.len * 2));
+        errdefer self.allocator.free(buf);
+        @memcpy(buf[0..self.carry.items.len], self.carry.items);
+        var filled = self.carry.items.len;
+        self.carry.clearRetainingCapacity();
+
+        var cut: ?usize = null;
+        while (!self.eof) {
+            if (filled == buf.len) {
+                cut = std.mem.lastIndexOfScalar(u8, buf, self.delimiter);
+                if (cut != null) break;
+                buf = try self.allocator.realloc(buf, buf.len * 2);
+            }
+            const want = buf.len - filled;
+            const n = try self.file.read(buf[filled..]);
+            self.bytes += n;
+            filled += n;
+            if (n == 0) self.eof = true;
+            if (n < want) {
+                cut = std.mem.lastIndexOfScalar(u8, buf[0..filled], self.delimiter);
+                if (cut != null) break;
+            }
+        }
+
+        const end = if (self.eof) filled else cut.? + 1;
+        try self.carry.appendSlice(self.allocator, buf[end..filled]);
+        if (end == 0) {
+            self.allocator.free(buf);
+            return null;
+        }
+        return try Batch.create(self.allocator, buf[0..end], buf);
+    }
+};
+
+// ============================================================================
+// Output
+// ============================================================================
+
+/// Formats a diagnostic to stderr
+fn report(comptime fmt: []const u8, args: anytype) void {
+    var buf: [1024]u8 = undefined;
+    var stderr = std.fs.File.stderr().writer(&buf);
+    stderr.interface.print(fmt, args) catch return;
+    stderr.interface.flush() catch {};
+}
+
+fn writeBatch(out: std.fs.File, batch: *Batch) !void {
+    // Linux caps a single writev at 1024 segments
+    var segments = batch.segments.items;
+    while (segments.len > 0) {
+        const n = @min(segments.len, 1024);
+        try out.writevAll(segments[0..n]);
+        segments = segments[n..];
+    }
+}
+
+pub fn main() !u8 {
+    const allocator = std.heap.smp_allocator;
+    const args = try std.process.argsAlloc(allocator);
+    defer std.process.argsFree(allocator, args);
+
+    const call = parseArgs(args[1..]) catch |err| {
+        if (err == error.Help) {
+            std.fs.File.stdout().writeAll(usage) catch return 1;
+            return 0;
+        }
+        report("zstring: {s}\n\n{s}", .{ @errorName(err), usage });
+        return 2;
+    };
+
+    const stdout = std.fs.File.stdout();
+    var reader = Reader.init(allocator, std.fs.File.stdin(), call.delimiter, call.batch_size);
+    defer reader.deinit();
+
+    var pool: std.Thread.Pool = undefined;
+    try pool.init(.{ .allocator = allocator, .n_jobs = call.jobs });
+    defer pool.deinit();
+
+    // Batches in flight, oldest first; output is written in this order
+    const window = try allocator.alloc(*Batch, 2 * @max(pool.threads.len, 1));
+    defer allocator.free(window);
+    var head: usize = 0;
+    var count: usize = 0;
+    defer {
+        while (count > 0) : (count -= 1) {
+            const batch = window[head];
+            batch.done.wait();
+            batch.destroy(allocator);
+            head = (head + 1) % window.len;
+        }
+    }
+
+    var timer = try std.time.Timer.start();
+    var records: usize = 0;
+    while (true) {
+        while (count < window.len) {
+            const batch = try reader.next() orelse break;
+            window[(head + count) % window.len] = batch;
+            count += 1;
+            pool.spawn(processBatch, .{ &call, batch }) catch processBatch(&call, batch);
+        }
+        if (count == 0) break;
+
+        const batch = window[head];
+        batch.done.wait();
+        head = (head + 1) % window.len;
+        count -= 1;
+        defer batch.destroy(allocator);
+
+        if (batch.err) |err| {
+            report("zstring: {s}: {s}\n", .{ @tagName(call.method), @errorName(err) });
+            return 1;
+        }
+        records += batch.records;
+        writeBatch(stdout, batch) catch |err| switch (err) {
+            // The reader went away (e.g. `| head`)
+            error.BrokenPipe => return 0,
+            else => return err,
+        };
+    }
+
+    if (call.stats) {
+        const seconds = @as(f64, @floatFromInt(timer.read())) / std.time.ns_per_s;
+        const mib = @as(f64, @floatFromInt(reader.bytes)) / (1024 * 1024);
+        report("{d} records, {d:.1} MiB in {d:.3}s ({d:.1} MiB/s)\n", .{ records, mib, seconds, mib / seconds });
+    }
+    return 0;
+}
+
+test "parseArgs" {
+    const call = try parseArgs(&.{ "-d", ",", "split", ";", "3" });
+    try std.testing.expectEqual(Method.split, call.method);
+    try std.testing.expectEqual(@as(u8, ','), call.delimiter);
+    try std.testing.expectEqual(@as(?isize, 3), call.ints[1]);
+
+    try std.testing.expectEqual(Method.toLowerCase, (try parseArgs(&.{"lower"})).method);
+    try std.testing.expectError(error.WrongArgumentCount, parseArgs(&.{"replaceAll"}));
+    try std.testing.expectError(error.UnknownMethod, parseArgs(&.{"frobnicate"}));
+}
+
+test "replaceAll with an empty search string inserts everywhere" {
+    const allocator = std.testing.allocator;
+    const call = try parseArgs(&.{ "replaceAll", "", "-" });
+    const batch = try Batch.create(allocator, "abc\n\na😀\n", null);
+    defer batch.destroy(allocator);
+
+    processBatch(&call, batch);
+    var text = std.ArrayList(u8){};
+    defer text.deinit(allocator);
+    for (batch.segments.items) |seg| try text.appendSlice(allocator, seg.base[0..seg.len]);
+    try std.testing.expectEqualStrings("-a-b-c-\n-\n-a-😀-\n", text.items);
+}
+
+test "batch output stays contiguous" {
+    const allocator = std.testing.allocator;
+    const call = try parseArgs(&.{"trim"});
+    const batch = try Batch.create(allocator, "a\nb\nc\n", null);
+    defer batch.destroy(allocator);
+
+    processBatch(&call, batch);
+    try std.testing.expectEqual(@as(usize, 3), batch.records);
+    try std.testing.expectEqual(@as(usize, 1), batch.segments.items.len);
+    try std.testing.expectEqual(@as(usize, 6), batch.segments.items[0].len);
+}
+
+test "split emits one record per field" {
+    const allocator = std.testing.allocator;
+    const call = try parseArgs(&.{ "split", ",", "2" });
+    const batch = try Batch.create(allocator, "a,b,c\nx\n", null);
+    defer batch.destroy(allocator);
+
+    processBatch(&call, batch);
+    var text = std.ArrayList(u8){};
+    defer text.deinit(allocator);
+    for (batch.segments.items) |seg| try text.appendSlice(allocator, seg.base[0..seg.len]);
+    try std.testing.expectEqualStrings("a\nb\nx\n", text.items);
+}
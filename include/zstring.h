@@ -39,16 +39,38 @@ typedef enum {
     ZSTRING_ERROR_INVALID_ARGUMENT = 4,
     ZSTRING_ERROR_REGEX_COMPILE = 5,
     ZSTRING_ERROR_REGEX_MATCH = 6,
+    ZSTRING_ERROR_MALFORMED_URI = 7,
+    ZSTRING_ERROR_IO = 8,
+    ZSTRING_ERROR_BUSY = 9,
+    ZSTRING_ERROR_CANCELLED = 10,
 } ZStringError;
 
 /**
  * String array result (for split, match operations)
+ *
+ * Item lengths are available in O(1) through zstring_str_len.
  */
 typedef struct {
     char** items;
     size_t count;
 } ZStringArray;
 
+/**
+ * Borrowed string view (not null-terminated)
+ */
+typedef struct {
+    const char* data;
+    size_t len;
+} ZStringView;
+
+/**
+ * Per-field callback for zstring_split_map_join
+ *
+ * Returns the mapped field as a view that must stay valid until the call
+ * returns (typically a sub-range of the field, or a constant string).
+ */
+typedef ZStringView (*ZStringMapFn)(ZStringView field, void* user_data);
+
 /**
  * Match result for regex operations
  */
@@ -410,15 +432,1688 @@ ZStringError zstring_replace(const ZString* zstr, const char* search_value, cons
 ZStringError zstring_replace_all(const ZString* zstr, const char* search_value, const char* replace_value, char** out);
 
 /* ============================================================================
- * Memory Management Helpers
+ * Join
  * ========================================================================== */
 
 /**
- * Free a string allocated by zstring functions
+ * Join string views with a separator (Array.prototype.join)
  *
- * @param str String to free
+ * The result length is computed up front and allocated once.
+ *
+ * @param parts Array of views
+ * @param count Number of views
+ * @param separator Separator (pass NULL for ",")
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, error code otherwise
  */
-void zstring_str_free(char* str);
+ZStringError zstring_join(const ZStringView* parts, size_t count, const char* separator, char** out);
+
+/**
+ * Join a ZStringArray with a separator (Array.prototype.join)
+ *
+ * Item lengths are read from the hidden length header of each item (see
+ * zstring_str_len), so every item must have been allocated by this
+ * library. Passing an array built by the caller is undefined behaviour;
+ * join your own strings with zstring_join and ZStringView instead.
+ *
+ * @param array Array returned by this library, e.g. from zstring_split
+ * @param separator Separator (pass NULL for ",")
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_join_array(const ZStringArray* array, const char* separator, char** out);
+
+/**
+ * Fused split -> map -> join without intermediate arrays
+ *
+ * Splits on separator (empty splits into characters), passes each field
+ * through map_fn and joins the results with joiner. map_fn is called twice
+ * per field (measure, then copy) and must return the same view both times.
+ *
+ * @param zstr ZString handle
+ * @param separator Field separator
+ * @param joiner String placed between mapped fields
+ * @param map_fn Per-field callback
+ * @param user_data Passed through to map_fn
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_split_map_join(const ZString* zstr, const char* separator, const char* joiner, ZStringMapFn map_fn, void* user_data, char** out);
+
+/* ============================================================================
+ * Multi-pair Replacement
+ * ========================================================================== */
+
+/**
+ * Opaque compiled replacer handle
+ */
+typedef struct ZStringReplacer ZStringReplacer;
+
+/**
+ * Compile literal key/replacement pairs into a reusable replacer
+ *
+ * Matching is leftmost-longest; among keys of equal length the first one
+ * listed wins. Replacement text is never re-scanned. Empty keys are ignored.
+ *
+ * @param from Array of keys
+ * @param to Array of replacements (parallel to from)
+ * @param count Number of pairs
+ * @param out Pointer to receive the replacer handle
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_replacer_new(const char** from, const char** to, size_t count, ZStringReplacer** out);
+
+/**
+ * Apply a compiled replacer to a string in a single pass
+ *
+ * @param rep Replacer handle
+ * @param zstr ZString handle
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_replacer_apply(const ZStringReplacer* rep, const ZString* zstr, char** out);
+
+/**
+ * Free a compiled replacer
+ *
+ * @param rep Replacer to free
+ */
+void zstring_replacer_free(ZStringReplacer* rep);
+
+/**
+ * Replace several literal keys in one pass (compile + apply)
+ *
+ * @param zstr ZString handle
+ * @param from Array of keys
+ * @param to Array of replacements (parallel to from)
+ * @param count Number of pairs
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_replace_many(const ZString* zstr, const char** from, const char** to, size_t count, char** out);
+
+/**
+ * Translate bytes (tr): every from[i] becomes to[i]
+ *
+ * @param zstr ZString handle
+ * @param from ASCII bytes to replace
+ * @param to ASCII replacement bytes (same length as from)
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_ARGUMENT if the sets
+ *         differ in length or contain non-ASCII bytes
+ */
+ZStringError zstring_translate(const ZString* zstr, const char* from, const char* to, char** out);
+
+/* ============================================================================
+ * Escaping
+ * ========================================================================== */
+
+/**
+ * Escape for use inside a JSON string literal (no surrounding quotes)
+ *
+ * @param zstr ZString handle
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_escape_json(const ZString* zstr, char** out);
+
+/**
+ * Decode JSON string escapes (\n, \uXXXX, ...)
+ *
+ * @param zstr ZString handle
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_ARGUMENT on a
+ *         malformed escape sequence
+ */
+ZStringError zstring_unescape_json(const ZString* zstr, char** out);
+
+/**
+ * Quote as a JSON string (JSON.stringify)
+ *
+ * @param zstr ZString handle
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_quote_json(const ZString* zstr, char** out);
+
+/**
+ * Escape HTML special characters (& < > " ')
+ *
+ * @param zstr ZString handle
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_escape_html(const ZString* zstr, char** out);
+
+/**
+ * Decode HTML character references (&amp;, &#39;, &#x1F600;, ...)
+ *
+ * @param zstr ZString handle
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_unescape_html(const ZString* zstr, char** out);
+
+/* ============================================================================
+ * URI Encoding
+ * ========================================================================== */
+
+/**
+ * Percent-encode a URI component (encodeURIComponent)
+ *
+ * @param zstr ZString handle
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_UTF8 for malformed
+ *         input or lone surrogates
+ */
+ZStringError zstring_encode_uri_component(const ZString* zstr, char** out);
+
+/**
+ * Percent-encode a full URI, keeping reserved characters (encodeURI)
+ *
+ * @param zstr ZString handle
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_UTF8 for malformed
+ *         input or lone surrogates
+ */
+ZStringError zstring_encode_uri(const ZString* zstr, char** out);
+
+/**
+ * Decode all percent escapes (decodeURIComponent)
+ *
+ * @param zstr ZString handle
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_MALFORMED_URI for truncated,
+ *         non-hex or non-UTF-8 escapes
+ */
+ZStringError zstring_decode_uri_component(const ZString* zstr, char** out);
+
+/**
+ * Decode percent escapes except reserved characters (decodeURI)
+ *
+ * @param zstr ZString handle
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_MALFORMED_URI for truncated,
+ *         non-hex or non-UTF-8 escapes
+ */
+ZStringError zstring_decode_uri(const ZString* zstr, char** out);
+
+/* ============================================================================
+ * Number Conversion
+ * ========================================================================== */
+
+/**
+ * Convert a number to its ECMAScript string form (Number.prototype.toString)
+ *
+ * Radix 10 uses the shortest round-trip digits ("0.1", "1e+21", "NaN").
+ *
+ * @param value Number to convert
+ * @param radix Radix in 2..36
+ * @param out Pointer to receive allocated result
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_ARGUMENT for a bad radix
+ */
+ZStringError zstring_number_to_string(double value, int radix, char** out);
+
+/**
+ * Parse the longest decimal literal prefix (parseFloat)
+ *
+ * @param zstr ZString handle
+ * @return Parsed value, or NaN if no prefix is a number
+ */
+double zstring_parse_float(const ZString* zstr);
+
+/**
+ * Parse an integer prefix in the given radix (parseInt)
+ *
+ * @param zstr ZString handle
+ * @param radix Radix in 2..36, or 0 to detect 10/16 from a "0x" prefix
+ * @return Parsed value, or NaN for a bad radix or no digits
+ */
+double zstring_parse_int(const ZString* zstr, int radix);
+
+/* ============================================================================
+ * String Column
+ * ========================================================================== */
+
+/**
+ * Opaque columnar string array
+ *
+ * All rows share one contiguous data buffer plus an offsets array, so there
+ * is no per-row handle or allocation. Column operations return new columns
+ * or bitmaps (one bit per row, least significant bit first).
+ */
+typedef struct ZStringColumn ZStringColumn;
+
+/**
+ * Create an empty column
+ *
+ * @param track_stats Cache per-row UTF-16 length and ASCII bit on append
+ * @param out Pointer to receive the column (free with zstring_column_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_column_new(bool track_stats, ZStringColumn** out);
+
+/**
+ * Free a column
+ *
+ * @param col Column to free (NULL is ignored)
+ */
+void zstring_column_free(ZStringColumn* col);
+
+/**
+ * Append a row
+ *
+ * @param col Column
+ * @param data UTF-8 bytes (copied)
+ * @param len Byte length
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_ARGUMENT when the
+ *         column data would exceed 4 GiB
+ */
+ZStringError zstring_column_append(ZStringColumn* col, const char* data, size_t len);
+
+/**
+ * Get the number of rows
+ */
+size_t zstring_column_len(const ZStringColumn* col);
+
+/**
+ * Borrow a row (valid until the column is modified or freed)
+ *
+ * @param col Column
+ * @param index Row index
+ * @param out Pointer to receive the view
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INDEX_OUT_OF_BOUNDS otherwise
+ */
+ZStringError zstring_column_get(const ZStringColumn* col, size_t index, ZStringView* out);
+
+/**
+ * Get the UTF-16 length of a row (cached when stats are tracked)
+ */
+size_t zstring_column_utf16_length(const ZStringColumn* col, size_t index);
+
+/**
+ * Lowercase every row into a new column
+ *
+ * @param col Column
+ * @param out Pointer to receive the new column
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_column_lower(const ZStringColumn* col, ZStringColumn** out);
+
+/**
+ * Trim every row into a new column
+ *
+ * @param col Column
+ * @param out Pointer to receive the new column
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_column_trim(const ZStringColumn* col, ZStringColumn** out);
+
+/**
+ * Keep the part of every row before the first separator
+ *
+ * @param col Column
+ * @param separator Field separator
+ * @param out Pointer to receive the new column
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_column_split_first_field(const ZStringColumn* col, const char* separator, ZStringColumn** out);
+
+/**
+ * Test every row for a substring
+ *
+ * @param col Column
+ * @param needle Substring to search for
+ * @param out_bits Buffer of (rows + 7) / 8 bytes receiving one bit per row
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_column_includes(const ZStringColumn* col, const char* needle, uint8_t* out_bits);
+
+/**
+ * Test every row for a prefix
+ *
+ * @param col Column
+ * @param prefix Prefix to test
+ * @param out_bits Buffer of (rows + 7) / 8 bytes receiving one bit per row
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_column_starts_with(const ZStringColumn* col, const char* prefix, uint8_t* out_bits);
+
+/* ============================================================================
+ * Arrow C Data Interface
+ * ========================================================================== */
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+/**
+ * Move a column into an Arrow utf8 array without copying
+ *
+ * On success the column handle is consumed; its buffers now belong to the
+ * Arrow array and are freed by out_array->release.
+ *
+ * @param col Column to export
+ * @param out_array Receives the array
+ * @param out_schema Receives the schema (format "u")
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_ARGUMENT when the
+ *         data exceeds int32 offsets
+ */
+ZStringError zstring_column_to_arrow(ZStringColumn* col, struct ArrowArray* out_array, struct ArrowSchema* out_schema);
+
+/**
+ * Lowercase every row of a utf8/large_utf8 array
+ *
+ * The input is read in place (borrowed, not released). The result has the
+ * input's type and nulls.
+ *
+ * @param in Input array
+ * @param in_schema Input schema ("u" or "U")
+ * @param out Receives the result array
+ * @param out_schema Receives the result schema
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_arrow_lower(const struct ArrowArray* in, const struct ArrowSchema* in_schema, struct ArrowArray* out, struct ArrowSchema* out_schema);
+
+/**
+ * Trim every row of a utf8/large_utf8 array
+ *
+ * @see zstring_arrow_lower
+ */
+ZStringError zstring_arrow_trim(const struct ArrowArray* in, const struct ArrowSchema* in_schema, struct ArrowArray* out, struct ArrowSchema* out_schema);
+
+/**
+ * Keep the part of every row before the first separator
+ *
+ * @see zstring_arrow_lower
+ */
+ZStringError zstring_arrow_split_first_field(const struct ArrowArray* in, const struct ArrowSchema* in_schema, const char* separator, struct ArrowArray* out, struct ArrowSchema* out_schema);
+
+/**
+ * Test every row for a substring, as a boolean array (format "b")
+ *
+ * Null rows stay null in the result (and their value bit is false).
+ *
+ * @param in Input array
+ * @param in_schema Input schema ("u" or "U")
+ * @param needle Substring to search for
+ * @param out Receives the boolean array
+ * @param out_schema Receives the boolean schema
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_arrow_includes(const struct ArrowArray* in, const struct ArrowSchema* in_schema, const char* needle, struct ArrowArray* out, struct ArrowSchema* out_schema);
+
+/**
+ * Test every row for a prefix, as a boolean array (format "b")
+ *
+ * @see zstring_arrow_includes
+ */
+ZStringError zstring_arrow_starts_with(const struct ArrowArray* in, const struct ArrowSchema* in_schema, const char* prefix, struct ArrowArray* out, struct ArrowSchema* out_schema);
+
+/* ============================================================================
+ * Dictionary-encoded Column
+ * ========================================================================== */
+
+/**
+ * Opaque dictionary-encoded string column
+ *
+ * Distinct values are stored once; each row holds a u8/u16/u32 code that
+ * widens as the dictionary grows. Operations run once per distinct value
+ * and are broadcast to the rows.
+ */
+typedef struct ZStringDictionary ZStringDictionary;
+
+/**
+ * Create an empty dictionary-encoded column
+ *
+ * @param out Pointer to receive the column (free with zstring_dictionary_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_dictionary_new(ZStringDictionary** out);
+
+/**
+ * Dictionary-encode every row of a column
+ *
+ * @param col Source column
+ * @param out Pointer to receive the encoded column
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_dictionary_from_column(const ZStringColumn* col, ZStringDictionary** out);
+
+/**
+ * Free a dictionary-encoded column
+ *
+ * @param dict Column to free (NULL is ignored)
+ */
+void zstring_dictionary_free(ZStringDictionary* dict);
+
+/**
+ * Append a row (hashed into the dictionary)
+ *
+ * @param dict Column
+ * @param data UTF-8 bytes
+ * @param len Byte length
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_dictionary_append(ZStringDictionary* dict, const char* data, size_t len);
+
+/**
+ * Get the number of rows
+ */
+size_t zstring_dictionary_len(const ZStringDictionary* dict);
+
+/**
+ * Get the number of distinct values
+ */
+size_t zstring_dictionary_cardinality(const ZStringDictionary* dict);
+
+/**
+ * Get the dictionary code of a row
+ */
+uint32_t zstring_dictionary_code(const ZStringDictionary* dict, size_t index);
+
+/**
+ * Borrow the value for a dictionary code
+ *
+ * @param dict Column
+ * @param code Code in [0, cardinality)
+ * @param out Pointer to receive the view
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INDEX_OUT_OF_BOUNDS otherwise
+ */
+ZStringError zstring_dictionary_value(const ZStringDictionary* dict, uint32_t code, ZStringView* out);
+
+/**
+ * Lowercase every distinct value into a new column
+ *
+ * Values that collide after lowering are merged.
+ *
+ * @param dict Column
+ * @param out Pointer to receive the new column
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_dictionary_lower(const ZStringDictionary* dict, ZStringDictionary** out);
+
+/**
+ * Test every row for a substring
+ *
+ * @param dict Column
+ * @param needle Substring to search for
+ * @param out_bits Buffer of (rows + 7) / 8 bytes receiving one bit per row
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_dictionary_includes(const ZStringDictionary* dict, const char* needle, uint8_t* out_bits);
+
+/**
+ * Test every row for a prefix
+ *
+ * @param dict Column
+ * @param prefix Prefix to test
+ * @param out_bits Buffer of (rows + 7) / 8 bytes receiving one bit per row
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_dictionary_starts_with(const ZStringDictionary* dict, const char* prefix, uint8_t* out_bits);
+
+/**
+ * Compare every row with a string (String.prototype.localeCompare)
+ *
+ * @param dict Column
+ * @param that String to compare with
+ * @param out Array of rows entries receiving -1, 0 or 1
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_dictionary_locale_compare(const ZStringDictionary* dict, const char* that, int8_t* out);
+
+/* ============================================================================
+ * Compressed Strings
+ * ========================================================================== */
+
+/**
+ * Opaque container of strings compressed with a shared symbol table
+ *
+ * Up to 255 frequent substrings (1-8 bytes) are replaced by one-byte codes.
+ * Each string decompresses independently, and equality, includes and
+ * startsWith compare against a needle compressed with the same table.
+ */
+typedef struct ZStringCompressed ZStringCompressed;
+
+/**
+ * Build a symbol table from the strings and compress them
+ *
+ * @param parts Array of string views
+ * @param count Number of strings
+ * @param out Pointer to receive the container (free with zstring_compressed_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_compressed_build(const ZStringView* parts, size_t count, ZStringCompressed** out);
+
+/**
+ * Free a compressed container
+ *
+ * @param c Container to free (NULL is ignored)
+ */
+void zstring_compressed_free(ZStringCompressed* c);
+
+/**
+ * Compress and append a string using the existing symbol table
+ *
+ * @param c Container
+ * @param data UTF-8 bytes
+ * @param len Byte length
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_compressed_append(ZStringCompressed* c, const char* data, size_t len);
+
+/**
+ * Get the number of strings
+ */
+size_t zstring_compressed_len(const ZStringCompressed* c);
+
+/**
+ * Get the size of the compressed data in bytes
+ */
+size_t zstring_compressed_size(const ZStringCompressed* c);
+
+/**
+ * Decompress one string
+ *
+ * @param c Container
+ * @param index String index
+ * @param out Pointer to receive the string (must be freed with zstring_str_free)
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INDEX_OUT_OF_BOUNDS otherwise
+ */
+ZStringError zstring_compressed_get(const ZStringCompressed* c, size_t index, char** out);
+
+/**
+ * Test every string for equality without decompressing
+ *
+ * @param c Container
+ * @param needle String to compare with
+ * @param out_bits Buffer of (count + 7) / 8 bytes receiving one bit per string
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_compressed_equals(const ZStringCompressed* c, const char* needle, uint8_t* out_bits);
+
+/**
+ * Test every string for a substring
+ *
+ * @param c Container
+ * @param needle Substring to search for
+ * @param out_bits Buffer of (count + 7) / 8 bytes receiving one bit per string
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_compressed_includes(const ZStringCompressed* c, const char* needle, uint8_t* out_bits);
+
+/**
+ * Test every string for a prefix
+ *
+ * @param c Container
+ * @param prefix Prefix to test
+ * @param out_bits Buffer of (count + 7) / 8 bytes receiving one bit per string
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_compressed_starts_with(const ZStringCompressed* c, const char* prefix, uint8_t* out_bits);
+
+/* ============================================================================
+ * Serialized String Table
+ * ========================================================================== */
+
+/**
+ * Opaque read-only string table mapped from a file
+ *
+ * The file holds a header, an offsets array, the string data, per-entry
+ * hashes and UTF-16 lengths, and optionally a perfect-hash index. Opening
+ * maps it with a single mmap; entries are views into the shared mapping.
+ */
+typedef struct ZStringTable ZStringTable;
+
+/**
+ * Serialize strings to a table file
+ *
+ * @param parts Array of string views
+ * @param count Number of strings
+ * @param perfect_hash Build a perfect-hash index (strings must be unique)
+ * @param path Output file path
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_table_write(const ZStringView* parts, size_t count, bool perfect_hash, const char* path);
+
+/**
+ * Map a table file
+ *
+ * Every offset and perfect-hash slot is checked first, so a truncated or
+ * corrupt file is rejected here rather than read out of bounds later.
+ *
+ * @param path File path
+ * @param out Pointer to receive the table (close with zstring_table_close)
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_ARGUMENT for a
+ *         corrupt file, error code otherwise
+ */
+ZStringError zstring_table_open(const char* path, ZStringTable** out);
+
+/**
+ * Unmap a table (views obtained from it become invalid)
+ *
+ * @param table Table to close (NULL is ignored)
+ */
+void zstring_table_close(ZStringTable* table);
+
+/**
+ * Get the number of entries
+ */
+size_t zstring_table_len(const ZStringTable* table);
+
+/**
+ * Borrow an entry
+ *
+ * @param table Table
+ * @param index Entry index
+ * @param out Pointer to receive the view (valid until the table is closed)
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INDEX_OUT_OF_BOUNDS otherwise
+ */
+ZStringError zstring_table_get(const ZStringTable* table, size_t index, ZStringView* out);
+
+/**
+ * Get the precomputed 64-bit hash of an entry
+ */
+uint64_t zstring_table_hash(const ZStringTable* table, size_t index);
+
+/**
+ * Get the precomputed UTF-16 length of an entry
+ */
+size_t zstring_table_utf16_length(const ZStringTable* table, size_t index);
+
+/**
+ * Look up an entry by value
+ *
+ * Uses the perfect-hash index when present.
+ *
+ * @param table Table
+ * @param data UTF-8 bytes
+ * @param len Byte length
+ * @param out_index Receives the entry index when found (may be NULL)
+ * @return true if found
+ */
+bool zstring_table_find(const ZStringTable* table, const char* data, size_t len, size_t* out_index);
+
+/* ============================================================================
+ * N-gram Index
+ * ========================================================================== */
+
+/**
+ * Opaque trigram inverted index over a collection of strings
+ *
+ * Queries intersect the posting lists of the needle's trigrams and verify
+ * the remaining rows with indexOf semantics. Rows can be appended without
+ * rebuilding.
+ */
+typedef struct ZStringNgramIndex ZStringNgramIndex;
+
+/**
+ * A verified match: row and UTF-16 index of the first occurrence
+ */
+typedef struct {
+    size_t row;
+    size_t index;
+} ZStringRowMatch;
+
+/**
+ * Create an empty index
+ *
+ * @param out Pointer to receive the index (free with zstring_ngram_index_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_ngram_index_new(ZStringNgramIndex** out);
+
+/**
+ * Index a collection of strings
+ *
+ * @param parts Array of string views (copied into the index)
+ * @param count Number of strings
+ * @param thread_count Build threads (0 = one per CPU)
+ * @param out Pointer to receive the index
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_ngram_index_build(const ZStringView* parts, size_t count, size_t thread_count, ZStringNgramIndex** out);
+
+/**
+ * Free an index
+ *
+ * @param index Index to free (NULL is ignored)
+ */
+void zstring_ngram_index_free(ZStringNgramIndex* index);
+
+/**
+ * Append and index a row
+ *
+ * @param index Index
+ * @param data UTF-8 bytes
+ * @param len Byte length
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_ngram_index_append(ZStringNgramIndex* index, const char* data, size_t len);
+
+/**
+ * Get the number of rows
+ */
+size_t zstring_ngram_index_len(const ZStringNgramIndex* index);
+
+/**
+ * Find every row containing a substring
+ *
+ * @param index Index
+ * @param needle Substring to search for
+ * @param out Pointer to receive the matches in row order (free with zstring_matches_free)
+ * @param out_count Pointer to receive the number of matches
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_ngram_index_search(const ZStringNgramIndex* index, const char* needle, ZStringRowMatch** out, size_t* out_count);
+
+/**
+ * Free matches returned by zstring_ngram_index_search
+ *
+ * @param matches Matches to free (NULL is ignored)
+ * @param count Number of matches
+ */
+void zstring_matches_free(ZStringRowMatch* matches, size_t count);
+
+/* ============================================================================
+ * Prefix Set
+ * ========================================================================== */
+
+/**
+ * Opaque set of prefixes stored as a double-array trie
+ *
+ * Longest-prefix and all-prefix queries cost O(length of the input),
+ * independent of the number of prefixes.
+ */
+typedef struct ZStringPrefixSet ZStringPrefixSet;
+
+/**
+ * Build a prefix set
+ *
+ * @param prefixes Array of prefixes; match ids are indices into this array
+ * @param count Number of prefixes
+ * @param out Pointer to receive the set (free with zstring_prefix_set_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_prefix_set_build(const ZStringView* prefixes, size_t count, ZStringPrefixSet** out);
+
+/**
+ * Load a prefix set from its serialized form
+ *
+ * @param data Serialized bytes (copied)
+ * @param len Byte length
+ * @param out Pointer to receive the set
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_ARGUMENT if malformed
+ */
+ZStringError zstring_prefix_set_load(const void* data, size_t len, ZStringPrefixSet** out);
+
+/**
+ * Free a prefix set
+ *
+ * @param set Set to free (NULL is ignored)
+ */
+void zstring_prefix_set_free(ZStringPrefixSet* set);
+
+/**
+ * Borrow the serialized form of a prefix set
+ *
+ * @param set Set
+ * @param out_data Receives a pointer valid until the set is freed
+ * @param out_len Receives the byte length
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_prefix_set_serialized(const ZStringPrefixSet* set, const void** out_data, size_t* out_len);
+
+/**
+ * Find the longest prefix of a string in the set
+ *
+ * @param set Set
+ * @param str Input bytes
+ * @param len Byte length
+ * @param out_id Receives the prefix id (may be NULL)
+ * @param out_len Receives the prefix length in bytes (may be NULL)
+ * @return true if some prefix matched
+ */
+bool zstring_prefix_set_longest(const ZStringPrefixSet* set, const char* str, size_t len, uint32_t* out_id, size_t* out_len);
+
+/**
+ * Find every prefix of a string in the set, shortest first
+ *
+ * @param set Set
+ * @param str Input bytes
+ * @param len Byte length
+ * @param out_ids Buffer receiving up to capacity ids (may be NULL)
+ * @param capacity Size of out_ids
+ * @return Total number of matching prefixes (may exceed capacity)
+ */
+size_t zstring_prefix_set_matches(const ZStringPrefixSet* set, const char* str, size_t len, uint32_t* out_ids, size_t capacity);
+
+/* ============================================================================
+ * Fuzzy Matching
+ * ========================================================================== */
+
+/**
+ * Result of zstring_index_of_approx
+ */
+typedef struct {
+    int64_t index;    /* UTF-16 index, or -1 if nothing matched */
+    size_t length;    /* UTF-16 length of the matched text */
+    size_t distance;  /* edits needed */
+} ZStringApproxMatch;
+
+/**
+ * Edit distance between two UTF-8 strings, in code points
+ *
+ * Bit-parallel (Myers/Hyyro); ASCII inputs are compared without decoding.
+ *
+ * @param a First string
+ * @param a_len Byte length of a
+ * @param b Second string
+ * @param b_len Byte length of b
+ * @param max Stop early once the distance exceeds this (SIZE_MAX for no limit)
+ * @param transpositions Count adjacent swaps as one edit
+ * @param out Receives the distance, or SIZE_MAX if it exceeds max
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_UTF8 otherwise
+ */
+ZStringError zstring_edit_distance(const char* a, size_t a_len, const char* b, size_t b_len, size_t max, bool transpositions, size_t* out);
+
+/**
+ * Find the first approximate occurrence of a substring
+ *
+ * @param zstr ZString handle
+ * @param search_str Substring to search for
+ * @param max_errors Maximum number of edits
+ * @param transpositions Count adjacent swaps as one edit
+ * @param out Receives the match (index -1 if none)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_index_of_approx(const ZString* zstr, const char* search_str, size_t max_errors, bool transpositions, ZStringApproxMatch* out);
+
+/* ============================================================================
+ * Diff
+ * ========================================================================== */
+
+typedef enum {
+    ZSTRING_DIFF_CODE_POINT = 0,  /* one token per code point */
+    ZSTRING_DIFF_WORD = 1,        /* words, whitespace runs, punctuation */
+    ZSTRING_DIFF_LINE = 2         /* lines including their terminator */
+} ZStringDiffGranularity;
+
+typedef enum {
+    ZSTRING_EDIT_EQUAL = 0,
+    ZSTRING_EDIT_DELETE = 1,
+    ZSTRING_EDIT_INSERT = 2
+} ZStringEditOp;
+
+/**
+ * One step of an edit script
+ *
+ * Offsets and lengths are in UTF-16 code units. Each edit starts where the
+ * previous one ended in both texts; old_len is 0 for inserts and new_len
+ * is 0 for deletes.
+ */
+typedef struct {
+    int op;            /* ZStringEditOp */
+    size_t old_start;
+    size_t old_len;
+    size_t new_start;
+    size_t new_len;
+} ZStringEdit;
+
+/**
+ * Compute an edit script turning one UTF-8 string into another
+ *
+ * Myers O(ND) diff in linear space; the common prefix and suffix are
+ * skipped with vector compares first.
+ *
+ * @param old_text Old text
+ * @param old_len Byte length of old_text
+ * @param new_text New text
+ * @param new_len Byte length of new_text
+ * @param granularity ZStringDiffGranularity
+ * @param out Pointer to receive the edits (free with zstring_edits_free)
+ * @param out_count Pointer to receive the number of edits
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_diff(const char* old_text, size_t old_len, const char* new_text, size_t new_len, int granularity, ZStringEdit** out, size_t* out_count);
+
+/**
+ * Free edits returned by zstring_diff
+ *
+ * @param edits Edits to free (NULL is ignored)
+ * @param count Number of edits
+ */
+void zstring_edits_free(ZStringEdit* edits, size_t count);
+
+/* ============================================================================
+ * Display Width
+ * ========================================================================== */
+
+typedef enum {
+    ZSTRING_PAD_START = 0,  /* pad before the text */
+    ZSTRING_PAD_END = 1,    /* pad after the text */
+    ZSTRING_PAD_BOTH = 2    /* center, extra column after */
+} ZStringPadSide;
+
+/**
+ * Terminal display width in columns
+ *
+ * East Asian Wide/Fullwidth characters and emoji count two columns,
+ * combining marks and controls none; emoji ZWJ sequences, skin tones
+ * and flags count as one glyph.
+ */
+size_t zstring_display_width(const ZString* zstr);
+
+/**
+ * Pad to a display width (padStart/padEnd count UTF-16 units instead)
+ *
+ * @param zstr ZString handle
+ * @param width Target width in columns
+ * @param fill Padding text (NULL for a space)
+ * @param side ZStringPadSide
+ * @param out Pointer to receive result (must be freed with zstring_str_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_pad_to_width(const ZString* zstr, size_t width, const char* fill, int side, char** out);
+
+/**
+ * Cut to at most a display width
+ *
+ * @param zstr ZString handle
+ * @param width Maximum width in columns
+ * @param ellipsis Appended when text was cut (may be NULL)
+ * @param out Pointer to receive result (must be freed with zstring_str_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_truncate_to_width(const ZString* zstr, size_t width, const char* ellipsis, char** out);
+
+/**
+ * Word-wrap to lines of at most a display width
+ *
+ * Breaks at spaces and between wide characters; longer words are split.
+ *
+ * @param zstr ZString handle
+ * @param width Maximum line width in columns
+ * @param out Array to receive the lines (must be freed with zstring_array_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_wrap_to_width(const ZString* zstr, size_t width, ZStringArray* out);
+
+/* ============================================================================
+ * Lines
+ * ========================================================================== */
+
+/**
+ * Line iterator state (declare on the stack, start with zstring_lines_init)
+ */
+typedef struct {
+    const char* data;
+    size_t len;
+    size_t pos;
+    size_t number;
+    size_t index;
+    bool track_utf16;
+    bool done;
+} ZStringLineIterator;
+
+/**
+ * A line borrowed from the iterated text (terminator excluded)
+ */
+typedef struct {
+    const char* data;
+    size_t len;
+    size_t number;  /* zero-based line number */
+    size_t start;   /* byte offset */
+    size_t index;   /* UTF-16 offset (0 unless tracking was requested) */
+} ZStringLine;
+
+/**
+ * Start iterating over lines without allocating
+ *
+ * Lines end at \n, \r, \r\n, U+2028 and U+2029, found with a vector
+ * scan. A trailing terminator yields a final empty line, as split() does.
+ * The text must outlive the iterator.
+ *
+ * @param it Iterator to initialize
+ * @param data UTF-8 text
+ * @param len Byte length
+ * @param track_utf16 Compute ZStringLine.index
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_lines_init(ZStringLineIterator* it, const char* data, size_t len, bool track_utf16);
+
+/**
+ * Advance to the next line
+ *
+ * @param it Iterator
+ * @param out Receives the line
+ * @return true if a line was returned, false at the end
+ */
+bool zstring_lines_next(ZStringLineIterator* it, ZStringLine* out);
+
+/* ============================================================================
+ * Character Sets
+ * ========================================================================== */
+
+/**
+ * Opaque compiled set of code points
+ *
+ * ASCII members are matched with a vectorized nibble-table classifier;
+ * non-ASCII members are kept as sorted ranges. Compile once, reuse across
+ * calls. All returned indices are in UTF-16 code units.
+ */
+typedef struct ZStringCharSet ZStringCharSet;
+
+/**
+ * Compile the set of code points appearing in a string
+ *
+ * @param chars Member code points (UTF-8, null-terminated)
+ * @param out Pointer to receive the set (free with zstring_charset_free)
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_UTF8 if malformed
+ */
+ZStringError zstring_charset_new(const char* chars, ZStringCharSet** out);
+
+/**
+ * Free a character set
+ *
+ * @param set Set to free (NULL is ignored)
+ */
+void zstring_charset_free(ZStringCharSet* set);
+
+/**
+ * Find the first code point in a set (like strpbrk)
+ *
+ * @param zstr ZString handle
+ * @param set Character set
+ * @param position Starting position (pass -1 for 0)
+ * @return Index of the first member, or -1 if none
+ */
+int64_t zstring_index_of_any(const ZString* zstr, const ZStringCharSet* set, int64_t position);
+
+/**
+ * Find the last code point in a set
+ *
+ * @param zstr ZString handle
+ * @param set Character set
+ * @param position Last position to consider (pass -1 for the end)
+ * @return Index of the last member, or -1 if none
+ */
+int64_t zstring_last_index_of_any(const ZString* zstr, const ZStringCharSet* set, int64_t position);
+
+/**
+ * Length of the leading run of code points in a set (like strspn)
+ *
+ * @param zstr ZString handle
+ * @param set Character set
+ * @return Length in UTF-16 code units
+ */
+size_t zstring_span_of(const ZString* zstr, const ZStringCharSet* set);
+
+/**
+ * Remove leading and trailing code points in a set
+ *
+ * @param zstr ZString handle
+ * @param set Character set
+ * @param out Pointer to receive result (must be freed with zstring_str_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_trim_chars(const ZString* zstr, const ZStringCharSet* set, char** out);
+
+/**
+ * Split at every code point in a set
+ *
+ * Adjacent separators produce empty fields, as split() does.
+ *
+ * @param zstr ZString handle
+ * @param set Character set
+ * @param out Array to receive the fields (must be freed with zstring_array_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_split_any(const ZString* zstr, const ZStringCharSet* set, ZStringArray* out);
+
+/* ============================================================================
+ * File Pipeline (Linux io_uring)
+ * ========================================================================== */
+
+/**
+ * Output of one record, passed to a ZStringRecordFn
+ */
+typedef struct ZStringSink ZStringSink;
+
+/**
+ * Per-record transform
+ *
+ * Called concurrently from worker threads. Write the result with
+ * zstring_sink_write; the delimiter is written back by the pipeline.
+ * Returning anything but ZSTRING_OK stops the pipeline and is returned
+ * from zstring_pipeline_run.
+ */
+typedef ZStringError (*ZStringRecordFn)(void* ctx, const char* data, size_t len, ZStringSink* sink);
+
+/**
+ * Pipeline tuning (zero fields take the defaults)
+ */
+typedef struct {
+    size_t block_size;     /* bytes per read (default 1 MiB) */
+    uint32_t queue_depth;  /* reads in flight, at most 1024 (default 8) */
+    uint32_t workers;      /* worker threads (default one per CPU) */
+    char delimiter;        /* record separator (default '\n') */
+} ZStringPipelineOptions;
+
+/**
+ * Pipeline totals
+ */
+typedef struct {
+    size_t records;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+} ZStringPipelineStats;
+
+/**
+ * Append bytes to a record's output
+ *
+ * @param sink Sink passed to the transform
+ * @param data Bytes to append
+ * @param len Byte length
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_sink_write(ZStringSink* sink, const char* data, size_t len);
+
+/**
+ * Transform every record of a file into another file
+ *
+ * Reads go through io_uring with registered buffers and several requests
+ * in flight. Records are transformed on a worker pool and written back
+ * asynchronously in input order.
+ *
+ * @param in_path Input file (regular file)
+ * @param out_path Output file (created or truncated)
+ * @param fn Per-record transform
+ * @param ctx Passed to fn
+ * @param options Tuning (may be NULL)
+ * @param out_stats Receives totals (may be NULL)
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_IO on I/O failure or when
+ *         io_uring is unavailable, or the transform's error code
+ */
+ZStringError zstring_pipeline_run(const char* in_path, const char* out_path, ZStringRecordFn fn, void* ctx,
+                                  const ZStringPipelineOptions* options, ZStringPipelineStats* out_stats);
+
+/* ============================================================================
+ * Lazy Iterators
+ * ========================================================================== */
+
+/**
+ * split() iterator state (declare on the stack, start with zstring_split_iter_init)
+ */
+typedef struct {
+    const char* data;
+    size_t len;
+    const char* separator;
+    size_t separator_len;
+    size_t limit;
+    size_t pos;
+    size_t count;
+    bool done;
+} ZStringSplitIterator;
+
+/**
+ * Start iterating over the fields split(separator, limit) would return
+ *
+ * Fields are borrowed from data, which (like separator) must outlive the
+ * iterator. An empty separator yields one field per code point.
+ *
+ * @param it Iterator to initialize
+ * @param data UTF-8 text
+ * @param len Byte length
+ * @param separator Separator bytes
+ * @param separator_len Separator length
+ * @param limit Maximum number of fields (SIZE_MAX for no limit)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_split_iter_init(ZStringSplitIterator* it, const char* data, size_t len,
+                                     const char* separator, size_t separator_len, size_t limit);
+
+/**
+ * Advance to the next field
+ *
+ * @param it Iterator
+ * @param out Receives the field
+ * @return true if a field was returned, false at the end
+ */
+bool zstring_split_iter_next(ZStringSplitIterator* it, ZStringView* out);
+
+/**
+ * Opaque lazy matchAll() iterator
+ */
+typedef struct ZStringMatchIterator ZStringMatchIterator;
+
+/**
+ * Compile a pattern for lazy matchAll()
+ *
+ * Each zstring_match_iter_next call runs one search on the input after
+ * the previous match. The text must outlive the iterator.
+ *
+ * @param data UTF-8 text
+ * @param len Byte length
+ * @param pattern Regular expression
+ * @param out Pointer to receive the iterator (free with zstring_match_iter_free)
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_REGEX_COMPILE for a bad pattern
+ */
+ZStringError zstring_match_iter_new(const char* data, size_t len, const char* pattern, ZStringMatchIterator** out);
+
+/**
+ * Advance to the next match
+ *
+ * A failed search is reported rather than treated as the end of the
+ * matches, so a truncated result is never mistaken for a complete one.
+ *
+ * @param it Iterator
+ * @param out Receives the matched text (borrowed from the input)
+ * @param out_index Receives the UTF-16 index of the match (may be NULL)
+ * @param out_found Set to true if a match was returned, false at the end
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_REGEX_MATCH or
+ *         ZSTRING_ERROR_OUT_OF_MEMORY if the search failed
+ */
+ZStringError zstring_match_iter_next(ZStringMatchIterator* it, ZStringView* out, size_t* out_index, bool* out_found);
+
+/**
+ * Capture group of the match last returned
+ *
+ * @param it Iterator
+ * @param n Group number (1-15)
+ * @param out Receives the group text (borrowed from the input)
+ * @return true if the group captured, false otherwise
+ */
+bool zstring_match_iter_group(const ZStringMatchIterator* it, size_t n, ZStringView* out);
+
+/**
+ * Free a match iterator
+ *
+ * @param it Iterator to free (NULL is ignored)
+ */
+void zstring_match_iter_free(ZStringMatchIterator* it);
+
+/* ============================================================================
+ * Resumable Jobs
+ * ========================================================================== */
+
+/**
+ * Opaque resumable operation
+ *
+ * A job runs split, replaceAll, normalize, case conversion or matchAll a
+ * slice at a time, so an event loop can process a large input without
+ * blocking:
+ *
+ *   ZStringJob* job;
+ *   zstring_job_replace_all(body, body_len, "foo", "bar", &job);
+ *   bool done = false;
+ *   while (!done) {
+ *       zstring_job_step(job, 64 * 1024, &done);
+ *       run_other_callbacks();
+ *   }
+ *   ZStringView result;
+ *   zstring_job_text(job, &result);
+ *   zstring_job_free(job);
+ *
+ * The input is borrowed and must outlive the job. Regex jobs yield
+ * between matches, so a step that finds no match may scan to the end.
+ */
+typedef struct ZStringJob ZStringJob;
+
+/**
+ * Resumable split(separator, limit)
+ *
+ * @param limit Maximum number of fields (SIZE_MAX for no limit)
+ * @param out Pointer to receive the job (free with zstring_job_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_job_split(const char* data, size_t len, const char* separator, size_t separator_len, size_t limit, ZStringJob** out);
+
+/**
+ * Resumable replaceAll(pattern, replacement)
+ *
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_job_replace_all(const char* data, size_t len, const char* pattern, const char* replacement, ZStringJob** out);
+
+/**
+ * Resumable normalize(form)
+ *
+ * @param form "NFC", "NFD", "NFKC" or "NFKD" (NULL means "NFC")
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_job_normalize(const char* data, size_t len, const char* form, ZStringJob** out);
+
+/**
+ * Resumable toLowerCase()
+ */
+ZStringError zstring_job_to_lower_case(const char* data, size_t len, ZStringJob** out);
+
+/**
+ * Resumable toUpperCase()
+ */
+ZStringError zstring_job_to_upper_case(const char* data, size_t len, ZStringJob** out);
+
+/**
+ * Resumable matchAll(pattern)
+ *
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_REGEX_COMPILE for a bad pattern
+ */
+ZStringError zstring_job_match_all(const char* data, size_t len, const char* pattern, ZStringJob** out);
+
+/**
+ * Process about budget bytes of input
+ *
+ * A step may run a few bytes past budget to end on a character boundary.
+ *
+ * @param job Job
+ * @param budget Input bytes to process
+ * @param out_done Set to true once the job has finished
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_job_step(ZStringJob* job, size_t budget, bool* out_done);
+
+/**
+ * Input bytes processed so far
+ */
+size_t zstring_job_progress(const ZStringJob* job);
+
+/**
+ * Output of a replaceAll, normalize or case job
+ *
+ * @param out Receives the output (borrowed until the job is freed)
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_ARGUMENT for other jobs
+ */
+ZStringError zstring_job_text(const ZStringJob* job, ZStringView* out);
+
+/**
+ * Fields of a split job, or matched text of a matchAll job
+ *
+ * @param out Pointer to receive a copy (free with zstring_array_free)
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_ARGUMENT for other jobs
+ */
+ZStringError zstring_job_parts(const ZStringJob* job, ZStringArray* out);
+
+/**
+ * Free a job
+ *
+ * @param job Job to free (NULL is ignored)
+ */
+void zstring_job_free(ZStringJob* job);
+
+/* ============================================================================
+ * Async Submission
+ * ========================================================================== */
+
+/**
+ * Opaque handle to a job running on the shared executor
+ *
+ * Jobs (see zstring_job_*) are run to completion by a pool of worker
+ * threads fed from a bounded queue. The ticket completes when the job
+ * finishes, fails, or is cancelled:
+ *
+ *   ZStringJob* job;
+ *   zstring_job_normalize(text, len, "NFC", &job);
+ *   ZStringTicket* ticket;
+ *   zstring_submit_job(job, NULL, NULL, &ticket);   // ticket owns job
+ *   if (zstring_ticket_wait(ticket) == ZSTRING_OK) {
+ *       ZStringView out;
+ *       zstring_job_text(zstring_ticket_job(ticket), &out);
+ *   }
+ *   zstring_ticket_free(ticket);
+ */
+typedef struct ZStringTicket ZStringTicket;
+
+/**
+ * Completion callback
+ *
+ * Runs on a worker thread, or on the thread that cancelled a queued
+ * ticket. It may free the ticket with zstring_ticket_free, which then
+ * returns without waiting; the ticket must not be used after that.
+ */
+typedef void (*ZStringTicketCallback)(ZStringTicket* ticket, void* user_data);
+
+/**
+ * Size the shared executor
+ *
+ * Only allowed before the first submission or after
+ * zstring_executor_shutdown.
+ *
+ * @param workers Worker threads (0 for one per CPU)
+ * @param capacity Queued jobs before submission blocks
+ * @return ZSTRING_OK, or ZSTRING_ERROR_BUSY if the executor is running
+ */
+ZStringError zstring_executor_configure(size_t workers, size_t capacity);
+
+/**
+ * Stop the shared executor
+ *
+ * Queued tickets complete as cancelled; running ones finish first.
+ * Submissions already waiting for queue space fail, and so do new ones
+ * until shutdown returns. Safe to call while other threads submit, cancel
+ * or free tickets; must not be called from a ticket callback.
+ */
+void zstring_executor_shutdown(void);
+
+/**
+ * Run a job on the shared executor, waiting for queue space if needed
+ *
+ * On success the ticket owns the job; on failure the caller still does.
+ *
+ * @param job Job from a zstring_job_* constructor
+ * @param callback Completion callback (may be NULL)
+ * @param user_data Passed to callback
+ * @param out Pointer to receive the ticket (free with zstring_ticket_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_submit_job(ZStringJob* job, ZStringTicketCallback callback, void* user_data, ZStringTicket** out);
+
+/**
+ * Like zstring_submit_job, but never waits
+ *
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_BUSY if the queue is full
+ */
+ZStringError zstring_try_submit_job(ZStringJob* job, ZStringTicketCallback callback, void* user_data, ZStringTicket** out);
+
+/**
+ * Check whether a ticket has completed, without blocking
+ */
+bool zstring_ticket_poll(ZStringTicket* ticket);
+
+/**
+ * Block until a ticket completes
+ *
+ * @return ZSTRING_OK, ZSTRING_ERROR_CANCELLED, or the job's error
+ */
+ZStringError zstring_ticket_wait(ZStringTicket* ticket);
+
+/**
+ * Block for up to timeout_ns nanoseconds
+ *
+ * @return true if the ticket completed
+ */
+bool zstring_ticket_wait_for(ZStringTicket* ticket, uint64_t timeout_ns);
+
+/**
+ * Result of a ticket
+ *
+ * @return As zstring_ticket_wait, or ZSTRING_ERROR_BUSY if not yet complete
+ */
+ZStringError zstring_ticket_result(ZStringTicket* ticket);
+
+/**
+ * Cancel a ticket
+ *
+ * A queued job is dropped at once; a running one stops at its next step
+ * (every 1 MB of input).
+ */
+void zstring_ticket_cancel(ZStringTicket* ticket);
+
+/**
+ * The job of a ticket (owned by the ticket; read results once complete)
+ */
+ZStringJob* zstring_ticket_job(ZStringTicket* ticket);
+
+/**
+ * Take ownership of the job of a completed ticket
+ *
+ * @return The job (free with zstring_job_free), or NULL if the ticket has
+ *         not completed or the job was already taken
+ */
+ZStringJob* zstring_ticket_take_job(ZStringTicket* ticket);
+
+/**
+ * Free a ticket and its job, cancelling and waiting if still running
+ *
+ * @param ticket Ticket to free (NULL is ignored)
+ */
+void zstring_ticket_free(ZStringTicket* ticket);
+
+/* ============================================================================
+ * Mutable Buffers
+ * ========================================================================== */
+
+/**
+ * Opaque mutable string buffer
+ *
+ * Edits use UTF-16 indices like the rest of the API. The UTF-16 length and
+ * ASCII flag are kept current by each edit, so reading them is O(1).
+ */
+typedef struct ZStringBuf ZStringBuf;
+
+/**
+ * Create a buffer holding a copy of data
+ *
+ * @param data UTF-8 text (may be NULL when len is 0)
+ * @param len Byte length
+ * @param out Pointer to receive the buffer (free with zstring_buf_free)
+ * @return ZSTRING_OK on success, ZSTRING_ERROR_INVALID_UTF8 for bad input
+ */
+ZStringError zstring_buf_new(const char* data, size_t len, ZStringBuf** out);
+
+/**
+ * Replace UTF-16 code units [start, end) with data
+ *
+ * @return ZSTRING_OK on success,
+ *         ZSTRING_ERROR_INDEX_OUT_OF_BOUNDS if start > end or end > length,
+ *         ZSTRING_ERROR_INVALID_ARGUMENT if an index splits a surrogate pair,
+ *         ZSTRING_ERROR_INVALID_UTF8 if data is not valid UTF-8
+ */
+ZStringError zstring_buf_replace(ZStringBuf* buf, size_t start, size_t end, const char* data, size_t len);
+
+/**
+ * Insert data before UTF-16 index
+ */
+ZStringError zstring_buf_insert(ZStringBuf* buf, size_t index, const char* data, size_t len);
+
+/**
+ * Remove UTF-16 code units [start, end)
+ */
+ZStringError zstring_buf_delete(ZStringBuf* buf, size_t start, size_t end);
+
+/**
+ * Length in UTF-16 code units
+ */
+size_t zstring_buf_length(const ZStringBuf* buf);
+
+/**
+ * Length in UTF-8 bytes
+ */
+size_t zstring_buf_byte_length(const ZStringBuf* buf);
+
+/**
+ * Check whether the buffer holds only ASCII
+ */
+bool zstring_buf_is_ascii(const ZStringBuf* buf);
+
+/**
+ * Contiguous view of the text
+ *
+ * @param out Receives the text (borrowed; invalidated by the next edit)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_buf_view(ZStringBuf* buf, ZStringView* out);
+
+/**
+ * Copy the text into a new ZString
+ *
+ * @param out Pointer to receive the string (free with zstring_free)
+ * @return ZSTRING_OK on success, error code otherwise
+ */
+ZStringError zstring_buf_to_zstring(ZStringBuf* buf, ZString** out);
+
+/**
+ * Free a buffer
+ *
+ * @param buf Buffer to free (NULL is ignored)
+ */
+void zstring_buf_free(ZStringBuf* buf);
+
+/* ============================================================================
+ * Memory Management Helpers
+ * ========================================================================== */
+
+/**
+ * Free a string allocated by zstring functions
+ *
+ * Reads the stored length; the string is not scanned.
+ *
+ * @param str String to free
+ */
+void zstring_str_free(char* str);
+
+/**
+ * Byte length of a string allocated by zstring functions, in O(1)
+ *
+ * Every char* result (including ZStringArray items) records its length,
+ * so use this instead of strlen; it also counts embedded NUL bytes.
+ * Only pass strings returned by this library.
+ *
+ * @param str String returned by a zstring function (NULL gives 0)
+ * @return Length in bytes, excluding the terminating NUL
+ */
+size_t zstring_str_len(const char* str);
+
+/**
+ * Release the calling thread's cache of small result buffers
+ *
+ * Small strings freed with zstring_str_free() are kept in a bounded
+ * per-thread cache for reuse. On POSIX builds linked against libc (the
+ * documented build passes -lc) the cache is released when the thread
+ * exits; elsewhere, call this before a thread that used the library exits.
+ */
+void zstring_thread_cache_flush(void);
 
 #ifdef __cplusplus
 }
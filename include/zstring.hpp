@@ -13,11 +13,25 @@
 
 #include "zstring.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <stdexcept>
 #include <memory>
 #include <cstdint>
+#include <utility>
+#include <type_traits>
+#include <iterator>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <chrono>
+#include <future>
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#include <coroutine>
+#define ZSTRING_HAS_COROUTINES 1
+#endif
 
 namespace zstring {
 
@@ -35,6 +49,8 @@ private:
     ZStringError error_code_;
 };
 
+class CharSet;
+
 /**
  * RAII wrapper for C ZString
  *
@@ -145,7 +161,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "charAt failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -165,7 +181,7 @@ public:
         if (!result) {
             return std::nullopt;
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -220,6 +236,25 @@ public:
         return zstring_last_index_of(handle_, search_str.c_str(), position);
     }
 
+    /**
+     * Find the first code point in a set at or after position
+     *
+     * @return Index of the first member, or -1 if none
+     */
+    int64_t indexOfAny(const CharSet& set, int64_t position = 0) const;
+
+    /**
+     * Find the last code point in a set at or before position
+     *
+     * @return Index of the last member, or -1 if none
+     */
+    int64_t lastIndexOfAny(const CharSet& set, int64_t position = -1) const;
+
+    /**
+     * Length of the leading run of code points in a set (strspn)
+     */
+    size_t spanOf(const CharSet& set) const;
+
     /**
      * Check if string contains substring (String.prototype.includes)
      */
@@ -256,7 +291,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "slice failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -272,7 +307,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "substring failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -294,7 +329,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "concat failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -310,7 +345,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "repeat failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -330,7 +365,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "padStart failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -346,7 +381,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "padEnd failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -366,7 +401,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "trim failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -382,7 +417,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "trimStart failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -398,11 +433,18 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "trimEnd failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
 
+    /**
+     * Remove leading and trailing code points in a set
+     *
+     * @throws Exception on error
+     */
+    std::string trimChars(const CharSet& set) const;
+
     /* ========================================================================
      * Split Method
      * ====================================================================== */
@@ -422,7 +464,7 @@ public:
         std::vector<std::string> result;
         result.reserve(array.count);
         for (size_t i = 0; i < array.count; ++i) {
-            result.emplace_back(array.items[i]);
+            result.emplace_back(array.items[i], zstring_str_len(array.items[i]));
         }
         zstring_array_free(&array);
         return result;
@@ -443,12 +485,51 @@ public:
         std::vector<std::string> result;
         result.reserve(array.count);
         for (size_t i = 0; i < array.count; ++i) {
-            result.emplace_back(array.items[i]);
+            result.emplace_back(array.items[i], zstring_str_len(array.items[i]));
         }
         zstring_array_free(&array);
         return result;
     }
 
+    /**
+     * Split at every code point in a set
+     *
+     * @throws Exception on error
+     */
+    std::vector<std::string> splitAny(const CharSet& set) const;
+
+    /**
+     * Fused split -> map -> join without intermediate arrays
+     *
+     * map takes a std::string_view field and returns something convertible
+     * to std::string_view that stays valid until this call returns (e.g. a
+     * sub-view of the field). It is called twice per field and must not throw.
+     *
+     * Example:
+     *   s.splitMapJoin(",", "|", [](std::string_view f) { return f.substr(0, 1); });
+     *
+     * @throws Exception on error
+     */
+    template <typename F>
+    std::string splitMapJoin(const std::string& separator, const std::string& joiner, F&& map) const {
+        using Fn = std::remove_reference_t<F>;
+        ZStringMapFn trampoline = [](ZStringView field, void* user_data) -> ZStringView {
+            Fn& fn = *static_cast<Fn*>(user_data);
+            std::string_view mapped = fn(std::string_view(field.data, field.len));
+            return ZStringView{mapped.data(), mapped.size()};
+        };
+
+        char* result = nullptr;
+        void* user_data = const_cast<void*>(static_cast<const void*>(std::addressof(map)));
+        ZStringError err = zstring_split_map_join(handle_, separator.c_str(), joiner.c_str(), trampoline, user_data, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "splitMapJoin failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
     /* ========================================================================
      * Case Conversion
      * ====================================================================== */
@@ -464,7 +545,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "toLowerCase failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -480,7 +561,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "toUpperCase failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -510,7 +591,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "normalize failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -543,7 +624,7 @@ public:
         std::vector<std::string> result;
         result.reserve(array.count);
         for (size_t i = 0; i < array.count; ++i) {
-            result.emplace_back(array.items[i]);
+            result.emplace_back(array.items[i], zstring_str_len(array.items[i]));
         }
         zstring_array_free(&array);
         return result;
@@ -560,7 +641,7 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "replace failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
@@ -576,11 +657,284 @@ public:
         if (err != ZSTRING_OK) {
             throw Exception(err, "replaceAll failed");
         }
-        std::string str(result);
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /**
+     * Replace several literal keys in one leftmost-longest pass
+     *
+     * @throws Exception on error
+     */
+    std::string replaceMany(const std::vector<std::pair<std::string, std::string>>& pairs) const;
+
+    /**
+     * Translate ASCII bytes (tr): every from[i] becomes to[i]
+     *
+     * @throws Exception on error
+     */
+    std::string translate(const std::string& from, const std::string& to) const {
+        char* result = nullptr;
+        ZStringError err = zstring_translate(handle_, from.c_str(), to.c_str(), &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "translate failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /* ========================================================================
+     * Escaping
+     * ====================================================================== */
+
+    /**
+     * Escape for use inside a JSON string literal
+     *
+     * @throws Exception on error
+     */
+    std::string escapeJson() const {
+        char* result = nullptr;
+        ZStringError err = zstring_escape_json(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "escapeJson failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /**
+     * Decode JSON string escapes
+     *
+     * @throws Exception on error
+     */
+    std::string unescapeJson() const {
+        char* result = nullptr;
+        ZStringError err = zstring_unescape_json(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "unescapeJson failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /**
+     * Quote as a JSON string (JSON.stringify)
+     *
+     * @throws Exception on error
+     */
+    std::string quoteJson() const {
+        char* result = nullptr;
+        ZStringError err = zstring_quote_json(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "quoteJson failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /**
+     * Escape HTML special characters
+     *
+     * @throws Exception on error
+     */
+    std::string escapeHtml() const {
+        char* result = nullptr;
+        ZStringError err = zstring_escape_html(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "escapeHtml failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /**
+     * Decode HTML character references
+     *
+     * @throws Exception on error
+     */
+    std::string unescapeHtml() const {
+        char* result = nullptr;
+        ZStringError err = zstring_unescape_html(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "unescapeHtml failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /* ========================================================================
+     * URI Encoding
+     * ====================================================================== */
+
+    /**
+     * Percent-encode as a URI component (encodeURIComponent)
+     *
+     * @throws Exception on error
+     */
+    std::string encodeURIComponent() const {
+        char* result = nullptr;
+        ZStringError err = zstring_encode_uri_component(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "encodeURIComponent failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /**
+     * Percent-encode as a full URI (encodeURI)
+     *
+     * @throws Exception on error
+     */
+    std::string encodeURI() const {
+        char* result = nullptr;
+        ZStringError err = zstring_encode_uri(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "encodeURI failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /**
+     * Decode all percent escapes (decodeURIComponent)
+     *
+     * @throws Exception on error
+     */
+    std::string decodeURIComponent() const {
+        char* result = nullptr;
+        ZStringError err = zstring_decode_uri_component(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "decodeURIComponent failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /**
+     * Decode percent escapes except reserved characters (decodeURI)
+     *
+     * @throws Exception on error
+     */
+    std::string decodeURI() const {
+        char* result = nullptr;
+        ZStringError err = zstring_decode_uri(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "decodeURI failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /* ========================================================================
+     * Number Conversion
+     * ====================================================================== */
+
+    /**
+     * Parse the longest decimal literal prefix (parseFloat)
+     *
+     * @return Parsed value, or NaN if no prefix is a number
+     */
+    double parseFloat() const {
+        return zstring_parse_float(handle_);
+    }
+
+    /**
+     * Parse an integer prefix (parseInt)
+     *
+     * @param radix Radix in 2..36, or 0 to detect 10/16 from a "0x" prefix
+     * @return Parsed value, or NaN for a bad radix or no digits
+     */
+    double parseInt(int radix = 0) const {
+        return zstring_parse_int(handle_, radix);
+    }
+
+    /**
+     * Terminal display width in columns (CJK and emoji count two)
+     */
+    size_t displayWidth() const {
+        return zstring_display_width(handle_);
+    }
+
+    /**
+     * Pad to a display width rather than a UTF-16 length
+     *
+     * @throws Exception on error
+     */
+    std::string padToWidth(size_t width, const std::string& fill = " ", ZStringPadSide side = ZSTRING_PAD_END) const {
+        char* result = nullptr;
+        ZStringError err = zstring_pad_to_width(handle_, width, fill.c_str(), side, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "padToWidth failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /**
+     * Cut to at most a display width, appending ellipsis if anything was cut
+     *
+     * @throws Exception on error
+     */
+    std::string truncateToWidth(size_t width, const std::string& ellipsis = "") const {
+        char* result = nullptr;
+        ZStringError err = zstring_truncate_to_width(handle_, width, ellipsis.c_str(), &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "truncateToWidth failed");
+        }
+        std::string str(result, zstring_str_len(result));
         zstring_str_free(result);
         return str;
     }
 
+    /**
+     * Word-wrap to lines of at most a display width
+     *
+     * @throws Exception on error
+     */
+    std::vector<std::string> wrapToWidth(size_t width) const {
+        ZStringArray array;
+        ZStringError err = zstring_wrap_to_width(handle_, width, &array);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "wrapToWidth failed");
+        }
+
+        std::vector<std::string> result;
+        result.reserve(array.count);
+        for (size_t i = 0; i < array.count; ++i) {
+            result.emplace_back(array.items[i], zstring_str_len(array.items[i]));
+        }
+        zstring_array_free(&array);
+        return result;
+    }
+
+    /**
+     * First occurrence of search_str with at most maxErrors edits
+     *
+     * @return Match with UTF-16 index/length (index -1 if none)
+     * @throws Exception on error
+     */
+    ZStringApproxMatch indexOfApprox(const std::string& search_str, size_t maxErrors, bool transpositions = false) const {
+        ZStringApproxMatch result{-1, 0, 0};
+        ZStringError err = zstring_index_of_approx(handle_, search_str.c_str(), maxErrors, transpositions, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "indexOfApprox failed");
+        }
+        return result;
+    }
+
     /* ========================================================================
      * Internal
      * ====================================================================== */
@@ -594,6 +948,1745 @@ private:
     ZString* handle_;
 };
 
+/**
+ * RAII wrapper for a compiled multi-pair replacer
+ *
+ * Compile once, apply to many strings.
+ *
+ * Example:
+ *   zstring::Replacer escape({{"&", "&amp;"}, {"<", "&lt;"}, {">", "&gt;"}});
+ *   std::string html = escape.apply(zstring::String("a < b"));
+ */
+class Replacer {
+public:
+    /**
+     * Compile literal key/replacement pairs
+     *
+     * @throws Exception on error
+     */
+    explicit Replacer(const std::vector<std::pair<std::string, std::string>>& pairs) {
+        std::vector<const char*> from;
+        std::vector<const char*> to;
+        from.reserve(pairs.size());
+        to.reserve(pairs.size());
+        for (const auto& p : pairs) {
+            from.push_back(p.first.c_str());
+            to.push_back(p.second.c_str());
+        }
+
+        ZStringError err = zstring_replacer_new(from.data(), to.data(), pairs.size(), &handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to compile replacer");
+        }
+    }
+
+    Replacer(Replacer&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    Replacer& operator=(Replacer&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_replacer_free(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~Replacer() {
+        if (handle_) {
+            zstring_replacer_free(handle_);
+        }
+    }
+
+    Replacer(const Replacer&) = delete;
+    Replacer& operator=(const Replacer&) = delete;
+
+    /**
+     * Apply all replacements to a string in a single pass
+     *
+     * @throws Exception on error
+     */
+    std::string apply(const String& str) const {
+        char* result = nullptr;
+        ZStringError err = zstring_replacer_apply(handle_, str.handle(), &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "replacer apply failed");
+        }
+        std::string out(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return out;
+    }
+
+private:
+    ZStringReplacer* handle_ = nullptr;
+};
+
+/**
+ * RAII wrapper for a columnar string array
+ *
+ * Rows are stored contiguously; operator[] returns views into the column.
+ *
+ * Example:
+ *   zstring::StringColumn col;
+ *   col.push_back("  GET /a ");
+ *   col.push_back("POST /b");
+ *   auto methods = col.trim().splitFirstField(" ");   // ["GET", "POST"]
+ *   std::vector<bool> api = col.includes("/a");       // [true, false]
+ */
+class StringColumn {
+public:
+    /**
+     * Create an empty column
+     *
+     * @param track_stats Cache per-row UTF-16 length and ASCII bit
+     * @throws Exception on error
+     */
+    explicit StringColumn(bool track_stats = false) {
+        ZStringError err = zstring_column_new(track_stats, &handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to create column");
+        }
+    }
+
+    StringColumn(StringColumn&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    StringColumn& operator=(StringColumn&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_column_free(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~StringColumn() {
+        if (handle_) {
+            zstring_column_free(handle_);
+        }
+    }
+
+    StringColumn(const StringColumn&) = delete;
+    StringColumn& operator=(const StringColumn&) = delete;
+
+    /**
+     * Append a row
+     *
+     * @throws Exception on error
+     */
+    void push_back(std::string_view row) {
+        ZStringError err = zstring_column_append(handle_, row.data(), row.size());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "column append failed");
+        }
+    }
+
+    /**
+     * Number of rows
+     */
+    size_t size() const {
+        return zstring_column_len(handle_);
+    }
+
+    /**
+     * View of row i (valid until the column is modified)
+     */
+    std::string_view operator[](size_t i) const {
+        ZStringView view{nullptr, 0};
+        zstring_column_get(handle_, i, &view);
+        return std::string_view(view.data, view.len);
+    }
+
+    /**
+     * UTF-16 length of row i (String.prototype.length)
+     */
+    size_t utf16Length(size_t i) const {
+        return zstring_column_utf16_length(handle_, i);
+    }
+
+    /**
+     * Lowercase every row
+     *
+     * @throws Exception on error
+     */
+    StringColumn lower() const {
+        ZStringColumn* result = nullptr;
+        ZStringError err = zstring_column_lower(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "column lower failed");
+        }
+        return StringColumn(result);
+    }
+
+    /**
+     * Trim every row
+     *
+     * @throws Exception on error
+     */
+    StringColumn trim() const {
+        ZStringColumn* result = nullptr;
+        ZStringError err = zstring_column_trim(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "column trim failed");
+        }
+        return StringColumn(result);
+    }
+
+    /**
+     * Keep the part of every row before the first separator
+     *
+     * @throws Exception on error
+     */
+    StringColumn splitFirstField(const std::string& separator) const {
+        ZStringColumn* result = nullptr;
+        ZStringError err = zstring_column_split_first_field(handle_, separator.c_str(), &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "column splitFirstField failed");
+        }
+        return StringColumn(result);
+    }
+
+    /**
+     * Test every row for a substring
+     *
+     * @throws Exception on error
+     */
+    std::vector<bool> includes(const std::string& needle) const {
+        std::vector<uint8_t> bits((size() + 7) / 8);
+        ZStringError err = zstring_column_includes(handle_, needle.c_str(), bits.data());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "column includes failed");
+        }
+        return unpack(bits);
+    }
+
+    /**
+     * Test every row for a prefix
+     *
+     * @throws Exception on error
+     */
+    std::vector<bool> startsWith(const std::string& prefix) const {
+        std::vector<uint8_t> bits((size() + 7) / 8);
+        ZStringError err = zstring_column_starts_with(handle_, prefix.c_str(), bits.data());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "column startsWith failed");
+        }
+        return unpack(bits);
+    }
+
+    /**
+     * Move the rows into an Arrow utf8 array without copying
+     *
+     * The column is left empty; the caller owns the Arrow structs and must
+     * call their release callbacks.
+     *
+     * @throws Exception on error
+     */
+    void toArrow(ArrowArray* out_array, ArrowSchema* out_schema) && {
+        ZStringError err = zstring_column_to_arrow(handle_, out_array, out_schema);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "column toArrow failed");
+        }
+        handle_ = nullptr;
+    }
+
+    /**
+     * Get the underlying C handle (for advanced use)
+     */
+    const ZStringColumn* handle() const { return handle_; }
+
+private:
+    explicit StringColumn(ZStringColumn* handle) : handle_(handle) {}
+
+    std::vector<bool> unpack(const std::vector<uint8_t>& bits) const {
+        std::vector<bool> result(size());
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = (bits[i >> 3] >> (i & 7)) & 1;
+        }
+        return result;
+    }
+
+    ZStringColumn* handle_ = nullptr;
+};
+
+/**
+ * RAII wrapper for a dictionary-encoded string column
+ *
+ * Example:
+ *   zstring::DictionaryColumn methods;
+ *   for (auto m : {"GET", "POST", "GET"}) methods.push_back(m);
+ *   methods.cardinality();                     // 2
+ *   std::vector<bool> gets = methods.startsWith("GET");
+ */
+class DictionaryColumn {
+public:
+    /**
+     * Create an empty column
+     *
+     * @throws Exception on error
+     */
+    DictionaryColumn() {
+        ZStringError err = zstring_dictionary_new(&handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to create dictionary column");
+        }
+    }
+
+    /**
+     * Dictionary-encode every row of a column
+     *
+     * @throws Exception on error
+     */
+    explicit DictionaryColumn(const StringColumn& column) {
+        ZStringError err = zstring_dictionary_from_column(column.handle(), &handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to encode column");
+        }
+    }
+
+    DictionaryColumn(DictionaryColumn&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    DictionaryColumn& operator=(DictionaryColumn&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_dictionary_free(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~DictionaryColumn() {
+        if (handle_) {
+            zstring_dictionary_free(handle_);
+        }
+    }
+
+    DictionaryColumn(const DictionaryColumn&) = delete;
+    DictionaryColumn& operator=(const DictionaryColumn&) = delete;
+
+    /**
+     * Append a row
+     *
+     * @throws Exception on error
+     */
+    void push_back(std::string_view value) {
+        ZStringError err = zstring_dictionary_append(handle_, value.data(), value.size());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "dictionary append failed");
+        }
+    }
+
+    /**
+     * Number of rows
+     */
+    size_t size() const {
+        return zstring_dictionary_len(handle_);
+    }
+
+    /**
+     * Number of distinct values
+     */
+    size_t cardinality() const {
+        return zstring_dictionary_cardinality(handle_);
+    }
+
+    /**
+     * Dictionary code of row i
+     */
+    uint32_t code(size_t i) const {
+        return zstring_dictionary_code(handle_, i);
+    }
+
+    /**
+     * Value for a dictionary code
+     */
+    std::string_view value(uint32_t code) const {
+        ZStringView view{nullptr, 0};
+        zstring_dictionary_value(handle_, code, &view);
+        return std::string_view(view.data, view.len);
+    }
+
+    /**
+     * Value of row i
+     */
+    std::string_view operator[](size_t i) const {
+        return value(code(i));
+    }
+
+    /**
+     * Lowercase every distinct value
+     *
+     * @throws Exception on error
+     */
+    DictionaryColumn lower() const {
+        ZStringDictionary* result = nullptr;
+        ZStringError err = zstring_dictionary_lower(handle_, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "dictionary lower failed");
+        }
+        return DictionaryColumn(result);
+    }
+
+    /**
+     * Test every row for a substring
+     *
+     * @throws Exception on error
+     */
+    std::vector<bool> includes(const std::string& needle) const {
+        std::vector<uint8_t> bits((size() + 7) / 8);
+        ZStringError err = zstring_dictionary_includes(handle_, needle.c_str(), bits.data());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "dictionary includes failed");
+        }
+        return unpack(bits);
+    }
+
+    /**
+     * Test every row for a prefix
+     *
+     * @throws Exception on error
+     */
+    std::vector<bool> startsWith(const std::string& prefix) const {
+        std::vector<uint8_t> bits((size() + 7) / 8);
+        ZStringError err = zstring_dictionary_starts_with(handle_, prefix.c_str(), bits.data());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "dictionary startsWith failed");
+        }
+        return unpack(bits);
+    }
+
+    /**
+     * Compare every row with a string (-1, 0 or 1 per row)
+     *
+     * @throws Exception on error
+     */
+    std::vector<int8_t> localeCompare(const std::string& that) const {
+        std::vector<int8_t> result(size());
+        ZStringError err = zstring_dictionary_locale_compare(handle_, that.c_str(), result.data());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "dictionary localeCompare failed");
+        }
+        return result;
+    }
+
+    /**
+     * Get the underlying C handle (for advanced use)
+     */
+    const ZStringDictionary* handle() const { return handle_; }
+
+private:
+    explicit DictionaryColumn(ZStringDictionary* handle) : handle_(handle) {}
+
+    std::vector<bool> unpack(const std::vector<uint8_t>& bits) const {
+        std::vector<bool> result(size());
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = (bits[i >> 3] >> (i & 7)) & 1;
+        }
+        return result;
+    }
+
+    ZStringDictionary* handle_ = nullptr;
+};
+
+/**
+ * RAII wrapper for a set of strings compressed with a shared symbol table
+ *
+ * Example:
+ *   std::vector<std::string> urls = load();
+ *   zstring::CompressedStrings store(urls);
+ *   std::string first = store[0];
+ *   std::vector<bool> secure = store.startsWith("https://");
+ */
+class CompressedStrings {
+public:
+    /**
+     * Build a symbol table from the range and compress every element
+     *
+     * @throws Exception on error
+     */
+    template <typename Range>
+    explicit CompressedStrings(const Range& strings) {
+        std::vector<ZStringView> views;
+        for (const auto& s : strings) {
+            std::string_view sv(s);
+            views.push_back(ZStringView{sv.data(), sv.size()});
+        }
+        ZStringError err = zstring_compressed_build(views.data(), views.size(), &handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to compress strings");
+        }
+    }
+
+    CompressedStrings(CompressedStrings&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    CompressedStrings& operator=(CompressedStrings&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_compressed_free(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~CompressedStrings() {
+        if (handle_) {
+            zstring_compressed_free(handle_);
+        }
+    }
+
+    CompressedStrings(const CompressedStrings&) = delete;
+    CompressedStrings& operator=(const CompressedStrings&) = delete;
+
+    /**
+     * Compress and append a string with the existing symbol table
+     *
+     * @throws Exception on error
+     */
+    void push_back(std::string_view value) {
+        ZStringError err = zstring_compressed_append(handle_, value.data(), value.size());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "compressed append failed");
+        }
+    }
+
+    /**
+     * Number of strings
+     */
+    size_t size() const {
+        return zstring_compressed_len(handle_);
+    }
+
+    /**
+     * Size of the compressed data in bytes
+     */
+    size_t compressedSize() const {
+        return zstring_compressed_size(handle_);
+    }
+
+    /**
+     * Decompress string i
+     *
+     * @throws Exception if i is out of range
+     */
+    std::string operator[](size_t i) const {
+        char* result = nullptr;
+        ZStringError err = zstring_compressed_get(handle_, i, &result);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "compressed get failed");
+        }
+        std::string str(result, zstring_str_len(result));
+        zstring_str_free(result);
+        return str;
+    }
+
+    /**
+     * Test every string for equality
+     *
+     * @throws Exception on error
+     */
+    std::vector<bool> equals(const std::string& needle) const {
+        return scan(zstring_compressed_equals, needle, "compressed equals failed");
+    }
+
+    /**
+     * Test every string for a substring
+     *
+     * @throws Exception on error
+     */
+    std::vector<bool> includes(const std::string& needle) const {
+        return scan(zstring_compressed_includes, needle, "compressed includes failed");
+    }
+
+    /**
+     * Test every string for a prefix
+     *
+     * @throws Exception on error
+     */
+    std::vector<bool> startsWith(const std::string& prefix) const {
+        return scan(zstring_compressed_starts_with, prefix, "compressed startsWith failed");
+    }
+
+    /**
+     * Get the underlying C handle (for advanced use)
+     */
+    const ZStringCompressed* handle() const { return handle_; }
+
+private:
+    using ScanFn = ZStringError (*)(const ZStringCompressed*, const char*, uint8_t*);
+
+    std::vector<bool> scan(ScanFn fn, const std::string& needle, const char* what) const {
+        std::vector<uint8_t> bits((size() + 7) / 8);
+        ZStringError err = fn(handle_, needle.c_str(), bits.data());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, what);
+        }
+        std::vector<bool> result(size());
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = (bits[i >> 3] >> (i & 7)) & 1;
+        }
+        return result;
+    }
+
+    ZStringCompressed* handle_ = nullptr;
+};
+
+/**
+ * RAII wrapper for a memory-mapped string table file
+ *
+ * Example:
+ *   zstring::StringTable::write(names, "names.zst", true);
+ *   zstring::StringTable table("names.zst");
+ *   std::string_view first = table[0];         // points into the mapping
+ *   std::optional<size_t> i = table.find("id");
+ */
+class StringTable {
+public:
+    /**
+     * Serialize a range of strings to a table file
+     *
+     * @param strings Range whose elements convert to std::string_view
+     * @param path Output file path
+     * @param perfectHash Build a perfect-hash index (strings must be unique)
+     * @throws Exception on error
+     */
+    template <typename Range>
+    static void write(const Range& strings, const std::string& path, bool perfectHash = false) {
+        std::vector<ZStringView> views;
+        for (const auto& s : strings) {
+            std::string_view sv(s);
+            views.push_back(ZStringView{sv.data(), sv.size()});
+        }
+        ZStringError err = zstring_table_write(views.data(), views.size(), perfectHash, path.c_str());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to write string table");
+        }
+    }
+
+    /**
+     * Map a table file
+     *
+     * @throws Exception on error
+     */
+    explicit StringTable(const std::string& path) {
+        ZStringError err = zstring_table_open(path.c_str(), &handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to open string table");
+        }
+    }
+
+    StringTable(StringTable&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    StringTable& operator=(StringTable&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_table_close(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~StringTable() {
+        if (handle_) {
+            zstring_table_close(handle_);
+        }
+    }
+
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+
+    /**
+     * Number of entries
+     */
+    size_t size() const {
+        return zstring_table_len(handle_);
+    }
+
+    /**
+     * Entry i (valid while the table is open)
+     */
+    std::string_view operator[](size_t i) const {
+        ZStringView view{nullptr, 0};
+        zstring_table_get(handle_, i, &view);
+        return std::string_view(view.data, view.len);
+    }
+
+    /**
+     * Precomputed hash of entry i
+     */
+    uint64_t hash(size_t i) const {
+        return zstring_table_hash(handle_, i);
+    }
+
+    /**
+     * Precomputed UTF-16 length of entry i
+     */
+    size_t utf16Length(size_t i) const {
+        return zstring_table_utf16_length(handle_, i);
+    }
+
+    /**
+     * Index of an entry, or std::nullopt
+     */
+    std::optional<size_t> find(std::string_view key) const {
+        size_t index = 0;
+        if (zstring_table_find(handle_, key.data(), key.size(), &index)) {
+            return index;
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * Get the underlying C handle (for advanced use)
+     */
+    const ZStringTable* handle() const { return handle_; }
+
+private:
+    ZStringTable* handle_ = nullptr;
+};
+
+/**
+ * RAII wrapper for a trigram index over a collection of strings
+ *
+ * Example:
+ *   zstring::NgramIndex index(titles);         // parallel build
+ *   index.push_back("a late title");           // no rebuild
+ *   for (const ZStringRowMatch& m : index.search("title")) {
+ *       // m.row, m.index (UTF-16)
+ *   }
+ */
+class NgramIndex {
+public:
+    /**
+     * Create an empty index
+     *
+     * @throws Exception on error
+     */
+    NgramIndex() {
+        ZStringError err = zstring_ngram_index_new(&handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to create n-gram index");
+        }
+    }
+
+    /**
+     * Index a range of strings
+     *
+     * @param strings Range whose elements convert to std::string_view
+     * @param threads Build threads (0 = one per CPU)
+     * @throws Exception on error
+     */
+    template <typename Range>
+    explicit NgramIndex(const Range& strings, size_t threads = 0) {
+        std::vector<ZStringView> views;
+        for (const auto& s : strings) {
+            std::string_view sv(s);
+            views.push_back(ZStringView{sv.data(), sv.size()});
+        }
+        ZStringError err = zstring_ngram_index_build(views.data(), views.size(), threads, &handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to build n-gram index");
+        }
+    }
+
+    NgramIndex(NgramIndex&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    NgramIndex& operator=(NgramIndex&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_ngram_index_free(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~NgramIndex() {
+        if (handle_) {
+            zstring_ngram_index_free(handle_);
+        }
+    }
+
+    NgramIndex(const NgramIndex&) = delete;
+    NgramIndex& operator=(const NgramIndex&) = delete;
+
+    /**
+     * Append and index a row
+     *
+     * @throws Exception on error
+     */
+    void push_back(std::string_view value) {
+        ZStringError err = zstring_ngram_index_append(handle_, value.data(), value.size());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "n-gram index append failed");
+        }
+    }
+
+    /**
+     * Number of rows
+     */
+    size_t size() const {
+        return zstring_ngram_index_len(handle_);
+    }
+
+    /**
+     * Every row containing needle, with the UTF-16 index of the first match
+     *
+     * @throws Exception on error
+     */
+    std::vector<ZStringRowMatch> search(const std::string& needle) const {
+        ZStringRowMatch* matches = nullptr;
+        size_t count = 0;
+        ZStringError err = zstring_ngram_index_search(handle_, needle.c_str(), &matches, &count);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "n-gram index search failed");
+        }
+        std::vector<ZStringRowMatch> result(matches, matches + count);
+        zstring_matches_free(matches, count);
+        return result;
+    }
+
+    /**
+     * Get the underlying C handle (for advanced use)
+     */
+    const ZStringNgramIndex* handle() const { return handle_; }
+
+private:
+    ZStringNgramIndex* handle_ = nullptr;
+};
+
+/**
+ * RAII wrapper for a set of prefixes (double-array trie)
+ *
+ * Example:
+ *   zstring::PrefixSet routes(std::vector<std::string>{"/api", "/api/v1", "/static"});
+ *   auto m = routes.longestMatch("/api/v1/users");   // {1, 7}
+ *   std::vector<uint32_t> all = routes.matches("/api/v1/users");  // {0, 1}
+ */
+class PrefixSet {
+public:
+    /**
+     * Build a set from a range of prefixes (ids are positions in the range)
+     *
+     * @throws Exception on error
+     */
+    template <typename Range>
+    explicit PrefixSet(const Range& prefixes) {
+        std::vector<ZStringView> views;
+        for (const auto& s : prefixes) {
+            std::string_view sv(s);
+            views.push_back(ZStringView{sv.data(), sv.size()});
+        }
+        ZStringError err = zstring_prefix_set_build(views.data(), views.size(), &handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to build prefix set");
+        }
+    }
+
+    /**
+     * Load a set from its serialized form (see serialized())
+     *
+     * @throws Exception if the data is malformed
+     */
+    static PrefixSet load(const void* data, size_t len) {
+        ZStringPrefixSet* handle = nullptr;
+        ZStringError err = zstring_prefix_set_load(data, len, &handle);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to load prefix set");
+        }
+        return PrefixSet(handle);
+    }
+
+    PrefixSet(PrefixSet&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    PrefixSet& operator=(PrefixSet&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_prefix_set_free(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~PrefixSet() {
+        if (handle_) {
+            zstring_prefix_set_free(handle_);
+        }
+    }
+
+    PrefixSet(const PrefixSet&) = delete;
+    PrefixSet& operator=(const PrefixSet&) = delete;
+
+    /**
+     * Longest matching prefix as {id, length in bytes}, or std::nullopt
+     */
+    std::optional<std::pair<uint32_t, size_t>> longestMatch(std::string_view str) const {
+        uint32_t id = 0;
+        size_t len = 0;
+        if (zstring_prefix_set_longest(handle_, str.data(), str.size(), &id, &len)) {
+            return std::make_pair(id, len);
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * Ids of every matching prefix, shortest first
+     */
+    std::vector<uint32_t> matches(std::string_view str) const {
+        std::vector<uint32_t> ids(str.size() + 1);
+        size_t count = zstring_prefix_set_matches(handle_, str.data(), str.size(), ids.data(), ids.size());
+        ids.resize(count);
+        return ids;
+    }
+
+    /**
+     * Serialized form (valid while the set is alive)
+     */
+    std::string_view serialized() const {
+        const void* data = nullptr;
+        size_t len = 0;
+        zstring_prefix_set_serialized(handle_, &data, &len);
+        return std::string_view(static_cast<const char*>(data), len);
+    }
+
+    /**
+     * Get the underlying C handle (for advanced use)
+     */
+    const ZStringPrefixSet* handle() const { return handle_; }
+
+private:
+    explicit PrefixSet(ZStringPrefixSet* handle) : handle_(handle) {}
+
+    ZStringPrefixSet* handle_ = nullptr;
+};
+
+/**
+ * A line of text, borrowed from the string being iterated
+ */
+struct Line {
+    std::string_view text;
+    size_t number;  // zero-based
+    size_t start;   // byte offset
+    size_t index;   // UTF-16 offset (0 unless tracking was requested)
+};
+
+/**
+ * Zero-copy range over the lines of a text
+ *
+ * Lines end at \n, \r, \r\n, U+2028 and U+2029. The text must outlive
+ * the range.
+ *
+ * Example:
+ *   for (const auto& line : zstring::lines(text)) { ... line.text ... }
+ */
+class Lines {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Line;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Line*;
+        using reference = const Line&;
+
+        iterator() = default;
+
+        explicit iterator(const ZStringLineIterator& state) : state_(state), done_(false) {
+            ++*this;
+        }
+
+        reference operator*() const { return line_; }
+        pointer operator->() const { return &line_; }
+
+        iterator& operator++() {
+            ZStringLine line;
+            if (zstring_lines_next(&state_, &line)) {
+                line_ = Line{std::string_view(line.data, line.len), line.number, line.start, line.index};
+            } else {
+                done_ = true;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return done_ == other.done_ && (done_ || line_.number == other.line_.number);
+        }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        ZStringLineIterator state_{};
+        Line line_{};
+        bool done_ = true;
+    };
+
+    explicit Lines(std::string_view text, bool trackUtf16 = false) : text_(text), trackUtf16_(trackUtf16) {}
+
+    iterator begin() const {
+        ZStringLineIterator state;
+        zstring_lines_init(&state, text_.data(), text_.size(), trackUtf16_);
+        return iterator(state);
+    }
+
+    iterator end() const { return iterator(); }
+
+private:
+    std::string_view text_;
+    bool trackUtf16_;
+};
+
+/**
+ * Iterate over the lines of a text without allocating
+ */
+inline Lines lines(std::string_view text, bool trackUtf16 = false) {
+    return Lines(text, trackUtf16);
+}
+
+/**
+ * RAII wrapper for a compiled character set
+ *
+ * Example:
+ *   zstring::CharSet punct(",;:");
+ *   auto fields = zstring::String("a,b;c").splitAny(punct); // {"a", "b", "c"}
+ */
+class CharSet {
+public:
+    /**
+     * Compile the set of code points in chars (UTF-8)
+     *
+     * @throws Exception on invalid UTF-8
+     */
+    explicit CharSet(const std::string& chars) {
+        ZStringError err = zstring_charset_new(chars.c_str(), &handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to create character set");
+        }
+    }
+
+    CharSet(CharSet&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    CharSet& operator=(CharSet&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_charset_free(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~CharSet() {
+        if (handle_) {
+            zstring_charset_free(handle_);
+        }
+    }
+
+    CharSet(const CharSet&) = delete;
+    CharSet& operator=(const CharSet&) = delete;
+
+    /**
+     * Get the underlying C handle (for advanced use)
+     */
+    const ZStringCharSet* handle() const { return handle_; }
+
+private:
+    ZStringCharSet* handle_ = nullptr;
+};
+
+/**
+ * Join a range of strings with a separator (Array.prototype.join)
+ *
+ * Accepts any range whose elements convert to std::string_view
+ * (std::string, std::string_view, const char*). The result is sized
+ * exactly and allocated once.
+ *
+ * Example:
+ *   zstring::join(std::vector<std::string>{"a", "b", "c"}, "-")  // "a-b-c"
+ *
+ * @throws Exception on error
+ */
+template <typename Range>
+inline std::string join(const Range& parts, const std::string& separator = ",") {
+    std::vector<ZStringView> views;
+    for (const auto& part : parts) {
+        std::string_view view(part);
+        views.push_back(ZStringView{view.data(), view.size()});
+    }
+
+    char* result = nullptr;
+    ZStringError err = zstring_join(views.data(), views.size(), separator.c_str(), &result);
+    if (err != ZSTRING_OK) {
+        throw Exception(err, "join failed");
+    }
+    std::string str(result, zstring_str_len(result));
+    zstring_str_free(result);
+    return str;
+}
+
+/**
+ * Convert a number to its ECMAScript string form (Number.prototype.toString)
+ *
+ * @throws Exception on error (radix outside 2..36)
+ */
+inline std::string numberToString(double value, int radix = 10) {
+    char* result = nullptr;
+    ZStringError err = zstring_number_to_string(value, radix, &result);
+    if (err != ZSTRING_OK) {
+        throw Exception(err, "numberToString failed");
+    }
+    std::string str(result, zstring_str_len(result));
+    zstring_str_free(result);
+    return str;
+}
+
+/**
+ * Edit distance between two UTF-8 strings, in code points
+ *
+ * @param max Stop early once the distance exceeds this
+ * @return The distance, or std::nullopt if it exceeds max
+ * @throws Exception on invalid UTF-8
+ */
+inline std::optional<size_t> editDistance(std::string_view a, std::string_view b,
+                                          size_t max = SIZE_MAX, bool transpositions = false) {
+    size_t result = 0;
+    ZStringError err = zstring_edit_distance(a.data(), a.size(), b.data(), b.size(), max, transpositions, &result);
+    if (err != ZSTRING_OK) {
+        throw Exception(err, "editDistance failed");
+    }
+    if (result == SIZE_MAX) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+/**
+ * Edit script turning old_text into new_text (offsets in UTF-16 code units)
+ *
+ * @throws Exception on invalid UTF-8
+ */
+inline std::vector<ZStringEdit> diff(std::string_view old_text, std::string_view new_text,
+                                     ZStringDiffGranularity granularity = ZSTRING_DIFF_CODE_POINT) {
+    ZStringEdit* edits = nullptr;
+    size_t count = 0;
+    ZStringError err = zstring_diff(old_text.data(), old_text.size(), new_text.data(), new_text.size(),
+                                    granularity, &edits, &count);
+    if (err != ZSTRING_OK) {
+        throw Exception(err, "diff failed");
+    }
+    std::vector<ZStringEdit> result(edits, edits + count);
+    zstring_edits_free(edits, count);
+    return result;
+}
+
+/**
+ * Mutable string buffer edited in UTF-16 indices (RAII wrapper for ZStringBuf)
+ *
+ * Example:
+ *   zstring::StringBuf buf("hello world");
+ *   buf.replace(6, 11, "zig");   // "hello zig"
+ *   buf.insert(0, "> ");         // "> hello zig"
+ *   buf.length();                // 11, without rescanning
+ */
+class StringBuf {
+public:
+    explicit StringBuf(std::string_view text = {}) {
+        ZStringError err = zstring_buf_new(text.data(), text.size(), &handle_);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "Failed to create string buffer");
+        }
+    }
+
+    StringBuf(StringBuf&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    StringBuf& operator=(StringBuf&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_buf_free(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~StringBuf() {
+        if (handle_) {
+            zstring_buf_free(handle_);
+        }
+    }
+
+    StringBuf(const StringBuf&) = delete;
+    StringBuf& operator=(const StringBuf&) = delete;
+
+    /**
+     * Replace UTF-16 code units [start, end) with text
+     *
+     * @throws Exception on a bad range or invalid UTF-8
+     */
+    void replace(size_t start, size_t end, std::string_view text) {
+        ZStringError err = zstring_buf_replace(handle_, start, end, text.data(), text.size());
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "replace failed");
+        }
+    }
+
+    void insert(size_t index, std::string_view text) { replace(index, index, text); }
+
+    void erase(size_t start, size_t end) { replace(start, end, {}); }
+
+    /**
+     * Length in UTF-16 code units
+     */
+    size_t length() const { return zstring_buf_length(handle_); }
+
+    size_t byteLength() const { return zstring_buf_byte_length(handle_); }
+
+    bool isAscii() const { return zstring_buf_is_ascii(handle_); }
+
+    /**
+     * The text, valid until the next edit
+     */
+    std::string_view view() {
+        ZStringView out;
+        zstring_buf_view(handle_, &out);
+        return std::string_view(out.data, out.len);
+    }
+
+    std::string str() { return std::string(view()); }
+
+    /**
+     * Copy the text into an immutable String
+     */
+    String toString() { return String(str()); }
+
+private:
+    ZStringBuf* handle_ = nullptr;
+};
+
+/**
+ * Resumable, time-sliced string operation (RAII wrapper for ZStringJob)
+ *
+ * Example:
+ *   auto job = zstring::Job::replaceAll(body, "foo", "bar");
+ *   while (!job.step(64 * 1024)) {
+ *       loop.runPending();
+ *   }
+ *   std::string_view result = job.text();
+ *
+ * The input is borrowed and must outlive the job.
+ */
+class Job {
+    friend class Ticket;
+
+public:
+    static Job split(std::string_view text, std::string_view separator, size_t limit = SIZE_MAX) {
+        ZStringJob* handle = nullptr;
+        check(zstring_job_split(text.data(), text.size(), separator.data(), separator.size(), limit, &handle));
+        return Job(handle);
+    }
+
+    static Job replaceAll(std::string_view text, const std::string& pattern, const std::string& replacement) {
+        ZStringJob* handle = nullptr;
+        check(zstring_job_replace_all(text.data(), text.size(), pattern.c_str(), replacement.c_str(), &handle));
+        return Job(handle);
+    }
+
+    static Job normalize(std::string_view text, const std::string& form = "NFC") {
+        ZStringJob* handle = nullptr;
+        check(zstring_job_normalize(text.data(), text.size(), form.c_str(), &handle));
+        return Job(handle);
+    }
+
+    static Job toLowerCase(std::string_view text) {
+        ZStringJob* handle = nullptr;
+        check(zstring_job_to_lower_case(text.data(), text.size(), &handle));
+        return Job(handle);
+    }
+
+    static Job toUpperCase(std::string_view text) {
+        ZStringJob* handle = nullptr;
+        check(zstring_job_to_upper_case(text.data(), text.size(), &handle));
+        return Job(handle);
+    }
+
+    static Job matchAll(std::string_view text, const std::string& pattern) {
+        ZStringJob* handle = nullptr;
+        check(zstring_job_match_all(text.data(), text.size(), pattern.c_str(), &handle));
+        return Job(handle);
+    }
+
+    Job(Job&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    Job& operator=(Job&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_job_free(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~Job() {
+        if (handle_) {
+            zstring_job_free(handle_);
+        }
+    }
+
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+
+    /**
+     * Process about budget bytes of input; returns true once finished
+     */
+    bool step(size_t budget) {
+        bool done = false;
+        check(zstring_job_step(handle_, budget, &done));
+        return done;
+    }
+
+    /**
+     * Input bytes processed so far
+     */
+    size_t progress() const { return zstring_job_progress(handle_); }
+
+    /**
+     * Output of a replaceAll / normalize / case job (valid while the job lives)
+     */
+    std::string_view text() const {
+        ZStringView view;
+        check(zstring_job_text(handle_, &view));
+        return std::string_view(view.data, view.len);
+    }
+
+    /**
+     * Fields of a split job, or matched text of a matchAll job
+     */
+    std::vector<std::string> parts() const {
+        ZStringArray array;
+        check(zstring_job_parts(handle_, &array));
+
+        std::vector<std::string> result;
+        result.reserve(array.count);
+        for (size_t i = 0; i < array.count; ++i) {
+            result.emplace_back(array.items[i], zstring_str_len(array.items[i]));
+        }
+        zstring_array_free(&array);
+        return result;
+    }
+
+private:
+    explicit Job(ZStringJob* handle) : handle_(handle) {}
+
+    static void check(ZStringError err) {
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "job failed");
+        }
+    }
+
+    ZStringJob* handle_ = nullptr;
+};
+
+/**
+ * Handle to a Job running on the shared executor, shaped like std::future<Job>
+ *
+ * Example:
+ *   auto ticket = zstring::Ticket::submit(zstring::Job::normalize(text, "NFC"));
+ *   ...
+ *   zstring::Job done = ticket.get();   // waits; throws on error or cancel
+ *   std::string_view result = done.text();
+ *
+ * Destroying a ticket that has not completed cancels it and waits.
+ */
+class Ticket {
+public:
+    /**
+     * Queue a job, waiting for space if the queue is full
+     *
+     * @throws Exception on error (the job is left with the caller)
+     */
+    static Ticket submit(Job&& job) {
+        ZStringTicket* handle = nullptr;
+        ZStringError err = zstring_submit_job(job.handle_, nullptr, nullptr, &handle);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "submit failed");
+        }
+        job.handle_ = nullptr;
+        return Ticket(handle);
+    }
+
+    /**
+     * Queue a job unless the queue is full (the job is then left with the caller)
+     */
+    static std::optional<Ticket> trySubmit(Job&& job) {
+        ZStringTicket* handle = nullptr;
+        ZStringError err = zstring_try_submit_job(job.handle_, nullptr, nullptr, &handle);
+        if (err == ZSTRING_ERROR_BUSY) {
+            return std::nullopt;
+        }
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "submit failed");
+        }
+        job.handle_ = nullptr;
+        return Ticket(handle);
+    }
+
+    Ticket(Ticket&& other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    Ticket& operator=(Ticket&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                zstring_ticket_free(handle_);
+            }
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~Ticket() {
+        if (handle_) {
+            zstring_ticket_free(handle_);
+        }
+    }
+
+    Ticket(const Ticket&) = delete;
+    Ticket& operator=(const Ticket&) = delete;
+
+    /**
+     * False after get() or a move
+     */
+    bool valid() const noexcept { return handle_ != nullptr; }
+
+    /**
+     * True once the job has completed, without blocking
+     */
+    bool ready() const { return zstring_ticket_poll(handle_); }
+
+    void wait() const { zstring_ticket_wait(handle_); }
+
+    template <typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+        return zstring_ticket_wait_for(handle_, ns > 0 ? static_cast<uint64_t>(ns) : 0)
+            ? std::future_status::ready
+            : std::future_status::timeout;
+    }
+
+    /**
+     * Ask the job to stop; get() then throws ZSTRING_ERROR_CANCELLED
+     */
+    void cancel() { zstring_ticket_cancel(handle_); }
+
+    /**
+     * Wait and take the finished job; the ticket is no longer valid
+     *
+     * @throws Exception if the job failed or was cancelled
+     */
+    Job get() {
+        ZStringError err = zstring_ticket_wait(handle_);
+        ZStringJob* job = zstring_ticket_take_job(handle_);
+        zstring_ticket_free(handle_);
+        handle_ = nullptr;
+        if (err != ZSTRING_OK) {
+            zstring_job_free(job);
+            throw Exception(err, err == ZSTRING_ERROR_CANCELLED ? "job cancelled" : "job failed");
+        }
+        return Job(job);
+    }
+
+private:
+    explicit Ticket(ZStringTicket* handle) : handle_(handle) {}
+
+    ZStringTicket* handle_ = nullptr;
+};
+
+#ifdef ZSTRING_HAS_COROUTINES
+
+/**
+ * Lazily evaluated sequence produced by a coroutine (C++20)
+ *
+ * A minimal stand-in for C++23 std::generator: single pass, move-only.
+ * Each step resumes the coroutine until its next co_yield, so nothing is
+ * computed for elements that are never reached.
+ */
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        const T* value = nullptr;
+        std::exception_ptr error;
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T& v) noexcept {
+            value = &v;
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        iterator() = default;
+        explicit iterator(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+        reference operator*() const { return *handle_.promise().value; }
+        pointer operator->() const { return handle_.promise().value; }
+
+        iterator& operator++() {
+            advance(handle_);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) { return !it.handle_ || it.handle_.done(); }
+        friend bool operator!=(const iterator& it, std::default_sentinel_t s) { return !(it == s); }
+
+    private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    Generator(Generator&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    ~Generator() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    /**
+     * Run to the first element (rethrows anything the coroutine threw)
+     */
+    iterator begin() {
+        advance(handle_);
+        return iterator(handle_);
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    explicit Generator(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    static void advance(std::coroutine_handle<promise_type> handle) {
+        handle.resume();
+        if (handle.promise().error) {
+            std::rethrow_exception(std::exchange(handle.promise().error, nullptr));
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * Lazy split(separator, limit): fields are views into text
+ *
+ * text and separator must outlive the generator.
+ */
+inline Generator<std::string_view> splitLazy(std::string_view text, std::string_view separator,
+                                             size_t limit = SIZE_MAX) {
+    ZStringSplitIterator it;
+    zstring_split_iter_init(&it, text.data(), text.size(), separator.data(), separator.size(), limit);
+    ZStringView field;
+    while (zstring_split_iter_next(&it, &field)) {
+        co_yield std::string_view(field.data, field.len);
+    }
+}
+
+/**
+ * Lazy matchAll(pattern): matched text as views into text
+ *
+ * Each step runs one regex search. text must outlive the generator.
+ *
+ * @throws Exception (on first use) if the pattern does not compile, and
+ *         when a search fails
+ */
+inline Generator<std::string_view> matchAllLazy(std::string_view text, std::string pattern) {
+    ZStringMatchIterator* it = nullptr;
+    ZStringError err = zstring_match_iter_new(text.data(), text.size(), pattern.c_str(), &it);
+    if (err != ZSTRING_OK) {
+        throw Exception(err, "matchAll failed");
+    }
+    std::unique_ptr<ZStringMatchIterator, void (*)(ZStringMatchIterator*)> guard(it, zstring_match_iter_free);
+
+    ZStringView match;
+    bool found = false;
+    for (;;) {
+        err = zstring_match_iter_next(it, &match, nullptr, &found);
+        if (err != ZSTRING_OK) {
+            throw Exception(err, "matchAll failed");
+        }
+        if (!found) {
+            break;
+        }
+        co_yield std::string_view(match.data, match.len);
+    }
+}
+
+/**
+ * Lazy lines: each line (terminator excluded) as a view into text
+ *
+ * text must outlive the generator.
+ */
+inline Generator<std::string_view> linesLazy(std::string_view text) {
+    ZStringLineIterator it;
+    zstring_lines_init(&it, text.data(), text.size(), false);
+    ZStringLine line;
+    while (zstring_lines_next(&it, &line)) {
+        co_yield std::string_view(line.data, line.len);
+    }
+}
+
+#endif /* ZSTRING_HAS_COROUTINES */
+
+/**
+ * Transform every record of a file into another file (Linux io_uring)
+ *
+ * fn is called as std::string(std::string_view) for each record, from
+ * several worker threads at once; its result replaces the record and the
+ * delimiter is written back. An exception thrown by fn stops the pipeline
+ * and is rethrown here.
+ *
+ * Example:
+ *   zstring::transformFile("in.txt", "out.txt", [](std::string_view rec) {
+ *       return zstring::String(std::string(rec)).toUpperCase();
+ *   });
+ *
+ * @throws Exception on I/O failure or when io_uring is unavailable
+ */
+template <typename F>
+ZStringPipelineStats transformFile(const std::string& in_path, const std::string& out_path, F&& fn,
+                                   const ZStringPipelineOptions& options = {}) {
+    struct State {
+        F& fn;
+        std::mutex mutex;
+        std::exception_ptr error;
+    } state{fn, {}, nullptr};
+
+    ZStringRecordFn trampoline = [](void* ctx, const char* data, size_t len, ZStringSink* sink) -> ZStringError {
+        auto* st = static_cast<State*>(ctx);
+        try {
+            std::string result = st->fn(std::string_view(data, len));
+            return zstring_sink_write(sink, result.data(), result.size());
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(st->mutex);
+            if (!st->error) {
+                st->error = std::current_exception();
+            }
+            return ZSTRING_ERROR_INVALID_ARGUMENT;
+        }
+    };
+
+    ZStringPipelineStats stats{};
+    ZStringError err = zstring_pipeline_run(in_path.c_str(), out_path.c_str(), trampoline, &state, &options, &stats);
+    if (state.error) {
+        std::rethrow_exception(state.error);
+    }
+    if (err != ZSTRING_OK) {
+        throw Exception(err, "transformFile failed");
+    }
+    return stats;
+}
+
+inline std::string String::replaceMany(const std::vector<std::pair<std::string, std::string>>& pairs) const {
+    return Replacer(pairs).apply(*this);
+}
+
+inline int64_t String::indexOfAny(const CharSet& set, int64_t position) const {
+    return zstring_index_of_any(handle_, set.handle(), position);
+}
+
+inline int64_t String::lastIndexOfAny(const CharSet& set, int64_t position) const {
+    return zstring_last_index_of_any(handle_, set.handle(), position);
+}
+
+inline size_t String::spanOf(const CharSet& set) const {
+    return zstring_span_of(handle_, set.handle());
+}
+
+inline std::string String::trimChars(const CharSet& set) const {
+    char* result = nullptr;
+    ZStringError err = zstring_trim_chars(handle_, set.handle(), &result);
+    if (err != ZSTRING_OK) {
+        throw Exception(err, "trimChars failed");
+    }
+    std::string str(result, zstring_str_len(result));
+    zstring_str_free(result);
+    return str;
+}
+
+inline std::vector<std::string> String::splitAny(const CharSet& set) const {
+    ZStringArray array;
+    ZStringError err = zstring_split_any(handle_, set.handle(), &array);
+    if (err != ZSTRING_OK) {
+        throw Exception(err, "splitAny failed");
+    }
+
+    std::vector<std::string> result;
+    result.reserve(array.count);
+    for (size_t i = 0; i < array.count; ++i) {
+        result.emplace_back(array.items[i], zstring_str_len(array.items[i]));
+    }
+    zstring_array_free(&array);
+    return result;
+}
+
 } // namespace zstring
 
 #endif /* ZSTRING_HPP */
@@ -4,8 +4,11 @@
 /// It exposes all ECMAScript String methods through C functions.
 ///
 /// Build instructions:
-///   zig build-lib src/c_api.zig -O ReleaseFast        # Static library
-///   zig build-lib src/c_api.zig -O ReleaseFast -dynamic  # Shared library
+///   zig build-lib src/c_api.zig -O ReleaseFast -lc        # Static library
+///   zig build-lib src/c_api.zig -O ReleaseFast -lc -dynamic  # Shared library
+///
+/// Linking libc (-lc) lets threads release their result cache on exit;
+/// without it, call zstring_thread_cache_flush() before a thread exits.
 ///
 /// Usage from C:
 ///   #include "zstring.h"
@@ -16,6 +19,7 @@
 ///   g++ -std=c++17 your_program.cpp -I./include -L. -lzstring -o your_program
 
 const std = @import("std");
+const builtin = @import("builtin");
 const zstring = @import("zstring.zig");
 
 /// Error codes for C API
@@ -27,6 +31,10 @@ pub const ZStringError = enum(c_int) {
     ZSTRING_ERROR_INVALID_ARGUMENT = 4,
     ZSTRING_ERROR_REGEX_COMPILE = 5,
     ZSTRING_ERROR_REGEX_MATCH = 6,
+    ZSTRING_ERROR_MALFORMED_URI = 7,
+    ZSTRING_ERROR_IO = 8,
+    ZSTRING_ERROR_BUSY = 9,
+    ZSTRING_ERROR_CANCELLED = 10,
 };
 
 /// Opaque handle to ZString
@@ -41,10 +49,188 @@ pub const ZStringArray = extern struct {
     count: usize,
 };
 
+/// Borrowed string view (not null-terminated)
+pub const ZStringView = extern struct {
+    data: [*c]const u8,
+    len: usize,
+
+    fn slice(self: ZStringView) []const u8 {
+        if (self.len == 0) return "";
+        return self.data[0..self.len];
+    }
+};
+
+/// Per-field callback for zstring_split_map_join
+pub const ZStringMapFn = *const fn (field: ZStringView, user_data: ?*anyopaque) callconv(.c) ZStringView;
+
 // Global allocator for C API
 var gpa = std.heap.GeneralPurposeAllocator(.{}){};
 const allocator = gpa.allocator();
 
+/// Hand an allocator-owned Zig result to C as a null-terminated copy
+/// Takes ownership of `result`.
+fn toCString(result: []const u8, out: *[*c]u8) ZStringError {
+    defer allocator.free(result);
+    const c_str = dupeCString(result) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    out.* = c_str.ptr;
+    return .ZSTRING_OK;
+}
+
+// Strings handed to C carry their byte length in a header just before the
+// first byte. zstring_str_len and the free functions read it instead of
+// scanning for the NUL, and results may contain embedded NULs.
+const c_string_header = @sizeOf(usize);
+
+/// Allocate a NUL-terminated result of len bytes (contents undefined)
+fn allocCString(len: usize) ![:0]u8 {
+    const block = try allocResultBlock(c_string_header + len + 1);
+    @as(*usize, @ptrCast(block)).* = len;
+    block[c_string_header + len] = 0;
+    return block[c_string_header..][0..len :0];
+}
+
+fn dupeCString(bytes: []const u8) ![:0]u8 {
+    const c_str = try allocCString(bytes.len);
+    @memcpy(c_str, bytes);
+    return c_str;
+}
+
+fn cStringLen(c_str: [*]const u8) usize {
+    return @as(*const usize, @ptrCast(@alignCast(c_str - c_string_header))).*;
+}
+
+fn freeCString(c_str: [*]u8) void {
+    const block: [*]align(@alignOf(usize)) u8 = @alignCast(c_str - c_string_header);
+    freeResultBlock(block, c_string_header + cStringLen(c_str) + 1);
+}
+
+/// Per-thread free lists of small result blocks
+///
+/// charAt, split fields and trimmed keys allocate and free tiny buffers
+/// at a high rate. Blocks up to 256 bytes are rounded up to a size class
+/// and recycled through a list owned by the calling thread: no locks and
+/// no shared state on the fast path. Each list holds a bounded number of
+/// blocks; the rest go back to the allocator. A block freed on another
+/// thread simply joins that thread's list.
+const ResultCache = struct {
+    heads: [class_sizes.len]?*FreeBlock = @splat(null),
+    counts: [class_sizes.len]u16 = @splat(0),
+    registered: bool = false,
+
+    const class_sizes = [_]usize{ 32, 64, 128, 256 };
+    const max_blocks = 64;
+
+    const FreeBlock = struct {
+        next: ?*FreeBlock,
+    };
+
+    fn classOf(size: usize) ?usize {
+        for (class_sizes, 0..) |class_size, i| {
+            if (size <= class_size) return i;
+        }
+        return null;
+    }
+
+    fn alloc(self: *ResultCache, class: usize) ![*]align(@alignOf(usize)) u8 {
+        if (self.heads[class]) |block| {
+            self.heads[class] = block.next;
+            self.counts[class] -= 1;
+            return @ptrCast(block);
+        }
+        self.register();
+        const block = try allocator.alignedAlloc(u8, .of(usize), class_sizes[class]);
+        return block.ptr;
+    }
+
+    fn free(self: *ResultCache, class: usize, block: [*]align(@alignOf(usize)) u8) void {
+        if (self.counts[class] >= max_blocks) {
+            allocator.free(block[0..class_sizes[class]]);
+            return;
+        }
+        // A thread that only frees results still needs the exit flush
+        self.register();
+        const node: *FreeBlock = @ptrCast(block);
+        node.next = self.heads[class];
+        self.heads[class] = node;
+        self.counts[class] += 1;
+    }
+
+    /// Return every cached block to the allocator
+    fn flush(self: *ResultCache) void {
+        for (&self.heads, &self.counts, class_sizes) |*head, *count, class_size| {
+            while (head.*) |node| {
+                head.* = node.next;
+                const block: [*]align(@alignOf(usize)) u8 = @ptrCast(node);
+                allocator.free(block[0..class_size]);
+            }
+            count.* = 0;
+        }
+    }
+
+    /// With pthreads, flush automatically when the thread exits
+    fn register(self: *ResultCache) void {
+        if (!flush_on_exit) return;
+        if (self.registered) return;
+        self.registered = true;
+        cache_key_once.call();
+        _ = std.c.pthread_setspecific(cache_key, self);
+    }
+};
+
+threadlocal var result_cache: ResultCache = .{};
+
+const flush_on_exit = builtin.link_libc and builtin.os.tag != .windows;
+
+var cache_key: std.c.pthread_key_t = undefined;
+var cache_key_once = std.once(createCacheKey);
+
+fn createCacheKey() void {
+    _ = std.c.pthread_key_create(&cache_key, flushOnThreadExit);
+}
+
+fn flushOnThreadExit(cache: *anyopaque) callconv(.c) void {
+    const self: *ResultCache = @ptrCast(@alignCast(cache));
+    self.flush();
+    // The key's value is now cleared; re-register if a later destructor
+    // uses the C API on this thread again
+    self.registered = false;
+}
+
+fn allocResultBlock(size: usize) ![*]align(@alignOf(usize)) u8 {
+    if (ResultCache.classOf(size)) |class| return result_cache.alloc(class);
+    const block = try allocator.alignedAlloc(u8, .of(usize), size);
+    return block.ptr;
+}
+
+fn freeResultBlock(block: [*]align(@alignOf(usize)) u8, size: usize) void {
+    if (ResultCache.classOf(size)) |class| return result_cache.free(class, block);
+    allocator.free(block[0..size]);
+}
+
+/// Release the calling thread's cached result blocks
+///
+/// Threads exit-flush on their own when libc is linked; otherwise call
+/// this before a thread that used the C API exits.
+export fn zstring_thread_cache_flush() void {
+    result_cache.flush();
+}
+
+/// Map a Zig error to the closest C error code
+fn errorCode(err: anyerror) ZStringError {
+    return switch (err) {
+        error.OutOfMemory => .ZSTRING_ERROR_OUT_OF_MEMORY,
+        error.InvalidUtf8, error.InvalidCodePoint => .ZSTRING_ERROR_INVALID_UTF8,
+        error.IndexOutOfBounds => .ZSTRING_ERROR_INDEX_OUT_OF_BOUNDS,
+        error.MalformedUri => .ZSTRING_ERROR_MALFORMED_URI,
+        error.ReadFailed, error.WriteFailed, error.UnexpectedEndOfFile, error.IoUringUnavailable, error.Unsupported => .ZSTRING_ERROR_IO,
+        error.QueueFull => .ZSTRING_ERROR_BUSY,
+        error.RegexMatchFailed => .ZSTRING_ERROR_REGEX_MATCH,
+        else => .ZSTRING_ERROR_INVALID_ARGUMENT,
+    };
+}
+
 /// Initialize a new ZString from a C string
 export fn zstring_init(str: [*c]const u8, out: *?*ZString) ZStringError {
     if (str == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
@@ -105,20 +291,20 @@ export fn zstring_bytes(zstr: ?*const ZString) [*c]const u8 {
 
 /// Free a string allocated by zstring functions
 export fn zstring_str_free(str: [*c]u8) void {
-    if (str != null) {
-        const slice = std.mem.span(str);
-        allocator.free(slice);
-    }
+    if (str != null) freeCString(str);
+}
+
+/// Byte length of a string allocated by zstring functions (O(1))
+export fn zstring_str_len(str: [*c]const u8) usize {
+    if (str == null) return 0;
+    return cStringLen(str);
 }
 
 /// Free a ZStringArray
 export fn zstring_array_free(array: *ZStringArray) void {
     if (array.items != null) {
         for (0..array.count) |i| {
-            if (array.items[i] != null) {
-                const slice = std.mem.span(array.items[i]);
-                allocator.free(slice);
-            }
+            if (array.items[i] != null) freeCString(array.items[i]);
         }
         allocator.free(array.items[0..array.count]);
     }
@@ -148,7 +334,7 @@ export fn zstring_char_at(zstr: ?*const ZString, index: usize, out: *?[*c]u8) ZS
     };
 
     // Add null terminator for C
-    const c_str = allocator.dupeZ(u8, result) catch {
+    const c_str = dupeCString(result) catch {
         allocator.free(result);
         return .ZSTRING_ERROR_OUT_OF_MEMORY;
     };
@@ -174,7 +360,7 @@ export fn zstring_at(zstr: ?*const ZString, index: i64, out: *?[*c]u8) ZStringEr
 
     if (maybe_result) |result| {
         defer allocator.free(result);
-        const c_str = allocator.dupeZ(u8, result) catch {
+        const c_str = dupeCString(result) catch {
             return .ZSTRING_ERROR_OUT_OF_MEMORY;
         };
         out.* = c_str.ptr;
@@ -228,7 +414,7 @@ export fn zstring_to_upper_case(zstr: ?*const ZString, out: *?[*c]u8) ZStringErr
         return .ZSTRING_ERROR_OUT_OF_MEMORY;
     };
 
-    const c_str = allocator.dupeZ(u8, result) catch {
+    const c_str = dupeCString(result) catch {
         allocator.free(result);
         return .ZSTRING_ERROR_OUT_OF_MEMORY;
     };
@@ -249,7 +435,7 @@ export fn zstring_to_lower_case(zstr: ?*const ZString, out: *?[*c]u8) ZStringErr
         return .ZSTRING_ERROR_OUT_OF_MEMORY;
     };
 
-    const c_str = allocator.dupeZ(u8, result) catch {
+    const c_str = dupeCString(result) catch {
         allocator.free(result);
         return .ZSTRING_ERROR_OUT_OF_MEMORY;
     };
@@ -270,7 +456,7 @@ export fn zstring_trim(zstr: ?*const ZString, out: *?[*c]u8) ZStringError {
         return .ZSTRING_ERROR_OUT_OF_MEMORY;
     };
 
-    const c_str = allocator.dupeZ(u8, result) catch {
+    const c_str = dupeCString(result) catch {
         allocator.free(result);
         return .ZSTRING_ERROR_OUT_OF_MEMORY;
     };
@@ -305,10 +491,10 @@ export fn zstring_split(zstr: ?*const ZString, separator: [*c]const u8, limit: u
     };
 
     for (parts, 0..) |part, i| {
-        const c_str = allocator.dupeZ(u8, part) catch {
+        const c_str = dupeCString(part) catch {
             // Free already allocated items
             for (0..i) |j| {
-                allocator.free(std.mem.span(c_items[j]));
+                freeCString(c_items[j]);
             }
             allocator.free(c_items);
             return .ZSTRING_ERROR_OUT_OF_MEMORY;
@@ -324,6 +510,2101 @@ export fn zstring_split(zstr: ?*const ZString, separator: [*c]const u8, limit: u
     return .ZSTRING_OK;
 }
 
+// ============================================================================
+// Join Methods
+// ============================================================================
+
+/// Array.prototype.join over string views
+export fn zstring_join(parts: [*c]const ZStringView, count: usize, separator: [*c]const u8, out: ?*[*c]u8) ZStringError {
+    if (out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    if (parts == null and count > 0) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const sep: []const u8 = if (separator != null) std.mem.span(separator) else zstring.join.default_separator;
+
+    // Exact size, written straight into the returned buffer
+    var total: usize = if (count > 0) sep.len * (count - 1) else 0;
+    for (0..count) |i| {
+        total += parts[i].len;
+    }
+
+    const result = allocCString(total) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+
+    var pos: usize = 0;
+    for (0..count) |i| {
+        if (i > 0) {
+            @memcpy(result[pos .. pos + sep.len], sep);
+            pos += sep.len;
+        }
+        const part = parts[i].slice();
+        @memcpy(result[pos .. pos + part.len], part);
+        pos += part.len;
+    }
+
+    out.?.* = result.ptr;
+    return .ZSTRING_OK;
+}
+
+/// Array.prototype.join over a ZStringArray (e.g. a zstring_split result)
+///
+/// Items must come from this library: their lengths are read from the
+/// allocation header, not with strlen. Caller-built data goes through
+/// zstring_join.
+export fn zstring_join_array(array: ?*const ZStringArray, separator: [*c]const u8, out: ?*[*c]u8) ZStringError {
+    if (array == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const arr = array.?;
+    if (arr.items == null and arr.count > 0) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const sep: []const u8 = if (separator != null) std.mem.span(separator) else zstring.join.default_separator;
+
+    var total: usize = if (arr.count > 0) sep.len * (arr.count - 1) else 0;
+    for (0..arr.count) |i| {
+        total += cStringLen(arr.items[i]);
+    }
+
+    const result = allocCString(total) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+
+    var pos: usize = 0;
+    for (0..arr.count) |i| {
+        if (i > 0) {
+            @memcpy(result[pos .. pos + sep.len], sep);
+            pos += sep.len;
+        }
+        const part = arr.items[i][0..cStringLen(arr.items[i])];
+        @memcpy(result[pos .. pos + part.len], part);
+        pos += part.len;
+    }
+
+    out.?.* = result.ptr;
+    return .ZSTRING_OK;
+}
+
+const CMapper = struct {
+    map_fn: ZStringMapFn,
+    user_data: ?*anyopaque,
+
+    fn call(self: CMapper, field: []const u8) []const u8 {
+        return self.map_fn(.{ .data = field.ptr, .len = field.len }, self.user_data).slice();
+    }
+};
+
+/// Fused split -> map -> join without intermediate arrays
+export fn zstring_split_map_join(zstr: ?*const ZString, separator: [*c]const u8, joiner: [*c]const u8, map_fn: ?ZStringMapFn, user_data: ?*anyopaque, out: ?*[*c]u8) ZStringError {
+    if (zstr == null or separator == null or joiner == null or map_fn == null or out == null) {
+        return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    }
+
+    const handle = zstr.?;
+    const str = handle.data[0..handle.len];
+    const sep = std.mem.span(separator);
+    const join_str = std.mem.span(joiner);
+    const mapper = CMapper{ .map_fn = map_fn.?, .user_data = user_data };
+
+    const total = zstring.join.splitMapJoinLength(str, sep, join_str, mapper, CMapper.call);
+    const result = allocCString(total) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    zstring.join.splitMapJoinInto(result, str, sep, join_str, mapper, CMapper.call);
+
+    out.?.* = result.ptr;
+    return .ZSTRING_OK;
+}
+
+// ============================================================================
+// Multi-pair Replacement
+// ============================================================================
+
+/// Opaque handle to a compiled multi-pair replacer
+pub const ZStringReplacer = opaque {};
+
+fn replacerFromHandle(handle: *const ZStringReplacer) *const zstring.replace_many.Replacer {
+    return @ptrCast(@alignCast(handle));
+}
+
+/// Compile a replacer from parallel arrays of keys and replacements
+export fn zstring_replacer_new(from: [*c]const [*c]const u8, to: [*c]const [*c]const u8, count: usize, out: ?*?*ZStringReplacer) ZStringError {
+    if (out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    if (count > 0 and (from == null or to == null)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const pairs = allocator.alloc(zstring.replace_many.Pair, count) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    defer allocator.free(pairs);
+
+    for (pairs, 0..) |*pair, i| {
+        if (from[i] == null or to[i] == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+        pair.* = .{ .from = std.mem.span(from[i]), .to = std.mem.span(to[i]) };
+    }
+
+    const replacer = allocator.create(zstring.replace_many.Replacer) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    replacer.* = zstring.replace_many.Replacer.init(allocator, pairs) catch {
+        allocator.destroy(replacer);
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+
+    out.?.* = @ptrCast(replacer);
+    return .ZSTRING_OK;
+}
+
+/// Apply a compiled replacer to a string
+export fn zstring_replacer_apply(rep: ?*const ZStringReplacer, zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    if (rep == null or zstr == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const handle = zstr.?;
+    const result = replacerFromHandle(rep.?).replace(allocator, handle.data[0..handle.len]) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+
+    return toCString(result, out.?);
+}
+
+/// Free a compiled replacer
+export fn zstring_replacer_free(rep: ?*ZStringReplacer) void {
+    if (rep) |handle| {
+        const replacer: *zstring.replace_many.Replacer = @ptrCast(@alignCast(handle));
+        replacer.deinit();
+        allocator.destroy(replacer);
+    }
+}
+
+/// Replace several literal keys in one pass
+export fn zstring_replace_many(zstr: ?*const ZString, from: [*c]const [*c]const u8, to: [*c]const [*c]const u8, count: usize, out: ?*[*c]u8) ZStringError {
+    if (zstr == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    var rep: ?*ZStringReplacer = null;
+    const err = zstring_replacer_new(from, to, count, &rep);
+    if (err != .ZSTRING_OK) return err;
+    defer zstring_replacer_free(rep);
+
+    return zstring_replacer_apply(rep, zstr, out);
+}
+
+/// Translate ASCII bytes (tr)
+export fn zstring_translate(zstr: ?*const ZString, from: [*c]const u8, to: [*c]const u8, out: ?*[*c]u8) ZStringError {
+    if (zstr == null or from == null or to == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const handle = zstr.?;
+    const result = zstring.replace_many.translate(allocator, handle.data[0..handle.len], std.mem.span(from), std.mem.span(to)) catch |err| {
+        return errorCode(err);
+    };
+
+    return toCString(result, out.?);
+}
+
+// ============================================================================
+// Escaping Methods
+// ============================================================================
+
+fn escapeToC(comptime codec: anytype, zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    if (zstr == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const handle = zstr.?;
+    var result = codec(allocator, handle.data[0..handle.len]) catch |err| {
+        return errorCode(err);
+    };
+    defer result.deinit();
+
+    const c_str = dupeCString(result.data) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    out.?.* = c_str.ptr;
+    return .ZSTRING_OK;
+}
+
+/// Escape for a JSON string literal body
+export fn zstring_escape_json(zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    return escapeToC(zstring.escape.escapeJson, zstr, out);
+}
+
+/// Decode JSON string escapes
+export fn zstring_unescape_json(zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    return escapeToC(zstring.escape.unescapeJson, zstr, out);
+}
+
+/// JSON.stringify(string)
+export fn zstring_quote_json(zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    if (zstr == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const handle = zstr.?;
+    const result = zstring.escape.quoteJson(allocator, handle.data[0..handle.len]) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+
+    return toCString(result, out.?);
+}
+
+/// Escape HTML special characters
+export fn zstring_escape_html(zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    return escapeToC(zstring.escape.escapeHtml, zstr, out);
+}
+
+/// Decode HTML character references
+export fn zstring_unescape_html(zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    return escapeToC(zstring.escape.unescapeHtml, zstr, out);
+}
+
+// ============================================================================
+// URI Methods
+// ============================================================================
+
+/// encodeURIComponent
+export fn zstring_encode_uri_component(zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    return escapeToC(zstring.uri.encodeURIComponent, zstr, out);
+}
+
+/// encodeURI
+export fn zstring_encode_uri(zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    return escapeToC(zstring.uri.encodeURI, zstr, out);
+}
+
+/// decodeURIComponent
+export fn zstring_decode_uri_component(zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    return escapeToC(zstring.uri.decodeURIComponent, zstr, out);
+}
+
+/// decodeURI
+export fn zstring_decode_uri(zstr: ?*const ZString, out: ?*[*c]u8) ZStringError {
+    return escapeToC(zstring.uri.decodeURI, zstr, out);
+}
+
+// ============================================================================
+// Number Conversion
+// ============================================================================
+
+/// Number.prototype.toString(radix)
+export fn zstring_number_to_string(value: f64, radix: c_int, out: ?*[*c]u8) ZStringError {
+    if (out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    if (radix < 2 or radix > 36) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const result = zstring.number.numberToString(allocator, value, @intCast(radix)) catch |err| {
+        return errorCode(err);
+    };
+
+    return toCString(result, out.?);
+}
+
+/// parseFloat(string)
+export fn zstring_parse_float(zstr: ?*const ZString) f64 {
+    if (zstr) |handle| {
+        return zstring.number.parseFloat(handle.data[0..handle.len]);
+    }
+    return std.math.nan(f64);
+}
+
+/// parseInt(string, radix); radix 0 selects 10 or 16 from the input
+export fn zstring_parse_int(zstr: ?*const ZString, radix: c_int) f64 {
+    if (zstr) |handle| {
+        return zstring.number.parseInt(handle.data[0..handle.len], radix);
+    }
+    return std.math.nan(f64);
+}
+
+// ============================================================================
+// String Column
+// ============================================================================
+
+/// Opaque handle to a StringColumn (u32 offsets)
+pub const ZStringColumn = opaque {};
+
+fn columnFromHandle(col: *const ZStringColumn) *const zstring.StringColumn {
+    return @ptrCast(@alignCast(col));
+}
+
+fn columnToHandle(result: zstring.StringColumn, out: *?*ZStringColumn) ZStringError {
+    var value = result;
+    const ptr = allocator.create(zstring.StringColumn) catch {
+        value.deinit();
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    ptr.* = value;
+    out.* = @ptrCast(ptr);
+    return .ZSTRING_OK;
+}
+
+/// Create an empty column
+export fn zstring_column_new(track_stats: bool, out: ?*?*ZStringColumn) ZStringError {
+    if (out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const col = zstring.StringColumn.init(allocator, .{ .track_stats = track_stats }) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    return columnToHandle(col, out.?);
+}
+
+/// Free a column
+export fn zstring_column_free(col: ?*ZStringColumn) void {
+    if (col) |handle| {
+        const column: *zstring.StringColumn = @ptrCast(@alignCast(handle));
+        column.deinit();
+        allocator.destroy(column);
+    }
+}
+
+/// Append a row
+export fn zstring_column_append(col: ?*ZStringColumn, data: [*c]const u8, len: usize) ZStringError {
+    if (col == null or (data == null and len > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const column: *zstring.StringColumn = @ptrCast(@alignCast(col.?));
+    const row: []const u8 = if (len == 0) "" else data[0..len];
+    column.append(row) catch |err| {
+        return errorCode(err);
+    };
+    return .ZSTRING_OK;
+}
+
+/// Number of rows
+export fn zstring_column_len(col: ?*const ZStringColumn) usize {
+    if (col) |handle| return columnFromHandle(handle).len();
+    return 0;
+}
+
+/// Borrow row `index`
+export fn zstring_column_get(col: ?*const ZStringColumn, index: usize, out: ?*ZStringView) ZStringError {
+    if (col == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const column = columnFromHandle(col.?);
+    if (index >= column.len()) return .ZSTRING_ERROR_INDEX_OUT_OF_BOUNDS;
+
+    const row = column.get(index);
+    out.?.* = .{ .data = row.ptr, .len = row.len };
+    return .ZSTRING_OK;
+}
+
+/// UTF-16 length of row `index` (0 when out of range)
+export fn zstring_column_utf16_length(col: ?*const ZStringColumn, index: usize) usize {
+    if (col) |handle| {
+        const column = columnFromHandle(handle);
+        if (index < column.len()) return column.utf16Length(index);
+    }
+    return 0;
+}
+
+/// toLowerCase() of every row
+export fn zstring_column_lower(col: ?*const ZStringColumn, out: ?*?*ZStringColumn) ZStringError {
+    if (col == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const result = columnFromHandle(col.?).lower(allocator) catch |err| {
+        return errorCode(err);
+    };
+    return columnToHandle(result, out.?);
+}
+
+/// trim() of every row
+export fn zstring_column_trim(col: ?*const ZStringColumn, out: ?*?*ZStringColumn) ZStringError {
+    if (col == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const result = columnFromHandle(col.?).trim(allocator) catch |err| {
+        return errorCode(err);
+    };
+    return columnToHandle(result, out.?);
+}
+
+/// split(separator)[0] of every row
+export fn zstring_column_split_first_field(col: ?*const ZStringColumn, separator: [*c]const u8, out: ?*?*ZStringColumn) ZStringError {
+    if (col == null or separator == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const result = columnFromHandle(col.?).splitFirstField(allocator, std.mem.span(separator)) catch |err| {
+        return errorCode(err);
+    };
+    return columnToHandle(result, out.?);
+}
+
+/// includes(needle) of every row into a caller-provided bitmap
+export fn zstring_column_includes(col: ?*const ZStringColumn, needle: [*c]const u8, out_bits: [*c]u8) ZStringError {
+    if (col == null or needle == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const column = columnFromHandle(col.?);
+    const bits = bitmapFromC(out_bits, column.len()) orelse return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    column.includesInto(bits, std.mem.span(needle));
+    return .ZSTRING_OK;
+}
+
+/// startsWith(prefix) of every row into a caller-provided bitmap
+export fn zstring_column_starts_with(col: ?*const ZStringColumn, prefix: [*c]const u8, out_bits: [*c]u8) ZStringError {
+    if (col == null or prefix == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const column = columnFromHandle(col.?);
+    const bits = bitmapFromC(out_bits, column.len()) orelse return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    column.startsWithInto(bits, std.mem.span(prefix));
+    return .ZSTRING_OK;
+}
+
+var empty_bitmap = [_]u8{};
+
+fn bitmapFromC(out_bits: [*c]u8, rows: usize) ?zstring.column.Bitmap {
+    const byte_len = zstring.column.Bitmap.byteLength(rows);
+    if (byte_len == 0) return .{ .bytes = &empty_bitmap, .len = 0 };
+    if (out_bits == null) return null;
+
+    const bytes = out_bits[0..byte_len];
+    @memset(bytes, 0);
+    return .{ .bytes = bytes, .len = rows };
+}
+
+// ============================================================================
+// Arrow C Data Interface
+// ============================================================================
+
+const ArrowArray = zstring.arrow.ArrowArray;
+const ArrowSchema = zstring.arrow.ArrowSchema;
+
+/// Move a column into an Arrow utf8 array (zero-copy; frees the handle)
+export fn zstring_column_to_arrow(col: ?*ZStringColumn, out_array: ?*ArrowArray, out_schema: ?*ArrowSchema) ZStringError {
+    if (col == null or out_array == null or out_schema == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const column: *zstring.StringColumn = @ptrCast(@alignCast(col.?));
+    zstring.arrow.exportColumn(u32, allocator, column.*, null, out_array.?, out_schema.?) catch |err| {
+        return errorCode(err);
+    };
+
+    // The Arrow array now owns the buffers; only the handle is freed
+    allocator.destroy(column);
+    return .ZSTRING_OK;
+}
+
+const ArrowOp = enum { lower, trim, split_first_field, includes, starts_with };
+
+fn arrowOp(comptime op: ArrowOp, in: ?*const ArrowArray, in_schema: ?*const ArrowSchema, arg: [*c]const u8, out: ?*ArrowArray, out_schema: ?*ArrowSchema) ZStringError {
+    if (in == null or in_schema == null or out == null or out_schema == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    if (op != .lower and op != .trim and arg == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const format = std.mem.span(in_schema.?.format);
+    if (std.mem.eql(u8, format, "u")) return arrowOpAs(u32, op, in.?, in_schema.?, arg, out.?, out_schema.?);
+    if (std.mem.eql(u8, format, "U")) return arrowOpAs(u64, op, in.?, in_schema.?, arg, out.?, out_schema.?);
+    return .ZSTRING_ERROR_INVALID_ARGUMENT;
+}
+
+fn arrowOpAs(comptime Offset: type, comptime op: ArrowOp, in: *const ArrowArray, in_schema: *const ArrowSchema, arg: [*c]const u8, out: *ArrowArray, out_schema: *ArrowSchema) ZStringError {
+    const src = zstring.arrow.ArrowColumn(Offset).borrow(in, in_schema) catch |err| {
+        return errorCode(err);
+    };
+
+    switch (op) {
+        .includes, .starts_with => {
+            var bits = switch (op) {
+                .includes => src.view.includes(allocator, std.mem.span(arg)),
+                else => src.view.startsWith(allocator, std.mem.span(arg)),
+            } catch |err| {
+                return errorCode(err);
+            };
+            src.maskNulls(bits);
+            var validity = src.validityBitmap(allocator) catch |err| {
+                bits.deinit(allocator);
+                return errorCode(err);
+            };
+
+            zstring.arrow.exportBitmap(allocator, bits, validity, out, out_schema) catch |err| {
+                bits.deinit(allocator);
+                if (validity) |*nulls| nulls.deinit(allocator);
+                return errorCode(err);
+            };
+        },
+        .lower, .trim, .split_first_field => {
+            var result = switch (op) {
+                .lower => src.view.lower(allocator),
+                .trim => src.view.trim(allocator),
+                else => src.view.splitFirstField(allocator, std.mem.span(arg)),
+            } catch |err| {
+                return errorCode(err);
+            };
+            var validity = src.validityBitmap(allocator) catch |err| {
+                result.deinit();
+                return errorCode(err);
+            };
+
+            zstring.arrow.exportColumn(Offset, allocator, result, validity, out, out_schema) catch |err| {
+                result.deinit();
+                if (validity) |*bits| bits.deinit(allocator);
+                return errorCode(err);
+            };
+        },
+    }
+    return .ZSTRING_OK;
+}
+
+/// toLowerCase() of every row of an Arrow utf8/large_utf8 array
+export fn zstring_arrow_lower(in: ?*const ArrowArray, in_schema: ?*const ArrowSchema, out: ?*ArrowArray, out_schema: ?*ArrowSchema) ZStringError {
+    return arrowOp(.lower, in, in_schema, null, out, out_schema);
+}
+
+/// trim() of every row of an Arrow utf8/large_utf8 array
+export fn zstring_arrow_trim(in: ?*const ArrowArray, in_schema: ?*const ArrowSchema, out: ?*ArrowArray, out_schema: ?*ArrowSchema) ZStringError {
+    return arrowOp(.trim, in, in_schema, null, out, out_schema);
+}
+
+/// split(separator)[0] of every row of an Arrow utf8/large_utf8 array
+export fn zstring_arrow_split_first_field(in: ?*const ArrowArray, in_schema: ?*const ArrowSchema, separator: [*c]const u8, out: ?*ArrowArray, out_schema: ?*ArrowSchema) ZStringError {
+    return arrowOp(.split_first_field, in, in_schema, separator, out, out_schema);
+}
+
+/// includes(needle) of every row, as an Arrow boolean array
+export fn zstring_arrow_includes(in: ?*const ArrowArray, in_schema: ?*const ArrowSchema, needle: [*c]const u8, out: ?*ArrowArray, out_schema: ?*ArrowSchema) ZStringError {
+    return arrowOp(.includes, in, in_schema, needle, out, out_schema);
+}
+
+/// startsWith(prefix) of every row, as an Arrow boolean array
+export fn zstring_arrow_starts_with(in: ?*const ArrowArray, in_schema: ?*const ArrowSchema, prefix: [*c]const u8, out: ?*ArrowArray, out_schema: ?*ArrowSchema) ZStringError {
+    return arrowOp(.starts_with, in, in_schema, prefix, out, out_schema);
+}
+
+// ============================================================================
+// Dictionary-encoded Column
+// ============================================================================
+
+/// Opaque handle to a DictionaryColumn
+pub const ZStringDictionary = opaque {};
+
+fn dictionaryFromHandle(dict: *const ZStringDictionary) *const zstring.DictionaryColumn {
+    return @ptrCast(@alignCast(dict));
+}
+
+fn dictionaryToHandle(result: zstring.DictionaryColumn, out: *?*ZStringDictionary) ZStringError {
+    var value = result;
+    const ptr = allocator.create(zstring.DictionaryColumn) catch {
+        value.deinit();
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    ptr.* = value;
+    out.* = @ptrCast(ptr);
+    return .ZSTRING_OK;
+}
+
+/// Create an empty dictionary-encoded column
+export fn zstring_dictionary_new(out: ?*?*ZStringDictionary) ZStringError {
+    if (out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const dict = zstring.DictionaryColumn.init(allocator) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    return dictionaryToHandle(dict, out.?);
+}
+
+/// Dictionary-encode every row of a column
+export fn zstring_dictionary_from_column(col: ?*const ZStringColumn, out: ?*?*ZStringDictionary) ZStringError {
+    if (col == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const dict = zstring.DictionaryColumn.fromColumn(allocator, columnFromHandle(col.?).view()) catch |err| {
+        return errorCode(err);
+    };
+    return dictionaryToHandle(dict, out.?);
+}
+
+/// Free a dictionary-encoded column
+export fn zstring_dictionary_free(dict: ?*ZStringDictionary) void {
+    if (dict) |handle| {
+        const d: *zstring.DictionaryColumn = @ptrCast(@alignCast(handle));
+        d.deinit();
+        allocator.destroy(d);
+    }
+}
+
+/// Append a row
+export fn zstring_dictionary_append(dict: ?*ZStringDictionary, data: [*c]const u8, len: usize) ZStringError {
+    if (dict == null or (data == null and len > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const d: *zstring.DictionaryColumn = @ptrCast(@alignCast(dict.?));
+    const value: []const u8 = if (len == 0) "" else data[0..len];
+    d.append(value) catch |err| {
+        return errorCode(err);
+    };
+    return .ZSTRING_OK;
+}
+
+/// Number of rows
+export fn zstring_dictionary_len(dict: ?*const ZStringDictionary) usize {
+    if (dict) |handle| return dictionaryFromHandle(handle).len();
+    return 0;
+}
+
+/// Number of distinct values
+export fn zstring_dictionary_cardinality(dict: ?*const ZStringDictionary) usize {
+    if (dict) |handle| return dictionaryFromHandle(handle).cardinality();
+    return 0;
+}
+
+/// Dictionary code of row `index` (0 when out of range)
+export fn zstring_dictionary_code(dict: ?*const ZStringDictionary, index: usize) u32 {
+    if (dict) |handle| {
+        const d = dictionaryFromHandle(handle);
+        if (index < d.len()) return d.code(index);
+    }
+    return 0;
+}
+
+/// Borrow the dictionary value for `code`
+export fn zstring_dictionary_value(dict: ?*const ZStringDictionary, code: u32, out: ?*ZStringView) ZStringError {
+    if (dict == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const d = dictionaryFromHandle(dict.?);
+    if (code >= d.cardinality()) return .ZSTRING_ERROR_INDEX_OUT_OF_BOUNDS;
+
+    const value = d.values.get(code);
+    out.?.* = .{ .data = value.ptr, .len = value.len };
+    return .ZSTRING_OK;
+}
+
+/// Lowercase every distinct value (codes are remapped)
+export fn zstring_dictionary_lower(dict: ?*const ZStringDictionary, out: ?*?*ZStringDictionary) ZStringError {
+    if (dict == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const result = dictionaryFromHandle(dict.?).lower(allocator) catch |err| {
+        return errorCode(err);
+    };
+    return dictionaryToHandle(result, out.?);
+}
+
+fn copyBitmap(bits: *zstring.column.Bitmap, out_bits: [*c]u8) void {
+    defer bits.deinit(allocator);
+    if (bits.bytes.len > 0) @memcpy(out_bits[0..bits.bytes.len], bits.bytes);
+}
+
+/// includes(needle) of every row into a caller-provided bitmap
+export fn zstring_dictionary_includes(dict: ?*const ZStringDictionary, needle: [*c]const u8, out_bits: [*c]u8) ZStringError {
+    if (dict == null or needle == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const d = dictionaryFromHandle(dict.?);
+    if (out_bits == null and d.len() > 0) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    var bits = d.includes(allocator, std.mem.span(needle)) catch |err| {
+        return errorCode(err);
+    };
+    copyBitmap(&bits, out_bits);
+    return .ZSTRING_OK;
+}
+
+/// startsWith(prefix) of every row into a caller-provided bitmap
+export fn zstring_dictionary_starts_with(dict: ?*const ZStringDictionary, prefix: [*c]const u8, out_bits: [*c]u8) ZStringError {
+    if (dict == null or prefix == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const d = dictionaryFromHandle(dict.?);
+    if (out_bits == null and d.len() > 0) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    var bits = d.startsWith(allocator, std.mem.span(prefix)) catch |err| {
+        return errorCode(err);
+    };
+    copyBitmap(&bits, out_bits);
+    return .ZSTRING_OK;
+}
+
+/// localeCompare(that) of every row (-1, 0 or 1) into a caller-provided array
+export fn zstring_dictionary_locale_compare(dict: ?*const ZStringDictionary, that: [*c]const u8, out: [*c]i8) ZStringError {
+    if (dict == null or that == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const d = dictionaryFromHandle(dict.?);
+    if (out == null and d.len() > 0) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const result = d.localeCompare(allocator, std.mem.span(that)) catch |err| {
+        return errorCode(err);
+    };
+    defer allocator.free(result);
+    if (result.len > 0) @memcpy(out[0..result.len], result);
+    return .ZSTRING_OK;
+}
+
+// ============================================================================
+// Compressed Strings
+// ============================================================================
+
+/// Opaque handle to a CompressedStrings container
+pub const ZStringCompressed = opaque {};
+
+fn compressedFromHandle(c: *const ZStringCompressed) *const zstring.CompressedStrings {
+    return @ptrCast(@alignCast(c));
+}
+
+/// Build a symbol table from the strings and compress them all
+export fn zstring_compressed_build(parts: [*c]const ZStringView, count: usize, out: ?*?*ZStringCompressed) ZStringError {
+    if (out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    if (parts == null and count > 0) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const strings = allocator.alloc([]const u8, count) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    defer allocator.free(strings);
+    for (strings, 0..) |*s, i| s.* = parts[i].slice();
+
+    var result = zstring.CompressedStrings.build(allocator, strings) catch |err| {
+        return errorCode(err);
+    };
+    const ptr = allocator.create(zstring.CompressedStrings) catch {
+        result.deinit();
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    ptr.* = result;
+    out.?.* = @ptrCast(ptr);
+    return .ZSTRING_OK;
+}
+
+/// Free a compressed container
+export fn zstring_compressed_free(c: ?*ZStringCompressed) void {
+    if (c) |handle| {
+        const store: *zstring.CompressedStrings = @ptrCast(@alignCast(handle));
+        store.deinit();
+        allocator.destroy(store);
+    }
+}
+
+/// Compress and append a string with the existing symbol table
+export fn zstring_compressed_append(c: ?*ZStringCompressed, data: [*c]const u8, len: usize) ZStringError {
+    if (c == null or (data == null and len > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const store: *zstring.CompressedStrings = @ptrCast(@alignCast(c.?));
+    const value: []const u8 = if (len == 0) "" else data[0..len];
+    store.append(value) catch |err| {
+        return errorCode(err);
+    };
+    return .ZSTRING_OK;
+}
+
+/// Number of strings
+export fn zstring_compressed_len(c: ?*const ZStringCompressed) usize {
+    if (c) |handle| return compressedFromHandle(handle).len();
+    return 0;
+}
+
+/// Size of the compressed codes in bytes
+export fn zstring_compressed_size(c: ?*const ZStringCompressed) usize {
+    if (c) |handle| return compressedFromHandle(handle).compressedBytes();
+    return 0;
+}
+
+/// Decompress one string
+export fn zstring_compressed_get(c: ?*const ZStringCompressed, index: usize, out: ?*[*c]u8) ZStringError {
+    if (c == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const store = compressedFromHandle(c.?);
+    if (index >= store.len()) return .ZSTRING_ERROR_INDEX_OUT_OF_BOUNDS;
+
+    var result = std.ArrayList(u8){};
+    store.table.decompress(allocator, store.codesOf(index), &result) catch {
+        result.deinit(allocator);
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    defer result.deinit(allocator);
+    const c_str = dupeCString(result.items) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    out.?.* = c_str.ptr;
+    return .ZSTRING_OK;
+}
+
+const CompressedScan = enum { equals, includes, starts_with };
+
+fn compressedScan(comptime op: CompressedScan, c: ?*const ZStringCompressed, needle: [*c]const u8, out_bits: [*c]u8) ZStringError {
+    if (c == null or needle == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const store = compressedFromHandle(c.?);
+    if (out_bits == null and store.len() > 0) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const value = std.mem.span(needle);
+    var bits = switch (op) {
+        .equals => store.equals(allocator, value),
+        .includes => store.includes(allocator, value),
+        .starts_with => store.startsWith(allocator, value),
+    } catch |err| {
+        return errorCode(err);
+    };
+    copyBitmap(&bits, out_bits);
+    return .ZSTRING_OK;
+}
+
+/// Equality with `needle` of every string into a caller-provided bitmap
+export fn zstring_compressed_equals(c: ?*const ZStringCompressed, needle: [*c]const u8, out_bits: [*c]u8) ZStringError {
+    return compressedScan(.equals, c, needle, out_bits);
+}
+
+/// includes(needle) of every string into a caller-provided bitmap
+export fn zstring_compressed_includes(c: ?*const ZStringCompressed, needle: [*c]const u8, out_bits: [*c]u8) ZStringError {
+    return compressedScan(.includes, c, needle, out_bits);
+}
+
+/// startsWith(prefix) of every string into a caller-provided bitmap
+export fn zstring_compressed_starts_with(c: ?*const ZStringCompressed, prefix: [*c]const u8, out_bits: [*c]u8) ZStringError {
+    return compressedScan(.starts_with, c, prefix, out_bits);
+}
+
+// ============================================================================
+// Serialized String Table
+// ============================================================================
+
+/// Opaque handle to a memory-mapped StringTable
+pub const ZStringTable = opaque {};
+
+fn tableFromHandle(table: *const ZStringTable) *const zstring.StringTable {
+    return @ptrCast(@alignCast(table));
+}
+
+/// Serialize strings to a table file
+export fn zstring_table_write(parts: [*c]const ZStringView, count: usize, perfect_hash: bool, path: [*c]const u8) ZStringError {
+    if (path == null or (parts == null and count > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const strings = allocator.alloc([]const u8, count) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    defer allocator.free(strings);
+    for (strings, 0..) |*s, i| s.* = parts[i].slice();
+
+    zstring.StringTable.write(allocator, std.fs.cwd(), std.mem.span(path), strings, .{ .perfect_hash = perfect_hash }) catch |err| {
+        return errorCode(err);
+    };
+    return .ZSTRING_OK;
+}
+
+/// Map a table file (read-only, shared between processes)
+///
+/// The whole index is verified before the handle is returned, since C
+/// callers index entries without further bounds checks on the file.
+export fn zstring_table_open(path: [*c]const u8, out: ?*?*ZStringTable) ZStringError {
+    if (path == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    var table = zstring.StringTable.open(std.fs.cwd(), std.mem.span(path)) catch |err| {
+        return errorCode(err);
+    };
+    table.verify() catch |err| {
+        table.close();
+        return errorCode(err);
+    };
+    const ptr = allocator.create(zstring.StringTable) catch {
+        table.close();
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    ptr.* = table;
+    out.?.* = @ptrCast(ptr);
+    return .ZSTRING_OK;
+}
+
+/// Unmap a table
+export fn zstring_table_close(table: ?*ZStringTable) void {
+    if (table) |handle| {
+        const t: *zstring.StringTable = @ptrCast(@alignCast(handle));
+        t.close();
+        allocator.destroy(t);
+    }
+}
+
+/// Number of entries
+export fn zstring_table_len(table: ?*const ZStringTable) usize {
+    if (table) |handle| return tableFromHandle(handle).len();
+    return 0;
+}
+
+/// Borrow entry `index` (valid until the table is closed)
+export fn zstring_table_get(table: ?*const ZStringTable, index: usize, out: ?*ZStringView) ZStringError {
+    if (table == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const t = tableFromHandle(table.?);
+    if (index >= t.len()) return .ZSTRING_ERROR_INDEX_OUT_OF_BOUNDS;
+
+    const value = t.get(index);
+    out.?.* = .{ .data = value.ptr, .len = value.len };
+    return .ZSTRING_OK;
+}
+
+/// Precomputed hash of entry `index` (0 when out of range)
+export fn zstring_table_hash(table: ?*const ZStringTable, index: usize) u64 {
+    if (table) |handle| {
+        const t = tableFromHandle(handle);
+        if (index < t.len()) return t.hash(index);
+    }
+    return 0;
+}
+
+/// UTF-16 length of entry `index` (0 when out of range)
+export fn zstring_table_utf16_length(table: ?*const ZStringTable, index: usize) usize {
+    if (table) |handle| {
+        const t = tableFromHandle(handle);
+        if (index < t.len()) return t.utf16Length(index);
+    }
+    return 0;
+}
+
+/// Look up an entry by value
+export fn zstring_table_find(table: ?*const ZStringTable, data: [*c]const u8, len: usize, out_index: ?*usize) bool {
+    if (table == null or (data == null and len > 0)) return false;
+
+    const key: []const u8 = if (len == 0) "" else data[0..len];
+    if (tableFromHandle(table.?).find(key)) |index| {
+        if (out_index) |ptr| ptr.* = index;
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// N-gram Index
+// ============================================================================
+
+/// Opaque handle to an NgramIndex
+pub const ZStringNgramIndex = opaque {};
+
+/// Row and UTF-16 index of a verified match
+pub const ZStringRowMatch = extern struct {
+    row: usize,
+    index: usize,
+};
+
+fn ngramFromHandle(index: *const ZStringNgramIndex) *const zstring.NgramIndex {
+    return @ptrCast(@alignCast(index));
+}
+
+fn ngramToHandle(result: zstring.NgramIndex, out: *?*ZStringNgramIndex) ZStringError {
+    var value = result;
+    const ptr = allocator.create(zstring.NgramIndex) catch {
+        value.deinit();
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    ptr.* = value;
+    out.* = @ptrCast(ptr);
+    return .ZSTRING_OK;
+}
+
+/// Create an empty index
+export fn zstring_ngram_index_new(out: ?*?*ZStringNgramIndex) ZStringError {
+    if (out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const index = zstring.NgramIndex.init(allocator) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    return ngramToHandle(index, out.?);
+}
+
+/// Index a collection of strings in parallel (thread_count 0 = one per CPU)
+export fn zstring_ngram_index_build(parts: [*c]const ZStringView, count: usize, thread_count: usize, out: ?*?*ZStringNgramIndex) ZStringError {
+    if (out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    if (parts == null and count > 0) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const strings = allocator.alloc([]const u8, count) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    defer allocator.free(strings);
+    for (strings, 0..) |*s, i| s.* = parts[i].slice();
+
+    const index = zstring.NgramIndex.build(allocator, strings, thread_count) catch |err| {
+        return errorCode(err);
+    };
+    return ngramToHandle(index, out.?);
+}
+
+/// Free an index
+export fn zstring_ngram_index_free(index: ?*ZStringNgramIndex) void {
+    if (index) |handle| {
+        const idx: *zstring.NgramIndex = @ptrCast(@alignCast(handle));
+        idx.deinit();
+        allocator.destroy(idx);
+    }
+}
+
+/// Append and index a row
+export fn zstring_ngram_index_append(index: ?*ZStringNgramIndex, data: [*c]const u8, len: usize) ZStringError {
+    if (index == null or (data == null and len > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const idx: *zstring.NgramIndex = @ptrCast(@alignCast(index.?));
+    const value: []const u8 = if (len == 0) "" else data[0..len];
+    idx.append(value) catch |err| {
+        return errorCode(err);
+    };
+    return .ZSTRING_OK;
+}
+
+/// Number of rows
+export fn zstring_ngram_index_len(index: ?*const ZStringNgramIndex) usize {
+    if (index) |handle| return ngramFromHandle(handle).len();
+    return 0;
+}
+
+/// Find every row containing `needle`
+export fn zstring_ngram_index_search(index: ?*const ZStringNgramIndex, needle: [*c]const u8, out: ?*[*c]ZStringRowMatch, out_count: ?*usize) ZStringError {
+    if (index == null or needle == null or out == null or out_count == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const matches = ngramFromHandle(index.?).find(allocator, std.mem.span(needle)) catch |err| {
+        return errorCode(err);
+    };
+    defer allocator.free(matches);
+
+    out.?.* = null;
+    out_count.?.* = matches.len;
+    if (matches.len == 0) return .ZSTRING_OK;
+
+    const result = allocator.alloc(ZStringRowMatch, matches.len) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    for (matches, result) |m, *r| r.* = .{ .row = m.row, .index = m.index };
+    out.?.* = result.ptr;
+    return .ZSTRING_OK;
+}
+
+/// Free the result of zstring_ngram_index_search
+export fn zstring_matches_free(matches: [*c]ZStringRowMatch, count: usize) void {
+    if (matches != null and count > 0) allocator.free(matches[0..count]);
+}
+
+// ============================================================================
+// Prefix Set
+// ============================================================================
+
+/// Opaque handle to a PrefixSet
+pub const ZStringPrefixSet = opaque {};
+
+fn prefixSetFromHandle(set: *const ZStringPrefixSet) *const zstring.PrefixSet {
+    return @ptrCast(@alignCast(set));
+}
+
+fn prefixSetToHandle(result: zstring.PrefixSet, out: *?*ZStringPrefixSet) ZStringError {
+    var value = result;
+    const ptr = allocator.create(zstring.PrefixSet) catch {
+        value.deinit();
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    ptr.* = value;
+    out.* = @ptrCast(ptr);
+    return .ZSTRING_OK;
+}
+
+/// Build a prefix set (match ids are indices into `prefixes`)
+export fn zstring_prefix_set_build(prefixes: [*c]const ZStringView, count: usize, out: ?*?*ZStringPrefixSet) ZStringError {
+    if (out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    if (prefixes == null and count > 0) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const keys = allocator.alloc([]const u8, count) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    defer allocator.free(keys);
+    for (keys, 0..) |*k, i| k.* = prefixes[i].slice();
+
+    const set = zstring.PrefixSet.build(allocator, keys) catch |err| {
+        return errorCode(err);
+    };
+    return prefixSetToHandle(set, out.?);
+}
+
+/// Load a prefix set from its serialized form (the bytes are copied)
+export fn zstring_prefix_set_load(data: ?*const anyopaque, len: usize, out: ?*?*ZStringPrefixSet) ZStringError {
+    if (data == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const bytes = @as([*]const u8, @ptrCast(data.?))[0..len];
+    const set = zstring.PrefixSet.load(allocator, bytes) catch |err| {
+        return errorCode(err);
+    };
+    return prefixSetToHandle(set, out.?);
+}
+
+/// Free a prefix set
+export fn zstring_prefix_set_free(set: ?*ZStringPrefixSet) void {
+    if (set) |handle| {
+        const s: *zstring.PrefixSet = @ptrCast(@alignCast(handle));
+        s.deinit();
+        allocator.destroy(s);
+    }
+}
+
+/// Borrow the serialized form of a prefix set
+export fn zstring_prefix_set_serialized(set: ?*const ZStringPrefixSet, out_data: ?*?*const anyopaque, out_len: ?*usize) ZStringError {
+    if (set == null or out_data == null or out_len == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const bytes = prefixSetFromHandle(set.?).serialized();
+    out_data.?.* = bytes.ptr;
+    out_len.?.* = bytes.len;
+    return .ZSTRING_OK;
+}
+
+/// Longest prefix of `str` in the set
+export fn zstring_prefix_set_longest(set: ?*const ZStringPrefixSet, str: [*c]const u8, len: usize, out_id: ?*u32, out_len: ?*usize) bool {
+    if (set == null or (str == null and len > 0)) return false;
+
+    const path: []const u8 = if (len == 0) "" else str[0..len];
+    const m = prefixSetFromHandle(set.?).longestMatch(path) orelse return false;
+    if (out_id) |ptr| ptr.* = m.id;
+    if (out_len) |ptr| ptr.* = m.len;
+    return true;
+}
+
+/// Ids of every prefix of `str` in the set, shortest first
+/// Returns the total number of matches, which may exceed `capacity`.
+export fn zstring_prefix_set_matches(set: ?*const ZStringPrefixSet, str: [*c]const u8, len: usize, out_ids: [*c]u32, capacity: usize) usize {
+    if (set == null or (str == null and len > 0)) return 0;
+
+    const path: []const u8 = if (len == 0) "" else str[0..len];
+    var it = prefixSetFromHandle(set.?).matches(path);
+    var total: usize = 0;
+    while (it.next()) |m| {
+        if (total < capacity and out_ids != null) out_ids[total] = m.id;
+        total += 1;
+    }
+    return total;
+}
+
+// ============================================================================
+// Fuzzy Matching
+// ============================================================================
+
+/// Result of zstring_index_of_approx (index is -1 when nothing matched)
+pub const ZStringApproxMatch = extern struct {
+    index: i64,
+    length: usize,
+    distance: usize,
+};
+
+/// Edit distance in code points; SIZE_MAX when it exceeds `max`
+export fn zstring_edit_distance(a: [*c]const u8, a_len: usize, b: [*c]const u8, b_len: usize, max: usize, transpositions: bool, out: ?*usize) ZStringError {
+    if (out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    if ((a == null and a_len > 0) or (b == null and b_len > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const left: []const u8 = if (a_len == 0) "" else a[0..a_len];
+    const right: []const u8 = if (b_len == 0) "" else b[0..b_len];
+    const limit: ?usize = if (max == std.math.maxInt(usize)) null else max;
+
+    const result = zstring.fuzzy.distanceWithin(allocator, left, right, limit, .{ .transpositions = transpositions }) catch |err| {
+        return errorCode(err);
+    };
+    out.?.* = result orelse std.math.maxInt(usize);
+    return .ZSTRING_OK;
+}
+
+/// First occurrence of `search_str` with at most `max_errors` edits
+export fn zstring_index_of_approx(zstr: ?*const ZString, search_str: [*c]const u8, max_errors: usize, transpositions: bool, out: ?*ZStringApproxMatch) ZStringError {
+    if (zstr == null or search_str == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const handle = zstr.?;
+    const found = zstring.fuzzy.indexOfApprox(allocator, handle.data[0..handle.len], std.mem.span(search_str), max_errors, .{ .transpositions = transpositions }) catch |err| {
+        return errorCode(err);
+    };
+    out.?.* = if (found) |m|
+        .{ .index = @intCast(m.index), .length = m.length, .distance = m.distance }
+    else
+        .{ .index = -1, .length = 0, .distance = 0 };
+    return .ZSTRING_OK;
+}
+
+// ============================================================================
+// Diff
+// ============================================================================
+
+/// One step of an edit script; offsets and lengths are in UTF-16 code units
+pub const ZStringEdit = extern struct {
+    op: c_int,
+    old_start: usize,
+    old_len: usize,
+    new_start: usize,
+    new_len: usize,
+};
+
+/// Compute an edit script turning `old` into `new`
+export fn zstring_diff(old: [*c]const u8, old_len: usize, new: [*c]const u8, new_len: usize, granularity: c_int, out: ?*[*c]ZStringEdit, out_count: ?*usize) ZStringError {
+    if (out == null or out_count == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    if ((old == null and old_len > 0) or (new == null and new_len > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const g: zstring.diff.Granularity = switch (granularity) {
+        0 => .code_point,
+        1 => .word,
+        2 => .line,
+        else => return .ZSTRING_ERROR_INVALID_ARGUMENT,
+    };
+    const old_text: []const u8 = if (old_len == 0) "" else old[0..old_len];
+    const new_text: []const u8 = if (new_len == 0) "" else new[0..new_len];
+
+    const script = zstring.diff.diff(allocator, old_text, new_text, .{ .granularity = g }) catch |err| {
+        return errorCode(err);
+    };
+    defer allocator.free(script);
+
+    out.?.* = null;
+    out_count.?.* = script.len;
+    if (script.len == 0) return .ZSTRING_OK;
+
+    const result = allocator.alloc(ZStringEdit, script.len) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    for (script, result) |e, *r| r.* = .{
+        .op = @intFromEnum(e.op),
+        .old_start = e.old.start,
+        .old_len = e.old.len,
+        .new_start = e.new.start,
+        .new_len = e.new.len,
+    };
+    out.?.* = result.ptr;
+    return .ZSTRING_OK;
+}
+
+/// Free the result of zstring_diff
+export fn zstring_edits_free(edits: [*c]ZStringEdit, count: usize) void {
+    if (edits != null and count > 0) allocator.free(edits[0..count]);
+}
+
+// ============================================================================
+// Display Width
+// ============================================================================
+
+/// Terminal display width in columns
+export fn zstring_display_width(zstr: ?*const ZString) usize {
+    if (zstr) |handle| return zstring.width.width(handle.data[0..handle.len]);
+    return 0;
+}
+
+/// Pad to `width` display columns with `fill` (NULL for a space)
+export fn zstring_pad_to_width(zstr: ?*const ZString, width: usize, fill: [*c]const u8, side: c_int, out: ?*[*c]u8) ZStringError {
+    if (zstr == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const pad_side: zstring.width.Side = switch (side) {
+        0 => .start,
+        1 => .end,
+        2 => .both,
+        else => return .ZSTRING_ERROR_INVALID_ARGUMENT,
+    };
+    const handle = zstr.?;
+    const result = zstring.width.padToWidth(allocator, handle.data[0..handle.len], width, .{
+        .side = pad_side,
+        .fill = if (fill != null) std.mem.span(fill) else " ",
+    }) catch |err| {
+        return errorCode(err);
+    };
+    return toCString(result, out.?);
+}
+
+/// Cut to at most `width` display columns, ending with `ellipsis` (may be NULL)
+export fn zstring_truncate_to_width(zstr: ?*const ZString, width: usize, ellipsis: [*c]const u8, out: ?*[*c]u8) ZStringError {
+    if (zstr == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const handle = zstr.?;
+    const marker: []const u8 = if (ellipsis != null) std.mem.span(ellipsis) else "";
+    const result = zstring.width.truncateToWidth(allocator, handle.data[0..handle.len], width, marker) catch |err| {
+        return errorCode(err);
+    };
+    return toCString(result, out.?);
+}
+
+/// Word-wrap to lines of at most `width` display columns
+export fn zstring_wrap_to_width(zstr: ?*const ZString, width: usize, out: ?*ZStringArray) ZStringError {
+    if (zstr == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const handle = zstr.?;
+    const lines = zstring.width.wrapToWidth(allocator, handle.data[0..handle.len], width) catch |err| {
+        return errorCode(err);
+    };
+    defer allocator.free(lines);
+    return toCArray(lines, out.?);
+}
+
+/// Copy borrowed slices into a ZStringArray of owned C strings
+fn toCArray(parts: []const []const u8, out: *ZStringArray) ZStringError {
+    const c_items = allocator.alloc([*c]u8, parts.len) catch {
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    for (parts, 0..) |part, i| {
+        const c_str = dupeCString(part) catch {
+            for (0..i) |j| freeCString(c_items[j]);
+            allocator.free(c_items);
+            return .ZSTRING_ERROR_OUT_OF_MEMORY;
+        };
+        c_items[i] = c_str.ptr;
+    }
+    out.* = .{ .items = c_items.ptr, .count = parts.len };
+    return .ZSTRING_OK;
+}
+
+// ============================================================================
+// Lines
+// ============================================================================
+
+/// Line iterator state; lives on the caller's stack, no allocation
+pub const ZStringLineIterator = extern struct {
+    data: [*c]const u8,
+    len: usize,
+    pos: usize,
+    number: usize,
+    index: usize,
+    track_utf16: bool,
+    done: bool,
+};
+
+/// A line borrowed from the iterated text
+pub const ZStringLine = extern struct {
+    data: [*c]const u8,
+    len: usize,
+    number: usize,
+    start: usize,
+    index: usize,
+};
+
+/// Start iterating over the lines of `data`
+export fn zstring_lines_init(it: ?*ZStringLineIterator, data: [*c]const u8, len: usize, track_utf16: bool) ZStringError {
+    if (it == null or (data == null and len > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    it.?.* = .{
+        .data = data,
+        .len = len,
+        .pos = 0,
+        .number = 0,
+        .index = 0,
+        .track_utf16 = track_utf16,
+        .done = false,
+    };
+    return .ZSTRING_OK;
+}
+
+/// Advance to the next line; false once every line was returned
+export fn zstring_lines_next(it: ?*ZStringLineIterator, out: ?*ZStringLine) bool {
+    if (it == null or out == null) return false;
+
+    const state = it.?;
+    var iter = zstring.split.LineIterator{
+        .str = if (state.len == 0) "" else state.data[0..state.len],
+        .pos = state.pos,
+        .number = state.number,
+        .index = state.index,
+        .track_utf16 = state.track_utf16,
+        .done = state.done,
+    };
+    const line = iter.next() orelse return false;
+    state.pos = iter.pos;
+    state.number = iter.number;
+    state.index = iter.index;
+    state.done = iter.done;
+
+    out.?.* = .{
+        .data = line.text.ptr,
+        .len = line.text.len,
+        .number = line.number,
+        .start = line.start,
+        .index = line.index,
+    };
+    return true;
+}
+
+// ============================================================================
+// Character Sets
+// ============================================================================
+
+/// Opaque handle to a CharSet
+pub const ZStringCharSet = opaque {};
+
+fn charSetFromHandle(set: *const ZStringCharSet) *const zstring.CharSet {
+    return @ptrCast(@alignCast(set));
+}
+
+/// Compile the set of code points in `chars` (UTF-8, NUL-terminated)
+export fn zstring_charset_new(chars: [*c]const u8, out: ?*?*ZStringCharSet) ZStringError {
+    if (chars == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    var set = zstring.CharSet.init(allocator, std.mem.span(chars)) catch |err| {
+        return errorCode(err);
+    };
+    const ptr = allocator.create(zstring.CharSet) catch {
+        set.deinit();
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    ptr.* = set;
+    out.?.* = @ptrCast(ptr);
+    return .ZSTRING_OK;
+}
+
+/// Free a character set
+export fn zstring_charset_free(set: ?*ZStringCharSet) void {
+    if (set) |handle| {
+        const s: *zstring.CharSet = @ptrCast(@alignCast(handle));
+        s.deinit();
+        allocator.destroy(s);
+    }
+}
+
+/// First code point in `set` at or after `position` (negative: from the start)
+export fn zstring_index_of_any(zstr: ?*const ZString, set: ?*const ZStringCharSet, position: i64) i64 {
+    if (zstr == null or set == null) return -1;
+
+    const handle = zstr.?;
+    const pos: ?isize = if (position >= 0) @intCast(position) else null;
+    return charSetFromHandle(set.?).indexOfAny(handle.data[0..handle.len], pos);
+}
+
+/// Last code point in `set` at or before `position` (negative: from the end)
+export fn zstring_last_index_of_any(zstr: ?*const ZString, set: ?*const ZStringCharSet, position: i64) i64 {
+    if (zstr == null or set == null) return -1;
+
+    const handle = zstr.?;
+    const pos: ?isize = if (position >= 0) @intCast(position) else null;
+    return charSetFromHandle(set.?).lastIndexOfAny(handle.data[0..handle.len], pos);
+}
+
+/// Length in UTF-16 code units of the leading run of code points in `set`
+export fn zstring_span_of(zstr: ?*const ZString, set: ?*const ZStringCharSet) usize {
+    if (zstr == null or set == null) return 0;
+
+    const handle = zstr.?;
+    return charSetFromHandle(set.?).spanOf(handle.data[0..handle.len]);
+}
+
+/// Remove leading and trailing code points in `set`
+export fn zstring_trim_chars(zstr: ?*const ZString, set: ?*const ZStringCharSet, out: ?*[*c]u8) ZStringError {
+    if (zstr == null or set == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const handle = zstr.?;
+    const result = charSetFromHandle(set.?).trimChars(allocator, handle.data[0..handle.len]) catch |err| {
+        return errorCode(err);
+    };
+    return toCString(result, out.?);
+}
+
+/// Split at every code point in `set`
+export fn zstring_split_any(zstr: ?*const ZString, set: ?*const ZStringCharSet, out: ?*ZStringArray) ZStringError {
+    if (zstr == null or set == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const handle = zstr.?;
+    const parts = charSetFromHandle(set.?).splitAny(allocator, handle.data[0..handle.len]) catch |err| {
+        return errorCode(err);
+    };
+    defer allocator.free(parts);
+    return toCArray(parts, out.?);
+}
+
+// ============================================================================
+// File Pipeline
+// ============================================================================
+
+/// Output of one record (a zstring.pipeline.Output)
+pub const ZStringSink = opaque {};
+
+pub const ZStringRecordFn = *const fn (ctx: ?*anyopaque, data: [*c]const u8, len: usize, sink: ?*ZStringSink) callconv(.c) ZStringError;
+
+pub const ZStringPipelineOptions = extern struct {
+    block_size: usize,
+    queue_depth: u32,
+    workers: u32,
+    delimiter: u8,
+};
+
+pub const ZStringPipelineStats = extern struct {
+    records: usize,
+    bytes_in: u64,
+    bytes_out: u64,
+};
+
+/// Adapts a C record callback; keeps the first error code it returned
+const RecordCallback = struct {
+    func: ZStringRecordFn,
+    ctx: ?*anyopaque,
+    status: std.atomic.Value(c_int) = .init(0),
+
+    fn apply(context: ?*anyopaque, record: []const u8, out: zstring.pipeline.Output) anyerror!void {
+        const self: *RecordCallback = @ptrCast(@alignCast(context.?));
+        var sink = out;
+        const code = self.func(self.ctx, record.ptr, record.len, @ptrCast(&sink));
+        if (code == .ZSTRING_OK) return;
+        _ = self.status.cmpxchgStrong(0, @intFromEnum(code), .acq_rel, .acquire);
+        return error.TransformFailed;
+    }
+};
+
+/// Append to a record's output
+export fn zstring_sink_write(sink: ?*ZStringSink, data: [*c]const u8, len: usize) ZStringError {
+    if (sink == null or (data == null and len > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const out: *const zstring.pipeline.Output = @ptrCast(@alignCast(sink.?));
+    if (len > 0) out.write(data[0..len]) catch return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    return .ZSTRING_OK;
+}
+
+/// Transform every record of in_path into out_path
+export fn zstring_pipeline_run(
+    in_path: [*c]const u8,
+    out_path: [*c]const u8,
+    func: ?ZStringRecordFn,
+    ctx: ?*anyopaque,
+    options: ?*const ZStringPipelineOptions,
+    out_stats: ?*ZStringPipelineStats,
+) ZStringError {
+    if (in_path == null or out_path == null or func == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    var opts: zstring.pipeline.Options = .{};
+    if (options) |o| {
+        if (o.block_size > 0) opts.block_size = o.block_size;
+        if (o.queue_depth > 0) opts.queue_depth = @intCast(@min(o.queue_depth, 1024));
+        if (o.workers > 0) opts.workers = o.workers;
+        if (o.delimiter != 0) opts.delimiter = o.delimiter;
+    }
+
+    const input = std.fs.cwd().openFileZ(in_path, .{}) catch return .ZSTRING_ERROR_IO;
+    defer input.close();
+    const output = std.fs.cwd().createFileZ(out_path, .{}) catch return .ZSTRING_ERROR_IO;
+    defer output.close();
+
+    var callback = RecordCallback{ .func = func.?, .ctx = ctx };
+    const stats = zstring.pipeline.run(allocator, input, output, .{
+        .context = &callback,
+        .func = RecordCallback.apply,
+    }, opts) catch |err| {
+        const status = callback.status.load(.acquire);
+        if (err == error.TransformFailed and status != 0) return @enumFromInt(status);
+        return errorCode(err);
+    };
+
+    if (out_stats) |ptr| ptr.* = .{
+        .records = stats.records,
+        .bytes_in = stats.bytes_in,
+        .bytes_out = stats.bytes_out,
+    };
+    return .ZSTRING_OK;
+}
+
+// ============================================================================
+// Lazy Iterators
+// ============================================================================
+
+/// split() iterator state; lives on the caller's stack, no allocation
+pub const ZStringSplitIterator = extern struct {
+    data: [*c]const u8,
+    len: usize,
+    separator: [*c]const u8,
+    separator_len: usize,
+    limit: usize,
+    pos: usize,
+    count: usize,
+    done: bool,
+};
+
+/// Start iterating over the fields split(separator, limit) would return
+export fn zstring_split_iter_init(it: ?*ZStringSplitIterator, data: [*c]const u8, len: usize, separator: [*c]const u8, separator_len: usize, limit: usize) ZStringError {
+    if (it == null or (data == null and len > 0) or (separator == null and separator_len > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    it.?.* = .{
+        .data = data,
+        .len = len,
+        .separator = separator,
+        .separator_len = separator_len,
+        .limit = limit,
+        .pos = 0,
+        .count = 0,
+        .done = false,
+    };
+    return .ZSTRING_OK;
+}
+
+/// Advance to the next field; false once every field was returned
+export fn zstring_split_iter_next(it: ?*ZStringSplitIterator, out: ?*ZStringView) bool {
+    if (it == null or out == null) return false;
+
+    const state = it.?;
+    var iter = zstring.split.SplitIterator{
+        .str = (ZStringView{ .data = state.data, .len = state.len }).slice(),
+        .separator = (ZStringView{ .data = state.separator, .len = state.separator_len }).slice(),
+        .limit = state.limit,
+        .pos = state.pos,
+        .count = state.count,
+        .done = state.done,
+    };
+    const field = iter.next() orelse return false;
+    state.pos = iter.pos;
+    state.count = iter.count;
+    state.done = iter.done;
+
+    out.?.* = .{ .data = field.ptr, .len = field.len };
+    return true;
+}
+
+/// Opaque handle to a lazy matchAll() iterator
+pub const ZStringMatchIterator = opaque {};
+
+/// Iterator plus the groups of the match last returned
+const MatchIteratorState = struct {
+    iter: zstring.regex.MatchIterator,
+    current: ?zstring.regex.MatchIterator.Match = null,
+};
+
+/// Compile pattern for lazy matchAll() over data (borrowed until freed)
+export fn zstring_match_iter_new(data: [*c]const u8, len: usize, pattern: [*c]const u8, out: ?*?*ZStringMatchIterator) ZStringError {
+    if ((data == null and len > 0) or pattern == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const str = (ZStringView{ .data = data, .len = len }).slice();
+    var iter = zstring.regex.matchIterator(allocator, str, std.mem.span(pattern)) catch {
+        return .ZSTRING_ERROR_REGEX_COMPILE;
+    };
+    const state = allocator.create(MatchIteratorState) catch {
+        iter.deinit();
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    state.* = .{ .iter = iter };
+    out.?.* = @ptrCast(state);
+    return .ZSTRING_OK;
+}
+
+/// Advance to the next match; out_found is false after the last one
+export fn zstring_match_iter_next(it: ?*ZStringMatchIterator, out: ?*ZStringView, out_index: ?*usize, out_found: ?*bool) ZStringError {
+    if (it == null or out == null or out_found == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const state: *MatchIteratorState = @ptrCast(@alignCast(it.?));
+    out_found.?.* = false;
+    state.current = null;
+    state.current = state.iter.next() catch |err| return errorCode(err);
+    const m = state.current orelse return .ZSTRING_OK;
+    out.?.* = .{ .data = m.text.ptr, .len = m.text.len };
+    if (out_index) |ptr| ptr.* = m.index;
+    out_found.?.* = true;
+    return .ZSTRING_OK;
+}
+
+/// Capture group n (1-15) of the match last returned; false if not captured
+export fn zstring_match_iter_group(it: ?*const ZStringMatchIterator, n: usize, out: ?*ZStringView) bool {
+    if (it == null or out == null or n == 0 or n > 15) return false;
+
+    const state: *const MatchIteratorState = @ptrCast(@alignCast(it.?));
+    const m = state.current orelse return false;
+    const group = m.groups[n - 1] orelse return false;
+    out.?.* = .{ .data = group.ptr, .len = group.len };
+    return true;
+}
+
+/// Free a match iterator
+export fn zstring_match_iter_free(it: ?*ZStringMatchIterator) void {
+    if (it) |handle| {
+        const state: *MatchIteratorState = @ptrCast(@alignCast(handle));
+        state.iter.deinit();
+        allocator.destroy(state);
+    }
+}
+
+// ============================================================================
+// Resumable Jobs
+// ============================================================================
+
+/// Opaque handle to a resumable, time-sliced operation
+pub const ZStringJob = opaque {};
+
+fn newJob(job: anyerror!zstring.Job, out: ?*?*ZStringJob) ZStringError {
+    var value = job catch |err| return switch (err) {
+        error.InvalidPattern => .ZSTRING_ERROR_REGEX_COMPILE,
+        else => errorCode(err),
+    };
+    const handle = allocator.create(zstring.Job) catch {
+        value.deinit();
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    handle.* = value;
+    out.?.* = @ptrCast(handle);
+    return .ZSTRING_OK;
+}
+
+fn jobPtr(job: *ZStringJob) *zstring.Job {
+    return @ptrCast(@alignCast(job));
+}
+
+/// Resumable split(separator, limit); limit SIZE_MAX for no limit
+export fn zstring_job_split(data: [*c]const u8, len: usize, separator: [*c]const u8, separator_len: usize, limit: usize, out: ?*?*ZStringJob) ZStringError {
+    if ((data == null and len > 0) or (separator == null and separator_len > 0) or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    const str = (ZStringView{ .data = data, .len = len }).slice();
+    const sep = (ZStringView{ .data = separator, .len = separator_len }).slice();
+    return newJob(zstring.Job.split(allocator, str, sep, limit), out);
+}
+
+/// Resumable replaceAll(pattern, replacement)
+export fn zstring_job_replace_all(data: [*c]const u8, len: usize, pattern: [*c]const u8, replacement: [*c]const u8, out: ?*?*ZStringJob) ZStringError {
+    if ((data == null and len > 0) or pattern == null or replacement == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    const str = (ZStringView{ .data = data, .len = len }).slice();
+    return newJob(zstring.Job.replaceAll(allocator, str, std.mem.span(pattern), std.mem.span(replacement)), out);
+}
+
+/// Resumable normalize(form); form NULL means "NFC"
+export fn zstring_job_normalize(data: [*c]const u8, len: usize, form: [*c]const u8, out: ?*?*ZStringJob) ZStringError {
+    if ((data == null and len > 0) or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    const str = (ZStringView{ .data = data, .len = len }).slice();
+    const form_str: ?[]const u8 = if (form == null) null else std.mem.span(form);
+    return newJob(zstring.Job.normalize(allocator, str, form_str), out);
+}
+
+/// Resumable toLowerCase()
+export fn zstring_job_to_lower_case(data: [*c]const u8, len: usize, out: ?*?*ZStringJob) ZStringError {
+    if ((data == null and len > 0) or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    return newJob(zstring.Job.toLowerCase(allocator, (ZStringView{ .data = data, .len = len }).slice()), out);
+}
+
+/// Resumable toUpperCase()
+export fn zstring_job_to_upper_case(data: [*c]const u8, len: usize, out: ?*?*ZStringJob) ZStringError {
+    if ((data == null and len > 0) or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    return newJob(zstring.Job.toUpperCase(allocator, (ZStringView{ .data = data, .len = len }).slice()), out);
+}
+
+/// Resumable matchAll(pattern)
+export fn zstring_job_match_all(data: [*c]const u8, len: usize, pattern: [*c]const u8, out: ?*?*ZStringJob) ZStringError {
+    if ((data == null and len > 0) or pattern == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    const str = (ZStringView{ .data = data, .len = len }).slice();
+    return newJob(zstring.Job.matchAll(allocator, str, std.mem.span(pattern)), out);
+}
+
+/// Process about budget bytes of input; *out_done is set once finished
+export fn zstring_job_step(job: ?*ZStringJob, budget: usize, out_done: ?*bool) ZStringError {
+    if (job == null or out_done == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    out_done.?.* = jobPtr(job.?).step(budget) catch |err| return errorCode(err);
+    return .ZSTRING_OK;
+}
+
+/// Input bytes processed so far
+export fn zstring_job_progress(job: ?*const ZStringJob) usize {
+    const handle: *const zstring.Job = @ptrCast(@alignCast(job orelse return 0));
+    return handle.pos;
+}
+
+/// Output of a replace_all / normalize / case job (borrowed until freed)
+export fn zstring_job_text(job: ?*const ZStringJob, out: ?*ZStringView) ZStringError {
+    if (job == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    const handle: *const zstring.Job = @ptrCast(@alignCast(job.?));
+    switch (handle.state) {
+        .split, .match_all => return .ZSTRING_ERROR_INVALID_ARGUMENT,
+        else => {},
+    }
+    const result = handle.text();
+    out.?.* = .{ .data = result.ptr, .len = result.len };
+    return .ZSTRING_OK;
+}
+
+/// Fields of a split job or matched text of a matchAll job, copied
+/// (free with zstring_array_free)
+export fn zstring_job_parts(job: ?*const ZStringJob, out: ?*ZStringArray) ZStringError {
+    if (job == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    const handle: *const zstring.Job = @ptrCast(@alignCast(job.?));
+    switch (handle.state) {
+        .split => return toCArray(handle.parts(), out.?),
+        .match_all => {
+            const found = handle.matches();
+            const texts = allocator.alloc([]const u8, found.len) catch return .ZSTRING_ERROR_OUT_OF_MEMORY;
+            defer allocator.free(texts);
+            for (found, texts) |m, *t| t.* = m.text;
+            return toCArray(texts, out.?);
+        },
+        else => return .ZSTRING_ERROR_INVALID_ARGUMENT,
+    }
+}
+
+/// Free a job
+export fn zstring_job_free(job: ?*ZStringJob) void {
+    if (job) |handle| {
+        const state = jobPtr(handle);
+        state.deinit();
+        allocator.destroy(state);
+    }
+}
+
+// ============================================================================
+// Async Submission
+// ============================================================================
+
+/// Opaque handle to a job submitted to the shared executor
+pub const ZStringTicket = opaque {};
+
+/// Called on a worker thread when a ticket completes (done or cancelled)
+pub const ZStringTicketCallback = *const fn (ticket: ?*ZStringTicket, user_data: ?*anyopaque) callconv(.c) void;
+
+/// Input bytes a worker processes between cancellation checks
+const ticket_step_bytes = 1 << 20;
+
+/// The ticket whose callback is running on this thread, so freeing it from
+/// there does not wait for its own completion
+threadlocal var completing_ticket: ?*Ticket = null;
+
+const Ticket = struct {
+    task: zstring.executor.Task = .{ .runFn = run, .completeFn = complete, .releaseFn = releaseTask },
+    /// null once taken with zstring_ticket_take_job
+    job: ?*zstring.Job,
+    err: ZStringError = .ZSTRING_OK,
+    callback: ?ZStringTicketCallback,
+    user_data: ?*anyopaque,
+    /// One for the caller's handle, one for the completing thread; the
+    /// last to let go frees the ticket
+    refs: std.atomic.Value(u8) = .init(2),
+
+    fn run(task: *zstring.executor.Task) void {
+        const self: *Ticket = @fieldParentPtr("task", task);
+        while (!task.isCancelled()) {
+            const done = self.job.?.step(ticket_step_bytes) catch |err| {
+                self.err = errorCode(err);
+                return;
+            };
+            if (done) return;
+        }
+    }
+
+    fn complete(task: *zstring.executor.Task) void {
+        const self: *Ticket = @fieldParentPtr("task", task);
+        const callback = self.callback orelse return;
+        const outer = completing_ticket;
+        completing_ticket = self;
+        defer completing_ticket = outer;
+        callback(@ptrCast(self), self.user_data);
+    }
+
+    fn releaseTask(task: *zstring.executor.Task) void {
+        const self: *Ticket = @fieldParentPtr("task", task);
+        self.release();
+    }
+
+    fn release(self: *Ticket) void {
+        if (self.refs.fetchSub(1, .acq_rel) > 1) return;
+        if (self.job) |job| zstring_job_free(@ptrCast(job));
+        allocator.destroy(self);
+    }
+
+    /// Resolve the executor under executor_mutex so a concurrent
+    /// zstring_executor_shutdown cannot free it mid-removal. A ticket on an
+    /// executor already shutting down is not found here; its draining
+    /// worker completes it as cancelled instead.
+    fn cancel(self: *Ticket) void {
+        self.task.cancel();
+        executor_mutex.lock();
+        const removed = if (shared_executor) |pool| pool.remove(&self.task) else false;
+        executor_mutex.unlock();
+        if (removed) self.task.finishCancelled();
+    }
+
+    fn result(self: *const Ticket) ZStringError {
+        return switch (self.task.result()) {
+            .pending, .running => .ZSTRING_ERROR_BUSY,
+            .cancelled => .ZSTRING_ERROR_CANCELLED,
+            .done => self.err,
+        };
+    }
+};
+
+var executor_mutex: std.Thread.Mutex = .{};
+var shared_executor: ?*zstring.Executor = null;
+var executor_options: zstring.executor.Options = .{};
+/// Submissions holding shared_executor outside the lock; shutdown waits
+/// for them before freeing it
+var executor_users: usize = 0;
+var executor_released: std.Thread.Condition = .{};
+var executor_stopping = false;
+
+/// The shared executor, started on first use; pair with releaseExecutor()
+fn acquireExecutor() !*zstring.Executor {
+    executor_mutex.lock();
+    defer executor_mutex.unlock();
+    if (executor_stopping) return error.ShuttingDown;
+    if (shared_executor == null) {
+        shared_executor = try zstring.Executor.init(allocator, executor_options);
+    }
+    executor_users += 1;
+    return shared_executor.?;
+}
+
+fn releaseExecutor() void {
+    executor_mutex.lock();
+    defer executor_mutex.unlock();
+    executor_users -= 1;
+    if (executor_users == 0) executor_released.broadcast();
+}
+
+/// Size the shared executor; only before the first submission (or after
+/// zstring_executor_shutdown). workers 0 means one per CPU.
+export fn zstring_executor_configure(workers: usize, capacity: usize) ZStringError {
+    if (capacity == 0) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    executor_mutex.lock();
+    defer executor_mutex.unlock();
+    if (shared_executor != null) return .ZSTRING_ERROR_BUSY;
+    executor_options = .{ .workers = workers, .capacity = capacity };
+    return .ZSTRING_OK;
+}
+
+/// Cancel queued tickets, wait for running ones, and stop the workers
+///
+/// Submissions in progress are woken by stop() and waited for before the
+/// executor is freed; new ones fail until shutdown returns.
+export fn zstring_executor_shutdown() void {
+    executor_mutex.lock();
+    const pool = shared_executor orelse {
+        executor_mutex.unlock();
+        return;
+    };
+    // Another shutdown already owns this executor
+    if (executor_stopping) {
+        executor_mutex.unlock();
+        return;
+    }
+    executor_stopping = true;
+    pool.stop();
+    while (executor_users > 0) executor_released.wait(&executor_mutex);
+    shared_executor = null;
+    executor_mutex.unlock();
+
+    pool.deinit();
+
+    executor_mutex.lock();
+    executor_stopping = false;
+    executor_mutex.unlock();
+}
+
+fn submitJob(job: ?*ZStringJob, callback: ?ZStringTicketCallback, user_data: ?*anyopaque, out: ?*?*ZStringTicket, blocking: bool) ZStringError {
+    if (job == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const pool = acquireExecutor() catch |err| return errorCode(err);
+    defer releaseExecutor();
+    const ticket = allocator.create(Ticket) catch return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    ticket.* = .{ .job = jobPtr(job.?), .callback = callback, .user_data = user_data };
+
+    const submitted = if (blocking) pool.submit(&ticket.task) else pool.trySubmit(&ticket.task);
+    submitted catch |err| {
+        allocator.destroy(ticket);
+        return errorCode(err);
+    };
+    out.?.* = @ptrCast(ticket);
+    return .ZSTRING_OK;
+}
+
+/// Run a job on the shared executor, waiting for queue space if it is full
+export fn zstring_submit_job(job: ?*ZStringJob, callback: ?ZStringTicketCallback, user_data: ?*anyopaque, out: ?*?*ZStringTicket) ZStringError {
+    return submitJob(job, callback, user_data, out, true);
+}
+
+/// Like zstring_submit_job, but ZSTRING_ERROR_BUSY when the queue is full
+export fn zstring_try_submit_job(job: ?*ZStringJob, callback: ?ZStringTicketCallback, user_data: ?*anyopaque, out: ?*?*ZStringTicket) ZStringError {
+    return submitJob(job, callback, user_data, out, false);
+}
+
+fn ticketPtr(ticket: *ZStringTicket) *Ticket {
+    return @ptrCast(@alignCast(ticket));
+}
+
+/// True once the ticket has completed
+export fn zstring_ticket_poll(ticket: ?*ZStringTicket) bool {
+    return ticketPtr(ticket orelse return false).task.poll();
+}
+
+/// Block until the ticket completes; returns its result
+export fn zstring_ticket_wait(ticket: ?*ZStringTicket) ZStringError {
+    const t = ticketPtr(ticket orelse return .ZSTRING_ERROR_INVALID_ARGUMENT);
+    t.task.wait();
+    return t.result();
+}
+
+/// Block for up to timeout_ns; true if the ticket completed
+export fn zstring_ticket_wait_for(ticket: ?*ZStringTicket, timeout_ns: u64) bool {
+    const t = ticketPtr(ticket orelse return false);
+    t.task.timedWait(timeout_ns) catch return false;
+    return true;
+}
+
+/// Result of the ticket: ZSTRING_ERROR_BUSY while it has not completed
+export fn zstring_ticket_result(ticket: ?*ZStringTicket) ZStringError {
+    return ticketPtr(ticket orelse return .ZSTRING_ERROR_INVALID_ARGUMENT).result();
+}
+
+/// Cancel the ticket (a running job stops at its next step)
+export fn zstring_ticket_cancel(ticket: ?*ZStringTicket) void {
+    if (ticket) |t| ticketPtr(t).cancel();
+}
+
+/// The submitted job, for zstring_job_text / zstring_job_parts once done
+export fn zstring_ticket_job(ticket: ?*ZStringTicket) ?*ZStringJob {
+    return @ptrCast(ticketPtr(ticket orelse return null).job orelse return null);
+}
+
+/// Take ownership of the job of a completed ticket (NULL if still running
+/// or already taken); free it with zstring_job_free
+export fn zstring_ticket_take_job(ticket: ?*ZStringTicket) ?*ZStringJob {
+    const t = ticketPtr(ticket orelse return null);
+    if (!t.task.poll()) return null;
+    const job = t.job orelse return null;
+    t.job = null;
+    return @ptrCast(job);
+}
+
+/// Cancel if still pending, wait, and free the ticket and its job
+export fn zstring_ticket_free(ticket: ?*ZStringTicket) void {
+    const t = ticketPtr(ticket orelse return);
+    t.cancel();
+    // From inside its own callback the ticket is mid-completion on this
+    // thread; the completing side drops the last reference afterwards
+    if (completing_ticket != t) t.task.wait();
+    t.release();
+}
+
+// ============================================================================
+// Mutable Buffers
+// ============================================================================
+
+/// Opaque handle to a mutable string buffer
+pub const ZStringBuf = opaque {};
+
+/// Create a buffer holding a copy of data
+export fn zstring_buf_new(data: [*c]const u8, len: usize, out: ?*?*ZStringBuf) ZStringError {
+    if ((data == null and len > 0) or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+
+    const handle = allocator.create(zstring.ZStringBuf) catch return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    handle.* = zstring.ZStringBuf.initText(allocator, (ZStringView{ .data = data, .len = len }).slice()) catch |err| {
+        allocator.destroy(handle);
+        return errorCode(err);
+    };
+    out.?.* = @ptrCast(handle);
+    return .ZSTRING_OK;
+}
+
+/// Replace UTF-16 code units [start, end) with data
+export fn zstring_buf_replace(buf: ?*ZStringBuf, start: usize, end: usize, data: [*c]const u8, len: usize) ZStringError {
+    if (buf == null or (data == null and len > 0)) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    const handle: *zstring.ZStringBuf = @ptrCast(@alignCast(buf.?));
+    handle.replaceRange(start, end, (ZStringView{ .data = data, .len = len }).slice()) catch |err| return errorCode(err);
+    return .ZSTRING_OK;
+}
+
+/// Insert data before UTF-16 index
+export fn zstring_buf_insert(buf: ?*ZStringBuf, index: usize, data: [*c]const u8, len: usize) ZStringError {
+    return zstring_buf_replace(buf, index, index, data, len);
+}
+
+/// Remove UTF-16 code units [start, end)
+export fn zstring_buf_delete(buf: ?*ZStringBuf, start: usize, end: usize) ZStringError {
+    return zstring_buf_replace(buf, start, end, "", 0);
+}
+
+/// UTF-16 length
+export fn zstring_buf_length(buf: ?*const ZStringBuf) usize {
+    const handle: *const zstring.ZStringBuf = @ptrCast(@alignCast(buf orelse return 0));
+    return handle.length();
+}
+
+/// UTF-8 byte length
+export fn zstring_buf_byte_length(buf: ?*const ZStringBuf) usize {
+    const handle: *const zstring.ZStringBuf = @ptrCast(@alignCast(buf orelse return 0));
+    return handle.byteLength();
+}
+
+/// True if the buffer holds only ASCII
+export fn zstring_buf_is_ascii(buf: ?*const ZStringBuf) bool {
+    const handle: *const zstring.ZStringBuf = @ptrCast(@alignCast(buf orelse return true));
+    return handle.isAscii();
+}
+
+/// Contiguous view of the text (borrowed until the next edit)
+export fn zstring_buf_view(buf: ?*ZStringBuf, out: ?*ZStringView) ZStringError {
+    if (buf == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    const handle: *zstring.ZStringBuf = @ptrCast(@alignCast(buf.?));
+    const text = handle.contents();
+    out.?.* = .{ .data = text.ptr, .len = text.len };
+    return .ZSTRING_OK;
+}
+
+/// Copy the text into a new ZString
+export fn zstring_buf_to_zstring(buf: ?*ZStringBuf, out: ?*?*ZString) ZStringError {
+    if (buf == null or out == null) return .ZSTRING_ERROR_INVALID_ARGUMENT;
+    const handle: *zstring.ZStringBuf = @ptrCast(@alignCast(buf.?));
+
+    const zstr = allocator.create(ZString) catch return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    const copy = allocator.dupe(u8, handle.contents()) catch {
+        allocator.destroy(zstr);
+        return .ZSTRING_ERROR_OUT_OF_MEMORY;
+    };
+    zstr.* = .{ .data = copy.ptr, .len = copy.len };
+    out.?.* = zstr;
+    return .ZSTRING_OK;
+}
+
+/// Free a buffer
+export fn zstring_buf_free(buf: ?*ZStringBuf) void {
+    if (buf) |b| {
+        const handle: *zstring.ZStringBuf = @ptrCast(@alignCast(b));
+        handle.deinit();
+        allocator.destroy(handle);
+    }
+}
+
 // NOTE: Additional methods (slice, substring, concat, repeat, padStart, padEnd,
 // trimStart, trimEnd, charCodeAt, codePointAt, lastIndexOf, startsWith, endsWith,
 // localeCompare, normalize, search, match, replace, replaceAll) can be implemented
@@ -0,0 +1,452 @@
+const std = @import("std");
+const column = @import("column.zig");
+
+const Allocator = std.mem.Allocator;
+const Bitmap = column.Bitmap;
+
+/// Arrow C Data Interface structures
+/// Spec: https://arrow.apache.org/docs/format/CDataInterface.html
+///
+/// Layouts match the ABI-stable C definitions, so pointers can be passed
+/// straight to and from Arrow implementations.
+pub const ArrowSchema = extern struct {
+    format: [*:0]const u8,
+    name: ?[*:0]const u8 = null,
+    metadata: ?[*]const u8 = null,
+    flags: i64 = 0,
+    n_children: i64 = 0,
+    children: ?[*]*ArrowSchema = null,
+    dictionary: ?*ArrowSchema = null,
+    release: ?*const fn (*ArrowSchema) callconv(.c) void = null,
+    private_data: ?*anyopaque = null,
+};
+
+pub const ArrowArray = extern struct {
+    length: i64,
+    null_count: i64 = 0,
+    offset: i64 = 0,
+    n_buffers: i64,
+    n_children: i64 = 0,
+    buffers: ?[*]?*const anyopaque,
+    children: ?[*]*ArrowArray = null,
+    dictionary: ?*ArrowArray = null,
+    release: ?*const fn (*ArrowArray) callconv(.c) void = null,
+    private_data: ?*anyopaque = null,
+};
+
+pub const ARROW_FLAG_NULLABLE: i64 = 2;
+
+/// Errors reported by Arrow import and export
+pub const ArrowError = error{
+    /// The schema is not utf8 ("u") or large_utf8 ("U") as expected
+    UnsupportedFormat,
+    /// The array has an unexpected buffer layout or out-of-range offsets
+    InvalidArray,
+    /// A u32 column holds more data than Arrow's int32 offsets allow
+    OffsetOverflow,
+};
+
+/// Arrow format string for a column with `Offset`-sized offsets
+pub fn formatFor(comptime Offset: type) [:0]const u8 {
+    return switch (Offset) {
+        u32 => "u",
+        u64 => "U",
+        else => @compileError("unsupported offset type"),
+    };
+}
+
+// Placeholder for empty buffers; Arrow requires non-null data pointers
+var empty_data = [_]u8{0};
+const empty_offsets_u32 = [_]u32{0};
+const empty_offsets_u64 = [_]u64{0};
+
+// ============================================================================
+// Import
+// ============================================================================
+
+/// A utf8/large_utf8 Arrow array viewed as a string column
+///
+/// The rows are read in place from the Arrow buffers; nothing is copied.
+/// Null rows read as empty strings; use isNull() or maskNulls() to tell
+/// them apart.
+pub fn ArrowColumn(comptime Offset: type) type {
+    return struct {
+        const Self = @This();
+
+        view: column.ColumnView(Offset),
+        /// Arrow validity bitmap, indexed from `validity_offset`
+        validity: ?[*]const u8 = null,
+        validity_offset: usize = 0,
+        null_count: usize = 0,
+        /// Set when the array was imported (moved) rather than borrowed
+        owned: ?ArrowArray = null,
+
+        /// Views an Arrow array without taking ownership
+        /// The array must stay alive (and unreleased) while the view is used.
+        /// Offsets are checked to be non-negative and non-decreasing, so
+        /// every row lies inside the data buffer the last offset implies.
+        pub fn borrow(array: *const ArrowArray, schema: *const ArrowSchema) ArrowError!Self {
+            if (!std.mem.eql(u8, std.mem.span(schema.format), formatFor(Offset))) return error.UnsupportedFormat;
+            if (array.n_buffers != 3 or array.buffers == null) return error.InvalidArray;
+            if (array.length < 0 or array.offset < 0) return error.InvalidArray;
+
+            const length: usize = @intCast(array.length);
+            const start: usize = @intCast(array.offset);
+            const buffers = array.buffers.?;
+
+            var self = Self{ .view = undefined };
+
+            if (length == 0 or buffers[1] == null) {
+                if (length != 0) return error.InvalidArray;
+                const empty: []const Offset = if (Offset == u32) &empty_offsets_u32 else &empty_offsets_u64;
+                self.view = .{ .data = &empty_data, .offsets = empty };
+                return self;
+            }
+
+            // Arrow offsets are signed; valid ones are never negative, so the
+            // same bits read as unsigned are the same values.
+            const offsets_ptr: [*]const Offset = @ptrCast(@alignCast(buffers[1].?));
+            const offsets = offsets_ptr[start .. start + length + 1];
+            const Signed = std.meta.Int(.signed, @bitSizeOf(Offset));
+            if (@as(Signed, @bitCast(offsets[0])) < 0 or @as(Signed, @bitCast(offsets[length])) < 0) return error.InvalidArray;
+            for (offsets[0..length], offsets[1..]) |lo, hi| {
+                if (lo > hi) return error.InvalidArray;
+            }
+
+            const data: []const u8 = if (offsets[length] == 0)
+                &empty_data
+            else if (buffers[2]) |ptr|
+                @as([*]const u8, @ptrCast(ptr))[0..offsets[length]]
+            else
+                return error.InvalidArray;
+
+            self.view = .{ .data = data, .offsets = offsets };
+            if (array.null_count != 0) {
+                if (buffers[0]) |validity| {
+                    self.validity = @ptrCast(validity);
+                    self.validity_offset = start;
+                    self.null_count = if (array.null_count < 0) countNulls(self) else @intCast(array.null_count);
+                }
+            }
+            return self;
+        }
+
+        /// Takes ownership of an Arrow array (the C Data Interface "move")
+        ///
+        /// `array.release` is cleared so the producer's struct no longer
+        /// owns the buffers; call deinit() to release them.
+        pub fn import(array: *ArrowArray, schema: *const ArrowSchema) ArrowError!Self {
+            if (array.release == null) return error.InvalidArray;
+
+            var self = try borrow(array, schema);
+            self.owned = array.*;
+            array.release = null;
+            return self;
+        }
+
+        /// Releases an imported array (no-op for borrowed views)
+        pub fn deinit(self: *Self) void {
+            if (self.owned) |*array| {
+                if (array.release) |release| release(array);
+            }
+            self.* = undefined;
+        }
+
+        fn countNulls(self: Self) usize {
+            var nulls: usize = 0;
+            for (0..self.view.len()) |i| {
+                if (self.isNull(i)) nulls += 1;
+            }
+            return nulls;
+        }
+
+        /// Number of rows
+        pub inline fn len(self: Self) usize {
+            return self.view.len();
+        }
+
+        /// Returns row `i` (empty for null rows)
+        pub inline fn get(self: Self, i: usize) []const u8 {
+            return self.view.get(i);
+        }
+
+        /// Returns true if row `i` is null
+        pub fn isNull(self: Self, i: usize) bool {
+            const bits = self.validity orelse return false;
+            const bit = self.validity_offset + i;
+            return (bits[bit >> 3] >> @intCast(bit & 7)) & 1 == 0;
+        }
+
+        /// Clears the bits of null rows in a per-row result bitmap
+        pub fn maskNulls(self: Self, bits: Bitmap) void {
+            if (self.validity == null) return;
+            for (0..self.len()) |i| {
+                if (self.isNull(i)) bits.bytes[i >> 3] &= ~(@as(u8, 1) << @intCast(i & 7));
+            }
+        }
+
+        /// Copies the validity bitmap rebased to row 0, or null if no row is null
+        /// Pass the result to exportColumn() so transformed columns keep their nulls.
+        pub fn validityBitmap(self: Self, allocator: Allocator) !?Bitmap {
+            if (self.validity == null or self.null_count == 0) return null;
+
+            const bits = try Bitmap.init(allocator, self.len());
+            for (0..self.len()) |i| {
+                if (!self.isNull(i)) bits.set(i);
+            }
+            return bits;
+        }
+    };
+}
+
+// ============================================================================
+// Export
+// ============================================================================
+
+fn ExportedColumn(comptime Offset: type) type {
+    return struct {
+        allocator: Allocator,
+        column: column.StringColumnOf(Offset),
+        validity: ?Bitmap,
+        buffers: [3]?*const anyopaque,
+
+        fn release(array: *ArrowArray) callconv(.c) void {
+            const self: *@This() = @ptrCast(@alignCast(array.private_data.?));
+            const allocator = self.allocator;
+            self.column.deinit();
+            if (self.validity) |*bits| bits.deinit(allocator);
+            allocator.destroy(self);
+            array.release = null;
+        }
+    };
+}
+
+fn releaseSchema(schema: *ArrowSchema) callconv(.c) void {
+    // Format and name are static strings
+    schema.release = null;
+}
+
+/// Exports a column as an Arrow utf8 (u32) or large_utf8 (u64) array
+///
+/// Ownership of the column's buffers moves to the Arrow array: nothing is
+/// copied, and the consumer frees them by calling `out_array.release`.
+/// `validity` (optional, consumed) marks non-null rows. On error the column
+/// and validity are left with the caller.
+pub fn exportColumn(
+    comptime Offset: type,
+    allocator: Allocator,
+    col: column.StringColumnOf(Offset),
+    validity: ?Bitmap,
+    out_array: *ArrowArray,
+    out_schema: *ArrowSchema,
+) !void {
+    if (Offset == u32 and col.data.items.len > std.math.maxInt(i32)) return error.OffsetOverflow;
+    if (validity) |bits| std.debug.assert(bits.len == col.len());
+
+    const Exported = ExportedColumn(Offset);
+    const exported = try allocator.create(Exported);
+    exported.* = .{
+        .allocator = allocator,
+        .column = col,
+        .validity = validity,
+        .buffers = .{
+            if (validity) |bits| @ptrCast(bits.bytes.ptr) else null,
+            @ptrCast(col.offsets.items.ptr),
+            if (col.data.items.len > 0) @ptrCast(col.data.items.ptr) else @ptrCast(&empty_data),
+        },
+    };
+
+    const nulls: usize = if (validity) |bits| col.len() - bits.count() else 0;
+    out_array.* = .{
+        .length = @intCast(col.len()),
+        .null_count = @intCast(nulls),
+        .n_buffers = 3,
+        .buffers = &exported.buffers,
+        .release = &Exported.release,
+        .private_data = exported,
+    };
+    out_schema.* = .{
+        .format = formatFor(Offset).ptr,
+        .name = "",
+        .flags = if (validity != null) ARROW_FLAG_NULLABLE else 0,
+        .release = &releaseSchema,
+    };
+}
+
+const ExportedBitmap = struct {
+    allocator: Allocator,
+    bits: Bitmap,
+    validity: ?Bitmap,
+    buffers: [2]?*const anyopaque,
+
+    fn release(array: *ArrowArray) callconv(.c) void {
+        const self: *ExportedBitmap = @ptrCast(@alignCast(array.private_data.?));
+        const allocator = self.allocator;
+        self.bits.deinit(allocator);
+        if (self.validity) |*bits| bits.deinit(allocator);
+        allocator.destroy(self);
+        array.release = null;
+    }
+};
+
+/// Exports a per-row bitmap as an Arrow boolean array
+///
+/// The bitmap's bytes become the values buffer without copying; the
+/// consumer frees them by calling `out_array.release`. `validity`
+/// (optional, consumed) marks non-null rows, as in exportColumn(). On error
+/// both bitmaps are left with the caller.
+pub fn exportBitmap(allocator: Allocator, bits: Bitmap, validity: ?Bitmap, out_array: *ArrowArray, out_schema: *ArrowSchema) !void {
+    if (validity) |present| std.debug.assert(present.len == bits.len);
+
+    const exported = try allocator.create(ExportedBitmap);
+    exported.* = .{
+        .allocator = allocator,
+        .bits = bits,
+        .validity = validity,
+        .buffers = .{
+            if (validity) |present| @ptrCast(present.bytes.ptr) else null,
+            if (bits.bytes.len > 0) @ptrCast(bits.bytes.ptr) else @ptrCast(&empty_data),
+        },
+    };
+
+    const nulls: usize = if (validity) |present| bits.len - present.count() else 0;
+    out_array.* = .{
+        .length = @intCast(bits.len),
+        .null_count = @intCast(nulls),
+        .n_buffers = 2,
+        .buffers = &exported.buffers,
+        .release = &ExportedBitmap.release,
+        .private_data = exported,
+    };
+    out_schema.* = .{
+        .format = "b",
+        .name = "",
+        .flags = if (validity != null) ARROW_FLAG_NULLABLE else 0,
+        .release = &releaseSchema,
+    };
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "arrow - export and re-import a column without copying" {
+    const allocator = std.testing.allocator;
+
+    var col = try column.StringColumn.fromSlices(allocator, &[_][]const u8{ "GET", "", "café" }, .{});
+    const data_ptr = col.data.items.ptr;
+
+    var array: ArrowArray = undefined;
+    var schema: ArrowSchema = undefined;
+    exportColumn(u32, allocator, col, null, &array, &schema) catch |err| {
+        col.deinit();
+        return err;
+    };
+    defer schema.release.?(&schema);
+
+    try std.testing.expectEqualStrings("u", std.mem.span(schema.format));
+    try std.testing.expectEqual(@as(i64, 3), array.length);
+    try std.testing.expectEqual(@as(i64, 0), array.null_count);
+
+    var imported = try ArrowColumn(u32).import(&array, &schema);
+    defer imported.deinit();
+    try std.testing.expect(array.release == null);
+
+    try std.testing.expectEqual(@as(usize, 3), imported.len());
+    try std.testing.expectEqualStrings("GET", imported.get(0));
+    try std.testing.expectEqualStrings("", imported.get(1));
+    try std.testing.expectEqualStrings("café", imported.get(2));
+    try std.testing.expect(imported.get(0).ptr == data_ptr);
+}
+
+test "arrow - borrow a sliced array with nulls" {
+    const allocator = std.testing.allocator;
+
+    // Rows: "xx", "Hello", null, "World" (offset 1 skips "xx")
+    const offsets = [_]i32{ 0, 2, 7, 7, 12 };
+    const data = "xxHelloWorld";
+    const validity = [_]u8{0b1011};
+    var buffers = [_]?*const anyopaque{ &validity, &offsets, data };
+
+    const array = ArrowArray{
+        .length = 3,
+        .null_count = 1,
+        .offset = 1,
+        .n_buffers = 3,
+        .buffers = &buffers,
+    };
+    const schema = ArrowSchema{ .format = "u" };
+
+    var view = try ArrowColumn(u32).borrow(&array, &schema);
+    defer view.deinit();
+
+    try std.testing.expectEqualStrings("Hello", view.get(0));
+    try std.testing.expect(view.isNull(1));
+    try std.testing.expectEqualStrings("World", view.get(2));
+
+    // Batch operation on the borrowed buffers, result exported as Arrow
+    var lowered = try view.view.lower(allocator);
+    const nulls = view.validityBitmap(allocator) catch |err| {
+        lowered.deinit();
+        return err;
+    };
+
+    var out: ArrowArray = undefined;
+    var out_schema: ArrowSchema = undefined;
+    try exportColumn(u32, allocator, lowered, nulls, &out, &out_schema);
+    defer out.release.?(&out);
+    defer out_schema.release.?(&out_schema);
+
+    try std.testing.expectEqual(@as(i64, 1), out.null_count);
+    try std.testing.expect(out_schema.flags & ARROW_FLAG_NULLABLE != 0);
+
+    const result = try ArrowColumn(u32).borrow(&out, &out_schema);
+    try std.testing.expectEqualStrings("hello", result.get(0));
+    try std.testing.expect(result.isNull(1));
+    try std.testing.expectEqualStrings("world", result.get(2));
+
+    var hits = try view.view.includes(allocator, "o");
+    view.maskNulls(hits);
+    var hit_nulls = view.validityBitmap(allocator) catch |err| {
+        hits.deinit(allocator);
+        return err;
+    };
+    var bool_array: ArrowArray = undefined;
+    var bool_schema: ArrowSchema = undefined;
+    exportBitmap(allocator, hits, hit_nulls, &bool_array, &bool_schema) catch |err| {
+        hits.deinit(allocator);
+        if (hit_nulls) |*bits| bits.deinit(allocator);
+        return err;
+    };
+    defer bool_array.release.?(&bool_array);
+    defer bool_schema.release.?(&bool_schema);
+
+    try std.testing.expectEqualStrings("b", std.mem.span(bool_schema.format));
+    try std.testing.expectEqual(@as(i64, 1), bool_array.null_count);
+    const values: [*]const u8 = @ptrCast(bool_array.buffers.?[1].?);
+    try std.testing.expectEqual(@as(u8, 0b101), values[0]);
+    const present: [*]const u8 = @ptrCast(bool_array.buffers.?[0].?);
+    try std.testing.expectEqual(@as(u8, 0b101), present[0]);
+}
+
+test "arrow - rejects offsets that go backwards" {
+    // Row 1 would slice data[5..2]
+    const offsets = [_]i32{ 0, 5, 2, 6 };
+    const data = "abcdef";
+    var buffers = [_]?*const anyopaque{ null, &offsets, data };
+    const array = ArrowArray{ .length = 3, .n_buffers = 3, .buffers = &buffers };
+
+    try std.testing.expectError(error.InvalidArray, ArrowColumn(u32).borrow(&array, &ArrowSchema{ .format = "u" }));
+}
+
+test "arrow - rejects mismatched formats" {
+    const offsets = [_]i64{0};
+    var buffers = [_]?*const anyopaque{ null, &offsets, null };
+    const array = ArrowArray{ .length = 0, .n_buffers = 3, .buffers = &buffers };
+
+    try std.testing.expectError(error.UnsupportedFormat, ArrowColumn(u32).borrow(&array, &ArrowSchema{ .format = "U" }));
+    try std.testing.expectError(error.UnsupportedFormat, ArrowColumn(u64).borrow(&array, &ArrowSchema{ .format = "i" }));
+
+    const empty = try ArrowColumn(u64).borrow(&array, &ArrowSchema{ .format = "U" });
+    try std.testing.expectEqual(@as(usize, 0), empty.len());
+}
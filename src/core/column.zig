@@ -0,0 +1,517 @@
+const std = @import("std");
+const simd = @import("simd.zig");
+const utf16 = @import("utf16.zig");
+const case = @import("../methods/case.zig");
+const trimming = @import("../methods/trimming.zig");
+
+const Allocator = std.mem.Allocator;
+
+/// Fixed-length bitmap with one bit per row, least significant bit first
+///
+/// The byte layout matches Arrow validity bitmaps, so results can be handed
+/// to C callers or other engines without repacking.
+pub const Bitmap = struct {
+    bytes: []u8,
+    len: usize,
+
+    /// Number of bytes needed for `len` bits
+    pub fn byteLength(len: usize) usize {
+        return (len + 7) / 8;
+    }
+
+    /// Allocates a cleared bitmap of `len` bits
+    pub fn init(allocator: Allocator, len: usize) !Bitmap {
+        const bytes = try allocator.alloc(u8, byteLength(len));
+        @memset(bytes, 0);
+        return .{ .bytes = bytes, .len = len };
+    }
+
+    pub fn deinit(self: *Bitmap, allocator: Allocator) void {
+        allocator.free(self.bytes);
+        self.* = undefined;
+    }
+
+    pub inline fn isSet(self: Bitmap, i: usize) bool {
+        return (self.bytes[i >> 3] >> @intCast(i & 7)) & 1 != 0;
+    }
+
+    pub inline fn set(self: Bitmap, i: usize) void {
+        self.bytes[i >> 3] |= @as(u8, 1) << @intCast(i & 7);
+    }
+
+    /// Number of set bits
+    pub fn count(self: Bitmap) usize {
+        var total: usize = 0;
+        for (self.bytes) |b| total += @popCount(b);
+        return total;
+    }
+};
+
+/// Options for a new column
+pub const Options = struct {
+    /// Maintain a per-row UTF-16 length and ASCII bit as rows are appended
+    track_stats: bool = false,
+};
+
+/// Columnar array of UTF-8 strings
+///
+/// All rows live in one contiguous `data` buffer; row `i` is
+/// `data[offsets[i]..offsets[i + 1]]`. Compared to one ZString per row there
+/// is no per-row header or allocation, and column-wide operations run as
+/// tight loops over contiguous memory.
+///
+/// `Offset` is u32 (data up to 4 GiB) or u64. See StringColumn and
+/// LargeStringColumn.
+pub fn StringColumnOf(comptime Offset: type) type {
+    comptime std.debug.assert(Offset == u32 or Offset == u64);
+
+    return struct {
+        const Self = @This();
+
+        allocator: Allocator,
+        data: std.ArrayList(u8) = .{},
+        /// rows + 1 entries, starting at 0
+        offsets: std.ArrayList(Offset) = .{},
+        /// Per-row UTF-16 length when stats are tracked
+        utf16_lengths: ?std.ArrayList(Offset) = null,
+        /// Per-row ASCII bits (LSB first) when stats are tracked
+        ascii_bits: ?std.ArrayList(u8) = null,
+
+        pub fn init(allocator: Allocator, options: Options) !Self {
+            var self = Self{ .allocator = allocator };
+            errdefer self.deinit();
+
+            try self.offsets.append(allocator, 0);
+            if (options.track_stats) {
+                self.utf16_lengths = .{};
+                self.ascii_bits = .{};
+            }
+            return self;
+        }
+
+        /// Builds a column from a list of strings
+        pub fn fromSlices(allocator: Allocator, rows: []const []const u8, options: Options) !Self {
+            var self = try init(allocator, options);
+            errdefer self.deinit();
+
+            var total: usize = 0;
+            for (rows) |row| total += row.len;
+            try self.reserve(rows.len, total);
+
+            for (rows) |row| try self.append(row);
+            return self;
+        }
+
+        pub fn deinit(self: *Self) void {
+            self.data.deinit(self.allocator);
+            self.offsets.deinit(self.allocator);
+            if (self.utf16_lengths) |*lengths| lengths.deinit(self.allocator);
+            if (self.ascii_bits) |*bits| bits.deinit(self.allocator);
+            self.* = undefined;
+        }
+
+        /// Reserves room for `rows` more rows holding `bytes` more data bytes
+        pub fn reserve(self: *Self, rows: usize, bytes: usize) !void {
+            try self.data.ensureUnusedCapacity(self.allocator, bytes);
+            try self.offsets.ensureUnusedCapacity(self.allocator, rows);
+            if (self.utf16_lengths) |*lengths| try lengths.ensureUnusedCapacity(self.allocator, rows);
+            if (self.ascii_bits) |*bits| try bits.ensureUnusedCapacity(self.allocator, Bitmap.byteLength(rows) + 1);
+        }
+
+        /// Appends a row
+        /// Returns error.OffsetOverflow when the data no longer fits `Offset`.
+        pub fn append(self: *Self, str: []const u8) !void {
+            const end = self.data.items.len + str.len;
+            if (end > std.math.maxInt(Offset)) return error.OffsetOverflow;
+
+            const row = self.len();
+            try self.offsets.ensureUnusedCapacity(self.allocator, 1);
+            if (self.utf16_lengths) |*lengths| try lengths.ensureUnusedCapacity(self.allocator, 1);
+            if (self.ascii_bits) |*bits| {
+                if (row % 8 == 0) try bits.append(self.allocator, 0);
+            }
+            try self.data.appendSlice(self.allocator, str);
+            self.offsets.appendAssumeCapacity(@intCast(end));
+
+            if (self.utf16_lengths) |*lengths| {
+                const ascii = simd.isAscii(str);
+                lengths.appendAssumeCapacity(@intCast(if (ascii) str.len else utf16.lengthUtf16(str)));
+                if (ascii) self.ascii_bits.?.items[row >> 3] |= @as(u8, 1) << @intCast(row & 7);
+            }
+        }
+
+        /// Number of rows
+        pub inline fn len(self: Self) usize {
+            return self.offsets.items.len - 1;
+        }
+
+        /// Returns row `i` as a view into the column's data
+        pub inline fn get(self: Self, i: usize) []const u8 {
+            return self.data.items[self.offsets.items[i]..self.offsets.items[i + 1]];
+        }
+
+        /// Returns true if per-row stats are tracked
+        pub inline fn hasStats(self: Self) bool {
+            return self.utf16_lengths != null;
+        }
+
+        /// String.prototype.length of row `i` (cached when stats are tracked)
+        pub fn utf16Length(self: Self, i: usize) usize {
+            if (self.utf16_lengths) |lengths| return lengths.items[i];
+            return utf16.lengthUtf16(self.get(i));
+        }
+
+        /// Returns true if row `i` is pure ASCII (cached when stats are tracked)
+        pub fn isAscii(self: Self, i: usize) bool {
+            if (self.ascii_bits) |bits| return (bits.items[i >> 3] >> @intCast(i & 7)) & 1 != 0;
+            return simd.isAscii(self.get(i));
+        }
+
+        /// Borrowed view of the rows, used by the column operations
+        pub fn view(self: Self) View {
+            return .{
+                .data = self.data.items,
+                .offsets = self.offsets.items,
+                .utf16_lengths = if (self.utf16_lengths) |lengths| lengths.items else null,
+                .ascii_bits = if (self.ascii_bits) |bits| bits.items else null,
+            };
+        }
+
+        pub const View = ColumnView(Offset);
+
+        // ====================================================================
+        // Column Operations
+        // ====================================================================
+
+        /// toLowerCase() of every row
+        pub fn lower(self: Self, allocator: Allocator) !Self {
+            return self.view().lower(allocator);
+        }
+
+        /// trim() of every row
+        pub fn trim(self: Self, allocator: Allocator) !Self {
+            return self.view().trim(allocator);
+        }
+
+        /// split(separator)[0] of every row
+        pub fn splitFirstField(self: Self, allocator: Allocator, separator: []const u8) !Self {
+            return self.view().splitFirstField(allocator, separator);
+        }
+
+        /// includes(needle) of every row, as a bitmap
+        pub fn includes(self: Self, allocator: Allocator, needle: []const u8) !Bitmap {
+            return self.view().includes(allocator, needle);
+        }
+
+        /// Writes includes(needle) of every row into a cleared bitmap
+        pub fn includesInto(self: Self, bits: Bitmap, needle: []const u8) void {
+            self.view().includesInto(bits, needle);
+        }
+
+        /// startsWith(prefix) of every row, as a bitmap
+        pub fn startsWith(self: Self, allocator: Allocator, prefix: []const u8) !Bitmap {
+            return self.view().startsWith(allocator, prefix);
+        }
+
+        /// Writes startsWith(prefix) of every row into a cleared bitmap
+        pub fn startsWithInto(self: Self, bits: Bitmap, prefix: []const u8) void {
+            self.view().startsWithInto(bits, prefix);
+        }
+    };
+}
+
+/// Read-only rows over borrowed `data` and `offsets` buffers
+///
+/// Row `i` is `data[offsets[i]..offsets[i + 1]]`; `offsets[0]` need not be 0,
+/// so sliced buffers from other engines (e.g. Arrow arrays with a non-zero
+/// offset) can be used in place. Operations allocate only their results.
+pub fn ColumnView(comptime Offset: type) type {
+    return struct {
+        const Self = @This();
+        const Column = StringColumnOf(Offset);
+
+        data: []const u8,
+        /// rows + 1 entries
+        offsets: []const Offset,
+        utf16_lengths: ?[]const Offset = null,
+        ascii_bits: ?[]const u8 = null,
+
+        /// Number of rows
+        pub inline fn len(self: Self) usize {
+            return self.offsets.len - 1;
+        }
+
+        /// Returns row `i`
+        pub inline fn get(self: Self, i: usize) []const u8 {
+            return self.data[self.offsets[i]..self.offsets[i + 1]];
+        }
+
+        /// Returns true if row `i` is pure ASCII (cached when stats are present)
+        pub fn isAscii(self: Self, i: usize) bool {
+            if (self.ascii_bits) |bits| return (bits[i >> 3] >> @intCast(i & 7)) & 1 != 0;
+            return simd.isAscii(self.get(i));
+        }
+
+        /// The bytes spanned by all rows
+        fn span(self: Self) []const u8 {
+            return self.data[self.offsets[0]..self.offsets[self.len()]];
+        }
+
+        fn statsOptions(self: Self) Options {
+            return .{ .track_stats = self.utf16_lengths != null };
+        }
+
+        /// toLowerCase() of every row
+        ///
+        /// All-ASCII data is lowered in one vectorized pass and reuses the
+        /// offsets; otherwise ASCII rows take the byte path and only
+        /// non-ASCII rows go through full case mapping.
+        pub fn lower(self: Self, allocator: Allocator) !Column {
+            var result = try Column.init(allocator, self.statsOptions());
+            errdefer result.deinit();
+
+            const bytes = self.span();
+            if (simd.isAscii(bytes)) {
+                try result.data.resize(allocator, bytes.len);
+                asciiLowerInto(result.data.items, bytes);
+                try result.offsets.ensureUnusedCapacity(allocator, self.len());
+                for (self.offsets[1..]) |offset| {
+                    result.offsets.appendAssumeCapacity(offset - self.offsets[0]);
+                }
+                if (self.utf16_lengths) |lengths| try result.utf16_lengths.?.appendSlice(allocator, lengths);
+                if (self.ascii_bits) |bits| try result.ascii_bits.?.appendSlice(allocator, bits);
+                return result;
+            }
+
+            try result.reserve(self.len(), bytes.len);
+            var scratch = std.ArrayList(u8){};
+            defer scratch.deinit(allocator);
+
+            for (0..self.len()) |i| {
+                const row = self.get(i);
+                if (self.isAscii(i)) {
+                    try scratch.resize(allocator, row.len);
+                    asciiLowerInto(scratch.items, row);
+                    try result.append(scratch.items);
+                } else {
+                    const lowered = try case.toLowerCase(allocator, row);
+                    defer allocator.free(lowered);
+                    try result.append(lowered);
+                }
+            }
+            return result;
+        }
+
+        /// trim() of every row
+        pub fn trim(self: Self, allocator: Allocator) !Column {
+            var result = try Column.init(allocator, self.statsOptions());
+            errdefer result.deinit();
+
+            try result.reserve(self.len(), self.span().len);
+            for (0..self.len()) |i| {
+                try result.append(trimming.trimmedSlice(self.get(i)));
+            }
+            return result;
+        }
+
+        /// split(separator)[0] of every row
+        ///
+        /// Rows without the separator are kept whole. An empty separator
+        /// keeps the first character of each row.
+        pub fn splitFirstField(self: Self, allocator: Allocator, separator: []const u8) !Column {
+            var result = try Column.init(allocator, self.statsOptions());
+            errdefer result.deinit();
+
+            try result.reserve(self.len(), self.span().len);
+            for (0..self.len()) |i| {
+                const row = self.get(i);
+                const end = if (separator.len == 0)
+                    @min(row.len, std.unicode.utf8ByteSequenceLength(if (row.len > 0) row[0] else 0) catch 1)
+                else
+                    std.mem.indexOf(u8, row, separator) orelse row.len;
+                try result.append(row[0..end]);
+            }
+            return result;
+        }
+
+        /// includes(needle) of every row, as a bitmap
+        pub fn includes(self: Self, allocator: Allocator, needle: []const u8) !Bitmap {
+            const bits = try Bitmap.init(allocator, self.len());
+            self.includesInto(bits, needle);
+            return bits;
+        }
+
+        /// Writes includes(needle) of every row into a cleared bitmap
+        ///
+        /// Searches the whole data span at once and maps each hit back to
+        /// its row, skipping to the next row after the first hit. Matches
+        /// that straddle a row boundary are ignored.
+        pub fn includesInto(self: Self, bits: Bitmap, needle: []const u8) void {
+            std.debug.assert(bits.len == self.len());
+            const offsets = self.offsets;
+            const end: usize = offsets[self.len()];
+            const data = self.data[0..end];
+
+            if (needle.len == 0) {
+                for (0..self.len()) |i| bits.set(i);
+                return;
+            }
+
+            var row: usize = 0;
+            var pos: usize = offsets[0];
+            while (pos < end) {
+                const hit = std.mem.indexOfPos(u8, data, pos, needle) orelse break;
+                while (offsets[row + 1] <= hit) row += 1;
+                const row_end: usize = offsets[row + 1];
+                if (hit + needle.len <= row_end) {
+                    bits.set(row);
+                    pos = row_end;
+                } else {
+                    pos = hit + 1;
+                }
+            }
+        }
+
+        /// startsWith(prefix) of every row, as a bitmap
+        pub fn startsWith(self: Self, allocator: Allocator, prefix: []const u8) !Bitmap {
+            const bits = try Bitmap.init(allocator, self.len());
+            self.startsWithInto(bits, prefix);
+            return bits;
+        }
+
+        /// Writes startsWith(prefix) of every row into a cleared bitmap
+        pub fn startsWithInto(self: Self, bits: Bitmap, prefix: []const u8) void {
+            std.debug.assert(bits.len == self.len());
+
+            for (0..self.len()) |i| {
+                const start: usize = self.offsets[i];
+                if (self.offsets[i + 1] - start >= prefix.len and
+                    std.mem.eql(u8, self.data[start .. start + prefix.len], prefix))
+                {
+                    bits.set(i);
+                }
+            }
+        }
+    };
+}
+
+/// Column with u32 offsets (up to 4 GiB of string data)
+pub const StringColumn = StringColumnOf(u32);
+
+/// Column with u64 offsets
+pub const LargeStringColumn = StringColumnOf(u64);
+
+/// Lowers ASCII letters from `src` into `dst` (same length)
+fn asciiLowerInto(dst: []u8, src: []const u8) void {
+    std.debug.assert(dst.len == src.len);
+
+    var i: usize = 0;
+    while (i + simd.lanes <= src.len) : (i += simd.lanes) {
+        const v = simd.load(src, i);
+        dst[i..][0..simd.lanes].* = v | (simd.inRange(v, 'A', 'Z') & simd.splat(0x20));
+    }
+    while (i < src.len) : (i += 1) {
+        dst[i] = std.ascii.toLower(src[i]);
+    }
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "StringColumn - append and get" {
+    const allocator = std.testing.allocator;
+
+    var col = try StringColumn.init(allocator, .{ .track_stats = true });
+    defer col.deinit();
+
+    try col.append("hello");
+    try col.append("");
+    try col.append("café 😀");
+
+    try std.testing.expectEqual(@as(usize, 3), col.len());
+    try std.testing.expectEqualStrings("hello", col.get(0));
+    try std.testing.expectEqualStrings("", col.get(1));
+    try std.testing.expectEqualStrings("café 😀", col.get(2));
+
+    try std.testing.expectEqual(@as(usize, 5), col.utf16Length(0));
+    try std.testing.expectEqual(@as(usize, 7), col.utf16Length(2));
+    try std.testing.expect(col.isAscii(0));
+    try std.testing.expect(col.isAscii(1));
+    try std.testing.expect(!col.isAscii(2));
+}
+
+test "StringColumn - lower ASCII and Unicode columns" {
+    const allocator = std.testing.allocator;
+
+    var ascii = try StringColumn.fromSlices(allocator, &[_][]const u8{ "HeLLo", "WORLD and a longer row of TEXT", "" }, .{});
+    defer ascii.deinit();
+    var lowered = try ascii.lower(allocator);
+    defer lowered.deinit();
+    try std.testing.expectEqualStrings("hello", lowered.get(0));
+    try std.testing.expectEqualStrings("world and a longer row of text", lowered.get(1));
+    try std.testing.expectEqualStrings("", lowered.get(2));
+
+    var mixed = try LargeStringColumn.fromSlices(allocator, &[_][]const u8{ "ABC", "CAFÉ" }, .{ .track_stats = true });
+    defer mixed.deinit();
+    var mixed_lower = try mixed.lower(allocator);
+    defer mixed_lower.deinit();
+    try std.testing.expectEqualStrings("abc", mixed_lower.get(0));
+    try std.testing.expectEqualStrings("café", mixed_lower.get(1));
+    try std.testing.expect(!mixed_lower.isAscii(1));
+}
+
+test "StringColumn - trim and splitFirstField" {
+    const allocator = std.testing.allocator;
+
+    var col = try StringColumn.fromSlices(allocator, &[_][]const u8{ "  GET /a  ", "\tPOST /b\n", "   " }, .{});
+    defer col.deinit();
+
+    var trimmed = try col.trim(allocator);
+    defer trimmed.deinit();
+    try std.testing.expectEqualStrings("GET /a", trimmed.get(0));
+    try std.testing.expectEqualStrings("POST /b", trimmed.get(1));
+    try std.testing.expectEqualStrings("", trimmed.get(2));
+
+    var methods = try trimmed.splitFirstField(allocator, " ");
+    defer methods.deinit();
+    try std.testing.expectEqualStrings("GET", methods.get(0));
+    try std.testing.expectEqualStrings("POST", methods.get(1));
+    try std.testing.expectEqualStrings("", methods.get(2));
+}
+
+test "StringColumn - includes ignores matches across rows" {
+    const allocator = std.testing.allocator;
+
+    var col = try StringColumn.fromSlices(allocator, &[_][]const u8{ "error: disk", "ok", "warn-err", "or", "", "errors errors" }, .{});
+    defer col.deinit();
+
+    var bits = try col.includes(allocator, "err");
+    defer bits.deinit(allocator);
+    try std.testing.expect(bits.isSet(0));
+    try std.testing.expect(!bits.isSet(1));
+    try std.testing.expect(bits.isSet(2));
+    try std.testing.expect(!bits.isSet(3));
+    try std.testing.expect(!bits.isSet(4));
+    try std.testing.expect(bits.isSet(5));
+    try std.testing.expectEqual(@as(usize, 3), bits.count());
+
+    // "ok" + "warn" would match "kw" only across the boundary
+    var straddle = try col.includes(allocator, "kw");
+    defer straddle.deinit(allocator);
+    try std.testing.expectEqual(@as(usize, 0), straddle.count());
+}
+
+test "StringColumn - startsWith" {
+    const allocator = std.testing.allocator;
+
+    var col = try StringColumn.fromSlices(allocator, &[_][]const u8{ "/api/users", "/static/x", "/api", "/ap" }, .{});
+    defer col.deinit();
+
+    var bits = try col.startsWith(allocator, "/api");
+    defer bits.deinit(allocator);
+    try std.testing.expect(bits.isSet(0));
+    try std.testing.expect(!bits.isSet(1));
+    try std.testing.expect(bits.isSet(2));
+    try std.testing.expect(!bits.isSet(3));
+}
@@ -0,0 +1,383 @@
+const std = @import("std");
+const column = @import("column.zig");
+const utility = @import("../methods/utility.zig");
+
+const Allocator = std.mem.Allocator;
+const Bitmap = column.Bitmap;
+const StringColumn = column.StringColumn;
+
+/// Per-row dictionary codes, stored at the narrowest width that fits
+///
+/// Starts as u8 and widens to u16 and then u32 as the dictionary grows.
+pub const Codes = union(enum) {
+    code8: std.ArrayList(u8),
+    code16: std.ArrayList(u16),
+    code32: std.ArrayList(u32),
+
+    pub fn len(self: Codes) usize {
+        return switch (self) {
+            inline else => |list| list.items.len,
+        };
+    }
+
+    pub inline fn get(self: Codes, i: usize) u32 {
+        return switch (self) {
+            inline else => |list| list.items[i],
+        };
+    }
+
+    fn deinit(self: *Codes, allocator: Allocator) void {
+        switch (self.*) {
+            inline else => |*list| list.deinit(allocator),
+        }
+    }
+
+    /// Largest code the current width can hold
+    fn maxCode(self: Codes) u32 {
+        return switch (self) {
+            inline else => |list| std.math.maxInt(@TypeOf(list.items[0])),
+        };
+    }
+
+    /// Re-encodes every code at the next wider width
+    fn widen(self: *Codes, allocator: Allocator) !void {
+        switch (self.*) {
+            .code8 => |*list| self.* = .{ .code16 = try widenList(u16, allocator, list) },
+            .code16 => |*list| self.* = .{ .code32 = try widenList(u32, allocator, list) },
+            .code32 => unreachable,
+        }
+    }
+
+    fn widenList(comptime T: type, allocator: Allocator, list: anytype) !std.ArrayList(T) {
+        var wide = try std.ArrayList(T).initCapacity(allocator, list.capacity);
+        for (list.items) |code| wide.appendAssumeCapacity(code);
+        list.deinit(allocator);
+        return wide;
+    }
+
+    fn append(self: *Codes, allocator: Allocator, code: u32) !void {
+        while (code > self.maxCode()) try self.widen(allocator);
+        switch (self.*) {
+            inline else => |*list| try list.append(allocator, @intCast(code)),
+        }
+    }
+};
+
+/// Hashes codes by the dictionary value they stand for
+const CodeContext = struct {
+    values: *const StringColumn,
+
+    pub fn hash(self: CodeContext, code: u32) u64 {
+        return std.hash.Wyhash.hash(0, self.values.get(code));
+    }
+
+    pub fn eql(_: CodeContext, a: u32, b: u32) bool {
+        return a == b;
+    }
+};
+
+/// Looks codes up by string value without storing slices in the map
+const ValueAdapter = struct {
+    values: *const StringColumn,
+
+    pub fn hash(_: ValueAdapter, value: []const u8) u64 {
+        return std.hash.Wyhash.hash(0, value);
+    }
+
+    pub fn eql(self: ValueAdapter, value: []const u8, code: u32) bool {
+        return std.mem.eql(u8, value, self.values.get(code));
+    }
+};
+
+const CodeMap = std.HashMapUnmanaged(u32, void, CodeContext, std.hash_map.default_max_load_percentage);
+
+/// Dictionary-encoded string column
+///
+/// Each distinct value is stored once in `values`; rows hold a code into
+/// it. For low-cardinality data (status, country, method) this is far
+/// smaller than one string per row, and per-value operations run once per
+/// dictionary entry and are broadcast to the rows through the codes.
+pub const DictionaryColumn = struct {
+    allocator: Allocator,
+    /// Distinct values in first-seen order; code `c` is `values.get(c)`
+    values: StringColumn,
+    codes: Codes = .{ .code8 = .{} },
+    /// Value -> code index (keys are codes, hashed by their value)
+    index: CodeMap = .{},
+
+    pub fn init(allocator: Allocator) !DictionaryColumn {
+        return .{
+            .allocator = allocator,
+            .values = try StringColumn.init(allocator, .{}),
+        };
+    }
+
+    /// Encodes every row of a column
+    pub fn fromColumn(allocator: Allocator, rows: StringColumn.View) !DictionaryColumn {
+        var self = try init(allocator);
+        errdefer self.deinit();
+
+        for (0..rows.len()) |i| {
+            try self.append(rows.get(i));
+        }
+        return self;
+    }
+
+    pub fn deinit(self: *DictionaryColumn) void {
+        self.values.deinit();
+        self.codes.deinit(self.allocator);
+        self.index.deinit(self.allocator);
+        self.* = undefined;
+    }
+
+    /// Returns the code for `value`, adding it to the dictionary if new
+    pub fn intern(self: *DictionaryColumn, value: []const u8) !u32 {
+        const ctx = CodeContext{ .values = &self.values };
+        const adapter = ValueAdapter{ .values = &self.values };
+
+        const entry = try self.index.getOrPutContextAdapted(self.allocator, value, adapter, ctx);
+        if (!entry.found_existing) {
+            const new_code: u32 = @intCast(self.values.len());
+            self.values.append(value) catch |err| {
+                self.index.removeByPtr(entry.key_ptr);
+                return err;
+            };
+            entry.key_ptr.* = new_code;
+        }
+        return entry.key_ptr.*;
+    }
+
+    /// Appends a row
+    pub fn append(self: *DictionaryColumn, value: []const u8) !void {
+        const value_code = try self.intern(value);
+        try self.codes.append(self.allocator, value_code);
+    }
+
+    /// Number of rows
+    pub inline fn len(self: DictionaryColumn) usize {
+        return self.codes.len();
+    }
+
+    /// Number of distinct values
+    pub inline fn cardinality(self: DictionaryColumn) usize {
+        return self.values.len();
+    }
+
+    /// Dictionary code of row `i`
+    pub inline fn code(self: DictionaryColumn, i: usize) u32 {
+        return self.codes.get(i);
+    }
+
+    /// Value of row `i`
+    pub inline fn get(self: DictionaryColumn, i: usize) []const u8 {
+        return self.values.get(self.codes.get(i));
+    }
+
+    /// Expands back to one string per row
+    pub fn decode(self: DictionaryColumn, allocator: Allocator) !StringColumn {
+        var result = try StringColumn.init(allocator, .{});
+        errdefer result.deinit();
+
+        for (0..self.len()) |i| {
+            try result.append(self.get(i));
+        }
+        return result;
+    }
+
+    // ========================================================================
+    // Column Operations (evaluated once per dictionary entry)
+    // ========================================================================
+
+    /// toLowerCase() of every row
+    ///
+    /// Lowers each distinct value once. Values that collide after lowering
+    /// ("GET", "get") merge into one entry, and the codes are remapped
+    /// through a per-entry table.
+    pub fn lower(self: DictionaryColumn, allocator: Allocator) !DictionaryColumn {
+        var lowered = try self.values.lower(allocator);
+        defer lowered.deinit();
+        return self.remap(allocator, lowered);
+    }
+
+    /// Builds a new column whose row `i` is `mapped.get(self.code(i))`
+    fn remap(self: DictionaryColumn, allocator: Allocator, mapped: StringColumn) !DictionaryColumn {
+        var result = try init(allocator);
+        errdefer result.deinit();
+
+        const table = try allocator.alloc(u32, mapped.len());
+        defer allocator.free(table);
+        for (table, 0..) |*slot, c| {
+            slot.* = try result.intern(mapped.get(c));
+        }
+
+        switch (result.codes) {
+            inline else => |*list| try list.ensureTotalCapacity(allocator, self.len()),
+        }
+        for (0..self.len()) |i| {
+            try result.codes.append(allocator, table[self.code(i)]);
+        }
+        return result;
+    }
+
+    /// Broadcasts a per-entry bitmap to the rows
+    fn broadcast(self: DictionaryColumn, allocator: Allocator, per_entry: Bitmap) !Bitmap {
+        const bits = try Bitmap.init(allocator, self.len());
+        switch (self.codes) {
+            inline else => |list| for (list.items, 0..) |c, i| {
+                if (per_entry.isSet(c)) bits.set(i);
+            },
+        }
+        return bits;
+    }
+
+    /// includes(needle) of every row, as a bitmap
+    pub fn includes(self: DictionaryColumn, allocator: Allocator, needle: []const u8) !Bitmap {
+        var per_entry = try self.values.includes(allocator, needle);
+        defer per_entry.deinit(allocator);
+        return self.broadcast(allocator, per_entry);
+    }
+
+    /// startsWith(prefix) of every row, as a bitmap
+    pub fn startsWith(self: DictionaryColumn, allocator: Allocator, prefix: []const u8) !Bitmap {
+        var per_entry = try self.values.startsWith(allocator, prefix);
+        defer per_entry.deinit(allocator);
+        return self.broadcast(allocator, per_entry);
+    }
+
+    /// localeCompare(that) of every row, as -1, 0 or 1
+    pub fn localeCompare(self: DictionaryColumn, allocator: Allocator, that: []const u8) ![]i8 {
+        const per_entry = try allocator.alloc(i8, self.cardinality());
+        defer allocator.free(per_entry);
+        for (per_entry, 0..) |*slot, c| {
+            slot.* = @intCast(std.math.sign(utility.localeCompare(self.values.get(c), that, null, null)));
+        }
+
+        const result = try allocator.alloc(i8, self.len());
+        for (result, 0..) |*slot, i| {
+            slot.* = per_entry[self.code(i)];
+        }
+        return result;
+    }
+
+    /// Sort rank of each dictionary entry under localeCompare()
+    ///
+    /// Rows can then be ordered by `ranks[code(i)]` with plain integer
+    /// comparisons instead of string comparisons. Equal values share a rank.
+    pub fn sortRanks(self: DictionaryColumn, allocator: Allocator) ![]u32 {
+        const count = self.cardinality();
+        const order = try allocator.alloc(u32, count);
+        defer allocator.free(order);
+        for (order, 0..) |*slot, c| slot.* = @intCast(c);
+
+        const SortContext = struct {
+            values: *const StringColumn,
+            fn lessThan(ctx: @This(), a: u32, b: u32) bool {
+                return utility.localeCompare(ctx.values.get(a), ctx.values.get(b), null, null) < 0;
+            }
+        };
+        std.mem.sort(u32, order, SortContext{ .values = &self.values }, SortContext.lessThan);
+
+        const ranks = try allocator.alloc(u32, count);
+        var rank: u32 = 0;
+        for (order, 0..) |c, pos| {
+            if (pos > 0 and SortContext.lessThan(.{ .values = &self.values }, order[pos - 1], c)) rank += 1;
+            ranks[c] = rank;
+        }
+        return ranks;
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "DictionaryColumn - encode and decode" {
+    const allocator = std.testing.allocator;
+
+    var dict = try DictionaryColumn.init(allocator);
+    defer dict.deinit();
+
+    for ([_][]const u8{ "GET", "POST", "GET", "GET", "DELETE", "POST" }) |v| {
+        try dict.append(v);
+    }
+
+    try std.testing.expectEqual(@as(usize, 6), dict.len());
+    try std.testing.expectEqual(@as(usize, 3), dict.cardinality());
+    try std.testing.expectEqual(@as(u32, 0), dict.code(2));
+    try std.testing.expectEqual(@as(u32, 2), dict.code(4));
+    try std.testing.expectEqualStrings("POST", dict.get(5));
+
+    var decoded = try dict.decode(allocator);
+    defer decoded.deinit();
+    try std.testing.expectEqualStrings("DELETE", decoded.get(4));
+}
+
+test "DictionaryColumn - codes widen past 256 entries" {
+    const allocator = std.testing.allocator;
+
+    var dict = try DictionaryColumn.init(allocator);
+    defer dict.deinit();
+
+    var buf: [16]u8 = undefined;
+    for (0..300) |n| {
+        try dict.append(try std.fmt.bufPrint(&buf, "v{d}", .{n}));
+    }
+    try dict.append("v7");
+
+    try std.testing.expect(dict.codes == .code16);
+    try std.testing.expectEqual(@as(usize, 300), dict.cardinality());
+    try std.testing.expectEqual(@as(u32, 299), dict.code(299));
+    try std.testing.expectEqual(@as(u32, 7), dict.code(300));
+    try std.testing.expectEqualStrings("v123", dict.get(123));
+}
+
+test "DictionaryColumn - lower merges colliding values" {
+    const allocator = std.testing.allocator;
+
+    var dict = try DictionaryColumn.init(allocator);
+    defer dict.deinit();
+    for ([_][]const u8{ "GET", "get", "Post", "GET" }) |v| try dict.append(v);
+
+    var lowered = try dict.lower(allocator);
+    defer lowered.deinit();
+
+    try std.testing.expectEqual(@as(usize, 2), lowered.cardinality());
+    try std.testing.expectEqualStrings("get", lowered.get(1));
+    try std.testing.expectEqualStrings("post", lowered.get(2));
+    try std.testing.expectEqual(lowered.code(0), lowered.code(3));
+}
+
+test "DictionaryColumn - predicates broadcast to rows" {
+    const allocator = std.testing.allocator;
+
+    var dict = try DictionaryColumn.init(allocator);
+    defer dict.deinit();
+    for ([_][]const u8{ "us-east", "eu-west", "us-west", "eu-west" }) |v| try dict.append(v);
+
+    var west = try dict.includes(allocator, "west");
+    defer west.deinit(allocator);
+    try std.testing.expect(!west.isSet(0));
+    try std.testing.expect(west.isSet(1));
+    try std.testing.expect(west.isSet(2));
+    try std.testing.expect(west.isSet(3));
+
+    var us = try dict.startsWith(allocator, "us");
+    defer us.deinit(allocator);
+    try std.testing.expectEqual(@as(usize, 2), us.count());
+
+    const cmp = try dict.localeCompare(allocator, "eu-west");
+    defer allocator.free(cmp);
+    try std.testing.expectEqualSlices(i8, &[_]i8{ 1, 0, 1, 0 }, cmp);
+}
+
+test "DictionaryColumn - sortRanks" {
+    const allocator = std.testing.allocator;
+
+    var dict = try DictionaryColumn.init(allocator);
+    defer dict.deinit();
+    for ([_][]const u8{ "charlie", "alpha", "bravo", "alpha" }) |v| try dict.append(v);
+
+    const ranks = try dict.sortRanks(allocator);
+    defer allocator.free(ranks);
+    try std.testing.expectEqualSlices(u32, &[_]u32{ 2, 0, 1 }, ranks);
+}
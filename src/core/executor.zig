@@ -0,0 +1,334 @@
+// Bounded work queue and worker threads for offloading string work
+//
+// An Executor owns a fixed set of worker threads fed from a ring buffer of
+// intrusive Task pointers. submit() blocks while the ring is full, which
+// pushes back on producers that outrun the workers; trySubmit() returns
+// error.QueueFull instead.
+//
+// A Task is embedded in the caller's own struct (recover it with
+// @fieldParentPtr) and stays owned by the caller, who may free it once it
+// has completed. Executor.cancel() takes a queued task off the queue and
+// completes it at once; a running task sees isCancelled() and may stop
+// early. Tasks still queued at deinit() complete as cancelled.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+
+pub const Options = struct {
+    /// Worker threads (0: one per CPU)
+    workers: usize = 0,
+    /// Queued tasks before submit() blocks
+    capacity: usize = 64,
+};
+
+pub const Task = struct {
+    /// The work itself; long-running work should poll isCancelled()
+    runFn: *const fn (task: *Task) void,
+    /// Runs on the completing thread just before waiters are woken
+    completeFn: ?*const fn (task: *Task) void = null,
+    /// Runs after waiters are woken, as the completing thread's last use of
+    /// the task; lets an owner free the task from inside completeFn
+    releaseFn: ?*const fn (task: *Task) void = null,
+    state: std.atomic.Value(State) = .init(.pending),
+    cancel_requested: std.atomic.Value(bool) = .init(false),
+    finished: std.Thread.ResetEvent = .{},
+
+    pub const State = enum(u8) { pending, running, done, cancelled };
+
+    /// Ask the task to stop; a running task finishes when its runFn next
+    /// checks. Executor.cancel() also pulls a queued task off the queue.
+    pub fn cancel(self: *Task) void {
+        self.cancel_requested.store(true, .release);
+    }
+
+    /// Complete a task taken off the queue with Executor.remove()
+    pub fn finishCancelled(self: *Task) void {
+        self.state.store(.cancelled, .release);
+        self.complete();
+    }
+
+    pub fn isCancelled(self: *const Task) bool {
+        return self.cancel_requested.load(.acquire);
+    }
+
+    /// True once the task has completed (done or cancelled)
+    pub fn poll(self: *const Task) bool {
+        return self.finished.isSet();
+    }
+
+    pub fn wait(self: *Task) void {
+        self.finished.wait();
+    }
+
+    pub fn timedWait(self: *Task, timeout_ns: u64) error{Timeout}!void {
+        return self.finished.timedWait(timeout_ns);
+    }
+
+    /// Final state; only meaningful once poll() is true
+    pub fn result(self: *const Task) State {
+        return self.state.load(.acquire);
+    }
+
+    fn execute(self: *Task) void {
+        if (!self.isCancelled()) {
+            self.state.store(.running, .release);
+            self.runFn(self);
+        }
+        self.state.store(if (self.isCancelled()) .cancelled else .done, .release);
+        self.complete();
+    }
+
+    fn complete(self: *Task) void {
+        if (self.completeFn) |f| f(self);
+        const release = self.releaseFn;
+        // Unless a releaseFn holds it back, the owner may free the task as
+        // soon as this returns
+        self.finished.set();
+        if (release) |f| f(self);
+    }
+};
+
+pub const Executor = struct {
+    allocator: Allocator,
+    mutex: std.Thread.Mutex = .{},
+    not_empty: std.Thread.Condition = .{},
+    not_full: std.Thread.Condition = .{},
+    queue: []*Task,
+    head: usize = 0,
+    count: usize = 0,
+    shutting_down: bool = false,
+    threads: []std.Thread,
+
+    /// Start the workers; call deinit() to stop them
+    pub fn init(allocator: Allocator, options: Options) !*Executor {
+        if (options.capacity == 0) return error.InvalidArgument;
+        const workers = if (options.workers > 0) options.workers else std.Thread.getCpuCount() catch 1;
+
+        const self = try allocator.create(Executor);
+        errdefer allocator.destroy(self);
+        const queue = try allocator.alloc(*Task, options.capacity);
+        errdefer allocator.free(queue);
+        const threads = try allocator.alloc(std.Thread, workers);
+        errdefer allocator.free(threads);
+
+        self.* = .{ .allocator = allocator, .queue = queue, .threads = threads };
+
+        var spawned: usize = 0;
+        errdefer {
+            self.stop();
+            for (threads[0..spawned]) |t| t.join();
+        }
+        while (spawned < workers) : (spawned += 1) {
+            threads[spawned] = try std.Thread.spawn(.{}, worker, .{self});
+        }
+        return self;
+    }
+
+    /// Cancel whatever is still queued, wait for running tasks, and free
+    /// the executor
+    pub fn deinit(self: *Executor) void {
+        self.stop();
+        for (self.threads) |t| t.join();
+        const allocator = self.allocator;
+        allocator.free(self.threads);
+        allocator.free(self.queue);
+        allocator.destroy(self);
+    }
+
+    /// Queue a task, blocking while the queue is full
+    pub fn submit(self: *Executor, task: *Task) error{ShuttingDown}!void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        while (self.count == self.queue.len and !self.shutting_down) {
+            self.not_full.wait(&self.mutex);
+        }
+        if (self.shutting_down) return error.ShuttingDown;
+        self.push(task);
+    }
+
+    /// Queue a task, or return error.QueueFull without waiting
+    pub fn trySubmit(self: *Executor, task: *Task) error{ ShuttingDown, QueueFull }!void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        if (self.shutting_down) return error.ShuttingDown;
+        if (self.count == self.queue.len) return error.QueueFull;
+        self.push(task);
+    }
+
+    /// Tasks waiting for a worker
+    pub fn pending(self: *Executor) usize {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        return self.count;
+    }
+
+    /// Cancel a task submitted here: a queued task is removed and completes
+    /// as cancelled right away, a running one is asked to stop. The caller
+    /// must keep the executor alive for the duration of the call.
+    pub fn cancel(self: *Executor, task: *Task) void {
+        task.cancel();
+        if (self.remove(task)) task.finishCancelled();
+    }
+
+    fn push(self: *Executor, task: *Task) void {
+        self.queue[(self.head + self.count) % self.queue.len] = task;
+        self.count += 1;
+        self.not_empty.signal();
+    }
+
+    /// Take a task off the queue without completing it (see
+    /// Task.finishCancelled); false if it is not queued here
+    pub fn remove(self: *Executor, task: *Task) bool {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        for (0..self.count) |i| {
+            if (self.queue[(self.head + i) % self.queue.len] != task) continue;
+            for (i..self.count - 1) |j| {
+                self.queue[(self.head + j) % self.queue.len] = self.queue[(self.head + j + 1) % self.queue.len];
+            }
+            self.count -= 1;
+            self.not_full.signal();
+            return true;
+        }
+        return false;
+    }
+
+    /// Make blocked and future submit() calls fail with error.ShuttingDown;
+    /// deinit() does this first, and is still needed to free the executor
+    pub fn stop(self: *Executor) void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        self.shutting_down = true;
+        self.not_empty.broadcast();
+        self.not_full.broadcast();
+    }
+
+    fn worker(self: *Executor) void {
+        while (true) {
+            self.mutex.lock();
+            while (self.count == 0 and !self.shutting_down) {
+                self.not_empty.wait(&self.mutex);
+            }
+            if (self.count == 0) {
+                self.mutex.unlock();
+                return;
+            }
+            const task = self.queue[self.head];
+            self.head = (self.head + 1) % self.queue.len;
+            self.count -= 1;
+            const draining = self.shutting_down;
+            self.not_full.signal();
+            self.mutex.unlock();
+
+            if (draining) task.cancel_requested.store(true, .release);
+            task.execute();
+        }
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+const CountTask = struct {
+    task: Task = .{ .runFn = run },
+    counter: *std.atomic.Value(usize),
+
+    fn run(task: *Task) void {
+        const self: *CountTask = @fieldParentPtr("task", task);
+        _ = self.counter.fetchAdd(1, .monotonic);
+    }
+};
+
+test "Executor - runs every submitted task" {
+    const allocator = std.testing.allocator;
+    const pool = try Executor.init(allocator, .{ .workers = 3, .capacity = 4 });
+    defer pool.deinit();
+
+    var counter = std.atomic.Value(usize).init(0);
+    var tasks: [32]CountTask = undefined;
+    for (&tasks) |*t| {
+        t.* = .{ .counter = &counter };
+        try pool.submit(&t.task);
+    }
+    for (&tasks) |*t| {
+        t.task.wait();
+        try std.testing.expectEqual(Task.State.done, t.task.result());
+    }
+    try std.testing.expectEqual(@as(usize, 32), counter.load(.monotonic));
+}
+
+const GateTask = struct {
+    task: Task = .{ .runFn = run },
+    started: std.Thread.ResetEvent = .{},
+
+    fn run(task: *Task) void {
+        const self: *GateTask = @fieldParentPtr("task", task);
+        self.started.set();
+        while (!task.isCancelled()) std.Thread.yield() catch {};
+    }
+};
+
+test "Executor - trySubmit reports a full queue and cancel unblocks" {
+    const allocator = std.testing.allocator;
+    const pool = try Executor.init(allocator, .{ .workers = 1, .capacity = 1 });
+    defer pool.deinit();
+
+    // Occupy the only worker, then fill the queue
+    var busy = GateTask{};
+    try pool.submit(&busy.task);
+    busy.started.wait();
+
+    var counter = std.atomic.Value(usize).init(0);
+    var queued = CountTask{ .counter = &counter };
+    try pool.trySubmit(&queued.task);
+
+    var extra = CountTask{ .counter = &counter };
+    try std.testing.expectError(error.QueueFull, pool.trySubmit(&extra.task));
+
+    // A queued task completes as soon as it is cancelled
+    pool.cancel(&queued.task);
+    try std.testing.expect(queued.task.poll());
+    try std.testing.expectEqual(Task.State.cancelled, queued.task.result());
+
+    busy.task.cancel();
+    busy.task.wait();
+    try std.testing.expectEqual(Task.State.cancelled, busy.task.result());
+    try std.testing.expectEqual(@as(usize, 0), counter.load(.monotonic));
+}
+
+const SharedTask = struct {
+    task: Task = .{ .runFn = run, .releaseFn = release },
+    /// One for the submitter, one for the completing thread
+    refs: std.atomic.Value(u8) = .init(2),
+    allocator: Allocator,
+
+    fn run(_: *Task) void {}
+
+    fn release(task: *Task) void {
+        const self: *SharedTask = @fieldParentPtr("task", task);
+        self.drop();
+    }
+
+    fn drop(self: *SharedTask) void {
+        if (self.refs.fetchSub(1, .acq_rel) == 1) self.allocator.destroy(self);
+    }
+};
+
+test "Executor - releaseFn is the completing thread's last use" {
+    const allocator = std.testing.allocator;
+    const pool = try Executor.init(allocator, .{ .workers = 2, .capacity = 8 });
+    defer pool.deinit();
+
+    for (0..16) |_| {
+        const shared = try allocator.create(SharedTask);
+        shared.* = .{ .allocator = allocator };
+        try pool.submit(&shared.task);
+        shared.task.wait();
+        try std.testing.expectEqual(Task.State.done, shared.task.result());
+        shared.drop();
+    }
+}
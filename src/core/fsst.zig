@@ -0,0 +1,603 @@
+const std = @import("std");
+const column = @import("column.zig");
+const ZString = @import("string.zig").ZString;
+
+const Allocator = std.mem.Allocator;
+const Bitmap = column.Bitmap;
+
+/// Code that marks the next byte as a literal
+pub const escape_code: u8 = 255;
+
+/// Maximum number of symbols (codes 0..254)
+pub const max_symbols = 255;
+
+/// Longest symbol in bytes
+pub const max_symbol_len = 8;
+
+/// Bytes of input sampled when building a symbol table
+pub const sample_target = 1 << 15;
+
+/// Rounds of count-and-select used to refine the symbol table
+const generations = 5;
+
+/// A symbol: 1 to 8 bytes, zero padded
+pub const Symbol = struct {
+    bytes: [max_symbol_len]u8 = [_]u8{0} ** max_symbol_len,
+    len: u8 = 0,
+
+    fn fromSlice(s: []const u8) Symbol {
+        var sym = Symbol{ .len = @intCast(s.len) };
+        @memcpy(sym.bytes[0..s.len], s);
+        return sym;
+    }
+
+    inline fn slice(self: *const Symbol) []const u8 {
+        return self.bytes[0..self.len];
+    }
+
+    fn key(self: Symbol) u64 {
+        return std.mem.readInt(u64, &self.bytes, .little) ^ (@as(u64, self.len) << 60);
+    }
+};
+
+/// FSST-style static symbol table
+///
+/// Maps up to 255 frequent substrings (1..8 bytes) to one-byte codes; any
+/// other byte is written as `escape_code` followed by the byte itself.
+/// Encoding is greedy longest-match, so a given table always compresses
+/// the same input to the same codes, which makes compressed equality exact.
+pub const SymbolTable = struct {
+    /// Symbols sorted by first byte, then by length (longest first)
+    symbols: [max_symbols]Symbol = [_]Symbol{.{}} ** max_symbols,
+    count: usize = 0,
+    /// Codes starting with byte `b` are `bucket_start[b]..bucket_start[b + 1]`
+    bucket_start: [257]u16 = [_]u16{0} ** 257,
+    /// byteSignature() of every symbol, by code
+    signatures: [max_symbols]u64 = [_]u64{0} ** max_symbols,
+
+    /// Builds a table from sample strings
+    ///
+    /// Starts empty and, for a few generations, compresses the sample with
+    /// the current table, counts how often each symbol and each adjacent
+    /// symbol pair occurs, and keeps the 255 candidates with the highest
+    /// gain (frequency x length).
+    pub fn build(allocator: Allocator, sample: []const []const u8) !SymbolTable {
+        var table = SymbolTable{};
+
+        const single = try allocator.alloc(u32, 512);
+        defer allocator.free(single);
+        const pairs = try allocator.alloc(u32, 512 * 512);
+        defer allocator.free(pairs);
+
+        var gains = std.AutoHashMap(Symbol, u64).init(allocator);
+        defer gains.deinit();
+        var candidates = std.ArrayList(Candidate){};
+        defer candidates.deinit(allocator);
+
+        for (0..generations) |_| {
+            @memset(single, 0);
+            @memset(pairs, 0);
+
+            for (sample) |str| {
+                var pos: usize = 0;
+                var prev: ?u16 = null;
+                while (pos < str.len) {
+                    var cur: u16 = 256 + @as(u16, str[pos]);
+                    var advance: usize = 1;
+                    if (table.longestMatch(str, pos)) |c| {
+                        cur = c;
+                        advance = table.symbols[c].len;
+                        // Keep the first byte in play so it can win on its own
+                        if (advance > 1) single[256 + @as(u16, str[pos])] += 1;
+                    }
+                    single[cur] += 1;
+                    if (prev) |p| pairs[@as(usize, p) * 512 + cur] += 1;
+                    prev = cur;
+                    pos += advance;
+                }
+            }
+
+            gains.clearRetainingCapacity();
+            for (0..512) |a| {
+                if (single[a] == 0) continue;
+                const sym_a = table.symbolOf(@intCast(a));
+                try addGain(&gains, sym_a, single[a]);
+
+                for (0..512) |b| {
+                    const n = pairs[a * 512 + b];
+                    if (n == 0) continue;
+                    const sym_b = table.symbolOf(@intCast(b));
+                    if (sym_a.len + sym_b.len > max_symbol_len) continue;
+
+                    var joined = sym_a;
+                    @memcpy(joined.bytes[sym_a.len .. sym_a.len + sym_b.len], sym_b.slice());
+                    joined.len += sym_b.len;
+                    try addGain(&gains, joined, n);
+                }
+            }
+
+            candidates.clearRetainingCapacity();
+            var it = gains.iterator();
+            while (it.next()) |entry| {
+                try candidates.append(allocator, .{ .symbol = entry.key_ptr.*, .gain = entry.value_ptr.* });
+            }
+            std.mem.sort(Candidate, candidates.items, {}, Candidate.better);
+
+            table = SymbolTable{};
+            for (candidates.items[0..@min(max_symbols, candidates.items.len)]) |cand| {
+                table.symbols[table.count] = cand.symbol;
+                table.count += 1;
+            }
+            table.finalize();
+        }
+
+        return table;
+    }
+
+    const Candidate = struct {
+        symbol: Symbol,
+        gain: u64,
+
+        fn better(_: void, a: Candidate, b: Candidate) bool {
+            if (a.gain != b.gain) return a.gain > b.gain;
+            return a.symbol.key() < b.symbol.key();
+        }
+    };
+
+    fn addGain(gains: *std.AutoHashMap(Symbol, u64), sym: Symbol, n: u32) !void {
+        const entry = try gains.getOrPut(sym);
+        if (!entry.found_existing) entry.value_ptr.* = 0;
+        entry.value_ptr.* += @as(u64, n) * sym.len;
+    }
+
+    /// Symbol for a code, or for a pseudo-code 256 + b (escaped byte b)
+    fn symbolOf(self: *const SymbolTable, code: u16) Symbol {
+        if (code >= 256) return Symbol.fromSlice(&[_]u8{@intCast(code - 256)});
+        return self.symbols[code];
+    }
+
+    /// Sorts symbols into first-byte buckets (longest first) and indexes them
+    fn finalize(self: *SymbolTable) void {
+        const Order = struct {
+            fn lessThan(_: void, a: Symbol, b: Symbol) bool {
+                if (a.bytes[0] != b.bytes[0]) return a.bytes[0] < b.bytes[0];
+                return a.len > b.len;
+            }
+        };
+        std.mem.sort(Symbol, self.symbols[0..self.count], {}, Order.lessThan);
+
+        var counts = [_]u16{0} ** 256;
+        for (self.symbols[0..self.count]) |sym| counts[sym.bytes[0]] += 1;
+        var start: u16 = 0;
+        for (0..256) |b| {
+            self.bucket_start[b] = start;
+            start += counts[b];
+        }
+        self.bucket_start[256] = start;
+
+        for (self.symbols[0..self.count], self.signatures[0..self.count]) |sym, *sig| {
+            sig.* = byteSignature(sym.slice());
+        }
+    }
+
+    /// Decompressed length and byte signature of a code stream
+    ///
+    /// Reads each code once and writes nothing, so it is much cheaper than
+    /// decompress().
+    pub fn summarize(self: *const SymbolTable, codes: []const u8) Summary {
+        var summary = Summary{};
+        var i: usize = 0;
+        while (i < codes.len) : (i += 1) {
+            const c = codes[i];
+            if (c == escape_code) {
+                i += 1;
+                summary.len += 1;
+                summary.signature |= byteBit(codes[i]);
+            } else {
+                summary.len += self.symbols[c].len;
+                summary.signature |= self.signatures[c];
+            }
+        }
+        return summary;
+    }
+
+    pub const Summary = struct {
+        len: usize = 0,
+        signature: u64 = 0,
+    };
+
+    /// Code of the longest symbol matching `str` at `pos`
+    pub inline fn longestMatch(self: *const SymbolTable, str: []const u8, pos: usize) ?u8 {
+        const first = str[pos];
+        const rest = str[pos..];
+        var c = self.bucket_start[first];
+        const end = self.bucket_start[@as(usize, first) + 1];
+        while (c < end) : (c += 1) {
+            const sym = &self.symbols[c];
+            if (sym.len <= rest.len and std.mem.eql(u8, sym.slice(), rest[0..sym.len])) return @intCast(c);
+        }
+        return null;
+    }
+
+    /// Appends the compressed form of `str` to `out`
+    pub fn compress(self: *const SymbolTable, allocator: Allocator, str: []const u8, out: *std.ArrayList(u8)) !void {
+        // Worst case: every byte escaped
+        try out.ensureUnusedCapacity(allocator, str.len * 2);
+
+        var pos: usize = 0;
+        while (pos < str.len) {
+            if (self.longestMatch(str, pos)) |c| {
+                out.appendAssumeCapacity(c);
+                pos += self.symbols[c].len;
+            } else {
+                out.appendAssumeCapacity(escape_code);
+                out.appendAssumeCapacity(str[pos]);
+                pos += 1;
+            }
+        }
+    }
+
+    /// Appends the decompressed form of `codes` to `out`
+    pub fn decompress(self: *const SymbolTable, allocator: Allocator, codes: []const u8, out: *std.ArrayList(u8)) !void {
+        // Every code expands to at most 8 bytes; full 8-byte stores avoid
+        // a variable-length copy per symbol
+        try out.ensureUnusedCapacity(allocator, codes.len * max_symbol_len);
+
+        var len = out.items.len;
+        const buf = out.allocatedSlice();
+        var i: usize = 0;
+        while (i < codes.len) : (i += 1) {
+            const c = codes[i];
+            if (c == escape_code) {
+                i += 1;
+                buf[len] = codes[i];
+                len += 1;
+            } else {
+                const sym = &self.symbols[c];
+                buf[len..][0..max_symbol_len].* = sym.bytes;
+                len += sym.len;
+            }
+        }
+        out.items.len = len;
+    }
+
+    /// Decompresses just enough of `codes` to fill `buf`; returns bytes written
+    pub fn decompressPrefix(self: *const SymbolTable, codes: []const u8, buf: []u8) usize {
+        var len: usize = 0;
+        var i: usize = 0;
+        while (i < codes.len and len < buf.len) : (i += 1) {
+            const c = codes[i];
+            if (c == escape_code) {
+                i += 1;
+                buf[len] = codes[i];
+                len += 1;
+            } else {
+                const sym = self.symbols[c].slice();
+                const n = @min(sym.len, buf.len - len);
+                @memcpy(buf[len .. len + n], sym[0..n]);
+                len += n;
+            }
+        }
+        return len;
+    }
+};
+
+/// One bit per byte value, folded to 64 bits (low six bits of the byte)
+inline fn byteBit(b: u8) u64 {
+    return @as(u64, 1) << @as(u6, @truncate(b));
+}
+
+/// Bloom-style set of the bytes in `bytes`
+///
+/// A string can only contain a needle if its signature covers the needle's.
+pub fn byteSignature(bytes: []const u8) u64 {
+    var sig: u64 = 0;
+    for (bytes) |b| sig |= byteBit(b);
+    return sig;
+}
+
+/// A needle compressed with a container's symbol table
+pub const CompressedNeedle = struct {
+    raw: []const u8,
+    codes: []u8,
+    /// byteSignature() of `raw`
+    signature: u64,
+
+    pub fn deinit(self: *CompressedNeedle, allocator: Allocator) void {
+        allocator.free(self.codes);
+        self.* = undefined;
+    }
+};
+
+/// Collection of strings compressed with one shared symbol table
+///
+/// Rows are stored back to back as code streams with u32 offsets, like
+/// StringColumn. Individual rows decompress independently, and equality,
+/// startsWith and includes compare against a needle compressed with the
+/// same table.
+pub const CompressedStrings = struct {
+    allocator: Allocator,
+    table: SymbolTable,
+    codes: std.ArrayList(u8) = .{},
+    offsets: std.ArrayList(u32) = .{},
+    /// Total bytes before compression
+    raw_bytes: usize = 0,
+
+    /// Builds a symbol table from a sample of `strings` and compresses them all
+    pub fn build(allocator: Allocator, strings: []const []const u8) !CompressedStrings {
+        var total: usize = 0;
+        for (strings) |s| total += s.len;
+
+        // Evenly strided sample of about sample_target bytes
+        var sample = std.ArrayList([]const u8){};
+        defer sample.deinit(allocator);
+        const stride = total / sample_target + 1;
+        var i: usize = 0;
+        while (i < strings.len) : (i += stride) {
+            try sample.append(allocator, strings[i]);
+        }
+
+        var self = try withTable(allocator, try SymbolTable.build(allocator, sample.items));
+        errdefer self.deinit();
+
+        try self.codes.ensureTotalCapacity(allocator, total);
+        try self.offsets.ensureTotalCapacity(allocator, strings.len + 1);
+        for (strings) |s| try self.append(s);
+        return self;
+    }
+
+    /// Creates an empty container that compresses with an existing table
+    pub fn withTable(allocator: Allocator, table: SymbolTable) !CompressedStrings {
+        var self = CompressedStrings{ .allocator = allocator, .table = table };
+        try self.offsets.append(allocator, 0);
+        return self;
+    }
+
+    pub fn deinit(self: *CompressedStrings) void {
+        self.codes.deinit(self.allocator);
+        self.offsets.deinit(self.allocator);
+        self.* = undefined;
+    }
+
+    /// Compresses and appends a string
+    pub fn append(self: *CompressedStrings, str: []const u8) !void {
+        try self.offsets.ensureUnusedCapacity(self.allocator, 1);
+        try self.table.compress(self.allocator, str, &self.codes);
+        if (self.codes.items.len > std.math.maxInt(u32)) return error.OffsetOverflow;
+        self.offsets.appendAssumeCapacity(@intCast(self.codes.items.len));
+        self.raw_bytes += str.len;
+    }
+
+    /// Number of strings
+    pub inline fn len(self: CompressedStrings) usize {
+        return self.offsets.items.len - 1;
+    }
+
+    /// Compressed size in bytes (codes only)
+    pub inline fn compressedBytes(self: CompressedStrings) usize {
+        return self.codes.items.len;
+    }
+
+    /// Code stream of row `i`
+    pub inline fn codesOf(self: CompressedStrings, i: usize) []const u8 {
+        return self.codes.items[self.offsets.items[i]..self.offsets.items[i + 1]];
+    }
+
+    /// Appends row `i`, decompressed, to `out` (which uses `allocator`)
+    pub fn getInto(self: CompressedStrings, allocator: Allocator, i: usize, out: *std.ArrayList(u8)) !void {
+        try self.table.decompress(allocator, self.codesOf(i), out);
+    }
+
+    /// Decompresses row `i` into an owned ZString
+    pub fn get(self: CompressedStrings, allocator: Allocator, i: usize) !ZString {
+        var out = std.ArrayList(u8){};
+        errdefer out.deinit(allocator);
+        try self.table.decompress(allocator, self.codesOf(i), &out);
+        return ZString.fromOwned(allocator, try out.toOwnedSlice(allocator));
+    }
+
+    /// Compresses a needle for the equality/startsWith/includes tests
+    pub fn prepare(self: CompressedStrings, allocator: Allocator, needle: []const u8) !CompressedNeedle {
+        var codes = std.ArrayList(u8){};
+        errdefer codes.deinit(allocator);
+        try self.table.compress(allocator, needle, &codes);
+        return .{
+            .raw = needle,
+            .codes = try codes.toOwnedSlice(allocator),
+            .signature = byteSignature(needle),
+        };
+    }
+
+    /// Row `i` equals the needle (compared fully on compressed codes)
+    pub fn equalsAt(self: CompressedStrings, i: usize, needle: CompressedNeedle) bool {
+        return std.mem.eql(u8, self.codesOf(i), needle.codes);
+    }
+
+    /// Row `i` starts with the needle
+    ///
+    /// A code-level prefix match is conclusive. Otherwise the row may
+    /// still match with a symbol that straddles the end of the needle, so
+    /// only the first needle.raw.len bytes are decompressed and compared.
+    pub fn startsWithAt(self: CompressedStrings, i: usize, needle: CompressedNeedle, scratch: *std.ArrayList(u8)) Allocator.Error!bool {
+        const row = self.codesOf(i);
+        if (std.mem.startsWith(u8, row, needle.codes)) return true;
+
+        try scratch.resize(self.allocator, needle.raw.len);
+        const n = self.table.decompressPrefix(row, scratch.items);
+        return n == needle.raw.len and std.mem.eql(u8, scratch.items[0..n], needle.raw);
+    }
+
+    /// Row `i` contains the needle
+    ///
+    /// First looks for the needle's codes at code boundaries of the row
+    /// (conclusive when found). Failing that, the row is rejected without
+    /// decompression when it is shorter than the needle or lacks one of the
+    /// needle's bytes (by byte signature). Only rows that pass both tests,
+    /// typically the matches plus a few false positives, are decompressed
+    /// and searched.
+    pub fn includesAt(self: CompressedStrings, i: usize, needle: CompressedNeedle, scratch: *std.ArrayList(u8)) Allocator.Error!bool {
+        if (needle.raw.len == 0) return true;
+
+        const row = self.codesOf(i);
+        if (needle.codes.len <= row.len) {
+            var p: usize = 0;
+            while (p + needle.codes.len <= row.len) {
+                if (std.mem.eql(u8, row[p .. p + needle.codes.len], needle.codes)) return true;
+                p += if (row[p] == escape_code) 2 else 1;
+            }
+        }
+
+        const summary = self.table.summarize(row);
+        if (summary.len < needle.raw.len) return false;
+        if (needle.signature & ~summary.signature != 0) return false;
+
+        scratch.clearRetainingCapacity();
+        try self.table.decompress(self.allocator, row, scratch);
+        return std.mem.indexOf(u8, scratch.items, needle.raw) != null;
+    }
+
+    /// Equality with `needle` for every row, as a bitmap
+    pub fn equals(self: CompressedStrings, allocator: Allocator, needle: []const u8) !Bitmap {
+        var compressed = try self.prepare(allocator, needle);
+        defer compressed.deinit(allocator);
+
+        const bits = try Bitmap.init(allocator, self.len());
+        for (0..self.len()) |i| {
+            if (self.equalsAt(i, compressed)) bits.set(i);
+        }
+        return bits;
+    }
+
+    /// startsWith(prefix) for every row, as a bitmap
+    pub fn startsWith(self: CompressedStrings, allocator: Allocator, prefix: []const u8) !Bitmap {
+        return self.scan(allocator, prefix, startsWithAt);
+    }
+
+    /// includes(needle) for every row, as a bitmap
+    pub fn includes(self: CompressedStrings, allocator: Allocator, needle: []const u8) !Bitmap {
+        return self.scan(allocator, needle, includesAt);
+    }
+
+    fn scan(
+        self: CompressedStrings,
+        allocator: Allocator,
+        needle: []const u8,
+        comptime predicate: fn (CompressedStrings, usize, CompressedNeedle, *std.ArrayList(u8)) Allocator.Error!bool,
+    ) !Bitmap {
+        var compressed = try self.prepare(allocator, needle);
+        defer compressed.deinit(allocator);
+        var scratch = std.ArrayList(u8){};
+        defer scratch.deinit(self.allocator);
+
+        var bits = try Bitmap.init(allocator, self.len());
+        errdefer bits.deinit(allocator);
+        for (0..self.len()) |i| {
+            if (try predicate(self, i, compressed, &scratch)) bits.set(i);
+        }
+        return bits;
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+const test_rows = [_][]const u8{
+    "https://example.com/index.html",
+    "https://example.com/about.html",
+    "https://example.org/index.html",
+    "http://example.net/contact",
+    "https://example.com/index.html",
+    "ftp://files.example.com/pub/readme.txt",
+    "https://example.com/blog/2024/01/hello-world",
+    "https://example.com/blog/2024/02/compression",
+    "caf\u{e9} \u{1F600}",
+    "",
+};
+
+test "CompressedStrings - round trip and compression" {
+    const allocator = std.testing.allocator;
+
+    var rows = std.ArrayList([]const u8){};
+    defer rows.deinit(allocator);
+    for (0..20) |_| try rows.appendSlice(allocator, &test_rows);
+
+    var store = try CompressedStrings.build(allocator, rows.items);
+    defer store.deinit();
+
+    try std.testing.expectEqual(rows.items.len, store.len());
+    try std.testing.expect(store.compressedBytes() < store.raw_bytes);
+
+    for (rows.items, 0..) |expected, i| {
+        var row = try store.get(allocator, i);
+        defer row.deinit();
+        try std.testing.expectEqualStrings(expected, row.data);
+    }
+}
+
+test "CompressedStrings - bytes outside the table are escaped" {
+    const allocator = std.testing.allocator;
+
+    var store = try CompressedStrings.build(allocator, &[_][]const u8{ "aaaa", "abab" });
+    defer store.deinit();
+
+    try store.append("zzz\x00\xff");
+    var row = try store.get(allocator, 2);
+    defer row.deinit();
+    try std.testing.expectEqualStrings("zzz\x00\xff", row.data);
+}
+
+test "CompressedStrings - search on compressed form" {
+    const allocator = std.testing.allocator;
+
+    var store = try CompressedStrings.build(allocator, &test_rows);
+    defer store.deinit();
+
+    var eq = try store.equals(allocator, "https://example.com/index.html");
+    defer eq.deinit(allocator);
+    try std.testing.expect(eq.isSet(0));
+    try std.testing.expect(!eq.isSet(1));
+    try std.testing.expect(eq.isSet(4));
+    try std.testing.expectEqual(@as(usize, 2), eq.count());
+
+    var https = try store.startsWith(allocator, "https://example.c");
+    defer https.deinit(allocator);
+    try std.testing.expectEqual(@as(usize, 5), https.count());
+    try std.testing.expect(!https.isSet(2));
+
+    var blog = try store.includes(allocator, "/blog/");
+    defer blog.deinit(allocator);
+    try std.testing.expectEqual(@as(usize, 2), blog.count());
+    try std.testing.expect(blog.isSet(6));
+    try std.testing.expect(blog.isSet(7));
+
+    var emoji = try store.includes(allocator, "\u{1F600}");
+    defer emoji.deinit(allocator);
+    try std.testing.expect(emoji.isSet(8));
+    try std.testing.expectEqual(@as(usize, 1), emoji.count());
+
+    var none = try store.includes(allocator, "missing");
+    defer none.deinit(allocator);
+    try std.testing.expectEqual(@as(usize, 0), none.count());
+}
+
+test "CompressedStrings - signature rejects rows without decompressing" {
+    const allocator = std.testing.allocator;
+
+    var store = try CompressedStrings.build(allocator, &test_rows);
+    defer store.deinit();
+
+    var needle = try store.prepare(allocator, "readme");
+    defer needle.deinit(allocator);
+
+    // Row 0 has no 'r'; its summary alone rules it out
+    const summary = store.table.summarize(store.codesOf(0));
+    try std.testing.expectEqual(test_rows[0].len, summary.len);
+    try std.testing.expectEqual(byteSignature(test_rows[0]), summary.signature);
+    try std.testing.expect(needle.signature & ~summary.signature != 0);
+
+    var found = try store.includes(allocator, "readme");
+    defer found.deinit(allocator);
+    try std.testing.expectEqual(@as(usize, 1), found.count());
+    try std.testing.expect(found.isSet(5));
+}
@@ -0,0 +1,485 @@
+// Resumable, time-sliced versions of the heavy String methods
+//
+// A Job holds the state of one split / replaceAll / normalize / case
+// conversion / matchAll over a borrowed input. Each step() processes about
+// `budget` input bytes and returns, so a single-threaded event loop can
+// interleave a transform of a large body with its other work:
+//
+//     var job = try Job.replaceAll(allocator, body, "foo", "bar");
+//     defer job.deinit();
+//     while (!try job.step(64 * 1024)) loop.runPending();
+//     respond(job.text());
+//
+// Results match the one-shot methods. Steps are cut at code point
+// boundaries (and, for normalize, never before a combining mark), so a
+// step may run a few bytes past its budget. Regex steps stop at match
+// boundaries: one search that finds nothing scans to the end of input.
+// Patterns with `^`, `\b`, `\B` or lookbehind are searched over the whole
+// input in the first step (see regex.MatchIterator), since resuming after
+// a match would move their start of input; later steps reuse those matches.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const regex = @import("../methods/regex.zig");
+const split_methods = @import("../methods/split.zig");
+const case = @import("../methods/case.zig");
+const unicode_normalize = @import("../methods/unicode_normalize.zig");
+
+pub const Kind = enum {
+    split,
+    replace_all,
+    normalize,
+    to_lower_case,
+    to_upper_case,
+    match_all,
+};
+
+pub const Job = struct {
+    allocator: Allocator,
+    /// Borrowed; must outlive the job
+    input: []const u8,
+    /// Input bytes fully processed
+    pos: usize = 0,
+    done: bool = false,
+    /// Output of replaceAll / normalize / case jobs
+    out: std.ArrayList(u8) = .{},
+    state: State,
+
+    const State = union(Kind) {
+        split: Split,
+        replace_all: ReplaceAll,
+        normalize: Normalize,
+        to_lower_case,
+        to_upper_case,
+        match_all: MatchAll,
+    };
+
+    const Split = struct {
+        /// Owned copy
+        separator: []u8,
+        fields: split_methods.SplitIterator,
+        parts: std.ArrayList([]const u8) = .{},
+    };
+
+    const ReplaceAll = struct {
+        /// Owned copy
+        replacement: []u8,
+        /// Owned copy of a pattern without regex syntax, searched as bytes
+        literal: ?[]u8 = null,
+        iter: ?regex.MatchIterator = null,
+    };
+
+    const Normalize = struct {
+        /// null: unknown form, the input is copied (as normalize() does)
+        form: ?unicode_normalize.NormalizationForm,
+        /// normalize() copies invalid UTF-8 unchanged, so the whole input
+        /// is validated (in steps) before any output is produced
+        validated: usize = 0,
+    };
+
+    const MatchAll = struct {
+        iter: regex.MatchIterator,
+        found: std.ArrayList(regex.MatchIterator.Match) = .{},
+    };
+
+    /// Resumable split(separator, limit); parts() borrows from the input
+    pub fn split(allocator: Allocator, str: []const u8, separator: []const u8, limit: ?usize) !Job {
+        const owned = try allocator.dupe(u8, separator);
+        return .{
+            .allocator = allocator,
+            .input = str,
+            .state = .{ .split = .{
+                .separator = owned,
+                .fields = split_methods.splitIterator(str, owned, limit),
+            } },
+        };
+    }
+
+    /// Resumable replaceAll(pattern, replacement)
+    ///
+    /// Like replaceAll(), the pattern is tried as a regex first and falls
+    /// back to a literal search if it does not compile. Patterns without
+    /// regex syntax are searched as bytes, which keeps every step bounded.
+    pub fn replaceAll(allocator: Allocator, str: []const u8, pattern: []const u8, replacement: []const u8) !Job {
+        var state = ReplaceAll{ .replacement = try allocator.dupe(u8, replacement) };
+        errdefer allocator.free(state.replacement);
+
+        if (pattern.len > 0 and std.mem.indexOfAny(u8, pattern, "\\^$.|?*+()[]{}") == null) {
+            state.literal = try allocator.dupe(u8, pattern);
+        } else {
+            state.iter = regex.matchIterator(allocator, str, pattern) catch null;
+            if (state.iter == null and pattern.len > 0) {
+                state.literal = try allocator.dupe(u8, pattern);
+            }
+        }
+
+        return .{ .allocator = allocator, .input = str, .state = .{ .replace_all = state } };
+    }
+
+    /// Resumable normalize(form); null means NFC
+    pub fn normalize(allocator: Allocator, str: []const u8, form: ?[]const u8) Job {
+        return .{
+            .allocator = allocator,
+            .input = str,
+            .state = .{ .normalize = .{
+                .form = unicode_normalize.NormalizationForm.fromString(form orelse "NFC"),
+            } },
+        };
+    }
+
+    /// Resumable toLowerCase()
+    pub fn toLowerCase(allocator: Allocator, str: []const u8) Job {
+        return .{ .allocator = allocator, .input = str, .state = .to_lower_case };
+    }
+
+    /// Resumable toUpperCase()
+    pub fn toUpperCase(allocator: Allocator, str: []const u8) Job {
+        return .{ .allocator = allocator, .input = str, .state = .to_upper_case };
+    }
+
+    /// Resumable matchAll(pattern); matches() borrows from the input
+    ///
+    /// Returns error.InvalidPattern if the pattern does not compile.
+    pub fn matchAll(allocator: Allocator, str: []const u8, pattern: []const u8) !Job {
+        return .{
+            .allocator = allocator,
+            .input = str,
+            .state = .{ .match_all = .{ .iter = try regex.matchIterator(allocator, str, pattern) } },
+        };
+    }
+
+    pub fn deinit(self: *Job) void {
+        self.out.deinit(self.allocator);
+        switch (self.state) {
+            .split => |*s| {
+                self.allocator.free(s.separator);
+                s.parts.deinit(self.allocator);
+            },
+            .replace_all => |*s| {
+                self.allocator.free(s.replacement);
+                if (s.literal) |literal| self.allocator.free(literal);
+                if (s.iter) |*iter| iter.deinit();
+            },
+            .match_all => |*s| {
+                s.iter.deinit();
+                s.found.deinit(self.allocator);
+            },
+            .normalize, .to_lower_case, .to_upper_case => {},
+        }
+    }
+
+    /// Process about `budget` bytes of input; returns true once finished
+    pub fn step(self: *Job, budget: usize) !bool {
+        if (self.done) return true;
+        const n = @max(budget, 1);
+
+        switch (self.state) {
+            .split => |*s| try self.stepSplit(s, n),
+            .replace_all => |*s| if (s.literal) |literal| {
+                try self.stepLiteral(literal, s.replacement, n);
+            } else if (s.iter) |*iter| {
+                try self.stepRegex(iter, s.replacement, n);
+            } else {
+                try self.stepCopy(n);
+            },
+            .normalize => |*s| try self.stepNormalize(s, n),
+            .to_lower_case => try self.stepMapped(case.toLowerCase, n),
+            .to_upper_case => try self.stepMapped(case.toUpperCase, n),
+            .match_all => |*s| try self.stepMatchAll(s, n),
+        }
+        return self.done;
+    }
+
+    /// Run the remaining steps without yielding
+    pub fn finish(self: *Job) !void {
+        while (!try self.step(std.math.maxInt(usize))) {}
+    }
+
+    /// Output so far of a replaceAll / normalize / case job
+    pub fn text(self: *const Job) []const u8 {
+        return self.out.items;
+    }
+
+    /// Take the output of a finished replaceAll / normalize / case job
+    ///
+    /// The caller owns the returned slice.
+    pub fn toOwnedText(self: *Job) ![]u8 {
+        return self.out.toOwnedSlice(self.allocator);
+    }
+
+    /// Fields found so far by a split job
+    pub fn parts(self: *const Job) []const []const u8 {
+        return self.state.split.parts.items;
+    }
+
+    /// Matches found so far by a matchAll job
+    pub fn matches(self: *const Job) []const regex.MatchIterator.Match {
+        return self.state.match_all.found.items;
+    }
+
+    fn complete(self: *Job) void {
+        self.pos = self.input.len;
+        self.done = true;
+    }
+
+    /// End of a step starting at `from`: at least `budget` bytes on, moved
+    /// forward to a code point boundary, and past combining marks when
+    /// `marks` is set
+    fn chunkEnd(self: *const Job, from: usize, budget: usize, marks: bool) usize {
+        const str = self.input;
+        var end = from +| budget;
+        if (end >= str.len) return str.len;
+
+        while (end < str.len) {
+            const b = str[end];
+            if (b & 0xC0 == 0x80) {
+                end += 1;
+                continue;
+            }
+            // compose() joins U+0300-U+036F (CC 80 - CD AF) to the preceding base
+            if (marks and (b == 0xCC or (b == 0xCD and end + 1 < str.len and str[end + 1] <= 0xAF))) {
+                end += 1;
+                continue;
+            }
+            break;
+        }
+        return end;
+    }
+
+    fn stepSplit(self: *Job, s: *Split, budget: usize) !void {
+        const end = @min(self.input.len, self.pos +| budget);
+        while (s.fields.nextWithin(end)) |field| {
+            try s.parts.append(self.allocator, field);
+        }
+        if (s.fields.isDone()) return self.complete();
+        self.pos = end;
+    }
+
+    fn stepLiteral(self: *Job, pattern: []const u8, replacement: []const u8, budget: usize) !void {
+        const str = self.input;
+        const window_end = @min(str.len, self.pos +| budget +| (pattern.len - 1));
+
+        while (std.mem.indexOfPos(u8, str[0..window_end], self.pos, pattern)) |i| {
+            try self.out.appendSlice(self.allocator, str[self.pos..i]);
+            try self.out.appendSlice(self.allocator, replacement);
+            self.pos = i + pattern.len;
+        }
+
+        if (window_end == str.len) {
+            try self.out.appendSlice(self.allocator, str[self.pos..]);
+            return self.complete();
+        }
+        const safe = @max(self.pos, window_end - (pattern.len - 1));
+        try self.out.appendSlice(self.allocator, str[self.pos..safe]);
+        self.pos = safe;
+    }
+
+    fn stepRegex(self: *Job, iter: *regex.MatchIterator, replacement: []const u8, budget: usize) !void {
+        const str = self.input;
+        const start = self.pos;
+
+        while (self.pos - start < budget) {
+            const m = try iter.next() orelse {
+                try self.out.appendSlice(self.allocator, str[self.pos..]);
+                return self.complete();
+            };
+            const match_start = @intFromPtr(m.text.ptr) - @intFromPtr(str.ptr);
+            try self.out.appendSlice(self.allocator, str[self.pos..match_start]);
+            try self.out.appendSlice(self.allocator, replacement);
+            self.pos = match_start + m.text.len;
+        }
+    }
+
+    fn stepCopy(self: *Job, budget: usize) !void {
+        const end = self.chunkEnd(self.pos, budget, false);
+        try self.out.appendSlice(self.allocator, self.input[self.pos..end]);
+        self.pos = end;
+        if (end == self.input.len) self.complete();
+    }
+
+    fn stepMapped(self: *Job, comptime map: anytype, budget: usize) !void {
+        const end = self.chunkEnd(self.pos, budget, false);
+        const mapped = try map(self.allocator, self.input[self.pos..end]);
+        defer self.allocator.free(mapped);
+        try self.out.appendSlice(self.allocator, mapped);
+        self.pos = end;
+        if (end == self.input.len) self.complete();
+    }
+
+    fn stepNormalize(self: *Job, s: *Normalize, budget: usize) !void {
+        const form = s.form orelse return self.stepCopy(budget);
+
+        if (s.validated < self.input.len) {
+            // Cuts never fall on continuation bytes, so each chunk is valid
+            // exactly when its part of the whole input is
+            const end = self.chunkEnd(s.validated, budget, false);
+            if (!std.unicode.utf8ValidateSlice(self.input[s.validated..end])) {
+                s.form = null;
+            }
+            s.validated = end;
+            return;
+        }
+
+        const end = self.chunkEnd(self.pos, budget, true);
+        const normalized = try unicode_normalize.normalize(self.allocator, self.input[self.pos..end], form);
+        defer self.allocator.free(normalized);
+        try self.out.appendSlice(self.allocator, normalized);
+        self.pos = end;
+        if (end == self.input.len) self.complete();
+    }
+
+    fn stepMatchAll(self: *Job, s: *MatchAll, budget: usize) !void {
+        const start = self.pos;
+        while (self.pos - start < budget) {
+            const m = try s.iter.next() orelse return self.complete();
+            try s.found.append(self.allocator, m);
+            self.pos = s.iter.pos;
+        }
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+fn runSteps(job: *Job, budget: usize) !usize {
+    var steps: usize = 0;
+    while (!try job.step(budget)) steps += 1;
+    return steps + 1;
+}
+
+test "Job.split - small budgets match split()" {
+    const allocator = std.testing.allocator;
+    const cases = [_]struct { str: []const u8, sep: []const u8, limit: ?usize }{
+        .{ .str = "a,b,,c", .sep = ",", .limit = null },
+        .{ .str = "one::two::three", .sep = "::", .limit = null },
+        .{ .str = "one::two::three", .sep = "::", .limit = 2 },
+        .{ .str = "héllo", .sep = "", .limit = null },
+        .{ .str = "", .sep = ",", .limit = null },
+        .{ .str = "", .sep = "", .limit = null },
+        .{ .str = "no separator here", .sep = "|", .limit = null },
+    };
+
+    for (cases) |c| {
+        const expected = try split_methods.split(allocator, c.str, c.sep, c.limit);
+        defer split_methods.freeSplitResult(allocator, expected);
+
+        for ([_]usize{ 1, 2, 3, 1000 }) |budget| {
+            var job = try Job.split(allocator, c.str, c.sep, c.limit);
+            defer job.deinit();
+            _ = try runSteps(&job, budget);
+
+            try std.testing.expectEqual(expected.len, job.parts().len);
+            for (expected, job.parts()) |want, got| try std.testing.expectEqualStrings(want, got);
+        }
+    }
+}
+
+test "Job.replaceAll - literal pattern across step boundaries" {
+    const allocator = std.testing.allocator;
+    const input = "foo bar foo bar foofoo";
+
+    for ([_]usize{ 1, 2, 5, 1000 }) |budget| {
+        var job = try Job.replaceAll(allocator, input, "foo", "X");
+        defer job.deinit();
+        _ = try runSteps(&job, budget);
+        try std.testing.expectEqualStrings("X bar X bar XX", job.text());
+    }
+}
+
+test "Job.replaceAll - large input takes many steps" {
+    const allocator = std.testing.allocator;
+    const input = try allocator.alloc(u8, 1 << 16);
+    defer allocator.free(input);
+    for (input, 0..) |*b, i| b.* = if (i % 64 == 0) 'x' else '.';
+
+    var job = try Job.replaceAll(allocator, input, "x", "yy");
+    defer job.deinit();
+    const steps = try runSteps(&job, 4096);
+
+    try std.testing.expect(steps >= 16);
+    try std.testing.expectEqual(input.len + input.len / 64, job.text().len);
+}
+
+test "Job.toUpperCase / toLowerCase - multi-byte input" {
+    const allocator = std.testing.allocator;
+    const input = "café Straße ÉCOLE";
+
+    const upper = try case.toUpperCase(allocator, input);
+    defer allocator.free(upper);
+    const lower = try case.toLowerCase(allocator, input);
+    defer allocator.free(lower);
+
+    for ([_]usize{ 1, 3, 1000 }) |budget| {
+        var up = Job.toUpperCase(allocator, input);
+        defer up.deinit();
+        _ = try runSteps(&up, budget);
+        try std.testing.expectEqualStrings(upper, up.text());
+
+        var down = Job.toLowerCase(allocator, input);
+        defer down.deinit();
+        _ = try runSteps(&down, budget);
+        try std.testing.expectEqualStrings(lower, down.text());
+    }
+}
+
+test "Job.normalize - matches normalize()" {
+    const allocator = std.testing.allocator;
+    const inputs = [_][]const u8{ "café", "e\u{0301}e\u{0301}x", "plain ascii", "bad \xff utf8" };
+
+    for (inputs) |input| {
+        for ([_]unicode_normalize.NormalizationForm{ .NFC, .NFD }) |form| {
+            const expected = try unicode_normalize.normalize(allocator, input, form);
+            defer allocator.free(expected);
+
+            var job = Job.normalize(allocator, input, @tagName(form));
+            defer job.deinit();
+            _ = try runSteps(&job, 1);
+            try std.testing.expectEqualStrings(expected, job.text());
+        }
+    }
+}
+
+test "Job.matchAll - one match per step" {
+    const allocator = std.testing.allocator;
+    var job = try Job.matchAll(allocator, "a1b22c333", "\\d+");
+    defer job.deinit();
+    _ = try runSteps(&job, 1);
+
+    try std.testing.expectEqual(@as(usize, 3), job.matches().len);
+    try std.testing.expectEqualStrings("22", job.matches()[1].text);
+    try std.testing.expectEqual(@as(usize, 6), job.matches()[2].index);
+}
+
+test "Job.replaceAll / matchAll - anchored patterns match the one-shot methods" {
+    const allocator = std.testing.allocator;
+
+    const expected = try regex.replaceAll(allocator, "aaa", "^a", "b");
+    defer allocator.free(expected);
+    try std.testing.expectEqualStrings("baa", expected);
+
+    var job = try Job.replaceAll(allocator, "aaa", "^a", "b");
+    defer job.deinit();
+    _ = try runSteps(&job, 1);
+    try std.testing.expectEqualStrings(expected, job.text());
+
+    const all = try regex.matchAll(allocator, "foofoo foo", "\\bfoo");
+    defer regex.freeMatchAll(allocator, all);
+
+    var matches = try Job.matchAll(allocator, "foofoo foo", "\\bfoo");
+    defer matches.deinit();
+    _ = try runSteps(&matches, 1);
+    try std.testing.expectEqual(all.len, matches.matches().len);
+    for (all, matches.matches()) |want, got| try std.testing.expectEqual(want.index, got.index);
+}
+
+test "Job.toOwnedText - caller owns the output" {
+    const allocator = std.testing.allocator;
+    var job = Job.toUpperCase(allocator, "abc");
+    defer job.deinit();
+    try job.finish();
+
+    const owned = try job.toOwnedText();
+    defer allocator.free(owned);
+    try std.testing.expectEqualStrings("ABC", owned);
+}
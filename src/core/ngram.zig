@@ -0,0 +1,485 @@
+const std = @import("std");
+const column = @import("column.zig");
+const search = @import("../methods/search.zig");
+
+const Allocator = std.mem.Allocator;
+
+/// Bytes per n-gram; needles shorter than this cannot use the index
+pub const gram_len = 3;
+
+/// Rows per build thread below which extra threads are not worth spawning
+const min_rows_per_thread = 4096;
+
+/// Packs the trigram at byte `i` into the low 24 bits
+inline fn gramAt(str: []const u8, i: usize) u32 {
+    return @as(u32, str[i]) | @as(u32, str[i + 1]) << 8 | @as(u32, str[i + 2]) << 16;
+}
+
+/// Sorted, deduplicated trigrams of `str` (UTF-8 bytes) into `out`
+fn collectGrams(allocator: Allocator, str: []const u8, out: *std.ArrayList(u32)) !void {
+    out.clearRetainingCapacity();
+    if (str.len < gram_len) return;
+
+    try out.ensureTotalCapacity(allocator, str.len - gram_len + 1);
+    for (0..str.len - gram_len + 1) |i| out.appendAssumeCapacity(gramAt(str, i));
+    std.mem.sort(u32, out.items, {}, std.sort.asc(u32));
+
+    var unique: usize = 0;
+    for (out.items) |g| {
+        if (unique > 0 and out.items[unique - 1] == g) continue;
+        out.items[unique] = g;
+        unique += 1;
+    }
+    out.shrinkRetainingCapacity(unique);
+}
+
+/// Longest varint encoding of a u32
+const max_varint_len = 5;
+
+/// Caller reserves max_varint_len bytes in `out`
+fn writeVarint(out: *std.ArrayList(u8), value: u32) void {
+    var v = value;
+    while (v >= 0x80) : (v >>= 7) {
+        out.appendAssumeCapacity(@as(u8, @truncate(v)) | 0x80);
+    }
+    out.appendAssumeCapacity(@intCast(v));
+}
+
+inline fn readVarint(bytes: []const u8, pos: *usize) u32 {
+    var value: u32 = 0;
+    var shift: u5 = 0;
+    while (true) : (shift += 7) {
+        const b = bytes[pos.*];
+        pos.* += 1;
+        value |= @as(u32, b & 0x7f) << shift;
+        if (b < 0x80) return value;
+    }
+}
+
+/// Ascending row ids stored as varint-encoded deltas
+pub const PostingList = struct {
+    bytes: std.ArrayList(u8) = .{},
+    /// Last row pushed (deltas are relative to it)
+    last: u32 = 0,
+    count: u32 = 0,
+
+    pub fn deinit(self: *PostingList, allocator: Allocator) void {
+        self.bytes.deinit(allocator);
+        self.* = undefined;
+    }
+
+    /// Appends a row; rows must be pushed in increasing order
+    fn push(self: *PostingList, allocator: Allocator, row: u32) !void {
+        try self.bytes.ensureUnusedCapacity(allocator, max_varint_len);
+        self.pushAssumeCapacity(row);
+    }
+
+    /// push() into max_varint_len bytes reserved beforehand
+    fn pushAssumeCapacity(self: *PostingList, row: u32) void {
+        writeVarint(&self.bytes, row - self.last);
+        self.last = row;
+        self.count += 1;
+    }
+
+    /// Appends every row of `other`, whose rows all follow self.last
+    ///
+    /// Only the first delta is re-encoded; the rest is copied verbatim.
+    fn concat(self: *PostingList, allocator: Allocator, other: *const PostingList) !void {
+        var it = other.iterator();
+        try self.push(allocator, it.next().?);
+        try self.bytes.appendSlice(allocator, other.bytes.items[it.pos..]);
+        self.last = other.last;
+        self.count += other.count - 1;
+    }
+
+    pub fn iterator(self: *const PostingList) Iterator {
+        return .{ .bytes = self.bytes.items };
+    }
+
+    pub const Iterator = struct {
+        bytes: []const u8,
+        pos: usize = 0,
+        row: u32 = 0,
+
+        pub fn next(self: *Iterator) ?u32 {
+            if (self.pos >= self.bytes.len) return null;
+            self.row += readVarint(self.bytes, &self.pos);
+            return self.row;
+        }
+    };
+};
+
+const PostingMap = std.AutoHashMapUnmanaged(u32, PostingList);
+
+fn deinitPostings(allocator: Allocator, postings: *PostingMap) void {
+    var it = postings.valueIterator();
+    while (it.next()) |list| list.deinit(allocator);
+    postings.deinit(allocator);
+}
+
+/// A verified occurrence: row and UTF-16 index of the first match in it
+pub const Match = struct {
+    row: usize,
+    index: usize,
+};
+
+/// Trigram inverted index over a growing collection of strings
+///
+/// Every row is copied into an internal StringColumn and each distinct
+/// byte trigram of the row is added to that trigram's posting list. A
+/// query intersects the posting lists of the needle's trigrams and then
+/// verifies the surviving rows with String.prototype.indexOf semantics,
+/// so results are exact; needles shorter than three bytes fall back to a
+/// full scan.
+pub const NgramIndex = struct {
+    allocator: Allocator,
+    rows: column.StringColumn,
+    postings: PostingMap = .{},
+    /// Scratch trigram buffer reused by append()
+    scratch: std.ArrayList(u32) = .{},
+
+    /// Creates an empty index
+    pub fn init(allocator: Allocator) !NgramIndex {
+        return .{
+            .allocator = allocator,
+            .rows = try column.StringColumn.init(allocator, .{}),
+        };
+    }
+
+    /// Indexes `strings` using up to `thread_count` threads (0 = one per CPU)
+    ///
+    /// Each thread indexes a contiguous range of rows into its own posting
+    /// lists, which are then concatenated in row order. The allocator must
+    /// be thread-safe when more than one thread is used.
+    pub fn build(allocator: Allocator, strings: []const []const u8, thread_count: usize) !NgramIndex {
+        if (strings.len > std.math.maxInt(u32)) return error.TooManyRows;
+
+        var self = NgramIndex{
+            .allocator = allocator,
+            .rows = try column.StringColumn.fromSlices(allocator, strings, .{}),
+        };
+        errdefer self.deinit();
+
+        const wanted = if (thread_count == 0) std.Thread.getCpuCount() catch 1 else thread_count;
+        const n = @max(1, @min(wanted, strings.len / min_rows_per_thread));
+
+        const chunks = try allocator.alloc(Chunk, n);
+        defer allocator.free(chunks);
+        const per_chunk = (strings.len + n - 1) / n;
+        for (chunks, 0..) |*chunk, i| {
+            const start = @min(i * per_chunk, strings.len);
+            const end = @min(start + per_chunk, strings.len);
+            chunk.* = .{ .allocator = allocator, .strings = strings[start..end], .first_row = @intCast(start) };
+        }
+        defer for (chunks) |*chunk| deinitPostings(allocator, &chunk.postings);
+
+        const threads = try allocator.alloc(?std.Thread, n);
+        defer allocator.free(threads);
+        threads[0] = null;
+        for (chunks[1..], threads[1..]) |*chunk, *thread| {
+            thread.* = std.Thread.spawn(.{}, Chunk.run, .{chunk}) catch null;
+        }
+        chunks[0].run();
+        for (chunks[1..], threads[1..]) |*chunk, thread| {
+            if (thread) |t| t.join() else chunk.run();
+        }
+        for (chunks) |chunk| {
+            if (chunk.err) |err| return err;
+        }
+
+        for (chunks) |*chunk| {
+            var it = chunk.postings.iterator();
+            while (it.next()) |entry| {
+                const merged = try self.postings.getOrPut(allocator, entry.key_ptr.*);
+                if (!merged.found_existing) {
+                    // Take over the chunk's list
+                    merged.value_ptr.* = entry.value_ptr.*;
+                    entry.value_ptr.* = .{};
+                } else {
+                    try merged.value_ptr.concat(allocator, entry.value_ptr);
+                }
+            }
+        }
+        return self;
+    }
+
+    const Chunk = struct {
+        allocator: Allocator,
+        strings: []const []const u8,
+        first_row: u32,
+        postings: PostingMap = .{},
+        err: ?anyerror = null,
+
+        fn run(self: *Chunk) void {
+            self.index() catch |err| {
+                self.err = err;
+            };
+        }
+
+        fn index(self: *Chunk) !void {
+            var grams = std.ArrayList(u32){};
+            defer grams.deinit(self.allocator);
+            for (self.strings, 0..) |str, i| {
+                try collectGrams(self.allocator, str, &grams);
+                try addRow(self.allocator, &self.postings, self.first_row + @as(u32, @intCast(i)), grams.items);
+            }
+        }
+    };
+
+    fn addRow(allocator: Allocator, postings: *PostingMap, row: u32, grams: []const u32) !void {
+        for (grams) |g| {
+            const entry = try postings.getOrPut(allocator, g);
+            if (!entry.found_existing) entry.value_ptr.* = .{};
+            try entry.value_ptr.push(allocator, row);
+        }
+    }
+
+    pub fn deinit(self: *NgramIndex) void {
+        deinitPostings(self.allocator, &self.postings);
+        self.scratch.deinit(self.allocator);
+        self.rows.deinit();
+        self.* = undefined;
+    }
+
+    /// Appends and indexes a row (no rebuild of existing posting lists)
+    ///
+    /// Every allocation happens before the row is stored, so on error the
+    /// index is unchanged.
+    pub fn append(self: *NgramIndex, str: []const u8) !void {
+        if (self.len() >= std.math.maxInt(u32)) return error.TooManyRows;
+        const row: u32 = @intCast(self.len());
+
+        try collectGrams(self.allocator, str, &self.scratch);
+        errdefer self.dropEmptyLists();
+        for (self.scratch.items) |g| {
+            const entry = try self.postings.getOrPut(self.allocator, g);
+            if (!entry.found_existing) entry.value_ptr.* = .{};
+            try entry.value_ptr.bytes.ensureUnusedCapacity(self.allocator, max_varint_len);
+        }
+        try self.rows.append(str);
+
+        for (self.scratch.items) |g| self.postings.getPtr(g).?.pushAssumeCapacity(row);
+    }
+
+    /// Removes lists a failed append() created for the grams in scratch
+    fn dropEmptyLists(self: *NgramIndex) void {
+        for (self.scratch.items) |g| {
+            const list = self.postings.getPtr(g) orelse continue;
+            if (list.count > 0) continue;
+            list.deinit(self.allocator);
+            _ = self.postings.remove(g);
+        }
+    }
+
+    /// Number of rows
+    pub inline fn len(self: NgramIndex) usize {
+        return self.rows.len();
+    }
+
+    /// Row `i`
+    pub inline fn get(self: NgramIndex, i: usize) []const u8 {
+        return self.rows.get(i);
+    }
+
+    /// Number of distinct trigrams
+    pub inline fn gramCount(self: NgramIndex) usize {
+        return self.postings.count();
+    }
+
+    /// Encoded size of all posting lists in bytes
+    pub fn postingBytes(self: NgramIndex) usize {
+        var total: usize = 0;
+        var it = self.postings.valueIterator();
+        while (it.next()) |list| total += list.bytes.items.len;
+        return total;
+    }
+
+    /// Rows that contain every trigram of `needle`, ascending
+    ///
+    /// Returns null when the needle is too short to use the index (every
+    /// row is a candidate).
+    pub fn candidates(self: NgramIndex, allocator: Allocator, needle: []const u8) !?[]u32 {
+        if (needle.len < gram_len) return null;
+
+        var grams = std.ArrayList(u32){};
+        defer grams.deinit(allocator);
+        try collectGrams(allocator, needle, &grams);
+
+        const lists = try allocator.alloc(*const PostingList, grams.items.len);
+        defer allocator.free(lists);
+        for (grams.items, lists) |g, *list| {
+            list.* = self.postings.getPtr(g) orelse return try allocator.alloc(u32, 0);
+        }
+
+        // Intersect starting from the shortest list
+        const ByCount = struct {
+            fn lessThan(_: void, a: *const PostingList, b: *const PostingList) bool {
+                return a.count < b.count;
+            }
+        };
+        std.mem.sort(*const PostingList, lists, {}, ByCount.lessThan);
+
+        var result = std.ArrayList(u32){};
+        errdefer result.deinit(allocator);
+        try result.ensureTotalCapacity(allocator, lists[0].count);
+        var first = lists[0].iterator();
+        while (first.next()) |row| result.appendAssumeCapacity(row);
+
+        for (lists[1..]) |list| {
+            var it = list.iterator();
+            var cur = it.next();
+            var kept: usize = 0;
+            for (result.items) |row| {
+                while (cur) |c| {
+                    if (c >= row) break;
+                    cur = it.next();
+                }
+                if (cur == null) break;
+                if (cur.? == row) {
+                    result.items[kept] = row;
+                    kept += 1;
+                }
+            }
+            result.shrinkRetainingCapacity(kept);
+            if (kept == 0) break;
+        }
+        return try result.toOwnedSlice(allocator);
+    }
+
+    /// Every row containing `needle`, with the UTF-16 index of its first
+    /// occurrence (as indexOf would return)
+    pub fn find(self: NgramIndex, allocator: Allocator, needle: []const u8) ![]Match {
+        var matches = std.ArrayList(Match){};
+        errdefer matches.deinit(allocator);
+
+        if (try self.candidates(allocator, needle)) |rows| {
+            defer allocator.free(rows);
+            for (rows) |row| try self.verify(allocator, &matches, row, needle);
+        } else {
+            for (0..self.len()) |row| try self.verify(allocator, &matches, row, needle);
+        }
+        return matches.toOwnedSlice(allocator);
+    }
+
+    fn verify(self: NgramIndex, allocator: Allocator, matches: *std.ArrayList(Match), row: usize, needle: []const u8) !void {
+        const pos = search.indexOf(self.rows.get(row), needle, null);
+        if (pos >= 0) try matches.append(allocator, .{ .row = row, .index = @intCast(pos) });
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "PostingList - varint deltas and concat" {
+    const allocator = std.testing.allocator;
+
+    var a = PostingList{};
+    defer a.deinit(allocator);
+    for ([_]u32{ 0, 5, 200, 70000 }) |row| try a.push(allocator, row);
+
+    var b = PostingList{};
+    defer b.deinit(allocator);
+    for ([_]u32{ 70001, 1 << 30 }) |row| try b.push(allocator, row);
+
+    try a.concat(allocator, &b);
+    try std.testing.expectEqual(@as(u32, 6), a.count);
+
+    var it = a.iterator();
+    for ([_]u32{ 0, 5, 200, 70000, 70001, 1 << 30 }) |expected| {
+        try std.testing.expectEqual(@as(?u32, expected), it.next());
+    }
+    try std.testing.expectEqual(@as(?u32, null), it.next());
+}
+
+test "NgramIndex - find with UTF-16 positions" {
+    const allocator = std.testing.allocator;
+
+    var index = try NgramIndex.init(allocator);
+    defer index.deinit();
+    for ([_][]const u8{ "hello world", "\u{1F600} world peace", "word", "no match", "worldworld", "worl rld" }) |row| {
+        try index.append(row);
+    }
+
+    const matches = try index.find(allocator, "world");
+    defer allocator.free(matches);
+    try std.testing.expectEqual(@as(usize, 3), matches.len);
+    try std.testing.expectEqual(Match{ .row = 0, .index = 6 }, matches[0]);
+    try std.testing.expectEqual(Match{ .row = 1, .index = 3 }, matches[1]);
+    try std.testing.expectEqual(Match{ .row = 4, .index = 0 }, matches[2]);
+
+    // Row 5 has every trigram of "world" but not the substring itself
+    const candidates = (try index.candidates(allocator, "world")).?;
+    defer allocator.free(candidates);
+    try std.testing.expectEqualSlices(u32, &[_]u32{ 0, 1, 4, 5 }, candidates);
+
+    // Short needles scan every row
+    try std.testing.expect((try index.candidates(allocator, "wo")) == null);
+    const short = try index.find(allocator, "wo");
+    defer allocator.free(short);
+    try std.testing.expectEqual(@as(usize, 5), short.len);
+
+    const none = try index.find(allocator, "absent");
+    defer allocator.free(none);
+    try std.testing.expectEqual(@as(usize, 0), none.len);
+}
+
+test "NgramIndex - failed append leaves the index unchanged" {
+    var fail_index: usize = 0;
+    while (true) : (fail_index += 1) {
+        var failing = std.testing.FailingAllocator.init(std.testing.allocator, .{ .fail_index = fail_index });
+        const allocator = failing.allocator();
+
+        var index = NgramIndex.init(allocator) catch continue;
+        defer index.deinit();
+        index.append("hello world") catch continue;
+        const grams = index.gramCount();
+
+        if (index.append("world peace")) |_| {
+            const matches = try index.find(std.testing.allocator, "peace");
+            defer std.testing.allocator.free(matches);
+            try std.testing.expectEqual(@as(usize, 1), matches.len);
+            break;
+        } else |err| {
+            try std.testing.expectEqual(error.OutOfMemory, err);
+            try std.testing.expectEqual(@as(usize, 1), index.len());
+            try std.testing.expectEqual(grams, index.gramCount());
+        }
+    }
+}
+
+test "NgramIndex - parallel build matches incremental" {
+    const allocator = std.testing.allocator;
+
+    var rows = std.ArrayList([]u8){};
+    defer {
+        for (rows.items) |row| allocator.free(row);
+        rows.deinit(allocator);
+    }
+    for (0..3 * min_rows_per_thread) |i| {
+        try rows.append(allocator, try std.fmt.allocPrint(allocator, "item-{d}-{s}", .{ i, if (i % 7 == 0) "needle" else "hay" }));
+    }
+
+    var built = try NgramIndex.build(allocator, rows.items, 3);
+    defer built.deinit();
+
+    var grown = try NgramIndex.init(allocator);
+    defer grown.deinit();
+    for (rows.items) |row| try grown.append(row);
+
+    try std.testing.expectEqual(grown.gramCount(), built.gramCount());
+    try std.testing.expectEqual(grown.postingBytes(), built.postingBytes());
+
+    const a = try built.find(allocator, "needle");
+    defer allocator.free(a);
+    const b = try grown.find(allocator, "needle");
+    defer allocator.free(b);
+    try std.testing.expectEqualSlices(Match, b, a);
+    try std.testing.expectEqual((rows.items.len + 6) / 7, a.len);
+
+    try built.append("late needle");
+    const c = try built.find(allocator, "needle");
+    defer allocator.free(c);
+    try std.testing.expectEqual(a.len + 1, c.len);
+    try std.testing.expectEqual(Match{ .row = rows.items.len, .index = 5 }, c[c.len - 1]);
+}
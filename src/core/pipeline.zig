@@ -0,0 +1,626 @@
+const std = @import("std");
+const builtin = @import("builtin");
+const linux = std.os.linux;
+const posix = std.posix;
+const Allocator = std.mem.Allocator;
+
+// File -> records -> transform -> file pipeline driven by io_uring (Linux)
+//
+// The input is read as fixed-size blocks into buffers registered with
+// the ring, several reads in flight at once. Blocks are cut at the last
+// delimiter; the partial record at the end of one block is carried into
+// the next. Each block's whole records go to a worker pool as one job,
+// borrowing the registered buffer until the job is done. Job output is
+// written back through the ring at offsets assigned in input order, so
+// writes may complete in any order while the file comes out ordered.
+//
+// Workers wake the ring thread through an eventfd whose read is kept
+// armed on the ring, so one io_uring_enter waits for disk and CPU alike.
+
+pub const Options = struct {
+    /// Record separator; it is written back after every record that had one
+    delimiter: u8 = '\n',
+    /// Bytes per read
+    block_size: usize = 1 << 20,
+    /// Reads in flight (and registered buffers), 1 to 1024
+    queue_depth: u16 = 8,
+    /// Worker threads; null for one per CPU
+    workers: ?usize = null,
+};
+
+pub const Stats = struct {
+    records: usize = 0,
+    bytes_in: u64 = 0,
+    bytes_out: u64 = 0,
+};
+
+/// Where a transform writes its result for one record
+pub const Output = struct {
+    list: *std.ArrayList(u8),
+    allocator: Allocator,
+
+    pub fn write(self: Output, bytes: []const u8) !void {
+        try self.list.appendSlice(self.allocator, bytes);
+    }
+};
+
+/// A per-record transform
+///
+/// Called concurrently from worker threads, so `func` must be thread-safe
+/// with respect to `context`. The delimiter is not part of `record`.
+pub const Transform = struct {
+    context: ?*anyopaque = null,
+    func: *const fn (context: ?*anyopaque, record: []const u8, out: Output) anyerror!void,
+
+    /// Adapts a `fn (Allocator, []const u8) ![]u8` such as case.toUpperCase
+    pub fn allocating(comptime f: anytype) Transform {
+        return .{ .func = struct {
+            fn apply(_: ?*anyopaque, record: []const u8, out: Output) anyerror!void {
+                const result = try f(out.allocator, record);
+                defer out.allocator.free(result);
+                try out.write(result);
+            }
+        }.apply };
+    }
+};
+
+/// Transforms every record of `input` into `output`, written from offset 0
+///
+/// `input` must be a regular file. `allocator` is used from worker threads
+/// and must be thread-safe. Returns error.IoUringUnavailable when the
+/// kernel (or a sandbox) does not allow io_uring.
+pub fn run(allocator: Allocator, input: std.fs.File, output: std.fs.File, transform: Transform, options: Options) !Stats {
+    if (builtin.os.tag != .linux) return error.Unsupported;
+
+    const size = (try input.stat()).size;
+    const depth = std.math.clamp(options.queue_depth, 1, 1024);
+    const block_size = @max(options.block_size, 1);
+
+    // Reads, writes (one per job in the window) and the eventfd read
+    var ring = linux.IoUring.init(std.math.ceilPowerOfTwoAssert(u16, 4 * depth + 1), 0) catch |err| switch (err) {
+        error.SystemOutdated, error.PermissionDenied => return error.IoUringUnavailable,
+        else => return err,
+    };
+    defer ring.deinit();
+
+    // The slot buffers and, at the tail, the eventfd read target: all the
+    // memory the kernel writes into
+    const reads_len = @as(usize, depth) * block_size;
+    const memory = try allocator.alloc(u8, reads_len + @sizeOf(u64));
+    // Leaked if the ring could not be drained (see Pipeline.drain)
+    var stuck = false;
+    defer if (!stuck) allocator.free(memory);
+    const slots = try allocator.alloc(Slot, depth);
+    defer allocator.free(slots);
+    const iovecs = try allocator.alloc(posix.iovec, depth);
+    defer allocator.free(iovecs);
+    for (slots, iovecs, 0..) |*slot, *iov, i| {
+        slot.* = .{ .buf = memory[i * block_size ..][0..block_size] };
+        iov.* = .{ .base = slot.buf.ptr, .len = block_size };
+    }
+    // Registration needs locked memory; plain reads work without it
+    const fixed = if (ring.register_buffers(iovecs)) true else |_| false;
+
+    const window = try allocator.alloc(?*Job, 3 * @as(usize, depth));
+    defer allocator.free(window);
+    @memset(window, null);
+
+    const wake_fd = try posix.eventfd(0, linux.EFD.CLOEXEC);
+    defer posix.close(wake_fd);
+
+    var pipeline = Pipeline{
+        .allocator = allocator,
+        .options = options,
+        .transform = transform,
+        .ring = &ring,
+        .fixed = fixed,
+        .in_fd = input.handle,
+        .out_fd = output.handle,
+        .wake_fd = wake_fd,
+        .wake_buf = memory[reads_len..],
+        .size = size,
+        .block_size = block_size,
+        .slots = slots,
+        .window = window,
+    };
+    defer pipeline.deinit();
+
+    var pool: std.Thread.Pool = undefined;
+    try pool.init(.{ .allocator = allocator, .n_jobs = options.workers });
+    // Joined before pipeline.deinit() frees what the workers touched
+    defer pool.deinit();
+    pipeline.pool = &pool;
+
+    const looped = pipeline.loop();
+    stuck = pipeline.stuck;
+    try looped;
+    return pipeline.stats;
+}
+
+const Slot = struct {
+    buf: []u8,
+    state: enum { free, reading, ready, busy } = .free,
+    seq: u64 = 0,
+    offset: u64 = 0,
+    want: usize = 0,
+    filled: usize = 0,
+};
+
+const Job = struct {
+    pipeline: *Pipeline,
+    seq: u64,
+    /// Carried partial record completed by the head of the block (owned)
+    head: []u8,
+    /// Whole records borrowed from the slot's registered buffer
+    body: []const u8,
+    slot: ?u16,
+    output: std.ArrayList(u8) = .{},
+    records: usize = 0,
+    err: ?anyerror = null,
+    state: enum { running, finished, writing } = .running,
+    out_offset: u64 = 0,
+    written: usize = 0,
+    /// Link in Pipeline.done
+    next: ?*Job = null,
+
+    fn run(job: *Job) void {
+        job.transformRecords() catch |err| {
+            job.err = err;
+        };
+
+        const p = job.pipeline;
+        p.mutex.lock();
+        job.next = p.done;
+        p.done = job;
+        p.mutex.unlock();
+
+        const one: u64 = 1;
+        _ = posix.write(p.wake_fd, std.mem.asBytes(&one)) catch {};
+    }
+
+    fn transformRecords(job: *Job) !void {
+        const p = job.pipeline;
+        const delimiter = p.options.delimiter;
+        const out = Output{ .list = &job.output, .allocator = p.allocator };
+
+        for ([_][]const u8{ job.head, job.body }) |piece| {
+            var pos: usize = 0;
+            while (pos < piece.len) {
+                const end = std.mem.indexOfScalarPos(u8, piece, pos, delimiter);
+                try p.transform.func(p.transform.context, piece[pos .. end orelse piece.len], out);
+                job.records += 1;
+                const e = end orelse break;
+                try job.output.append(p.allocator, delimiter);
+                pos = e + 1;
+            }
+        }
+    }
+};
+
+const Tag = enum(u8) { read, write, wake, cancel };
+
+fn userData(tag: Tag, index: usize) u64 {
+    return (@as(u64, @intFromEnum(tag)) << 32) | @as(u32, @intCast(index));
+}
+
+const Pipeline = struct {
+    allocator: Allocator,
+    options: Options,
+    transform: Transform,
+    ring: *linux.IoUring,
+    fixed: bool,
+    pool: *std.Thread.Pool = undefined,
+    in_fd: posix.fd_t,
+    out_fd: posix.fd_t,
+    wake_fd: posix.fd_t,
+    wake_buf: []u8,
+    wake_armed: bool = false,
+    size: u64,
+    block_size: usize,
+
+    slots: []Slot,
+    /// Jobs by seq % len, from write_seq up to next_job_seq
+    window: []?*Job,
+    carry: std.ArrayList(u8) = .{},
+
+    /// Finished jobs handed back by workers
+    mutex: std.Thread.Mutex = .{},
+    done: ?*Job = null,
+
+    next_offset: u64 = 0,
+    next_read_seq: u64 = 0,
+    next_block: u64 = 0,
+    next_job_seq: u64 = 0,
+    write_seq: u64 = 0,
+    out_offset: u64 = 0,
+
+    /// Slots reading or read but not yet cut into a job
+    blocks_pending: usize = 0,
+    reads_in_flight: usize = 0,
+    writes_in_flight: usize = 0,
+    jobs_running: usize = 0,
+    /// Jobs created and not yet fully written
+    jobs_live: usize = 0,
+    cancels_in_flight: usize = 0,
+
+    /// Set once loop() exits; completions no longer start new I/O
+    draining: bool = false,
+    /// The ring stopped responding with requests still in flight
+    stuck: bool = false,
+    failure: ?anyerror = null,
+    stats: Stats = .{},
+
+    fn deinit(self: *Pipeline) void {
+        // Writes still in flight on a stuck ring read job output; leak it
+        if (!self.stuck) {
+            for (self.window) |entry| {
+                if (entry) |job| self.destroyJob(job);
+            }
+        }
+        self.carry.deinit(self.allocator);
+    }
+
+    fn fail(self: *Pipeline, err: anyerror) void {
+        if (self.failure == null) self.failure = err;
+    }
+
+    fn loop(self: *Pipeline) !void {
+        try self.armWake();
+        defer self.drain();
+        var cqes: [64]linux.io_uring_cqe = undefined;
+
+        while (true) {
+            if (self.failure == null) {
+                self.fillReads() catch |err| self.fail(err);
+                self.flushWrites() catch |err| self.fail(err);
+            }
+            if (self.failure) |err| {
+                // Let in-flight I/O and workers drain before unwinding
+                if (self.reads_in_flight == 0 and self.writes_in_flight == 0 and self.jobs_running == 0) return err;
+            } else if (self.next_offset >= self.size and self.blocks_pending == 0 and self.jobs_live == 0) {
+                self.stats.bytes_in = self.size;
+                return;
+            }
+
+            _ = try self.ring.submit();
+            const n = self.ring.copy_cqes(&cqes, 1) catch |err| switch (err) {
+                error.SignalInterrupt => continue,
+                else => return err,
+            };
+            for (cqes[0..n]) |cqe| self.complete(cqe);
+        }
+    }
+
+    fn complete(self: *Pipeline, cqe: linux.io_uring_cqe) void {
+        const index: usize = @as(u32, @truncate(cqe.user_data));
+        switch (@as(Tag, @enumFromInt(cqe.user_data >> 32))) {
+            .read => self.onRead(@intCast(index), cqe.res) catch |err| self.fail(err),
+            .write => self.onWrite(index, cqe.res) catch |err| self.fail(err),
+            .wake => {
+                self.wake_armed = false;
+                self.collect();
+                if (!self.draining) self.armWake() catch |err| self.fail(err);
+            },
+            .cancel => self.cancels_in_flight -= 1,
+        }
+    }
+
+    fn armWake(self: *Pipeline) !void {
+        _ = try self.ring.read(userData(.wake, 0), self.wake_fd, .{ .buffer = self.wake_buf }, 0);
+        self.wake_armed = true;
+    }
+
+    /// Cancels whatever the ring still has in flight, including the armed
+    /// eventfd read, and waits for the completions so no request outlives
+    /// the buffers it targets. If the ring stops responding, sets `stuck`
+    /// and run() leaks those buffers rather than free them under the kernel.
+    fn drain(self: *Pipeline) void {
+        self.draining = true;
+        self.cancelInFlight() catch {
+            self.stuck = true;
+            return;
+        };
+
+        var cqes: [64]linux.io_uring_cqe = undefined;
+        while (self.reads_in_flight > 0 or self.writes_in_flight > 0 or self.wake_armed or self.cancels_in_flight > 0) {
+            const n = self.ring.copy_cqes(&cqes, 1) catch |err| switch (err) {
+                error.SignalInterrupt => continue,
+                else => {
+                    self.stuck = true;
+                    return;
+                },
+            };
+            for (cqes[0..n]) |cqe| self.complete(cqe);
+        }
+    }
+
+    fn cancelInFlight(self: *Pipeline) !void {
+        // Flush queued entries first so every cancel fits in the ring
+        _ = try self.ring.submit();
+        if (self.reads_in_flight > 0) {
+            for (self.slots, 0..) |slot, i| {
+                if (slot.state == .reading) try self.cancel(userData(.read, i));
+            }
+        }
+        if (self.writes_in_flight > 0) {
+            for (self.window, 0..) |entry, i| {
+                const job = entry orelse continue;
+                if (job.state == .writing) try self.cancel(userData(.write, i));
+            }
+        }
+        if (self.wake_armed) try self.cancel(userData(.wake, 0));
+        _ = try self.ring.submit();
+    }
+
+    /// Requests that don't exist any more complete the cancel with -ENOENT
+    fn cancel(self: *Pipeline, target: u64) !void {
+        _ = try self.ring.cancel(userData(.cancel, 0), target, 0);
+        self.cancels_in_flight += 1;
+    }
+
+    // ========================================================================
+    // Reading
+    // ========================================================================
+
+    fn fillReads(self: *Pipeline) !void {
+        // Every pending block may become a job, so keep the window from
+        // overflowing
+        while (self.next_offset < self.size and self.blocks_pending + self.jobs_live < self.window.len) {
+            const index = self.freeSlot() orelse return;
+            const slot = &self.slots[index];
+            slot.* = .{
+                .buf = slot.buf,
+                .state = .reading,
+                .seq = self.next_read_seq,
+                .offset = self.next_offset,
+                .want = @intCast(@min(@as(u64, self.block_size), self.size - self.next_offset)),
+            };
+            self.next_offset += slot.want;
+            self.next_read_seq += 1;
+            self.blocks_pending += 1;
+            try self.submitRead(index);
+        }
+    }
+
+    fn submitRead(self: *Pipeline, index: u16) !void {
+        const slot = &self.slots[index];
+        const dest = slot.buf[slot.filled..slot.want];
+        const user_data = userData(.read, index);
+        if (self.fixed) {
+            var iov = posix.iovec{ .base = dest.ptr, .len = dest.len };
+            _ = try self.ring.read_fixed(user_data, self.in_fd, &iov, slot.offset + slot.filled, index);
+        } else {
+            _ = try self.ring.read(user_data, self.in_fd, .{ .buffer = dest }, slot.offset + slot.filled);
+        }
+        self.reads_in_flight += 1;
+    }
+
+    fn onRead(self: *Pipeline, index: u16, res: i32) !void {
+        self.reads_in_flight -= 1;
+        if (res < 0) return error.ReadFailed;
+        // The file shrank after stat()
+        if (res == 0) return error.UnexpectedEndOfFile;
+        if (self.failure != null or self.draining) return;
+
+        const slot = &self.slots[index];
+        slot.filled += @intCast(res);
+        if (slot.filled < slot.want) return self.submitRead(index);
+
+        slot.state = .ready;
+        while (self.readySlot(self.next_block)) |ready| try self.cutBlock(ready);
+    }
+
+    fn freeSlot(self: *Pipeline) ?u16 {
+        for (self.slots, 0..) |slot, i| {
+            if (slot.state == .free) return @intCast(i);
+        }
+        return null;
+    }
+
+    fn readySlot(self: *Pipeline, seq: u64) ?u16 {
+        for (self.slots, 0..) |slot, i| {
+            if (slot.state == .ready and slot.seq == seq) return @intCast(i);
+        }
+        return null;
+    }
+
+    /// Turns the next block (in file order) into a job of whole records
+    fn cutBlock(self: *Pipeline, index: u16) !void {
+        const slot = &self.slots[index];
+        const data = slot.buf[0..slot.filled];
+        const final = slot.offset + slot.filled >= self.size;
+        const delimiter = self.options.delimiter;
+        self.next_block += 1;
+        self.blocks_pending -= 1;
+
+        const first = std.mem.indexOfScalar(u8, data, delimiter) orelse {
+            // One record spans the whole block
+            slot.state = .free;
+            try self.carry.appendSlice(self.allocator, data);
+            if (final) try self.startJob(try self.carry.toOwnedSlice(self.allocator), "", null);
+            return;
+        };
+        const cut = if (final) data.len else std.mem.lastIndexOfScalar(u8, data, delimiter).? + 1;
+
+        slot.state = .busy;
+        errdefer slot.state = .free;
+        try self.carry.appendSlice(self.allocator, data[0 .. first + 1]);
+        const head = try self.carry.toOwnedSlice(self.allocator);
+        self.carry.appendSlice(self.allocator, data[cut..]) catch |err| {
+            self.allocator.free(head);
+            return err;
+        };
+
+        const body = data[first + 1 .. cut];
+        if (body.len == 0) slot.state = .free;
+        try self.startJob(head, body, if (body.len == 0) null else index);
+    }
+
+    /// Hands records to the pool; takes ownership of `head`
+    fn startJob(self: *Pipeline, head: []u8, body: []const u8, slot: ?u16) !void {
+        const job = self.allocator.create(Job) catch |err| {
+            self.allocator.free(head);
+            return err;
+        };
+        job.* = .{ .pipeline = self, .seq = self.next_job_seq, .head = head, .body = body, .slot = slot };
+        self.window[self.next_job_seq % self.window.len] = job;
+        self.next_job_seq += 1;
+        self.jobs_live += 1;
+        self.jobs_running += 1;
+
+        self.pool.spawn(Job.run, .{job}) catch Job.run(job);
+    }
+
+    // ========================================================================
+    // Writing
+    // ========================================================================
+
+    /// Takes back jobs finished by workers
+    fn collect(self: *Pipeline) void {
+        self.mutex.lock();
+        var list = self.done;
+        self.done = null;
+        self.mutex.unlock();
+
+        while (list) |job| {
+            list = job.next;
+            job.state = .finished;
+            self.jobs_running -= 1;
+            if (job.slot) |i| self.slots[i].state = .free;
+            if (job.err) |err| self.fail(err);
+        }
+    }
+
+    /// Assigns output offsets in job order and starts the writes
+    fn flushWrites(self: *Pipeline) !void {
+        while (self.write_seq < self.next_job_seq) {
+            const index: usize = @intCast(self.write_seq % self.window.len);
+            const job = self.window[index].?;
+            if (job.state != .finished) return;
+
+            job.state = .writing;
+            job.out_offset = self.out_offset;
+            self.out_offset += job.output.items.len;
+            self.write_seq += 1;
+            self.stats.records += job.records;
+            self.stats.bytes_out += job.output.items.len;
+
+            if (job.output.items.len == 0) {
+                self.retire(index);
+            } else {
+                try self.submitWrite(index);
+            }
+        }
+    }
+
+    fn submitWrite(self: *Pipeline, index: usize) !void {
+        const job = self.window[index].?;
+        _ = try self.ring.write(userData(.write, index), self.out_fd, job.output.items[job.written..], job.out_offset + job.written);
+        self.writes_in_flight += 1;
+    }
+
+    fn onWrite(self: *Pipeline, index: usize, res: i32) !void {
+        self.writes_in_flight -= 1;
+        if (res <= 0) return error.WriteFailed;
+
+        const job = self.window[index].?;
+        job.written += @intCast(res);
+        if (job.written < job.output.items.len) {
+            if (self.failure == null and !self.draining) try self.submitWrite(index);
+            return;
+        }
+        self.retire(index);
+    }
+
+    fn retire(self: *Pipeline, index: usize) void {
+        self.destroyJob(self.window[index].?);
+        self.window[index] = null;
+        self.jobs_live -= 1;
+    }
+
+    fn destroyJob(self: *Pipeline, job: *Job) void {
+        self.allocator.free(job.head);
+        job.output.deinit(self.allocator);
+        self.allocator.destroy(job);
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+fn testRoundTrip(input_text: []const u8, options: Options, transform: Transform, expected: []const u8) !Stats {
+    const allocator = std.testing.allocator;
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    try tmp.dir.writeFile(.{ .sub_path = "in.txt", .data = input_text });
+    const input = try tmp.dir.openFile("in.txt", .{});
+    defer input.close();
+    const output = try tmp.dir.createFile("out.txt", .{ .read = true });
+    defer output.close();
+
+    const stats = run(allocator, input, output, transform, options) catch |err| switch (err) {
+        error.IoUringUnavailable, error.Unsupported => return error.SkipZigTest,
+        else => return err,
+    };
+
+    const written = try tmp.dir.readFileAlloc(allocator, "out.txt", 1 << 20);
+    defer allocator.free(written);
+    try std.testing.expectEqualStrings(expected, written);
+    return stats;
+}
+
+test "pipeline - records across block boundaries" {
+    const case = @import("../methods/case.zig");
+    const upper = Transform.allocating(case.toUpperCase);
+
+    // Tiny blocks force records to straddle reads and blocks without any
+    // delimiter at all
+    const stats = try testRoundTrip(
+        "alpha\nbeta\n\nthe quick brown fox\ngamma",
+        .{ .block_size = 4, .queue_depth = 3, .workers = 2 },
+        upper,
+        "ALPHA\nBETA\n\nTHE QUICK BROWN FOX\nGAMMA",
+    );
+    try std.testing.expectEqual(@as(usize, 5), stats.records);
+    try std.testing.expectEqual(@as(u64, 37), stats.bytes_in);
+    try std.testing.expectEqual(@as(u64, 37), stats.bytes_out);
+}
+
+test "pipeline - ordered output from many jobs" {
+    const allocator = std.testing.allocator;
+    var input = std.ArrayList(u8){};
+    defer input.deinit(allocator);
+    var expected = std.ArrayList(u8){};
+    defer expected.deinit(allocator);
+    for (0..2000) |i| {
+        try input.print(allocator, "row {d};", .{i});
+        try expected.print(allocator, "[row {d}];", .{i});
+    }
+
+    const Bracket = struct {
+        fn apply(_: ?*anyopaque, record: []const u8, out: Output) anyerror!void {
+            try out.write("[");
+            try out.write(record);
+            try out.write("]");
+        }
+    };
+    const stats = try testRoundTrip(input.items, .{ .delimiter = ';', .block_size = 64, .queue_depth = 4 }, .{ .func = Bracket.apply }, expected.items);
+    try std.testing.expectEqual(@as(usize, 2000), stats.records);
+}
+
+test "pipeline - transform errors are reported" {
+    const Reject = struct {
+        fn apply(_: ?*anyopaque, record: []const u8, out: Output) anyerror!void {
+            if (std.mem.eql(u8, record, "bad")) return error.BadRecord;
+            try out.write(record);
+        }
+    };
+    try std.testing.expectError(error.BadRecord, testRoundTrip("ok\nbad\nok\n", .{ .block_size = 3 }, .{ .func = Reject.apply }, ""));
+}
+
+test "pipeline - empty input" {
+    const stats = try testRoundTrip("", .{}, Transform.allocating(@import("../methods/case.zig").toUpperCase), "");
+    try std.testing.expectEqual(@as(usize, 0), stats.records);
+}
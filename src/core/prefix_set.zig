@@ -0,0 +1,404 @@
+const std = @import("std");
+
+const Allocator = std.mem.Allocator;
+
+/// Serialized form magic: "ZSPREFIX"
+pub const magic = "ZSPREFIX".*;
+
+/// Current format version
+pub const format_version: u32 = 2;
+
+/// Written in native order; reads back differently on a machine of the
+/// other byte order, whose arrays would be garbage
+pub const byte_order_mark: u32 = 0x01020304;
+
+/// `values` entry of a slot that ends no prefix
+pub const no_value = std.math.maxInt(u32);
+
+/// `checks` entry of a free slot
+const free_slot: i32 = -1;
+
+/// `checks` entry of the root (used, but never a transition target)
+const root_slot: i32 = -2;
+
+pub const FormatError = error{
+    InvalidFormat,
+    UnsupportedVersion,
+    UnsupportedEndian,
+};
+
+/// Header of the serialized form, followed by three u32/i32 arrays of
+/// `slot_count` entries: bases, checks, values
+pub const Header = extern struct {
+    magic: [8]u8 = magic,
+    version: u32 = format_version,
+    slot_count: u32 = 0,
+    prefix_count: u32 = 0,
+    byte_order: u32 = byte_order_mark,
+};
+
+/// A matching prefix: its id (index in the build input) and byte length
+pub const Match = struct {
+    id: u32,
+    len: usize,
+};
+
+/// Set of byte-string prefixes stored as a double-array trie
+///
+/// A transition from slot `s` on byte `c` goes to `t = bases[s] + c`,
+/// valid when `checks[t] == s`, so each path byte costs one array lookup
+/// no matter how many prefixes the set holds. The three arrays live in
+/// one buffer that is also the serialized form, so a set can be saved
+/// and viewed again without rebuilding.
+pub const PrefixSet = struct {
+    bases: []const i32,
+    checks: []const i32,
+    values: []const u32,
+    prefix_count: usize,
+    /// Backing buffer (header + arrays)
+    buffer: []align(4) const u8,
+    /// Set when the buffer is owned
+    allocator: ?Allocator = null,
+
+    const Entry = struct {
+        key: []const u8,
+        id: u32,
+
+        fn lessThan(_: void, a: Entry, b: Entry) bool {
+            return switch (std.mem.order(u8, a.key, b.key)) {
+                .lt => true,
+                .gt => false,
+                .eq => a.id < b.id,
+            };
+        }
+    };
+
+    const Pending = struct {
+        slot: u32,
+        lo: usize,
+        hi: usize,
+        depth: usize,
+    };
+
+    /// Builds a set from `prefixes`; match ids are indices into `prefixes`
+    ///
+    /// When a prefix occurs more than once, the first id wins.
+    pub fn build(allocator: Allocator, prefixes: []const []const u8) !PrefixSet {
+        if (prefixes.len >= no_value) return error.TooManyPrefixes;
+
+        const entries = try allocator.alloc(Entry, prefixes.len);
+        defer allocator.free(entries);
+        for (prefixes, entries, 0..) |p, *e, i| e.* = .{ .key = p, .id = @intCast(i) };
+        std.mem.sort(Entry, entries, {}, Entry.lessThan);
+
+        var bases = std.ArrayList(i32){};
+        defer bases.deinit(allocator);
+        var checks = std.ArrayList(i32){};
+        defer checks.deinit(allocator);
+        var values = std.ArrayList(u32){};
+        defer values.deinit(allocator);
+
+        try growSlots(allocator, &bases, &checks, &values, 256);
+        checks.items[0] = root_slot;
+
+        var queue = std.ArrayList(Pending){};
+        defer queue.deinit(allocator);
+        try queue.append(allocator, .{ .slot = 0, .lo = 0, .hi = entries.len, .depth = 0 });
+
+        var first_free: usize = 1;
+        var head: usize = 0;
+        while (head < queue.items.len) : (head += 1) {
+            const node = queue.items[head];
+            var lo = node.lo;
+
+            // A key that ends here sorts first; duplicates after it are skipped
+            if (lo < node.hi and entries[lo].key.len == node.depth) {
+                values.items[node.slot] = entries[lo].id;
+                while (lo < node.hi and entries[lo].key.len == node.depth) lo += 1;
+            }
+            if (lo == node.hi) continue;
+
+            // Children: one per distinct byte at `depth`
+            var labels: [256]u8 = undefined;
+            var starts: [257]usize = undefined;
+            var k: usize = 0;
+            var i = lo;
+            while (i < node.hi) : (i += 1) {
+                const c = entries[i].key[node.depth];
+                if (k == 0 or labels[k - 1] != c) {
+                    labels[k] = c;
+                    starts[k] = i;
+                    k += 1;
+                }
+            }
+            starts[k] = node.hi;
+
+            while (first_free < checks.items.len and checks.items[first_free] != free_slot) first_free += 1;
+            var base: usize = @max(1, first_free -| labels[0]);
+            search: while (true) : (base += 1) {
+                const needed = base + @as(usize, labels[k - 1]) + 1;
+                if (needed > checks.items.len) {
+                    try growSlots(allocator, &bases, &checks, &values, @max(needed, checks.items.len * 2));
+                }
+                for (labels[0..k]) |c| {
+                    if (checks.items[base + c] != free_slot) continue :search;
+                }
+                break;
+            }
+            if (base > std.math.maxInt(i32) - 256) return error.TooManyPrefixes;
+
+            bases.items[node.slot] = @intCast(base);
+            for (labels[0..k], 0..) |c, j| {
+                const t = base + c;
+                checks.items[t] = @intCast(node.slot);
+                try queue.append(allocator, .{ .slot = @intCast(t), .lo = starts[j], .hi = starts[j + 1], .depth = node.depth + 1 });
+            }
+        }
+
+        // Drop trailing free slots
+        var slot_count = checks.items.len;
+        while (slot_count > 1 and checks.items[slot_count - 1] == free_slot) slot_count -= 1;
+
+        const buffer = try allocator.alignedAlloc(u8, .@"4", @sizeOf(Header) + slot_count * 12);
+        const header = Header{ .slot_count = @intCast(slot_count), .prefix_count = @intCast(prefixes.len) };
+        @memcpy(buffer[0..@sizeOf(Header)], std.mem.asBytes(&header));
+        var pos: usize = @sizeOf(Header);
+        for ([_][]const u8{
+            std.mem.sliceAsBytes(bases.items[0..slot_count]),
+            std.mem.sliceAsBytes(checks.items[0..slot_count]),
+            std.mem.sliceAsBytes(values.items[0..slot_count]),
+        }) |array| {
+            @memcpy(buffer[pos .. pos + array.len], array);
+            pos += array.len;
+        }
+
+        var set = fromBytes(buffer) catch unreachable;
+        set.allocator = allocator;
+        return set;
+    }
+
+    fn growSlots(allocator: Allocator, bases: *std.ArrayList(i32), checks: *std.ArrayList(i32), values: *std.ArrayList(u32), n: usize) !void {
+        const extra = n - checks.items.len;
+        try bases.appendNTimes(allocator, 0, extra);
+        try checks.appendNTimes(allocator, free_slot, extra);
+        try values.appendNTimes(allocator, no_value, extra);
+    }
+
+    /// Views a serialized set without copying (`bytes` must outlive it)
+    ///
+    /// Every slot is validated (O(slot_count)), so corrupt or untrusted
+    /// input returns error.InvalidFormat instead of faulting on lookup.
+    pub fn fromBytes(bytes: []align(4) const u8) FormatError!PrefixSet {
+        if (bytes.len < @sizeOf(Header)) return error.InvalidFormat;
+
+        const header: *const Header = @ptrCast(bytes.ptr);
+        if (!std.mem.eql(u8, &header.magic, &magic)) return error.InvalidFormat;
+        if (header.byte_order != byte_order_mark) {
+            return if (header.byte_order == @byteSwap(byte_order_mark)) error.UnsupportedEndian else error.InvalidFormat;
+        }
+        if (header.version != format_version) return error.UnsupportedVersion;
+
+        const n: usize = header.slot_count;
+        if (n == 0 or n > std.math.maxInt(i32)) return error.InvalidFormat;
+        if (bytes.len - @sizeOf(Header) < n * 12) return error.InvalidFormat;
+
+        const arrays: [*]const u32 = @ptrCast(@alignCast(bytes.ptr + @sizeOf(Header)));
+        const set = PrefixSet{
+            .bases = @ptrCast(arrays[0..n]),
+            .checks = @ptrCast(arrays[n .. 2 * n]),
+            .values = arrays[2 * n .. 3 * n],
+            .prefix_count = header.prefix_count,
+            .buffer = bytes[0 .. @sizeOf(Header) + n * 12],
+        };
+        try set.validate();
+        return set;
+    }
+
+    /// Checks the invariants step() and the match iterator rely on
+    fn validate(self: PrefixSet) FormatError!void {
+        if (self.checks[0] != root_slot) return error.InvalidFormat;
+        for (self.bases, self.checks, self.values, 0..) |base, check, value, slot| {
+            // step() computes base + c as an unsigned index
+            if (base < 0 or base > std.math.maxInt(i32) - 256) return error.InvalidFormat;
+            if (slot > 0 and check != free_slot and (check < 0 or check >= self.checks.len)) return error.InvalidFormat;
+            if (value != no_value and value >= self.prefix_count) return error.InvalidFormat;
+        }
+    }
+
+    /// Copies a serialized set into an owned buffer
+    pub fn load(allocator: Allocator, bytes: []const u8) !PrefixSet {
+        const buffer = try allocator.alignedAlloc(u8, .@"4", bytes.len);
+        errdefer allocator.free(buffer);
+        @memcpy(buffer, bytes);
+
+        var set = try fromBytes(buffer);
+        set.allocator = allocator;
+        return set;
+    }
+
+    pub fn deinit(self: *PrefixSet) void {
+        if (self.allocator) |allocator| allocator.free(self.buffer);
+        self.* = undefined;
+    }
+
+    /// Serialized form (valid while the set is alive)
+    pub inline fn serialized(self: PrefixSet) []const u8 {
+        return self.buffer;
+    }
+
+    /// Number of prefixes the set was built from
+    pub inline fn len(self: PrefixSet) usize {
+        return self.prefix_count;
+    }
+
+    /// Follows byte `c` from `slot`
+    inline fn step(self: PrefixSet, slot: usize, c: u8) ?usize {
+        const t = @as(usize, @intCast(self.bases[slot])) + c;
+        if (t >= self.checks.len or self.checks[t] != @as(i32, @intCast(slot))) return null;
+        return t;
+    }
+
+    /// Longest prefix of `str` in the set
+    pub fn longestMatch(self: PrefixSet, str: []const u8) ?Match {
+        var it = self.matches(str);
+        var best: ?Match = null;
+        while (it.next()) |m| best = m;
+        return best;
+    }
+
+    /// Whether `str` starts with any prefix in the set
+    pub fn containsPrefixOf(self: PrefixSet, str: []const u8) bool {
+        var it = self.matches(str);
+        return it.next() != null;
+    }
+
+    /// Id of `key` if it is exactly one of the prefixes
+    pub fn find(self: PrefixSet, key: []const u8) ?u32 {
+        var slot: usize = 0;
+        for (key) |c| slot = self.step(slot, c) orelse return null;
+        const value = self.values[slot];
+        return if (value == no_value) null else value;
+    }
+
+    /// Iterates every prefix of `str` in the set, shortest first
+    pub fn matches(self: PrefixSet, str: []const u8) MatchIterator {
+        return .{ .set = self, .str = str };
+    }
+
+    pub const MatchIterator = struct {
+        set: PrefixSet,
+        str: []const u8,
+        slot: usize = 0,
+        pos: usize = 0,
+        done: bool = false,
+
+        pub fn next(self: *MatchIterator) ?Match {
+            while (!self.done) {
+                const value = self.set.values[self.slot];
+                const matched = self.pos;
+                if (self.pos == self.str.len) {
+                    self.done = true;
+                } else if (self.set.step(self.slot, self.str[self.pos])) |t| {
+                    self.slot = t;
+                    self.pos += 1;
+                } else {
+                    self.done = true;
+                }
+                if (value != no_value) return .{ .id = value, .len = matched };
+            }
+            return null;
+        }
+    };
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+const test_routes = [_][]const u8{ "/api", "/api/v1", "/api/v1/users", "/static", "/api/v2", "/", "/api" };
+
+test "PrefixSet - longest and all matches" {
+    const allocator = std.testing.allocator;
+
+    var set = try PrefixSet.build(allocator, &test_routes);
+    defer set.deinit();
+
+    try std.testing.expectEqual(@as(?Match, .{ .id = 2, .len = 13 }), set.longestMatch("/api/v1/users/42"));
+    try std.testing.expectEqual(@as(?Match, .{ .id = 1, .len = 7 }), set.longestMatch("/api/v1/orders"));
+    try std.testing.expectEqual(@as(?Match, .{ .id = 3, .len = 7 }), set.longestMatch("/static/app.js"));
+    try std.testing.expectEqual(@as(?Match, .{ .id = 5, .len = 1 }), set.longestMatch("/other"));
+    try std.testing.expectEqual(@as(?Match, null), set.longestMatch("api"));
+    try std.testing.expect(!set.containsPrefixOf(""));
+
+    var ids = std.ArrayList(u32){};
+    defer ids.deinit(allocator);
+    var it = set.matches("/api/v1/users");
+    while (it.next()) |m| try ids.append(allocator, m.id);
+    // Duplicate "/api" keeps the first id
+    try std.testing.expectEqualSlices(u32, &[_]u32{ 5, 0, 1, 2 }, ids.items);
+
+    try std.testing.expectEqual(@as(?u32, 4), set.find("/api/v2"));
+    try std.testing.expectEqual(@as(?u32, null), set.find("/api/v"));
+}
+
+test "PrefixSet - serialize and view" {
+    const allocator = std.testing.allocator;
+
+    var set = try PrefixSet.build(allocator, &test_routes);
+    defer set.deinit();
+
+    var loaded = try PrefixSet.load(allocator, set.serialized());
+    defer loaded.deinit();
+    try std.testing.expectEqual(set.len(), loaded.len());
+    try std.testing.expectEqual(@as(?Match, .{ .id = 2, .len = 13 }), loaded.longestMatch("/api/v1/users?x"));
+
+    try std.testing.expectError(error.InvalidFormat, PrefixSet.fromBytes(set.buffer[0..8]));
+}
+
+test "PrefixSet - corrupt input is rejected" {
+    const allocator = std.testing.allocator;
+
+    var set = try PrefixSet.build(allocator, &test_routes);
+    defer set.deinit();
+
+    const buf = try allocator.alignedAlloc(u8, .@"4", set.buffer.len);
+    defer allocator.free(buf);
+    const n = set.checks.len;
+    const arrays: [*]i32 = @ptrCast(@alignCast(buf.ptr + @sizeOf(Header)));
+
+    // Negative base
+    @memcpy(buf, set.buffer);
+    arrays[0] = -5;
+    try std.testing.expectError(error.InvalidFormat, PrefixSet.fromBytes(buf));
+
+    // Check pointing past the arrays
+    @memcpy(buf, set.buffer);
+    arrays[n + 1] = @intCast(n + 10);
+    try std.testing.expectError(error.InvalidFormat, PrefixSet.fromBytes(buf));
+
+    // Value that is not a prefix id
+    @memcpy(buf, set.buffer);
+    arrays[2 * n] = @intCast(test_routes.len);
+    try std.testing.expectError(error.InvalidFormat, PrefixSet.fromBytes(buf));
+
+    // Written on a machine of the other byte order
+    @memcpy(buf, set.buffer);
+    const header: *Header = @ptrCast(buf.ptr);
+    header.byte_order = @byteSwap(byte_order_mark);
+    try std.testing.expectError(error.UnsupportedEndian, PrefixSet.fromBytes(buf));
+}
+
+test "PrefixSet - empty prefix and binary keys" {
+    const allocator = std.testing.allocator;
+
+    var set = try PrefixSet.build(allocator, &[_][]const u8{ "", "\x00\xff", "\xff" });
+    defer set.deinit();
+
+    try std.testing.expectEqual(@as(?Match, .{ .id = 0, .len = 0 }), set.longestMatch("abc"));
+    try std.testing.expectEqual(@as(?Match, .{ .id = 1, .len = 2 }), set.longestMatch("\x00\xff\x01"));
+    try std.testing.expectEqual(@as(?Match, .{ .id = 2, .len = 1 }), set.longestMatch("\xff"));
+
+    var empty = try PrefixSet.build(allocator, &[_][]const u8{});
+    defer empty.deinit();
+    try std.testing.expectEqual(@as(?Match, null), empty.longestMatch("/"));
+}
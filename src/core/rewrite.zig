@@ -0,0 +1,68 @@
+const std = @import("std");
+const simd = @import("simd.zig");
+const ZString = @import("string.zig").ZString;
+const Allocator = std.mem.Allocator;
+
+/// Two-pass rewrite engine for escaping-style transforms
+///
+/// A codec is a byte class (see simd.indexOfClass) plus a `step` function
+/// that rewrites the sequence starting at a special byte:
+///
+///   fn vector(simd.Vec) simd.Vec
+///   fn scalar(u8) bool
+///   fn step(str: []const u8, pos: usize, buf: *[step_buf_len]u8) !Step
+///
+/// Special bytes are located with vector compares and the clean runs between
+/// them are copied in bulk. The engine runs twice: once to measure the exact
+/// output length, once to write into a single allocation. If the input has no
+/// special bytes at all, it is returned as a borrowed ZString.
+
+/// Scratch space available to a codec's step function
+pub const step_buf_len = 12;
+
+/// Result of rewriting one special sequence
+pub const Step = struct {
+    /// Bytes to emit (may point into the step buffer or the input)
+    bytes: []const u8,
+    /// Input bytes consumed
+    consumed: usize,
+};
+
+/// Rewrites str[start..] into `out`, or only measures it when `out` is null
+/// Returns the number of bytes produced.
+pub fn rewrite(comptime Codec: type, str: []const u8, start: usize, out: ?[]u8) !usize {
+    var written: usize = 0;
+    var i: usize = start;
+    var buf: [step_buf_len]u8 = undefined;
+
+    while (simd.indexOfClass(Codec, str, i)) |pos| {
+        written += emit(out, written, str[i..pos]);
+        const step = try Codec.step(str, pos, &buf);
+        written += emit(out, written, step.bytes);
+        i = pos + step.consumed;
+    }
+    written += emit(out, written, str[i..]);
+
+    return written;
+}
+
+inline fn emit(out: ?[]u8, at: usize, bytes: []const u8) usize {
+    if (out) |dest| @memcpy(dest[at .. at + bytes.len], bytes);
+    return bytes.len;
+}
+
+/// Applies a codec to `str`
+/// Returns `str` borrowed when it contains no special bytes, otherwise an
+/// owned ZString holding the rewritten text.
+pub fn apply(comptime Codec: type, allocator: Allocator, str: []const u8) !ZString {
+    const first = simd.indexOfClass(Codec, str, 0) orelse return ZString.init(str);
+
+    const out_len = first + try rewrite(Codec, str, first, null);
+    const result = try allocator.alloc(u8, out_len);
+    errdefer allocator.free(result);
+
+    @memcpy(result[0..first], str[0..first]);
+    _ = try rewrite(Codec, str, first, result[first..]);
+
+    return ZString.fromOwned(allocator, result);
+}
@@ -0,0 +1,258 @@
+const std = @import("std");
+const builtin = @import("builtin");
+
+/// Portable byte-vector helpers shared by the scanning fast paths
+///
+/// Every helper works on `Vec`, a vector of `lanes` bytes sized for the
+/// target (16 on SSE2/NEON, 32 on AVX2). Classification results are kept
+/// as byte masks (0xFF = hit, 0x00 = miss) so they can be combined with
+/// plain `|` and `&` before a single horizontal reduction.
+pub const lanes = std.simd.suggestVectorLength(u8) orelse 16;
+
+/// A vector of `lanes` bytes
+pub const Vec = @Vector(lanes, u8);
+
+/// Broadcasts a byte to every lane
+pub inline fn splat(b: u8) Vec {
+    return @splat(b);
+}
+
+/// Loads `lanes` bytes starting at `offset`
+/// The caller guarantees that `offset + lanes <= bytes.len`.
+pub inline fn load(bytes: []const u8, offset: usize) Vec {
+    return bytes[offset..][0..lanes].*;
+}
+
+/// Converts a lane predicate into a byte mask
+pub inline fn toBits(pred: @Vector(lanes, bool)) Vec {
+    return @select(u8, pred, splat(0xFF), splat(0));
+}
+
+/// Byte mask of lanes equal to `b`
+pub inline fn eq(v: Vec, b: u8) Vec {
+    return toBits(v == splat(b));
+}
+
+/// Byte mask of lanes strictly below `b`
+pub inline fn lessThan(v: Vec, b: u8) Vec {
+    return toBits(v < splat(b));
+}
+
+/// Byte mask of lanes in the inclusive range [lo, hi]
+pub inline fn inRange(v: Vec, lo: u8, hi: u8) Vec {
+    // Wrapping subtraction folds both bounds into one unsigned compare
+    return toBits((v -% splat(lo)) <= splat(hi - lo));
+}
+
+/// Returns true if any lane of the mask is set
+pub inline fn any(mask: Vec) bool {
+    return @reduce(.Or, mask) != 0;
+}
+
+/// Returns the index of the first set lane of a non-empty mask
+pub inline fn firstSet(mask: Vec) usize {
+    return std.simd.firstTrue(mask != splat(0)).?;
+}
+
+/// Broadcasts a 16-entry table to every 16-byte group of a vector
+pub fn table16(table: [16]u8) Vec {
+    var v: Vec = undefined;
+    inline for (0..lanes) |i| v[i] = table[i % 16];
+    return v;
+}
+
+/// Whether lookup16() compiles to a single byte shuffle (pshufb)
+const native_shuffle = builtin.cpu.arch == .x86_64 and
+    ((lanes == 16 and std.Target.x86.featureSetHas(builtin.cpu.features, .avx)) or
+        (lanes == 32 and std.Target.x86.featureSetHas(builtin.cpu.features, .avx2)));
+
+/// Per-lane table lookup: lane i of the result is `table[idx[i]]`
+///
+/// `table` comes from table16() and every index must be below 16. On
+/// AVX/AVX2 targets this is one vpshufb; elsewhere it is unrolled.
+pub inline fn lookup16(table: Vec, idx: Vec) Vec {
+    if (native_shuffle) {
+        return asm ("vpshufb %[idx], %[table], %[out]"
+            : [out] "=x" (-> Vec),
+            : [table] "x" (table),
+              [idx] "x" (idx),
+        );
+    } else {
+        const entries: [lanes]u8 = table;
+        var out: Vec = undefined;
+        inline for (0..lanes) |i| out[i] = entries[idx[i]];
+        return out;
+    }
+}
+
+/// Finds the first byte at or after `start` that belongs to a byte class
+///
+/// `Class` must declare `fn vector(Vec) Vec` returning a byte mask and
+/// `fn scalar(u8) bool`; both must classify bytes identically. Full vectors
+/// are scanned with `vector`, the tail with `scalar`.
+pub fn indexOfClass(comptime Class: type, bytes: []const u8, start: usize) ?usize {
+    var i = start;
+    while (i + lanes <= bytes.len) : (i += lanes) {
+        const mask = Class.vector(load(bytes, i));
+        if (any(mask)) return i + firstSet(mask);
+    }
+    while (i < bytes.len) : (i += 1) {
+        if (Class.scalar(bytes[i])) return i;
+    }
+    return null;
+}
+
+/// Returns true if every byte in `bytes` is ASCII (< 0x80)
+pub fn isAscii(bytes: []const u8) bool {
+    var i: usize = 0;
+    while (i + lanes <= bytes.len) : (i += lanes) {
+        if (any(toBits(load(bytes, i) >= splat(0x80)))) return false;
+    }
+    while (i < bytes.len) : (i += 1) {
+        if (bytes[i] >= 0x80) return false;
+    }
+    return true;
+}
+
+/// Returns the length of the longest common prefix of `a` and `b`
+pub fn commonPrefixLength(a: []const u8, b: []const u8) usize {
+    const n = @min(a.len, b.len);
+    var i: usize = 0;
+    while (i + lanes <= n) : (i += lanes) {
+        const mask = toBits(load(a, i) != load(b, i));
+        if (any(mask)) return i + firstSet(mask);
+    }
+    while (i < n and a[i] == b[i]) : (i += 1) {}
+    return i;
+}
+
+/// Returns the length of the longest common suffix of `a` and `b`
+pub fn commonSuffixLength(a: []const u8, b: []const u8) usize {
+    const n = @min(a.len, b.len);
+    var i: usize = 0;
+    while (i + lanes <= n) : (i += lanes) {
+        const mask = load(a, a.len - i - lanes) != load(b, b.len - i - lanes);
+        if (std.simd.lastTrue(mask)) |last| return i + (lanes - 1 - last);
+    }
+    while (i < n and a[a.len - 1 - i] == b[b.len - 1 - i]) : (i += 1) {}
+    return i;
+}
+
+/// A runtime set of bytes with a vectorized membership scan
+///
+/// Small sets (up to `small_max` distinct bytes) are scanned with one
+/// vector compare per member; larger sets fall back to a 256-entry table.
+pub const ByteSet = struct {
+    table: [256]bool = [_]bool{false} ** 256,
+    members: [small_max]u8 = undefined,
+    count: usize = 0,
+
+    pub const small_max = 8;
+
+    /// Adds a byte to the set (duplicates are ignored)
+    pub fn add(self: *ByteSet, b: u8) void {
+        if (self.table[b]) return;
+        self.table[b] = true;
+        if (self.count < small_max) self.members[self.count] = b;
+        self.count += 1;
+    }
+
+    /// Returns true if `b` is a member of the set
+    pub inline fn contains(self: *const ByteSet, b: u8) bool {
+        return self.table[b];
+    }
+
+    /// Returns the index of the first member byte at or after `start`
+    pub fn indexOf(self: *const ByteSet, bytes: []const u8, start: usize) ?usize {
+        if (self.count == 0) return null;
+
+        var i = start;
+        if (self.count <= small_max) {
+            while (i + lanes <= bytes.len) : (i += lanes) {
+                const v = load(bytes, i);
+                var mask = splat(0);
+                for (self.members[0..self.count]) |m| {
+                    mask |= eq(v, m);
+                }
+                if (any(mask)) return i + firstSet(mask);
+            }
+        }
+        while (i < bytes.len) : (i += 1) {
+            if (self.table[bytes[i]]) return i;
+        }
+        return null;
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "ByteSet - small set scan across vector boundary" {
+    var set = ByteSet{};
+    set.add('&');
+    set.add('<');
+
+    const text = "a plain run of text that is long enough <b> & more";
+    try std.testing.expectEqual(@as(?usize, 40), set.indexOf(text, 0));
+    try std.testing.expectEqual(@as(?usize, 44), set.indexOf(text, 41));
+    try std.testing.expectEqual(@as(?usize, null), set.indexOf("no specials", 0));
+}
+
+test "ByteSet - large set uses table" {
+    var set = ByteSet{};
+    for ("0123456789") |c| set.add(c);
+
+    try std.testing.expect(set.count > ByteSet.small_max);
+    try std.testing.expectEqual(@as(?usize, 5), set.indexOf("abcde7", 0));
+}
+
+test "indexOfClass - control characters" {
+    const Control = struct {
+        fn vector(v: Vec) Vec {
+            return lessThan(v, 0x20);
+        }
+        fn scalar(b: u8) bool {
+            return b < 0x20;
+        }
+    };
+
+    const text = "0123456789abcdef0123456789abcdef\tend";
+    try std.testing.expectEqual(@as(?usize, 32), indexOfClass(Control, text, 0));
+    try std.testing.expectEqual(@as(?usize, null), indexOfClass(Control, "clean", 0));
+}
+
+test "inRange and isAscii" {
+    const v = load("az{AZ09" ++ "\x00" ** (lanes - 7), 0);
+    const mask = inRange(v, 'a', 'z');
+    try std.testing.expectEqual(@as(u8, 0xFF), mask[0]);
+    try std.testing.expectEqual(@as(u8, 0xFF), mask[1]);
+    try std.testing.expectEqual(@as(u8, 0x00), mask[2]);
+
+    try std.testing.expect(isAscii("hello world"));
+    try std.testing.expect(!isAscii("café"));
+}
+
+test "commonPrefixLength and commonSuffixLength" {
+    const a = "the quick brown fox jumps over the lazy dog, again and again";
+    const b = "the quick brown fox jumps over the lazy cat, again and again";
+    try std.testing.expectEqual(@as(usize, 40), commonPrefixLength(a, b));
+    try std.testing.expectEqual(@as(usize, 17), commonSuffixLength(a, b));
+    try std.testing.expectEqual(a.len, commonPrefixLength(a, a));
+    try std.testing.expectEqual(@as(usize, 3), commonPrefixLength("abc", "abcdef"));
+    try std.testing.expectEqual(@as(usize, 0), commonSuffixLength("abc", ""));
+    try std.testing.expectEqual(@as(usize, 3), commonSuffixLength("xyzdef", "def"));
+}
+
+test "lookup16" {
+    var table: [16]u8 = undefined;
+    for (&table, 0..) |*entry, i| entry.* = @intCast(i * 3);
+    const t = table16(table);
+
+    var idx: Vec = undefined;
+    inline for (0..lanes) |i| idx[i] = @intCast((i * 7) % 16);
+    const out = lookup16(t, idx);
+    inline for (0..lanes) |i| {
+        try std.testing.expectEqual(table[(i * 7) % 16], out[i]);
+    }
+}
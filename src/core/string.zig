@@ -6,9 +6,16 @@ const transform = @import("../methods/transform.zig");
 const padding = @import("../methods/padding.zig");
 const trimming = @import("../methods/trimming.zig");
 const split_methods = @import("../methods/split.zig");
+const join_methods = @import("../methods/join.zig");
 const case = @import("../methods/case.zig");
 const utility = @import("../methods/utility.zig");
 const regex_methods = @import("../methods/regex.zig");
+const replace_many = @import("../methods/replace_many.zig");
+const escape = @import("../methods/escape.zig");
+const uri = @import("../methods/uri.zig");
+const fuzzy = @import("../methods/fuzzy.zig");
+const display = @import("../methods/width.zig");
+const charset = @import("../methods/charset.zig");
 
 const Allocator = std.mem.Allocator;
 
@@ -238,6 +245,36 @@ pub const ZString = struct {
         return search.endsWith(self.data, searchString, endPosition);
     }
 
+    /// Approximate indexOf: first occurrence of searchString with at most
+    /// maxErrors edits, or null. Index and length are in UTF-16 code units.
+    /// See fuzzy.indexOfApprox().
+    pub fn indexOfApprox(self: ZString, allocator: Allocator, searchString: []const u8, maxErrors: usize, options: fuzzy.Options) !?fuzzy.Match {
+        return fuzzy.indexOfApprox(allocator, self.data, searchString, maxErrors, options);
+    }
+
+    /// Levenshtein distance to `that` in code points (optionally counting
+    /// adjacent transpositions as one edit). See fuzzy.distance().
+    pub fn editDistance(self: ZString, allocator: Allocator, that: []const u8, options: fuzzy.Options) !usize {
+        return fuzzy.distance(allocator, self.data, that, options);
+    }
+
+    /// Index of the first code point in `set` at or after `position`, or -1
+    /// (strpbrk with UTF-16 indices). See charset.CharSet.
+    pub fn indexOfAny(self: ZString, set: *const charset.CharSet, position: ?isize) isize {
+        return set.indexOfAny(self.data, position);
+    }
+
+    /// Index of the last code point in `set` at or before `position`, or -1
+    pub fn lastIndexOfAny(self: ZString, set: *const charset.CharSet, position: ?isize) isize {
+        return set.lastIndexOfAny(self.data, position);
+    }
+
+    /// Length in UTF-16 code units of the leading run of code points in
+    /// `set` (strspn)
+    pub fn spanOf(self: ZString, set: *const charset.CharSet) usize {
+        return set.spanOf(self.data);
+    }
+
     // ========================================================================
     // Transformation Methods
     // ========================================================================
@@ -313,6 +350,34 @@ pub const ZString = struct {
         return padding.padEnd(allocator, self.data, targetLength, padString);
     }
 
+    /// Terminal display width in columns (CJK and emoji count two,
+    /// combining marks none). See methods/width.zig.
+    pub fn displayWidth(self: ZString) usize {
+        return display.width(self.data);
+    }
+
+    /// Pads to `target` display columns rather than UTF-16 code units
+    ///
+    /// The returned string must be freed by the caller.
+    pub fn padToWidth(self: ZString, allocator: Allocator, target: usize, options: display.PadOptions) ![]u8 {
+        return display.padToWidth(allocator, self.data, target, options);
+    }
+
+    /// Cuts to at most `max` display columns, appending `ellipsis` if
+    /// anything was removed
+    ///
+    /// The returned string must be freed by the caller.
+    pub fn truncateToWidth(self: ZString, allocator: Allocator, max: usize, ellipsis: []const u8) ![]u8 {
+        return display.truncateToWidth(allocator, self.data, max, ellipsis);
+    }
+
+    /// Word-wraps to lines of at most `max` display columns
+    ///
+    /// Returns slices of this string; free only the outer slice.
+    pub fn wrapToWidth(self: ZString, allocator: Allocator, max: usize) ![][]const u8 {
+        return display.wrapToWidth(allocator, self.data, max);
+    }
+
     // ========================================================================
     // Trimming Methods
     // ========================================================================
@@ -354,6 +419,13 @@ pub const ZString = struct {
     /// Alias for trimEnd()
     pub const trimRight = trimEnd;
 
+    /// Removes leading and trailing code points that are in `set`
+    ///
+    /// The returned string must be freed by the caller.
+    pub fn trimChars(self: ZString, allocator: Allocator, set: *const charset.CharSet) ![]u8 {
+        return set.trimChars(allocator, self.data);
+    }
+
     // ========================================================================
     // Split Methods
     // ========================================================================
@@ -376,6 +448,41 @@ pub const ZString = struct {
         split_methods.freeSplitResult(allocator, result);
     }
 
+    /// Splits at every code point in `set`
+    ///
+    /// Returns slices of this string; free only the outer slice.
+    pub fn splitAny(self: ZString, allocator: Allocator, set: *const charset.CharSet) ![][]const u8 {
+        return set.splitAny(allocator, self.data);
+    }
+
+    /// Lazy split(): yields the same fields as split() as slices of this
+    /// string. See split.splitIterator().
+    pub fn splitIterator(self: ZString, separator: []const u8, limit: ?usize) split_methods.SplitIterator {
+        return split_methods.splitIterator(self.data, separator, limit);
+    }
+
+    /// Zero-copy iterator over lines, ending at \n, \r, \r\n, U+2028 and
+    /// U+2029. See split.lines().
+    pub fn lines(self: ZString, options: split_methods.LinesOptions) split_methods.LineIterator {
+        return split_methods.lines(self.data, options);
+    }
+
+    /// Fused split(separator) -> map -> join(joiner)
+    ///
+    /// Produces the same result as splitting, mapping each field to a view and
+    /// joining, in a single exact-size allocation with no intermediate arrays.
+    /// See join.splitMapJoin() for the requirements on `map`.
+    pub fn splitMapJoin(
+        self: ZString,
+        allocator: Allocator,
+        separator: []const u8,
+        joiner: []const u8,
+        context: anytype,
+        comptime map: fn (@TypeOf(context), []const u8) []const u8,
+    ) ![]u8 {
+        return join_methods.splitMapJoin(allocator, self.data, separator, joiner, context, map);
+    }
+
     // ========================================================================
     // Case Conversion Methods
     // ========================================================================
@@ -518,6 +625,14 @@ pub const ZString = struct {
         return regex_methods.matchAll(allocator, self.data, pattern);
     }
 
+    /// Lazy matchAll(): finds one match per next() call, borrowing from
+    /// this string. Call deinit() on the iterator.
+    ///
+    /// Note: Requires zregexp dependency.
+    pub fn matchAllIterator(self: ZString, allocator: Allocator, pattern: []const u8) !regex_methods.MatchIterator {
+        return regex_methods.matchIterator(allocator, self.data, pattern);
+    }
+
     /// Helper to free the result of matchAll()
     pub fn freeMatchAllResult(allocator: Allocator, matches: []regex_methods.MatchArray) void {
         regex_methods.freeMatchAll(allocator, matches);
@@ -548,6 +663,101 @@ pub const ZString = struct {
     pub fn replaceAllRegex(self: ZString, allocator: Allocator, pattern: []const u8, replacement: []const u8) ![]const u8 {
         return regex_methods.replaceAll(allocator, self.data, pattern, replacement);
     }
+
+    /// Replaces every occurrence of each literal key with its replacement
+    ///
+    /// All pairs are applied in a single leftmost-longest pass; replacement
+    /// text is never re-scanned. To apply the same pairs to many strings,
+    /// compile a replace_many.Replacer once instead.
+    ///
+    /// The returned string must be freed by the caller.
+    pub fn replaceMany(self: ZString, allocator: Allocator, pairs: []const replace_many.Pair) ![]u8 {
+        return replace_many.replaceMany(allocator, self.data, pairs);
+    }
+
+    // ========================================================================
+    // Escaping Methods
+    // ========================================================================
+
+    /// Escapes the string for use inside a JSON string literal
+    ///
+    /// Returns this string borrowed when nothing needs escaping, otherwise an
+    /// owned copy. Always call deinit() on the result.
+    pub fn escapeJson(self: ZString, allocator: Allocator) !ZString {
+        return escape.escapeJson(allocator, self.data);
+    }
+
+    /// Decodes JSON string escape sequences
+    ///
+    /// Returns this string borrowed when it has no escapes, otherwise an
+    /// owned copy. Always call deinit() on the result.
+    pub fn unescapeJson(self: ZString, allocator: Allocator) !ZString {
+        return escape.unescapeJson(allocator, self.data);
+    }
+
+    /// JSON.stringify(string)
+    /// Spec: https://tc39.es/ecma262/2025/#sec-quotejsonstring
+    ///
+    /// The returned string must be freed by the caller.
+    pub fn quoteJson(self: ZString, allocator: Allocator) ![]u8 {
+        return escape.quoteJson(allocator, self.data);
+    }
+
+    /// Escapes the HTML special characters & < > " '
+    ///
+    /// Returns this string borrowed when nothing needs escaping, otherwise an
+    /// owned copy. Always call deinit() on the result.
+    pub fn escapeHtml(self: ZString, allocator: Allocator) !ZString {
+        return escape.escapeHtml(allocator, self.data);
+    }
+
+    /// Decodes HTML character references
+    ///
+    /// Returns this string borrowed when it has no references, otherwise an
+    /// owned copy. Always call deinit() on the result.
+    pub fn unescapeHtml(self: ZString, allocator: Allocator) !ZString {
+        return escape.unescapeHtml(allocator, self.data);
+    }
+
+    // ========================================================================
+    // URI Methods
+    // ========================================================================
+
+    /// encodeURIComponent(this)
+    /// Spec: https://tc39.es/ecma262/2025/#sec-encodeuricomponent-encodeduricomponent
+    ///
+    /// Returns this string borrowed when nothing needs encoding, otherwise an
+    /// owned copy. Always call deinit() on the result.
+    pub fn encodeURIComponent(self: ZString, allocator: Allocator) !ZString {
+        return uri.encodeURIComponent(allocator, self.data);
+    }
+
+    /// encodeURI(this)
+    /// Spec: https://tc39.es/ecma262/2025/#sec-encodeuri-uri
+    ///
+    /// Returns this string borrowed when nothing needs encoding, otherwise an
+    /// owned copy. Always call deinit() on the result.
+    pub fn encodeURI(self: ZString, allocator: Allocator) !ZString {
+        return uri.encodeURI(allocator, self.data);
+    }
+
+    /// decodeURIComponent(this)
+    /// Spec: https://tc39.es/ecma262/2025/#sec-decodeuricomponent-encodeduricomponent
+    ///
+    /// Returns this string borrowed when it has no escapes, otherwise an
+    /// owned copy. Always call deinit() on the result.
+    pub fn decodeURIComponent(self: ZString, allocator: Allocator) !ZString {
+        return uri.decodeURIComponent(allocator, self.data);
+    }
+
+    /// decodeURI(this)
+    /// Spec: https://tc39.es/ecma262/2025/#sec-decodeuri-encodeduri
+    ///
+    /// Returns this string borrowed when it has no escapes, otherwise an
+    /// owned copy. Always call deinit() on the result.
+    pub fn decodeURI(self: ZString, allocator: Allocator) !ZString {
+        return uri.decodeURI(allocator, self.data);
+    }
 };
 
 // Tests
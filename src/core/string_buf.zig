@@ -0,0 +1,346 @@
+const std = @import("std");
+const utf16 = @import("utf16.zig");
+const ZString = @import("string.zig").ZString;
+
+const Allocator = std.mem.Allocator;
+
+/// Target byte size of a breadcrumb segment
+const segment_bytes = 4096;
+
+/// Extra gap reserved whenever the buffer grows
+const min_gap = 64;
+
+/// ZStringBuf - mutable string edited in UTF-16 coordinates
+///
+/// Text is kept as UTF-8 in a gap buffer, so a run of edits near the same
+/// place only moves the bytes between consecutive edit points. Alongside
+/// it lives a breadcrumb index: the text is cut into segments of about
+/// 4 KB (on code point boundaries) that record their byte length, UTF-16
+/// length and non-ASCII byte count. An edit rescans only the segments it
+/// touches, and the UTF-16 length and ASCII flag are kept up to date from
+/// those segments alone.
+///
+/// Example:
+///   var buf = try ZStringBuf.initText(allocator, "hello world");
+///   defer buf.deinit();
+///   try buf.replaceRange(6, 11, "zig"); // "hello zig"
+///   try buf.insert(0, "¡");            // "¡hello zig"
+pub const ZStringBuf = struct {
+    allocator: Allocator,
+    /// Text before the gap, the gap, then text after the gap
+    buf: []u8 = &.{},
+    gap_start: usize = 0,
+    gap_end: usize = 0,
+    segments: std.ArrayList(Segment) = .{},
+    utf16_len: usize = 0,
+    non_ascii: usize = 0,
+
+    const Segment = struct {
+        bytes: usize = 0,
+        units: usize = 0,
+        non_ascii: usize = 0,
+    };
+
+    /// Creates an empty buffer
+    pub fn init(allocator: Allocator) ZStringBuf {
+        return .{ .allocator = allocator };
+    }
+
+    /// Creates a buffer holding a copy of text
+    ///
+    /// Returns error.InvalidUtf8 if text is not valid UTF-8.
+    pub fn initText(allocator: Allocator, text: []const u8) !ZStringBuf {
+        var self = init(allocator);
+        errdefer self.deinit();
+        try self.insert(0, text);
+        return self;
+    }
+
+    pub fn deinit(self: *ZStringBuf) void {
+        self.allocator.free(self.buf);
+        self.segments.deinit(self.allocator);
+        self.* = init(self.allocator);
+    }
+
+    /// Length in UTF-16 code units (String.prototype.length)
+    pub fn length(self: *const ZStringBuf) usize {
+        return self.utf16_len;
+    }
+
+    /// Length of the UTF-8 text in bytes
+    pub fn byteLength(self: *const ZStringBuf) usize {
+        return self.buf.len - (self.gap_end - self.gap_start);
+    }
+
+    pub fn isAscii(self: *const ZStringBuf) bool {
+        return self.non_ascii == 0;
+    }
+
+    /// Inserts text before UTF-16 index `index`
+    pub fn insert(self: *ZStringBuf, index: usize, text: []const u8) !void {
+        return self.replaceRange(index, index, text);
+    }
+
+    /// Removes UTF-16 code units [start, end)
+    pub fn delete(self: *ZStringBuf, start: usize, end: usize) !void {
+        return self.replaceRange(start, end, "");
+    }
+
+    /// Replaces UTF-16 code units [start, end) with text
+    ///
+    /// Returns error.IndexOutOfBounds if start > end or end > length(),
+    /// error.InvalidUtf16 if an index falls inside a surrogate pair, and
+    /// error.InvalidUtf8 if text is not valid UTF-8.
+    pub fn replaceRange(self: *ZStringBuf, start: usize, end: usize, text: []const u8) !void {
+        if (start > end) return error.IndexOutOfBounds;
+        if (!std.unicode.utf8ValidateSlice(text)) return error.InvalidUtf8;
+
+        const byte_start = try self.byteOffset(start);
+        const byte_end = if (end == start) byte_start else try self.byteOffset(end);
+        try self.edit(byte_start, byte_end, text);
+    }
+
+    /// The text as one contiguous slice, valid until the next edit
+    ///
+    /// Moves the gap to the end, so reading after an edit costs a copy of
+    /// the text behind the edit point.
+    pub fn contents(self: *ZStringBuf) []const u8 {
+        self.moveGap(self.byteLength());
+        return self.buf[0..self.gap_start];
+    }
+
+    /// Returns an owned ZString with a copy of the text (UTF-16 length
+    /// already cached)
+    pub fn toZString(self: *const ZStringBuf, allocator: Allocator) !ZString {
+        const copy = try allocator.alloc(u8, self.byteLength());
+        const chunks = self.parts(0, copy.len);
+        @memcpy(copy[0..chunks[0].len], chunks[0]);
+        @memcpy(copy[chunks[0].len..], chunks[1]);
+
+        var zstr = ZString.fromOwned(allocator, copy);
+        zstr.cached_utf16_length = self.utf16_len;
+        return zstr;
+    }
+
+    /// Logical bytes [start, end) as the pieces before and after the gap
+    fn parts(self: *const ZStringBuf, start: usize, end: usize) [2][]const u8 {
+        const gap = self.gap_end - self.gap_start;
+        var out: [2][]const u8 = .{ "", "" };
+        const before_end = @min(end, self.gap_start);
+        if (start < before_end) out[0] = self.buf[start..before_end];
+        const after_start = @max(start, self.gap_start);
+        if (after_start < end) out[1] = self.buf[after_start + gap .. end + gap];
+        return out;
+    }
+
+    /// Byte offset of a UTF-16 index, walking segments instead of text
+    fn byteOffset(self: *const ZStringBuf, index: usize) !usize {
+        if (index > self.utf16_len) return error.IndexOutOfBounds;
+        if (self.non_ascii == 0) return index;
+
+        var byte: usize = 0;
+        var unit: usize = 0;
+        for (self.segments.items) |seg| {
+            if (unit + seg.units <= index) {
+                unit += seg.units;
+                byte += seg.bytes;
+                continue;
+            }
+
+            for (self.parts(byte, byte + seg.bytes)) |part| {
+                for (part) |b| {
+                    if (b & 0xC0 != 0x80) {
+                        if (unit == index) return byte;
+                        unit += if (b >= 0xF0) 2 else 1;
+                        // A 4-byte sequence is a surrogate pair in UTF-16
+                        if (unit > index) return error.InvalidUtf16;
+                    }
+                    byte += 1;
+                }
+            }
+            unreachable;
+        }
+        return byte;
+    }
+
+    /// Replace bytes [start, end) with text and refresh the segments that
+    /// covered them
+    fn edit(self: *ZStringBuf, start: usize, end: usize, text: []const u8) !void {
+        const segs = self.segments.items;
+
+        // Segments [lo, hi) cover [region_start, region_end), which
+        // contains [start, end)
+        var lo: usize = 0;
+        var region_start: usize = 0;
+        while (lo + 1 < segs.len and region_start + segs[lo].bytes <= start) {
+            region_start += segs[lo].bytes;
+            lo += 1;
+        }
+        var hi = lo;
+        var region_end = region_start;
+        while (hi < segs.len and (hi == lo or region_end < end)) {
+            region_end += segs[hi].bytes;
+            hi += 1;
+        }
+        // Fold a shrinking region into its successor so deletes do not
+        // leave a trail of tiny segments
+        if (hi < segs.len and region_end - region_start - (end - start) + text.len < segment_bytes / 2) {
+            region_end += segs[hi].bytes;
+            hi += 1;
+        }
+
+        // Allocate up front so a failed edit leaves the buffer unchanged
+        const new_region_len = region_end - region_start - (end - start) + text.len;
+        try self.ensureGap(text.len);
+        try self.segments.ensureUnusedCapacity(self.allocator, new_region_len / segment_bytes + 1);
+
+        self.moveGap(start);
+        self.gap_end += end - start;
+        @memcpy(self.buf[self.gap_start..][0..text.len], text);
+        self.gap_start += text.len;
+
+        for (self.segments.items[lo..hi]) |old| {
+            self.utf16_len -= old.units;
+            self.non_ascii -= old.non_ascii;
+        }
+
+        // Scan the new region into segments appended at the end, then
+        // rotate them into place over the old ones
+        const old_len = self.segments.items.len;
+        var seg = Segment{};
+        for (self.parts(region_start, region_start + new_region_len)) |part| {
+            for (part) |b| {
+                const lead = b & 0xC0 != 0x80;
+                if (seg.bytes >= segment_bytes and lead) {
+                    self.segments.appendAssumeCapacity(seg);
+                    seg = .{};
+                }
+                seg.bytes += 1;
+                if (lead) seg.units += if (b >= 0xF0) 2 else 1;
+                if (b >= 0x80) seg.non_ascii += 1;
+            }
+        }
+        if (seg.bytes > 0) self.segments.appendAssumeCapacity(seg);
+
+        const added = self.segments.items[old_len..];
+        for (added) |new_seg| {
+            self.utf16_len += new_seg.units;
+            self.non_ascii += new_seg.non_ascii;
+        }
+        std.mem.rotate(Segment, self.segments.items[lo..], old_len - lo);
+        self.segments.replaceRangeAssumeCapacity(lo + added.len, hi - lo, &.{});
+    }
+
+    fn moveGap(self: *ZStringBuf, pos: usize) void {
+        if (pos < self.gap_start) {
+            const n = self.gap_start - pos;
+            std.mem.copyBackwards(u8, self.buf[self.gap_end - n .. self.gap_end], self.buf[pos..self.gap_start]);
+            self.gap_start = pos;
+            self.gap_end -= n;
+        } else if (pos > self.gap_start) {
+            const n = pos - self.gap_start;
+            std.mem.copyForwards(u8, self.buf[self.gap_start..][0..n], self.buf[self.gap_end..][0..n]);
+            self.gap_start += n;
+            self.gap_end += n;
+        }
+    }
+
+    fn ensureGap(self: *ZStringBuf, n: usize) !void {
+        const gap = self.gap_end - self.gap_start;
+        if (gap >= n) return;
+
+        const new_len = @max(self.buf.len * 2, self.buf.len - gap + n + min_gap);
+        const new_buf = try self.allocator.alloc(u8, new_len);
+        const tail = self.buf.len - self.gap_end;
+        @memcpy(new_buf[0..self.gap_start], self.buf[0..self.gap_start]);
+        @memcpy(new_buf[new_len - tail ..], self.buf[self.gap_end..]);
+
+        self.allocator.free(self.buf);
+        self.buf = new_buf;
+        self.gap_end = new_len - tail;
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "ZStringBuf - insert, delete and replace in UTF-16 coordinates" {
+    const allocator = std.testing.allocator;
+    var buf = try ZStringBuf.initText(allocator, "hello world");
+    defer buf.deinit();
+
+    try buf.replaceRange(6, 11, "zig");
+    try std.testing.expectEqualStrings("hello zig", buf.contents());
+    try std.testing.expect(buf.isAscii());
+
+    try buf.insert(0, "😀 ");
+    try std.testing.expectEqualStrings("😀 hello zig", buf.contents());
+    try std.testing.expectEqual(@as(usize, 12), buf.length());
+    try std.testing.expect(!buf.isAscii());
+
+    try buf.delete(0, 3);
+    try std.testing.expectEqualStrings("hello zig", buf.contents());
+    try std.testing.expect(buf.isAscii());
+}
+
+test "ZStringBuf - rejects bad indices and text" {
+    const allocator = std.testing.allocator;
+    var buf = try ZStringBuf.initText(allocator, "a😀b");
+    defer buf.deinit();
+
+    try std.testing.expectError(error.InvalidUtf16, buf.insert(2, "x"));
+    try std.testing.expectError(error.IndexOutOfBounds, buf.delete(3, 1));
+    try std.testing.expectError(error.IndexOutOfBounds, buf.insert(5, "x"));
+    try std.testing.expectError(error.InvalidUtf8, buf.insert(0, "\xff"));
+    try std.testing.expectEqualStrings("a😀b", buf.contents());
+}
+
+fn splitsPair(str: []const u8, index: usize) bool {
+    const byte = utf16.utf16IndexToByte(str, index) catch return false;
+    return (utf16.byteIndexToUtf16(str, byte) catch index) != index;
+}
+
+test "ZStringBuf - random edits match a rebuilt string" {
+    const allocator = std.testing.allocator;
+    var prng = std.Random.DefaultPrng.init(0x5eed);
+    const random = prng.random();
+    const pieces = [_][]const u8{ "a", "bc", "é", "日本", "😀", "xyz\n", "" };
+
+    var buf = ZStringBuf.init(allocator);
+    defer buf.deinit();
+    var model = std.ArrayList(u8){};
+    defer model.deinit(allocator);
+
+    for (0..2000) |i| {
+        // Mostly grow, so the text spans many segments
+        var text = std.ArrayList(u8){};
+        defer text.deinit(allocator);
+        const repeat = if (i % 50 == 0) 600 else random.uintLessThan(usize, 4);
+        for (0..repeat) |_| try text.appendSlice(allocator, pieces[random.uintLessThan(usize, pieces.len)]);
+
+        const len16 = utf16.lengthUtf16(model.items);
+        var start = random.uintAtMost(usize, len16);
+        var end = @min(len16, start + random.uintLessThan(usize, 8));
+        // Step off the middle of surrogate pairs
+        if (splitsPair(model.items, start)) start -= 1;
+        if (splitsPair(model.items, end)) end += 1;
+        if (i % 3 == 0) end = start;
+
+        try buf.replaceRange(start, end, text.items);
+
+        const byte_start = try utf16.utf16IndexToByte(model.items, start);
+        const byte_end = try utf16.utf16IndexToByte(model.items, end);
+        try model.replaceRange(allocator, byte_start, byte_end - byte_start, text.items);
+
+        try std.testing.expectEqual(utf16.lengthUtf16(model.items), buf.length());
+        try std.testing.expectEqual(model.items.len, buf.byteLength());
+        if (i % 100 == 0) try std.testing.expectEqualStrings(model.items, buf.contents());
+    }
+
+    try std.testing.expectEqualStrings(model.items, buf.contents());
+    try std.testing.expect(buf.segments.items.len > 1);
+    var zstr = try buf.toZString(allocator);
+    defer zstr.deinit();
+    try std.testing.expectEqual(zstr.lengthConst(), zstr.length());
+}
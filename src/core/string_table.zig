@@ -0,0 +1,457 @@
+const std = @import("std");
+const builtin = @import("builtin");
+const utf16 = @import("utf16.zig");
+const ZString = @import("string.zig").ZString;
+
+const Allocator = std.mem.Allocator;
+
+/// File magic: "ZSTRTBL" followed by a zero byte
+pub const magic = "ZSTRTBL\x00".*;
+
+/// Current format version
+pub const format_version: u32 = 1;
+
+/// Header flag: the file carries a perfect-hash index
+pub const flag_perfect_hash: u32 = 1 << 0;
+
+/// Average keys per perfect-hash bucket
+const keys_per_bucket = 4;
+
+/// Displacements tried per bucket before giving up
+const max_displacement = 1 << 20;
+
+pub const FormatError = error{
+    InvalidFormat,
+    UnsupportedVersion,
+    UnsupportedEndian,
+    DuplicateKey,
+    PerfectHashFailed,
+};
+
+/// On-disk header (little-endian, 8-byte aligned)
+///
+/// Sections follow in this order, each starting on an 8-byte boundary:
+///
+///   offsets   u64[count + 1]  byte offsets into data, offsets[0] == 0
+///   hashes    u64[count]      Wyhash (seed 0) of each entry
+///   utf16     u32[count]      UTF-16 length of each entry
+///   buckets   u32[nbuckets]   perfect-hash displacements (optional)
+///   slots     u32[count]      perfect-hash slot -> entry index (optional)
+///   data      u8[data_len]    entries back to back
+///
+/// Data comes last so the bulk of a large table is touched only when
+/// entries are read.
+pub const Header = extern struct {
+    magic: [8]u8 = magic,
+    version: u32 = format_version,
+    flags: u32 = 0,
+    count: u64 = 0,
+    data_len: u64 = 0,
+    offsets_offset: u64 = 0,
+    hashes_offset: u64 = 0,
+    utf16_offset: u64 = 0,
+    buckets_offset: u64 = 0,
+    bucket_count: u64 = 0,
+    slots_offset: u64 = 0,
+    data_offset: u64 = 0,
+    file_len: u64 = 0,
+};
+
+pub const WriteOptions = struct {
+    /// Build a minimal perfect-hash index for O(1) find(); entries must be unique
+    perfect_hash: bool = false,
+};
+
+/// Hash stored for each entry
+pub inline fn hashOf(str: []const u8) u64 {
+    return std.hash.Wyhash.hash(0, str);
+}
+
+inline fn bucketOf(h: u64, bucket_count: u64) u64 {
+    return (h >> 32) % bucket_count;
+}
+
+inline fn slotOf(h: u64, displacement: u32, count: u64) u64 {
+    var x = h ^ (@as(u64, displacement) *% 0x9E3779B97F4A7C15);
+    x = (x ^ (x >> 30)) *% 0xBF58476D1CE4E5B9;
+    x = (x ^ (x >> 27)) *% 0x94D049BB133111EB;
+    return (x ^ (x >> 31)) % count;
+}
+
+inline fn alignUp(n: u64) u64 {
+    return (n + 7) & ~@as(u64, 7);
+}
+
+/// Read-only string table backed by one serialized buffer
+///
+/// Entries are zero-copy slices into the buffer, which is usually a shared
+/// read-only mapping of the file (see open()), so startup cost does not
+/// depend on the table size and pages are shared between processes.
+pub const StringTable = struct {
+    header: *const Header,
+    offsets: []const u64,
+    hashes: []const u64,
+    utf16_lengths: []const u32,
+    buckets: []const u32,
+    slots: []const u32,
+    data: []const u8,
+    /// Set when the table owns a file mapping
+    mapping: ?[]align(std.heap.page_size_min) const u8 = null,
+
+    /// Serializes `strings` into a new buffer in table format
+    pub fn serialize(allocator: Allocator, strings: []const []const u8, options: WriteOptions) ![]align(8) u8 {
+        if (builtin.cpu.arch.endian() != .little) return error.UnsupportedEndian;
+
+        var header = Header{};
+        const count: u64 = strings.len;
+        var data_len: u64 = 0;
+        for (strings) |s| data_len += s.len;
+
+        header.count = count;
+        header.data_len = data_len;
+        var pos: u64 = alignUp(@sizeOf(Header));
+        header.offsets_offset = pos;
+        pos += (count + 1) * 8;
+        header.hashes_offset = pos;
+        pos += count * 8;
+        header.utf16_offset = pos;
+        pos = alignUp(pos + count * 4);
+        if (options.perfect_hash and count > 0) {
+            header.flags |= flag_perfect_hash;
+            header.bucket_count = (count + keys_per_bucket - 1) / keys_per_bucket;
+            header.buckets_offset = pos;
+            pos = alignUp(pos + header.bucket_count * 4);
+            header.slots_offset = pos;
+            pos = alignUp(pos + count * 4);
+        }
+        header.data_offset = pos;
+        pos = alignUp(pos + data_len);
+        header.file_len = pos;
+
+        const buf = try allocator.alignedAlloc(u8, .@"8", @intCast(pos));
+        errdefer allocator.free(buf);
+        @memset(buf, 0);
+
+        const offsets = sectionMut(u64, buf, header.offsets_offset, count + 1);
+        const hashes = sectionMut(u64, buf, header.hashes_offset, count);
+        const lengths = sectionMut(u32, buf, header.utf16_offset, count);
+        const data = buf[@intCast(header.data_offset)..][0..@intCast(data_len)];
+
+        var off: u64 = 0;
+        for (strings, 0..) |s, i| {
+            @memcpy(data[@intCast(off)..][0..s.len], s);
+            off += s.len;
+            offsets[i + 1] = off;
+            hashes[i] = hashOf(s);
+            lengths[i] = @intCast(utf16.lengthUtf16(s));
+        }
+
+        if (header.flags & flag_perfect_hash != 0) {
+            try buildPerfectHash(
+                allocator,
+                strings,
+                sectionMut(u32, buf, header.buckets_offset, header.bucket_count),
+                sectionMut(u32, buf, header.slots_offset, count),
+            );
+        }
+
+        @memcpy(buf[0..@sizeOf(Header)], std.mem.asBytes(&header));
+        return buf;
+    }
+
+    /// Serializes `strings` to `sub_path` in `dir`
+    pub fn write(allocator: Allocator, dir: std.fs.Dir, sub_path: []const u8, strings: []const []const u8, options: WriteOptions) !void {
+        const buf = try serialize(allocator, strings, options);
+        defer allocator.free(buf);
+        try dir.writeFile(.{ .sub_path = sub_path, .data = buf });
+    }
+
+    /// Maps a table file read-only and shared; close() unmaps it
+    pub fn open(dir: std.fs.Dir, sub_path: []const u8) !StringTable {
+        const file = try dir.openFile(sub_path, .{});
+        defer file.close();
+
+        const size = (try file.stat()).size;
+        if (size < @sizeOf(Header)) return error.InvalidFormat;
+
+        const mapping = try std.posix.mmap(null, @intCast(size), std.posix.PROT.READ, .{ .TYPE = .SHARED }, file.handle, 0);
+        errdefer std.posix.munmap(mapping);
+
+        var table = try fromBytes(mapping);
+        table.mapping = mapping;
+        return table;
+    }
+
+    /// Views an already loaded table buffer without copying
+    ///
+    /// Only the header and section bounds are checked, so this is O(1);
+    /// use verify() to check every offset of an untrusted file.
+    pub fn fromBytes(bytes: []align(8) const u8) FormatError!StringTable {
+        if (builtin.cpu.arch.endian() != .little) return error.UnsupportedEndian;
+        if (bytes.len < @sizeOf(Header)) return error.InvalidFormat;
+
+        const header: *const Header = @ptrCast(bytes.ptr);
+        if (!std.mem.eql(u8, &header.magic, &magic)) return error.InvalidFormat;
+        if (header.version != format_version) return error.UnsupportedVersion;
+        if (header.file_len > bytes.len) return error.InvalidFormat;
+
+        const count = header.count;
+        if (count >= bytes.len) return error.InvalidFormat;
+        const has_phf = header.flags & flag_perfect_hash != 0;
+        if (has_phf and header.bucket_count == 0) return error.InvalidFormat;
+
+        const table = StringTable{
+            .header = header,
+            .offsets = try section(u64, bytes, header.offsets_offset, count + 1),
+            .hashes = try section(u64, bytes, header.hashes_offset, count),
+            .utf16_lengths = try section(u32, bytes, header.utf16_offset, count),
+            .buckets = if (has_phf) try section(u32, bytes, header.buckets_offset, header.bucket_count) else &.{},
+            .slots = if (has_phf) try section(u32, bytes, header.slots_offset, count) else &.{},
+            .data = try section(u8, bytes, header.data_offset, header.data_len),
+        };
+        if (table.offsets[0] != 0 or table.offsets[count] != header.data_len) return error.InvalidFormat;
+        return table;
+    }
+
+    /// Unmaps the file if the table was opened with open()
+    pub fn close(self: *StringTable) void {
+        if (self.mapping) |mapping| std.posix.munmap(mapping);
+        self.* = undefined;
+    }
+
+    /// Checks every offset and perfect-hash slot (touches the whole index)
+    pub fn verify(self: StringTable) FormatError!void {
+        for (0..self.len()) |i| {
+            if (self.offsets[i] > self.offsets[i + 1]) return error.InvalidFormat;
+        }
+        for (self.slots) |slot| {
+            if (slot >= self.len()) return error.InvalidFormat;
+        }
+    }
+
+    /// Number of entries
+    pub inline fn len(self: StringTable) usize {
+        return self.offsets.len - 1;
+    }
+
+    /// Entry `i` as a slice into the table
+    pub inline fn get(self: StringTable, i: usize) []const u8 {
+        return self.data[@intCast(self.offsets[i])..@intCast(self.offsets[i + 1])];
+    }
+
+    /// Entry `i` as a borrowed ZString with its UTF-16 length pre-filled
+    pub inline fn view(self: StringTable, i: usize) ZString {
+        return .{
+            .data = self.get(i),
+            .allocator = null,
+            .cached_utf16_length = self.utf16_lengths[i],
+        };
+    }
+
+    /// Precomputed hash of entry `i` (see hashOf)
+    pub inline fn hash(self: StringTable, i: usize) u64 {
+        return self.hashes[i];
+    }
+
+    /// UTF-16 length of entry `i`
+    pub inline fn utf16Length(self: StringTable, i: usize) usize {
+        return self.utf16_lengths[i];
+    }
+
+    /// Whether find() uses the perfect-hash index
+    pub inline fn hasPerfectHash(self: StringTable) bool {
+        return self.buckets.len > 0;
+    }
+
+    /// Index of `key`, or null
+    ///
+    /// O(1) with a perfect-hash index; otherwise a scan of the hash array.
+    pub fn find(self: StringTable, key: []const u8) ?usize {
+        const n = self.len();
+        if (n == 0) return null;
+
+        const h = hashOf(key);
+        if (self.hasPerfectHash()) {
+            const displacement = self.buckets[@intCast(bucketOf(h, self.buckets.len))];
+            const i: usize = self.slots[@intCast(slotOf(h, displacement, n))];
+            if (self.hashes[i] == h and std.mem.eql(u8, self.get(i), key)) return i;
+            return null;
+        }
+
+        for (self.hashes, 0..) |entry_hash, i| {
+            if (entry_hash == h and std.mem.eql(u8, self.get(i), key)) return i;
+        }
+        return null;
+    }
+};
+
+fn section(comptime T: type, bytes: []align(8) const u8, offset: u64, n: u64) FormatError![]const T {
+    const size = std.math.mul(u64, n, @sizeOf(T)) catch return error.InvalidFormat;
+    if (offset % 8 != 0 or offset > bytes.len or size > bytes.len - offset) return error.InvalidFormat;
+    const ptr: [*]const T = @ptrCast(@alignCast(bytes.ptr + @as(usize, @intCast(offset))));
+    return ptr[0..@intCast(n)];
+}
+
+fn sectionMut(comptime T: type, bytes: []align(8) u8, offset: u64, n: u64) []T {
+    const ptr: [*]T = @ptrCast(@alignCast(bytes.ptr + @as(usize, @intCast(offset))));
+    return ptr[0..@intCast(n)];
+}
+
+/// Hash-and-displace: buckets are placed largest first, each trying
+/// displacements until all of its keys land on free slots.
+fn buildPerfectHash(allocator: Allocator, strings: []const []const u8, buckets: []u32, slots: []u32) !void {
+    const n: u64 = strings.len;
+    const nb: u64 = buckets.len;
+
+    const hashes = try allocator.alloc(u64, strings.len);
+    defer allocator.free(hashes);
+    for (strings, hashes) |s, *h| h.* = hashOf(s);
+
+    // Group key indices by bucket (counting sort)
+    const starts = try allocator.alloc(u32, buckets.len + 1);
+    defer allocator.free(starts);
+    @memset(starts, 0);
+    for (hashes) |h| starts[@intCast(bucketOf(h, nb) + 1)] += 1;
+    for (1..starts.len) |b| starts[b] += starts[b - 1];
+
+    const members = try allocator.alloc(u32, strings.len);
+    defer allocator.free(members);
+    const fill = try allocator.dupe(u32, starts[0..buckets.len]);
+    defer allocator.free(fill);
+    for (hashes, 0..) |h, i| {
+        const b: usize = @intCast(bucketOf(h, nb));
+        members[fill[b]] = @intCast(i);
+        fill[b] += 1;
+    }
+
+    const order = try allocator.alloc(u32, buckets.len);
+    defer allocator.free(order);
+    for (order, 0..) |*b, i| b.* = @intCast(i);
+    const BySize = struct {
+        fn larger(ctx: []const u32, a: u32, b: u32) bool {
+            return ctx[a + 1] - ctx[a] > ctx[b + 1] - ctx[b];
+        }
+    };
+    std.mem.sort(u32, order, @as([]const u32, starts), BySize.larger);
+
+    var taken = try std.DynamicBitSetUnmanaged.initEmpty(allocator, strings.len);
+    defer taken.deinit(allocator);
+
+    var placed: [64]u64 = undefined;
+    @memset(buckets, 0);
+    for (order) |b| {
+        const group = members[starts[b]..starts[b + 1]];
+        if (group.len == 0) break;
+        if (group.len > placed.len) return error.PerfectHashFailed;
+
+        for (group, 0..) |a, ia| {
+            for (group[ia + 1 ..]) |c| {
+                if (hashes[a] == hashes[c] and std.mem.eql(u8, strings[a], strings[c])) return error.DuplicateKey;
+            }
+        }
+
+        var displacement: u32 = 0;
+        search: while (displacement < max_displacement) : (displacement += 1) {
+            for (group, 0..) |key, k| {
+                const slot = slotOf(hashes[key], displacement, n);
+                if (taken.isSet(@intCast(slot))) continue :search;
+                for (placed[0..k]) |prev| {
+                    if (prev == slot) continue :search;
+                }
+                placed[k] = slot;
+            }
+            break;
+        } else return error.PerfectHashFailed;
+
+        buckets[b] = displacement;
+        for (group, placed[0..group.len]) |key, slot| {
+            taken.set(@intCast(slot));
+            slots[@intCast(slot)] = key;
+        }
+    }
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+const test_entries = [_][]const u8{ "alpha", "beta", "", "caf\u{e9}", "\u{1F600} smile", "gamma", "delta" };
+
+test "StringTable - serialize and view" {
+    const allocator = std.testing.allocator;
+
+    const buf = try StringTable.serialize(allocator, &test_entries, .{});
+    defer allocator.free(buf);
+
+    const table = try StringTable.fromBytes(buf);
+    try table.verify();
+    try std.testing.expectEqual(test_entries.len, table.len());
+    for (test_entries, 0..) |expected, i| {
+        try std.testing.expectEqualStrings(expected, table.get(i));
+        try std.testing.expectEqual(hashOf(expected), table.hash(i));
+        try std.testing.expectEqual(utf16.lengthUtf16(expected), table.utf16Length(i));
+    }
+
+    var smile = table.view(4);
+    try std.testing.expectEqual(@as(usize, 8), smile.length());
+    try std.testing.expect(!table.hasPerfectHash());
+    try std.testing.expectEqual(@as(?usize, 5), table.find("gamma"));
+    try std.testing.expectEqual(@as(?usize, null), table.find("omega"));
+}
+
+test "StringTable - perfect hash" {
+    const allocator = std.testing.allocator;
+
+    var names = std.ArrayList([]u8){};
+    defer {
+        for (names.items) |name| allocator.free(name);
+        names.deinit(allocator);
+    }
+    for (0..1000) |i| try names.append(allocator, try std.fmt.allocPrint(allocator, "name_{d}", .{i}));
+
+    const buf = try StringTable.serialize(allocator, names.items, .{ .perfect_hash = true });
+    defer allocator.free(buf);
+
+    const table = try StringTable.fromBytes(buf);
+    try table.verify();
+    try std.testing.expect(table.hasPerfectHash());
+    for (names.items, 0..) |name, i| {
+        try std.testing.expectEqual(@as(?usize, i), table.find(name));
+    }
+    try std.testing.expectEqual(@as(?usize, null), table.find("name_1000"));
+
+    try std.testing.expectError(error.DuplicateKey, StringTable.serialize(allocator, &[_][]const u8{ "a", "a" }, .{ .perfect_hash = true }));
+}
+
+test "StringTable - rejects malformed buffers" {
+    const allocator = std.testing.allocator;
+
+    const buf = try StringTable.serialize(allocator, &test_entries, .{});
+    defer allocator.free(buf);
+
+    try std.testing.expectError(error.InvalidFormat, StringTable.fromBytes(buf[0..16]));
+
+    buf[0] = 'X';
+    try std.testing.expectError(error.InvalidFormat, StringTable.fromBytes(buf));
+    buf[0] = 'Z';
+
+    const header: *Header = @ptrCast(buf.ptr);
+    header.version = 99;
+    try std.testing.expectError(error.UnsupportedVersion, StringTable.fromBytes(buf));
+}
+
+test "StringTable - write and open" {
+    const allocator = std.testing.allocator;
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    try StringTable.write(allocator, tmp.dir, "names.zst", &test_entries, .{ .perfect_hash = true });
+
+    var table = try StringTable.open(tmp.dir, "names.zst");
+    defer table.close();
+
+    try std.testing.expectEqual(test_entries.len, table.len());
+    try std.testing.expectEqualStrings("caf\u{e9}", table.get(3));
+    try std.testing.expectEqual(@as(?usize, 2), table.find(""));
+}
@@ -0,0 +1,371 @@
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const simd = @import("../core/simd.zig");
+const utf16 = @import("../core/utf16.zig");
+
+/// An inclusive range of code points
+pub const Range = struct {
+    first: u21,
+    last: u21,
+};
+
+/// A compiled set of code points for strpbrk/strspn-style scans
+///
+/// ASCII members are kept in a 256-bit byte bitmap and in two nibble tables
+/// for the vector classifier: byte b is a member iff
+/// `lo[b & 15] & hi[b >> 4] != 0`, where `hi` gives nibbles 0-7 one bit
+/// each and 8-15 none. That is two byte shuffles and an AND per vector.
+/// Non-ASCII members are kept as sorted, merged ranges; when there are
+/// any, UTF-8 lead bytes are flagged by the classifier as well and looked
+/// up by binary search.
+///
+/// All indices returned are in UTF-16 code units.
+pub const CharSet = struct {
+    allocator: Allocator,
+    bitmap: std.StaticBitSet(256),
+    lo_table: simd.Vec,
+    hi_table: simd.Vec,
+    /// Non-ASCII members, sorted and non-adjacent
+    ranges: []const Range,
+
+    /// Compiles the set of code points appearing in `chars` (UTF-8)
+    pub fn init(allocator: Allocator, chars: []const u8) !CharSet {
+        const view = std.unicode.Utf8View.init(chars) catch return error.InvalidUtf8;
+        var members = std.ArrayList(Range){};
+        defer members.deinit(allocator);
+
+        var it = view.iterator();
+        while (it.nextCodepoint()) |cp| try members.append(allocator, .{ .first = cp, .last = cp });
+        return initRanges(allocator, members.items);
+    }
+
+    /// Compiles a set from inclusive code point ranges (in any order)
+    pub fn initRanges(allocator: Allocator, members: []const Range) !CharSet {
+        var bitmap = std.StaticBitSet(256).initEmpty();
+        var wide = std.ArrayList(Range){};
+        defer wide.deinit(allocator);
+
+        for (members) |r| {
+            if (r.first > r.last or r.last > 0x10FFFF) return error.InvalidRange;
+            var cp = r.first;
+            while (cp <= @min(r.last, 0x7F)) : (cp += 1) bitmap.set(cp);
+            if (r.last >= 0x80) try wide.append(allocator, .{ .first = @max(r.first, 0x80), .last = r.last });
+        }
+
+        std.mem.sort(Range, wide.items, {}, rangeLessThan);
+        var count: usize = 0;
+        for (wide.items) |r| {
+            if (count > 0 and r.first <= wide.items[count - 1].last +| 1) {
+                wide.items[count - 1].last = @max(wide.items[count - 1].last, r.last);
+            } else {
+                wide.items[count] = r;
+                count += 1;
+            }
+        }
+        wide.shrinkRetainingCapacity(count);
+
+        var lo = [_]u8{0} ** 16;
+        var hi = [_]u8{0} ** 16;
+        for (0..8) |h| hi[h] = @as(u8, 1) << @intCast(h);
+        var bits = bitmap.iterator(.{});
+        while (bits.next()) |b| lo[b & 15] |= @as(u8, 1) << @intCast(b >> 4);
+
+        return .{
+            .allocator = allocator,
+            .bitmap = bitmap,
+            .lo_table = simd.table16(lo),
+            .hi_table = simd.table16(hi),
+            .ranges = try wide.toOwnedSlice(allocator),
+        };
+    }
+
+    pub fn deinit(self: *CharSet) void {
+        self.allocator.free(self.ranges);
+        self.* = undefined;
+    }
+
+    /// Returns true if `cp` is a member
+    pub fn contains(self: *const CharSet, cp: u21) bool {
+        if (cp < 0x80) return self.bitmap.isSet(cp);
+
+        var lo: usize = 0;
+        var hi = self.ranges.len;
+        while (lo < hi) {
+            const mid = lo + (hi - lo) / 2;
+            const r = self.ranges[mid];
+            if (cp < r.first) {
+                hi = mid;
+            } else if (cp > r.last) {
+                lo = mid + 1;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Index of the first member at or after `position`, or -1 (strpbrk)
+    pub fn indexOfAny(self: *const CharSet, str: []const u8, position: ?isize) isize {
+        const start = if (position) |pos| byteOffset(str, pos) else 0;
+        const found = self.find(str, start, true) orelse return -1;
+        return @intCast(utf16Offset(str, found));
+    }
+
+    /// Index of the last member at or before `position` (default: the end
+    /// of the string), or -1
+    pub fn lastIndexOfAny(self: *const CharSet, str: []const u8, position: ?isize) isize {
+        var end = str.len;
+        if (position) |pos| {
+            const b = byteOffset(str, pos);
+            if (b < str.len) end = b + decodeAt(str, b).len;
+        }
+        const found = self.findLast(str, end, true) orelse return -1;
+        return @intCast(utf16Offset(str, found));
+    }
+
+    /// Length of the longest prefix made only of members (strspn)
+    pub fn spanOf(self: *const CharSet, str: []const u8) usize {
+        const end = self.find(str, 0, false) orelse str.len;
+        return utf16Offset(str, end);
+    }
+
+    /// `str` without leading and trailing members (borrowed)
+    pub fn trimmedSlice(self: *const CharSet, str: []const u8) []const u8 {
+        const start = self.find(str, 0, false) orelse return str[str.len..];
+        const last = self.findLast(str, str.len, false).?;
+        return str[start .. last + decodeAt(str, last).len];
+    }
+
+    /// Removes leading and trailing members
+    ///
+    /// The returned string must be freed by the caller.
+    pub fn trimChars(self: *const CharSet, allocator: Allocator, str: []const u8) ![]u8 {
+        return allocator.dupe(u8, self.trimmedSlice(str));
+    }
+
+    /// Splits `str` at every member, like split() with several one-character
+    /// separators at once
+    ///
+    /// Returns slices of `str`; the caller frees only the outer slice.
+    pub fn splitAny(self: *const CharSet, allocator: Allocator, str: []const u8) ![][]const u8 {
+        var parts = std.ArrayList([]const u8){};
+        errdefer parts.deinit(allocator);
+
+        var field_start: usize = 0;
+        while (self.find(str, field_start, true)) |p| {
+            try parts.append(allocator, str[field_start..p]);
+            field_start = p + decodeAt(str, p).len;
+        }
+        try parts.append(allocator, str[field_start..]);
+        return parts.toOwnedSlice(allocator);
+    }
+
+    // ========================================================================
+    // Scanning
+    // ========================================================================
+
+    /// Byte mask of lanes holding ASCII members
+    inline fn asciiMembers(self: *const CharSet, v: simd.Vec) simd.Vec {
+        const shift: @Vector(simd.lanes, u3) = @splat(4);
+        const lo = simd.lookup16(self.lo_table, v & simd.splat(0x0F));
+        const hi = simd.lookup16(self.hi_table, v >> shift);
+        return simd.toBits((lo & hi) != simd.splat(0));
+    }
+
+    /// Byte mask of lanes that need a closer look when searching for a
+    /// code point whose membership is `member`
+    ///
+    /// Searching for members flags ASCII members and, if the set has
+    /// non-ASCII ranges, UTF-8 lead bytes. Searching for non-members flags
+    /// every byte that is not an ASCII member.
+    inline fn interesting(self: *const CharSet, v: simd.Vec, comptime member: bool) simd.Vec {
+        const ascii = self.asciiMembers(v);
+        if (!member) return ~ascii;
+        if (self.ranges.len == 0) return ascii;
+        return ascii | simd.toBits(v >= simd.splat(0xC0));
+    }
+
+    fn isMember(self: *const CharSet, c: Char) bool {
+        return if (c.cp) |cp| self.contains(cp) else false;
+    }
+
+    /// Byte offset of the first code point at or after `start` whose
+    /// membership is `member`
+    fn find(self: *const CharSet, str: []const u8, start: usize, comptime member: bool) ?usize {
+        var i = start;
+        while (i < str.len) {
+            if (i + simd.lanes <= str.len) {
+                const mask = self.interesting(simd.load(str, i), member);
+                if (!simd.any(mask)) {
+                    i += simd.lanes;
+                    continue;
+                }
+                i += simd.firstSet(mask);
+            }
+            const c = decodeAt(str, i);
+            if (self.isMember(c) == member) return i;
+            i += c.len;
+        }
+        return null;
+    }
+
+    /// Byte offset of the last code point starting before `end` whose
+    /// membership is `member`
+    fn findLast(self: *const CharSet, str: []const u8, end: usize, comptime member: bool) ?usize {
+        var e = end;
+        while (e > 0) {
+            var i = e - 1;
+            if (e >= simd.lanes) {
+                const mask = self.interesting(simd.load(str, e - simd.lanes), member);
+                const last = std.simd.lastTrue(mask != simd.splat(0)) orelse {
+                    e -= simd.lanes;
+                    continue;
+                };
+                i = e - simd.lanes + last;
+            }
+
+            // Back up from a continuation byte to the start of its code point
+            var s = i;
+            while (s > 0 and i - s < 3 and str[s] & 0xC0 == 0x80) s -= 1;
+            var c = decodeAt(str, s);
+            if (s + c.len <= i) {
+                // A stray continuation byte stands on its own
+                s = i;
+                c = .{ .cp = null, .len = 1 };
+            }
+            if (self.isMember(c) == member) return s;
+            e = s;
+        }
+        return null;
+    }
+};
+
+fn rangeLessThan(_: void, a: Range, b: Range) bool {
+    return a.first < b.first;
+}
+
+/// A decoded code point; invalid UTF-8 is one byte with no code point
+const Char = struct {
+    cp: ?u21,
+    len: usize,
+};
+
+fn decodeAt(str: []const u8, i: usize) Char {
+    const n = std.unicode.utf8ByteSequenceLength(str[i]) catch return .{ .cp = null, .len = 1 };
+    if (i + n > str.len) return .{ .cp = null, .len = 1 };
+    const cp = std.unicode.utf8Decode(str[i..][0..n]) catch return .{ .cp = null, .len = 1 };
+    return .{ .cp = cp, .len = n };
+}
+
+/// Byte offset of a UTF-16 position, clamped to the string
+fn byteOffset(str: []const u8, position: isize) usize {
+    if (position <= 0) return 0;
+    return utf16.utf16IndexToByte(str, @intCast(position)) catch str.len;
+}
+
+/// UTF-16 offset of a byte offset on a code point boundary
+fn utf16Offset(str: []const u8, byte_index: usize) usize {
+    const prefix = str[0..byte_index];
+    return if (simd.isAscii(prefix)) byte_index else utf16.lengthUtf16(prefix);
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "CharSet - ASCII indexOfAny and lastIndexOfAny" {
+    var set = try CharSet.init(std.testing.allocator, ",;:");
+    defer set.deinit();
+
+    try std.testing.expectEqual(@as(isize, 5), set.indexOfAny("hello;world,x", null));
+    try std.testing.expectEqual(@as(isize, 11), set.indexOfAny("hello;world,x", 6));
+    try std.testing.expectEqual(@as(isize, -1), set.indexOfAny("hello world", null));
+    try std.testing.expectEqual(@as(isize, 11), set.lastIndexOfAny("hello;world,x", null));
+    try std.testing.expectEqual(@as(isize, 5), set.lastIndexOfAny("hello;world,x", 10));
+    try std.testing.expectEqual(@as(isize, -1), set.lastIndexOfAny("hello;world,x", 4));
+
+    // Hits beyond the first vector and in the scalar tail
+    const long = "a" ** 70 ++ ":" ++ "b" ** 3;
+    try std.testing.expectEqual(@as(isize, 70), set.indexOfAny(long, null));
+    try std.testing.expectEqual(@as(isize, 70), set.lastIndexOfAny(long, null));
+}
+
+test "CharSet - non-ASCII members and UTF-16 indices" {
+    var set = try CharSet.init(std.testing.allocator, "、。😀");
+    defer set.deinit();
+
+    try std.testing.expect(set.contains(0x3001));
+    try std.testing.expect(!set.contains(0x3002 + 1));
+    // "ab€" is 3 units; "、" follows
+    try std.testing.expectEqual(@as(isize, 3), set.indexOfAny("ab€、cd", null));
+    // The emoji sits after a surrogate pair
+    try std.testing.expectEqual(@as(isize, 3), set.indexOfAny("🎉x😀", null));
+    try std.testing.expectEqual(@as(isize, 3), set.lastIndexOfAny("🎉x😀", null));
+
+    const long = "é" ** 40 ++ "。" ++ "x" ** 40;
+    try std.testing.expectEqual(@as(isize, 40), set.indexOfAny(long, null));
+    try std.testing.expectEqual(@as(isize, 40), set.lastIndexOfAny(long, null));
+}
+
+test "CharSet - spanOf and trimChars" {
+    const allocator = std.testing.allocator;
+    var set = try CharSet.init(allocator, " -*·");
+    defer set.deinit();
+
+    try std.testing.expectEqual(@as(usize, 4), set.spanOf("-* ·title"));
+    try std.testing.expectEqual(@as(usize, 0), set.spanOf("title"));
+    try std.testing.expectEqual(@as(usize, 3), set.spanOf("- *"));
+
+    const trimmed = try set.trimChars(allocator, "** ·title· - done **");
+    defer allocator.free(trimmed);
+    try std.testing.expectEqualStrings("title· - done", trimmed);
+
+    try std.testing.expectEqualStrings("", set.trimmedSlice("- - -"));
+    try std.testing.expectEqualStrings("x", set.trimmedSlice("x"));
+
+    const padded = "-" ** 50 ++ "core" ++ " " ** 50;
+    try std.testing.expectEqualStrings("core", set.trimmedSlice(padded));
+}
+
+test "CharSet - splitAny" {
+    const allocator = std.testing.allocator;
+    var set = try CharSet.initRanges(allocator, &.{
+        .{ .first = ',', .last = ',' },
+        .{ .first = ';', .last = ';' },
+        .{ .first = 0x3000, .last = 0x3002 },
+    });
+    defer set.deinit();
+
+    const parts = try set.splitAny(allocator, "a,b;;c、d");
+    defer allocator.free(parts);
+    try std.testing.expectEqual(@as(usize, 5), parts.len);
+    try std.testing.expectEqualStrings("a", parts[0]);
+    try std.testing.expectEqualStrings("b", parts[1]);
+    try std.testing.expectEqualStrings("", parts[2]);
+    try std.testing.expectEqualStrings("c", parts[3]);
+    try std.testing.expectEqualStrings("d", parts[4]);
+
+    const none = try set.splitAny(allocator, "");
+    defer allocator.free(none);
+    try std.testing.expectEqual(@as(usize, 1), none.len);
+}
+
+test "CharSet - ranges are merged" {
+    var set = try CharSet.initRanges(std.testing.allocator, &.{
+        .{ .first = 0x400, .last = 0x4FF },
+        .{ .first = 'a', .last = 'z' },
+        .{ .first = 0x450, .last = 0x520 },
+        .{ .first = 0x60, .last = 0x90 },
+    });
+    defer set.deinit();
+
+    try std.testing.expectEqual(@as(usize, 2), set.ranges.len);
+    try std.testing.expect(set.contains('a'));
+    try std.testing.expect(set.contains(0x7F));
+    try std.testing.expect(set.contains(0x85));
+    try std.testing.expect(set.contains(0x510));
+    try std.testing.expect(!set.contains('A'));
+    try std.testing.expect(!set.contains(0x3FF));
+
+    try std.testing.expectError(error.InvalidRange, CharSet.initRanges(std.testing.allocator, &.{.{ .first = 'z', .last = 'a' }}));
+}
@@ -0,0 +1,624 @@
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const simd = @import("../core/simd.zig");
+const utf16 = @import("../core/utf16.zig");
+const trimming = @import("trimming.zig");
+
+/// Unit the texts are compared in
+pub const Granularity = enum {
+    /// One token per code point
+    code_point,
+    /// Runs of word characters, runs of whitespace, and single punctuation
+    /// characters
+    word,
+    /// One token per line, including its terminator (\n, \r, \r\n, U+2028,
+    /// U+2029)
+    line,
+};
+
+/// Diff options
+pub const Options = struct {
+    granularity: Granularity = .code_point,
+};
+
+pub const Op = enum(u8) {
+    equal = 0,
+    delete = 1,
+    insert = 2,
+};
+
+/// A range of one of the two texts
+/// `start` and `len` are in UTF-16 code units (as computed by
+/// utf16.lengthUtf16()); the byte range is kept for slicing the UTF-8 input.
+pub const Range = struct {
+    start: usize,
+    len: usize,
+    byte_start: usize,
+    byte_len: usize,
+};
+
+/// One step of an edit script
+///
+/// Applying the script in order to the old text yields the new text:
+/// `.equal` copies `old` (which matches `new`), `.delete` drops `old`
+/// (`new` is empty), `.insert` adds `new` (`old` is empty). Both ranges
+/// always start where the previous edit ended.
+pub const Edit = struct {
+    op: Op,
+    old: Range,
+    new: Range,
+};
+
+/// Computes an edit script turning `old_text` into `new_text`
+///
+/// Uses Myers' O(ND) algorithm with the linear-space middle-snake
+/// refinement. The common prefix and suffix are trimmed with vector
+/// compares before any tokenizing, so mostly-identical documents cost
+/// little more than a memcmp. Adjacent edits of the same kind are merged.
+///
+/// Caller owns the returned slice.
+pub fn diff(allocator: Allocator, old_text: []const u8, new_text: []const u8, options: Options) ![]Edit {
+    if (!std.unicode.utf8ValidateSlice(old_text) or !std.unicode.utf8ValidateSlice(new_text)) {
+        return error.InvalidUtf8;
+    }
+    const g = options.granularity;
+
+    // Byte-level trimming, pulled back to a token boundary in both texts
+    var prefix = simd.commonPrefixLength(old_text, new_text);
+    while (prefix > 0 and !(isBoundary(g, old_text, prefix) and isBoundary(g, new_text, prefix))) {
+        prefix -= 1;
+    }
+    var suffix = simd.commonSuffixLength(old_text[prefix..], new_text[prefix..]);
+    while (suffix > 0 and
+        !(isBoundary(g, old_text, old_text.len - suffix) and isBoundary(g, new_text, new_text.len - suffix)))
+    {
+        suffix -= 1;
+    }
+
+    const prefix_units = utf16.lengthUtf16(old_text[0..prefix]);
+    const old_end = old_text.len - suffix;
+    const new_end = new_text.len - suffix;
+
+    var a = Tokens{};
+    defer a.deinit(allocator);
+    try a.build(allocator, g, old_text, prefix, old_end, prefix_units);
+    var b = Tokens{};
+    defer b.deinit(allocator);
+    try b.build(allocator, g, new_text, prefix, new_end, prefix_units);
+
+    var differ = Differ{
+        .allocator = allocator,
+        .old_text = old_text,
+        .new_text = new_text,
+        .a = &a,
+        .b = &b,
+    };
+    defer differ.ops.deinit(allocator);
+    try differ.run(0, a.len(), 0, b.len());
+
+    var script = std.ArrayList(Edit){};
+    errdefer script.deinit(allocator);
+
+    if (prefix > 0) {
+        const r = Range{ .start = 0, .len = prefix_units, .byte_start = 0, .byte_len = prefix };
+        try push(allocator, &script, .{ .op = .equal, .old = r, .new = r });
+    }
+    for (differ.ops.items) |raw| {
+        try push(allocator, &script, .{
+            .op = raw.op,
+            .old = a.range(raw.a_lo, raw.a_hi),
+            .new = b.range(raw.b_lo, raw.b_hi),
+        });
+    }
+    if (suffix > 0) {
+        const old_units = a.units.items[a.len()];
+        const new_units = b.units.items[b.len()];
+        const suffix_units = utf16.lengthUtf16(old_text[old_end..]);
+        try push(allocator, &script, .{
+            .op = .equal,
+            .old = .{ .start = old_units, .len = suffix_units, .byte_start = old_end, .byte_len = suffix },
+            .new = .{ .start = new_units, .len = suffix_units, .byte_start = new_end, .byte_len = suffix },
+        });
+    }
+    return script.toOwnedSlice(allocator);
+}
+
+/// Appends an edit, merging it into the previous one when the kinds match
+fn push(allocator: Allocator, script: *std.ArrayList(Edit), edit: Edit) !void {
+    if (script.items.len > 0) {
+        const last = &script.items[script.items.len - 1];
+        if (last.op == edit.op) {
+            last.old.len += edit.old.len;
+            last.old.byte_len += edit.old.byte_len;
+            last.new.len += edit.new.len;
+            last.new.byte_len += edit.new.byte_len;
+            return;
+        }
+    }
+    try script.append(allocator, edit);
+}
+
+// ============================================================================
+// Segmentation
+// ============================================================================
+
+const Class = enum { word, space, other };
+
+fn classOf(cp: u21) Class {
+    if (trimming.isWhitespace(cp)) return .space;
+    if (cp >= 0x80) return .word;
+    return switch (cp) {
+        'a'...'z', 'A'...'Z', '0'...'9', '_' => .word,
+        else => .other,
+    };
+}
+
+fn isLineTerminator(cp: u21) bool {
+    return cp == '\n' or cp == '\r' or cp == 0x2028 or cp == 0x2029;
+}
+
+/// Decodes the code point starting at byte `i` (input is valid UTF-8)
+fn codepointAt(str: []const u8, i: usize) u21 {
+    const len = std.unicode.utf8ByteSequenceLength(str[i]) catch unreachable;
+    return std.unicode.utf8Decode(str[i..][0..len]) catch unreachable;
+}
+
+/// Decodes the code point ending at byte `i` (input is valid UTF-8)
+fn codepointBefore(str: []const u8, i: usize) u21 {
+    var start = i - 1;
+    while (start > 0 and str[start] & 0xC0 == 0x80) start -= 1;
+    return codepointAt(str, start);
+}
+
+/// Returns true if a token boundary falls at byte `i`
+fn isBoundary(g: Granularity, str: []const u8, i: usize) bool {
+    if (i == 0 or i >= str.len) return true;
+    if (str[i] & 0xC0 == 0x80) return false;
+    return switch (g) {
+        .code_point => true,
+        .line => blk: {
+            const prev = codepointBefore(str, i);
+            break :blk isLineTerminator(prev) and !(prev == '\r' and str[i] == '\n');
+        },
+        .word => blk: {
+            const prev = classOf(codepointBefore(str, i));
+            break :blk prev == .other or prev != classOf(codepointAt(str, i));
+        },
+    };
+}
+
+/// Tokens of the untrimmed middle of one text
+const Tokens = struct {
+    /// Byte offset of each token start, plus the end (len + 1 entries)
+    bounds: std.ArrayList(usize) = .{},
+    /// UTF-16 offset of each token start, plus the end (len + 1 entries)
+    units: std.ArrayList(usize) = .{},
+    /// Hash of each token's bytes, checked before comparing them
+    hashes: std.ArrayList(u64) = .{},
+
+    fn deinit(self: *Tokens, allocator: Allocator) void {
+        self.bounds.deinit(allocator);
+        self.units.deinit(allocator);
+        self.hashes.deinit(allocator);
+    }
+
+    fn build(self: *Tokens, allocator: Allocator, g: Granularity, str: []const u8, start: usize, end: usize, unit_start: usize) !void {
+        try self.bounds.append(allocator, start);
+        try self.units.append(allocator, unit_start);
+
+        var i = start;
+        var token_start = start;
+        var unit = unit_start;
+        while (i < end) {
+            const cp_len = std.unicode.utf8ByteSequenceLength(str[i]) catch unreachable;
+            unit += if (cp_len == 4) 2 else 1;
+            i += cp_len;
+            if (i == end or isBoundary(g, str, i)) {
+                try self.bounds.append(allocator, i);
+                try self.units.append(allocator, unit);
+                try self.hashes.append(allocator, std.hash.Wyhash.hash(0, str[token_start..i]));
+                token_start = i;
+            }
+        }
+    }
+
+    fn len(self: *const Tokens) usize {
+        return self.hashes.items.len;
+    }
+
+    fn bytes(self: *const Tokens, str: []const u8, i: usize) []const u8 {
+        return str[self.bounds.items[i]..self.bounds.items[i + 1]];
+    }
+
+    fn range(self: *const Tokens, lo: usize, hi: usize) Range {
+        return .{
+            .start = self.units.items[lo],
+            .len = self.units.items[hi] - self.units.items[lo],
+            .byte_start = self.bounds.items[lo],
+            .byte_len = self.bounds.items[hi] - self.bounds.items[lo],
+        };
+    }
+};
+
+// ============================================================================
+// Myers
+// ============================================================================
+
+/// An edit over token indices
+const RawOp = struct {
+    op: Op,
+    a_lo: usize,
+    a_hi: usize,
+    b_lo: usize,
+    b_hi: usize,
+};
+
+const Differ = struct {
+    allocator: Allocator,
+    old_text: []const u8,
+    new_text: []const u8,
+    a: *const Tokens,
+    b: *const Tokens,
+    ops: std.ArrayList(RawOp) = .{},
+
+    fn same(self: *const Differ, i: usize, j: usize) bool {
+        return self.a.hashes.items[i] == self.b.hashes.items[j] and
+            std.mem.eql(u8, self.a.bytes(self.old_text, i), self.b.bytes(self.new_text, j));
+    }
+
+    fn emit(self: *Differ, op: Op, a_lo: usize, a_hi: usize, b_lo: usize, b_hi: usize) !void {
+        if (a_lo == a_hi and b_lo == b_hi) return;
+        if (self.ops.items.len > 0) {
+            const last = &self.ops.items[self.ops.items.len - 1];
+            if (last.op == op) {
+                last.a_hi = a_hi;
+                last.b_hi = b_hi;
+                return;
+            }
+        }
+        try self.ops.append(self.allocator, .{ .op = op, .a_lo = a_lo, .a_hi = a_hi, .b_lo = b_lo, .b_hi = b_hi });
+    }
+
+    /// Diffs a[a_lo..a_hi] against b[b_lo..b_hi], appending ops in order
+    fn run(self: *Differ, a_start: usize, a_end: usize, b_start: usize, b_end: usize) !void {
+        var a_lo = a_start;
+        var b_lo = b_start;
+        while (a_lo < a_end and b_lo < b_end and self.same(a_lo, b_lo)) {
+            a_lo += 1;
+            b_lo += 1;
+        }
+        try self.emit(.equal, a_start, a_lo, b_start, b_lo);
+
+        var a_hi = a_end;
+        var b_hi = b_end;
+        while (a_hi > a_lo and b_hi > b_lo and self.same(a_hi - 1, b_hi - 1)) {
+            a_hi -= 1;
+            b_hi -= 1;
+        }
+
+        if (a_lo == a_hi or b_lo == b_hi) {
+            try self.emit(.delete, a_lo, a_hi, b_lo, b_lo);
+            try self.emit(.insert, a_hi, a_hi, b_lo, b_hi);
+        } else if (a_hi - a_lo == 1 or b_hi - b_lo == 1) {
+            try self.runSingle(a_lo, a_hi, b_lo, b_hi);
+        } else if (try self.middleSnake(a_lo, a_hi, b_lo, b_hi)) |mid| {
+            try self.run(a_lo, mid[0], b_lo, mid[1]);
+            try self.run(mid[0], a_hi, mid[1], b_hi);
+        } else {
+            try self.emit(.delete, a_lo, a_hi, b_lo, b_lo);
+            try self.emit(.insert, a_hi, a_hi, b_lo, b_hi);
+        }
+
+        try self.emit(.equal, a_hi, a_end, b_hi, b_end);
+    }
+
+    /// One side is a single token: it either survives once inside the other
+    /// side (everything around it is inserted or deleted) or is replaced
+    fn runSingle(self: *Differ, a_lo: usize, a_hi: usize, b_lo: usize, b_hi: usize) !void {
+        if (a_hi - a_lo == 1) {
+            for (b_lo..b_hi) |j| {
+                if (!self.same(a_lo, j)) continue;
+                try self.emit(.insert, a_lo, a_lo, b_lo, j);
+                try self.emit(.equal, a_lo, a_hi, j, j + 1);
+                try self.emit(.insert, a_hi, a_hi, j + 1, b_hi);
+                return;
+            }
+        } else {
+            for (a_lo..a_hi) |i| {
+                if (!self.same(i, b_lo)) continue;
+                try self.emit(.delete, a_lo, i, b_lo, b_lo);
+                try self.emit(.equal, i, i + 1, b_lo, b_hi);
+                try self.emit(.delete, i + 1, a_hi, b_hi, b_hi);
+                return;
+            }
+        }
+        try self.emit(.delete, a_lo, a_hi, b_lo, b_lo);
+        try self.emit(.insert, a_hi, a_hi, b_lo, b_hi);
+    }
+
+    /// Finds a point on an optimal path through the middle of the edit
+    /// graph by running the forward and reverse searches until they overlap
+    ///
+    /// Both ranges are non-empty and their first and last tokens differ.
+    /// Returns null if no split strictly inside the ranges exists.
+    fn middleSnake(self: *Differ, a_lo: usize, a_hi: usize, b_lo: usize, b_hi: usize) !?[2]usize {
+        const n: isize = @intCast(a_hi - a_lo);
+        const m: isize = @intCast(b_hi - b_lo);
+        const max_d = @divTrunc(n + m + 1, 2);
+        const v_offset = max_d;
+        // Diagonals -max_d..max_d, plus the seed at v_offset + 1
+        const v_len = 2 * max_d + 2;
+
+        const v = try self.allocator.alloc(isize, @intCast(2 * v_len));
+        defer self.allocator.free(v);
+        @memset(v, -1);
+        const v1 = v[0..@intCast(v_len)];
+        const v2 = v[@intCast(v_len)..];
+        v1[@intCast(v_offset + 1)] = 0;
+        v2[@intCast(v_offset + 1)] = 0;
+
+        const delta = n - m;
+        // With an odd delta the forward search meets the reverse one
+        const front = @mod(delta, 2) != 0;
+        var k1_start: isize = 0;
+        var k1_end: isize = 0;
+        var k2_start: isize = 0;
+        var k2_end: isize = 0;
+
+        var d: isize = 0;
+        while (d < max_d) : (d += 1) {
+            var k1 = -d + k1_start;
+            while (k1 <= d - k1_end) : (k1 += 2) {
+                const k1_offset: usize = @intCast(v_offset + k1);
+                var x1 = if (k1 == -d or (k1 != d and v1[k1_offset - 1] < v1[k1_offset + 1]))
+                    v1[k1_offset + 1]
+                else
+                    v1[k1_offset - 1] + 1;
+                var y1 = x1 - k1;
+                while (x1 < n and y1 < m and self.same(a_lo + @as(usize, @intCast(x1)), b_lo + @as(usize, @intCast(y1)))) {
+                    x1 += 1;
+                    y1 += 1;
+                }
+                v1[k1_offset] = x1;
+                if (x1 > n) {
+                    k1_end += 2;
+                } else if (y1 > m) {
+                    k1_start += 2;
+                } else if (front) {
+                    const k2_offset = v_offset + delta - k1;
+                    if (k2_offset >= 0 and k2_offset < v_len and v2[@intCast(k2_offset)] != -1) {
+                        const x2 = n - v2[@intCast(k2_offset)];
+                        if (x1 >= x2) return split(a_lo, b_lo, x1, y1, n, m);
+                    }
+                }
+            }
+
+            var k2 = -d + k2_start;
+            while (k2 <= d - k2_end) : (k2 += 2) {
+                const k2_offset: usize = @intCast(v_offset + k2);
+                var x2 = if (k2 == -d or (k2 != d and v2[k2_offset - 1] < v2[k2_offset + 1]))
+                    v2[k2_offset + 1]
+                else
+                    v2[k2_offset - 1] + 1;
+                var y2 = x2 - k2;
+                while (x2 < n and y2 < m and
+                    self.same(a_lo + @as(usize, @intCast(n - x2 - 1)), b_lo + @as(usize, @intCast(m - y2 - 1))))
+                {
+                    x2 += 1;
+                    y2 += 1;
+                }
+                v2[k2_offset] = x2;
+                if (x2 > n) {
+                    k2_end += 2;
+                } else if (y2 > m) {
+                    k2_start += 2;
+                } else if (!front) {
+                    const k1_offset = v_offset + delta - k2;
+                    if (k1_offset >= 0 and k1_offset < v_len and v1[@intCast(k1_offset)] != -1) {
+                        const x1 = v1[@intCast(k1_offset)];
+                        const y1 = v_offset + x1 - k1_offset;
+                        if (x1 >= n - x2) return split(a_lo, b_lo, x1, y1, n, m);
+                    }
+                }
+            }
+        }
+        return null;
+    }
+
+    fn split(a_lo: usize, b_lo: usize, x: isize, y: isize, n: isize, m: isize) ?[2]usize {
+        // A split on a corner would not shrink the problem
+        if ((x == 0 and y == 0) or (x == n and y == m)) return null;
+        return .{ a_lo + @as(usize, @intCast(x)), b_lo + @as(usize, @intCast(y)) };
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+/// Rebuilds the new text from the old one and the script, checking that
+/// every range is contiguous and that UTF-16 offsets match the bytes
+fn expectApplies(old_text: []const u8, new_text: []const u8, script: []const Edit) !void {
+    var out = std.ArrayList(u8){};
+    defer out.deinit(std.testing.allocator);
+    var old_pos: usize = 0;
+    var new_pos: usize = 0;
+    for (script) |e| {
+        try std.testing.expectEqual(old_pos, e.old.byte_start);
+        try std.testing.expectEqual(new_pos, e.new.byte_start);
+        const old_part = old_text[e.old.byte_start..][0..e.old.byte_len];
+        const new_part = new_text[e.new.byte_start..][0..e.new.byte_len];
+        try std.testing.expectEqual(utf16.lengthUtf16(old_text[0..old_pos]), e.old.start);
+        try std.testing.expectEqual(utf16.lengthUtf16(new_text[0..new_pos]), e.new.start);
+        try std.testing.expectEqual(utf16.lengthUtf16(old_part), e.old.len);
+        try std.testing.expectEqual(utf16.lengthUtf16(new_part), e.new.len);
+        switch (e.op) {
+            .equal => {
+                try std.testing.expectEqualStrings(old_part, new_part);
+                try out.appendSlice(std.testing.allocator, old_part);
+            },
+            .delete => try std.testing.expectEqual(@as(usize, 0), e.new.byte_len),
+            .insert => {
+                try std.testing.expectEqual(@as(usize, 0), e.old.byte_len);
+                try out.appendSlice(std.testing.allocator, new_part);
+            },
+        }
+        old_pos += e.old.byte_len;
+        new_pos += e.new.byte_len;
+    }
+    try std.testing.expectEqual(old_text.len, old_pos);
+    try std.testing.expectEqualStrings(new_text, out.items);
+}
+
+fn editCost(script: []const Edit) usize {
+    var cost: usize = 0;
+    for (script) |e| {
+        if (e.op != .equal) cost += e.old.len + e.new.len;
+    }
+    return cost;
+}
+
+test "diff - code points" {
+    const allocator = std.testing.allocator;
+    const script = try diff(allocator, "kitten", "sitting", .{});
+    defer allocator.free(script);
+    try expectApplies("kitten", "sitting", script);
+    // k->s, e->i, +g
+    try std.testing.expectEqual(@as(usize, 5), editCost(script));
+
+    const same = try diff(allocator, "same", "same", .{});
+    defer allocator.free(same);
+    try std.testing.expectEqual(@as(usize, 1), same.len);
+    try std.testing.expectEqual(Op.equal, same[0].op);
+
+    const empty = try diff(allocator, "", "", .{});
+    defer allocator.free(empty);
+    try std.testing.expectEqual(@as(usize, 0), empty.len);
+
+    // One-token substitutions (the smallest middle-snake input)
+    const swapped = try diff(allocator, "a", "b", .{});
+    defer allocator.free(swapped);
+    try expectApplies("a", "b", swapped);
+    try std.testing.expectEqual(@as(usize, 2), swapped.len);
+    try std.testing.expectEqual(Op.delete, swapped[0].op);
+    try std.testing.expectEqual(Op.insert, swapped[1].op);
+
+    const vowel = try diff(allocator, "cat", "cut", .{});
+    defer allocator.free(vowel);
+    try expectApplies("cat", "cut", vowel);
+    try std.testing.expectEqual(@as(usize, 2), editCost(vowel));
+
+    // A single token kept inside a longer text
+    const grown = try diff(allocator, "b", "abc", .{});
+    defer allocator.free(grown);
+    try expectApplies("b", "abc", grown);
+    try std.testing.expectEqual(@as(usize, 3), grown.len);
+    try std.testing.expectEqual(Op.equal, grown[1].op);
+
+    const shrunk = try diff(allocator, "abc", "b", .{});
+    defer allocator.free(shrunk);
+    try expectApplies("abc", "b", shrunk);
+    try std.testing.expectEqual(@as(usize, 2), editCost(shrunk));
+
+    const added = try diff(allocator, "", "abc", .{});
+    defer allocator.free(added);
+    try std.testing.expectEqual(@as(usize, 1), added.len);
+    try std.testing.expectEqual(Op.insert, added[0].op);
+    try std.testing.expectEqual(@as(usize, 3), added[0].new.len);
+}
+
+test "diff - UTF-16 offsets" {
+    const allocator = std.testing.allocator;
+    const old_text = "a😀b café";
+    const new_text = "a😀c cafés";
+    const script = try diff(allocator, old_text, new_text, .{});
+    defer allocator.free(script);
+    try expectApplies(old_text, new_text, script);
+
+    // "a😀" is 3 code units; the change starts after it
+    try std.testing.expectEqual(Op.equal, script[0].op);
+    try std.testing.expectEqual(@as(usize, 3), script[0].old.len);
+    try std.testing.expectEqual(@as(usize, 3), script[1].old.start);
+    try std.testing.expectEqual(@as(usize, 3), script[1].new.start);
+
+    // Trimming must not split a multi-byte character ("é" vs "è" share a lead byte)
+    const accent = try diff(allocator, "é", "è", .{});
+    defer allocator.free(accent);
+    try expectApplies("é", "è", accent);
+    try std.testing.expectEqual(@as(usize, 2), accent.len);
+}
+
+test "diff - lines" {
+    const allocator = std.testing.allocator;
+    const old_text = "one\ntwo\nthree\r\nfour\n";
+    const new_text = "one\ntoo\nthree\r\nfour\nfive";
+    const script = try diff(allocator, old_text, new_text, .{ .granularity = .line });
+    defer allocator.free(script);
+    try expectApplies(old_text, new_text, script);
+
+    try std.testing.expectEqual(@as(usize, 5), script.len);
+    try std.testing.expectEqual(Op.delete, script[1].op);
+    try std.testing.expectEqualStrings("two\n", old_text[script[1].old.byte_start..][0..script[1].old.byte_len]);
+    try std.testing.expectEqual(Op.insert, script[2].op);
+    try std.testing.expectEqualStrings("too\n", new_text[script[2].new.byte_start..][0..script[2].new.byte_len]);
+    try std.testing.expectEqual(Op.insert, script[4].op);
+    try std.testing.expectEqualStrings("five", new_text[script[4].new.byte_start..]);
+
+    // "\r" becoming "\r\n" changes the whole line
+    const crlf = try diff(allocator, "a\rb", "a\r\nb", .{ .granularity = .line });
+    defer allocator.free(crlf);
+    try expectApplies("a\rb", "a\r\nb", crlf);
+    try std.testing.expectEqual(Op.delete, crlf[0].op);
+}
+
+test "diff - words" {
+    const allocator = std.testing.allocator;
+    const old_text = "The quick brown fox.";
+    const new_text = "The quick red fox!";
+    const script = try diff(allocator, old_text, new_text, .{ .granularity = .word });
+    defer allocator.free(script);
+    try expectApplies(old_text, new_text, script);
+
+    try std.testing.expectEqual(Op.delete, script[1].op);
+    try std.testing.expectEqualStrings("brown", old_text[script[1].old.byte_start..][0..script[1].old.byte_len]);
+    try std.testing.expectEqual(Op.insert, script[2].op);
+    try std.testing.expectEqualStrings("red", new_text[script[2].new.byte_start..][0..script[2].new.byte_len]);
+
+    // The shared "brow" prefix of two different words is not split off
+    const partial = try diff(allocator, "a brown b", "a browse b", .{ .granularity = .word });
+    defer allocator.free(partial);
+    try expectApplies("a brown b", "a browse b", partial);
+    try std.testing.expectEqual(@as(usize, 2), partial[0].old.len);
+}
+
+test "diff - interleaved changes match brute-force cost" {
+    const allocator = std.testing.allocator;
+    const old_text = "ABCABBA";
+    const new_text = "CBABAC";
+    const script = try diff(allocator, old_text, new_text, .{});
+    defer allocator.free(script);
+    try expectApplies(old_text, new_text, script);
+    // The example from Myers' paper: D = 5
+    try std.testing.expectEqual(@as(usize, 5), editCost(script));
+}
+
+test "diff - large mostly-identical document" {
+    const allocator = std.testing.allocator;
+    var old_doc = std.ArrayList(u8){};
+    defer old_doc.deinit(allocator);
+    var i: usize = 0;
+    while (i < 2000) : (i += 1) {
+        try old_doc.print(allocator, "line {d}\n", .{i});
+    }
+    const new_doc = try allocator.dupe(u8, old_doc.items);
+    defer allocator.free(new_doc);
+    // Change one character near the middle
+    const pos = std.mem.indexOf(u8, new_doc, "line 1000\n").?;
+    new_doc[pos + 5] = '9';
+
+    const script = try diff(allocator, old_doc.items, new_doc, .{ .granularity = .line });
+    defer allocator.free(script);
+    try expectApplies(old_doc.items, new_doc, script);
+    try std.testing.expectEqual(@as(usize, 4), script.len);
+    try std.testing.expectEqual(@as(usize, 10), script[1].old.len);
+}
@@ -0,0 +1,422 @@
+const std = @import("std");
+const simd = @import("../core/simd.zig");
+const engine = @import("../core/rewrite.zig");
+const ZString = @import("../core/string.zig").ZString;
+const Allocator = std.mem.Allocator;
+const Step = engine.Step;
+const rewrite = engine.rewrite;
+const apply = engine.apply;
+
+// Each codec below is a byte class plus a step function; see core/rewrite.zig.
+// Special bytes are found with vector compares, clean runs are copied in bulk
+// and inputs without special bytes are returned borrowed.
+
+const hex_digits = "0123456789abcdef";
+
+fn hexValue(c: u8) ?u8 {
+    return switch (c) {
+        '0'...'9' => c - '0',
+        'a'...'f' => c - 'a' + 10,
+        'A'...'F' => c - 'A' + 10,
+        else => null,
+    };
+}
+
+/// Encodes a code point as UTF-8, keeping lone surrogates as 3-byte WTF-8
+fn encodeCodePoint(cp: u21, buf: []u8) usize {
+    if (cp >= 0xD800 and cp <= 0xDFFF) {
+        buf[0] = 0xED;
+        buf[1] = @intCast(0x80 | ((cp >> 6) & 0x3F));
+        buf[2] = @intCast(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    return std.unicode.utf8Encode(cp, buf) catch unreachable;
+}
+
+// ============================================================================
+// JSON
+// ============================================================================
+
+const JsonEscape = struct {
+    fn vector(v: simd.Vec) simd.Vec {
+        return simd.lessThan(v, 0x20) | simd.eq(v, '"') | simd.eq(v, '\\') | simd.eq(v, 0xED);
+    }
+
+    fn scalar(b: u8) bool {
+        return b < 0x20 or b == '"' or b == '\\' or b == 0xED;
+    }
+
+    fn step(str: []const u8, pos: usize, buf: *[engine.step_buf_len]u8) !Step {
+        const b = str[pos];
+        const short: ?u8 = switch (b) {
+            '"' => '"',
+            '\\' => '\\',
+            0x08 => 'b',
+            0x0C => 'f',
+            '\n' => 'n',
+            '\r' => 'r',
+            '\t' => 't',
+            else => null,
+        };
+        if (short) |c| {
+            buf[0] = '\\';
+            buf[1] = c;
+            return .{ .bytes = buf[0..2], .consumed = 1 };
+        }
+
+        if (b < 0x20) {
+            return .{ .bytes = unicodeEscape(b, buf), .consumed = 1 };
+        }
+
+        // 0xED: lone surrogates (WTF-8 ED A0..BF xx) become \udxxx,
+        // anything else (U+D000..U+D7FF) is copied unchanged
+        if (pos + 2 < str.len and str[pos + 1] >= 0xA0 and str[pos + 1] <= 0xBF) {
+            const unit: u16 = 0xD000 | (@as(u16, str[pos + 1] & 0x3F) << 6) | (str[pos + 2] & 0x3F);
+            return .{ .bytes = unicodeEscape(unit, buf), .consumed = 3 };
+        }
+        return .{ .bytes = str[pos .. pos + 1], .consumed = 1 };
+    }
+
+    fn unicodeEscape(unit: u16, buf: *[engine.step_buf_len]u8) []const u8 {
+        buf[0] = '\\';
+        buf[1] = 'u';
+        buf[2] = hex_digits[(unit >> 12) & 0xF];
+        buf[3] = hex_digits[(unit >> 8) & 0xF];
+        buf[4] = hex_digits[(unit >> 4) & 0xF];
+        buf[5] = hex_digits[unit & 0xF];
+        return buf[0..6];
+    }
+};
+
+const JsonUnescape = struct {
+    fn vector(v: simd.Vec) simd.Vec {
+        return simd.eq(v, '\\');
+    }
+
+    fn scalar(b: u8) bool {
+        return b == '\\';
+    }
+
+    fn step(str: []const u8, pos: usize, buf: *[engine.step_buf_len]u8) !Step {
+        if (pos + 1 >= str.len) return error.InvalidEscape;
+
+        const simple: ?u8 = switch (str[pos + 1]) {
+            '"' => '"',
+            '\\' => '\\',
+            '/' => '/',
+            'b' => 0x08,
+            'f' => 0x0C,
+            'n' => '\n',
+            'r' => '\r',
+            't' => '\t',
+            'u' => null,
+            else => return error.InvalidEscape,
+        };
+        if (simple) |c| {
+            buf[0] = c;
+            return .{ .bytes = buf[0..1], .consumed = 2 };
+        }
+
+        const unit = try parseUnit(str, pos);
+        var cp: u21 = unit;
+        var consumed: usize = 6;
+
+        // Combine a surrogate pair written as two escapes
+        if (unit >= 0xD800 and unit <= 0xDBFF and
+            pos + 12 <= str.len and str[pos + 6] == '\\' and str[pos + 7] == 'u')
+        {
+            const low = try parseUnit(str, pos + 6);
+            if (low >= 0xDC00 and low <= 0xDFFF) {
+                cp = 0x10000 + ((@as(u21, unit) - 0xD800) << 10) + (low - 0xDC00);
+                consumed = 12;
+            }
+        }
+
+        const len = encodeCodePoint(cp, buf);
+        return .{ .bytes = buf[0..len], .consumed = consumed };
+    }
+
+    fn parseUnit(str: []const u8, pos: usize) !u16 {
+        if (pos + 6 > str.len) return error.InvalidEscape;
+        var unit: u16 = 0;
+        for (str[pos + 2 .. pos + 6]) |c| {
+            const d = hexValue(c) orelse return error.InvalidEscape;
+            unit = (unit << 4) | d;
+        }
+        return unit;
+    }
+};
+
+/// Escapes a string for use inside a JSON string literal
+///
+/// Follows JSON.stringify (QuoteJSONString) without the surrounding quotes:
+/// `"` and `\` are backslash-escaped, control characters use the short forms
+/// (\b \f \n \r \t) or \u00XX, and lone surrogates become \uDXXX.
+///
+/// Returns the input as a borrowed ZString when nothing needs escaping,
+/// otherwise an owned ZString. Always call deinit() on the result.
+///
+/// Examples:
+///   escapeJson("say \"hi\"") -> "say \\\"hi\\\""
+///   escapeJson("a\nb") -> "a\\nb"
+///   escapeJson("plain") -> "plain" (borrowed, no allocation)
+pub fn escapeJson(allocator: Allocator, str: []const u8) !ZString {
+    return apply(JsonEscape, allocator, str);
+}
+
+/// Decodes the escape sequences of a JSON string literal body
+///
+/// Accepts \" \\ \/ \b \f \n \r \t and \uXXXX (surrogate pairs are joined).
+/// Returns error.InvalidEscape for malformed sequences.
+///
+/// Returns the input as a borrowed ZString when it contains no escapes,
+/// otherwise an owned ZString. Always call deinit() on the result.
+///
+/// Examples:
+///   unescapeJson("a\\nb") -> "a\nb"
+///   unescapeJson("\\ud83d\\ude00") -> "😀"
+pub fn unescapeJson(allocator: Allocator, str: []const u8) !ZString {
+    return apply(JsonUnescape, allocator, str);
+}
+
+/// JSON.stringify(string)
+/// Spec: https://tc39.es/ecma262/2025/#sec-quotejsonstring
+///
+/// Returns the escaped string wrapped in double quotes.
+///
+/// Examples:
+///   quoteJson("hello") -> "\"hello\""
+///   quoteJson("tab\there") -> "\"tab\\there\""
+///
+/// The returned string must be freed by the caller.
+pub fn quoteJson(allocator: Allocator, str: []const u8) ![]u8 {
+    const first = simd.indexOfClass(JsonEscape, str, 0) orelse str.len;
+    const body_len = first + try rewrite(JsonEscape, str, first, null);
+
+    const result = try allocator.alloc(u8, body_len + 2);
+    errdefer allocator.free(result);
+
+    result[0] = '"';
+    @memcpy(result[1 .. 1 + first], str[0..first]);
+    _ = try rewrite(JsonEscape, str, first, result[1 + first .. 1 + body_len]);
+    result[body_len + 1] = '"';
+
+    return result;
+}
+
+// ============================================================================
+// HTML
+// ============================================================================
+
+const HtmlEscape = struct {
+    fn vector(v: simd.Vec) simd.Vec {
+        return simd.eq(v, '&') | simd.eq(v, '<') | simd.eq(v, '>') | simd.eq(v, '"') | simd.eq(v, '\'');
+    }
+
+    fn scalar(b: u8) bool {
+        return b == '&' or b == '<' or b == '>' or b == '"' or b == '\'';
+    }
+
+    fn step(str: []const u8, pos: usize, _: *[engine.step_buf_len]u8) !Step {
+        const entity: []const u8 = switch (str[pos]) {
+            '&' => "&amp;",
+            '<' => "&lt;",
+            '>' => "&gt;",
+            '"' => "&quot;",
+            '\'' => "&#39;",
+            else => unreachable,
+        };
+        return .{ .bytes = entity, .consumed = 1 };
+    }
+};
+
+const HtmlUnescape = struct {
+    const named = [_]struct { name: []const u8, value: []const u8 }{
+        .{ .name = "amp;", .value = "&" },
+        .{ .name = "lt;", .value = "<" },
+        .{ .name = "gt;", .value = ">" },
+        .{ .name = "quot;", .value = "\"" },
+        .{ .name = "apos;", .value = "'" },
+        .{ .name = "nbsp;", .value = "\u{00A0}" },
+    };
+
+    fn vector(v: simd.Vec) simd.Vec {
+        return simd.eq(v, '&');
+    }
+
+    fn scalar(b: u8) bool {
+        return b == '&';
+    }
+
+    fn step(str: []const u8, pos: usize, buf: *[engine.step_buf_len]u8) !Step {
+        const rest = str[pos + 1 ..];
+
+        if (rest.len > 0 and rest[0] == '#') {
+            if (numericReference(rest, buf)) |s| return .{ .bytes = s.bytes, .consumed = s.consumed + 1 };
+        } else {
+            for (named) |entity| {
+                if (std.mem.startsWith(u8, rest, entity.name)) {
+                    return .{ .bytes = entity.value, .consumed = entity.name.len + 1 };
+                }
+            }
+        }
+
+        // Unknown or malformed reference: keep the ampersand as-is
+        return .{ .bytes = str[pos .. pos + 1], .consumed = 1 };
+    }
+
+    /// Parses "#123;" or "#x1F600;" (rest starts at '#')
+    fn numericReference(rest: []const u8, buf: *[engine.step_buf_len]u8) ?Step {
+        var i: usize = 1;
+        const base: u8 = if (i < rest.len and (rest[i] == 'x' or rest[i] == 'X')) blk: {
+            i += 1;
+            break :blk 16;
+        } else 10;
+
+        const digits_start = i;
+        var value: u32 = 0;
+        while (i < rest.len and i - digits_start < 8) : (i += 1) {
+            const d = hexValue(rest[i]) orelse break;
+            if (d >= base) break;
+            value = value * base + d;
+        }
+        if (i == digits_start or i >= rest.len or rest[i] != ';') return null;
+
+        // Invalid code points decode to U+FFFD (HTML spec)
+        const cp: u21 = if (value == 0 or value > 0x10FFFF or (value >= 0xD800 and value <= 0xDFFF))
+            0xFFFD
+        else
+            @intCast(value);
+
+        const len = std.unicode.utf8Encode(cp, buf) catch unreachable;
+        return .{ .bytes = buf[0..len], .consumed = i + 1 };
+    }
+};
+
+/// Escapes the HTML special characters & < > " '
+///
+/// Returns the input as a borrowed ZString when nothing needs escaping,
+/// otherwise an owned ZString. Always call deinit() on the result.
+///
+/// Examples:
+///   escapeHtml("a < b & c") -> "a &lt; b &amp; c"
+///   escapeHtml("it's") -> "it&#39;s"
+pub fn escapeHtml(allocator: Allocator, str: []const u8) !ZString {
+    return apply(HtmlEscape, allocator, str);
+}
+
+/// Decodes HTML character references
+///
+/// Supports &amp; &lt; &gt; &quot; &apos; &nbsp; and numeric references
+/// (&#39; &#x1F600;). Unknown or unterminated references are left as-is.
+///
+/// Returns the input as a borrowed ZString when it contains no '&',
+/// otherwise an owned ZString. Always call deinit() on the result.
+///
+/// Examples:
+///   unescapeHtml("a &lt; b") -> "a < b"
+///   unescapeHtml("&#x1F600;") -> "😀"
+pub fn unescapeHtml(allocator: Allocator, str: []const u8) !ZString {
+    return apply(HtmlUnescape, allocator, str);
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "escapeJson - quotes, backslashes and control characters" {
+    const allocator = std.testing.allocator;
+
+    var result = try escapeJson(allocator, "say \"hi\"\\\n\t\x01");
+    defer result.deinit();
+    try std.testing.expectEqualStrings("say \\\"hi\\\"\\\\\\n\\t\\u0001", result.data);
+    try std.testing.expect(result.isOwned());
+}
+
+test "escapeJson - unchanged input is borrowed" {
+    const allocator = std.testing.allocator;
+
+    const input = "a clean string that is longer than one vector, with café and 😀";
+    var result = try escapeJson(allocator, input);
+    defer result.deinit();
+    try std.testing.expect(!result.isOwned());
+    try std.testing.expect(result.data.ptr == @as([]const u8, input).ptr);
+}
+
+test "escapeJson - lone surrogate and Hangul" {
+    const allocator = std.testing.allocator;
+
+    // U+D800 as WTF-8, followed by U+D55C (한, also starts with 0xED)
+    var result = try escapeJson(allocator, "\xED\xA0\x80\u{D55C}");
+    defer result.deinit();
+    try std.testing.expectEqualStrings("\\ud800\u{D55C}", result.data);
+}
+
+test "quoteJson - JSON.stringify" {
+    const allocator = std.testing.allocator;
+
+    const result1 = try quoteJson(allocator, "hello");
+    defer allocator.free(result1);
+    try std.testing.expectEqualStrings("\"hello\"", result1);
+
+    const result2 = try quoteJson(allocator, "tab\there");
+    defer allocator.free(result2);
+    try std.testing.expectEqualStrings("\"tab\\there\"", result2);
+
+    const result3 = try quoteJson(allocator, "");
+    defer allocator.free(result3);
+    try std.testing.expectEqualStrings("\"\"", result3);
+}
+
+test "unescapeJson - escapes and surrogate pairs" {
+    const allocator = std.testing.allocator;
+
+    var result = try unescapeJson(allocator, "a\\nb\\u00e9\\ud83d\\ude00\\/");
+    defer result.deinit();
+    try std.testing.expectEqualStrings("a\nbé😀/", result.data);
+
+    try std.testing.expectError(error.InvalidEscape, unescapeJson(allocator, "bad\\x"));
+    try std.testing.expectError(error.InvalidEscape, unescapeJson(allocator, "\\u12"));
+    try std.testing.expectError(error.InvalidEscape, unescapeJson(allocator, "trailing\\"));
+}
+
+test "escapeJson/unescapeJson - round trip" {
+    const allocator = std.testing.allocator;
+
+    const input = "line1\r\nline2\t\"quoted\" \\ back 😀";
+    var escaped = try escapeJson(allocator, input);
+    defer escaped.deinit();
+    var unescaped = try unescapeJson(allocator, escaped.data);
+    defer unescaped.deinit();
+    try std.testing.expectEqualStrings(input, unescaped.data);
+}
+
+test "escapeHtml - special characters" {
+    const allocator = std.testing.allocator;
+
+    var result = try escapeHtml(allocator, "<a href=\"x\">it's & more</a>");
+    defer result.deinit();
+    try std.testing.expectEqualStrings("&lt;a href=&quot;x&quot;&gt;it&#39;s &amp; more&lt;/a&gt;", result.data);
+
+    var clean = try escapeHtml(allocator, "nothing to do");
+    defer clean.deinit();
+    try std.testing.expect(!clean.isOwned());
+}
+
+test "unescapeHtml - named and numeric references" {
+    const allocator = std.testing.allocator;
+
+    var result = try unescapeHtml(allocator, "a &lt; b &amp;&amp; c&#39;s &#x1F600; &nbsp;");
+    defer result.deinit();
+    try std.testing.expectEqualStrings("a < b && c's 😀 \u{00A0}", result.data);
+
+    // Unknown and unterminated references are kept
+    var kept = try unescapeHtml(allocator, "AT&T &bogus; &#12");
+    defer kept.deinit();
+    try std.testing.expectEqualStrings("AT&T &bogus; &#12", kept.data);
+
+    // Invalid code points become U+FFFD
+    var invalid = try unescapeHtml(allocator, "&#0;&#xD800;");
+    defer invalid.deinit();
+    try std.testing.expectEqualStrings("\u{FFFD}\u{FFFD}", invalid.data);
+}
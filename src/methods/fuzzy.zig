@@ -0,0 +1,477 @@
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const simd = @import("../core/simd.zig");
+
+/// Edit distance options
+pub const Options = struct {
+    /// Count swapping two adjacent characters as one edit (optimal string
+    /// alignment / restricted Damerau-Levenshtein distance)
+    transpositions: bool = false,
+};
+
+/// An approximate occurrence found by indexOfApprox()
+/// `index` and `length` are in UTF-16 code units.
+pub const Match = struct {
+    index: usize,
+    length: usize,
+    distance: usize,
+};
+
+/// Edit distance between `a` and `b`, counted in code points
+///
+/// Uses Myers' bit-parallel algorithm (Hyyrö's variant when transpositions
+/// are enabled), processing 64 pattern characters per machine word. Pure
+/// ASCII inputs are compared byte-wise without decoding.
+pub fn distance(allocator: Allocator, a: []const u8, b: []const u8, options: Options) !usize {
+    return (try distanceWithin(allocator, a, b, null, options)).?;
+}
+
+/// Edit distance between `a` and `b`, or null as soon as it is known to
+/// exceed `max`
+pub fn distanceWithin(allocator: Allocator, a: []const u8, b: []const u8, max: ?usize, options: Options) !?usize {
+    if (simd.isAscii(a) and simd.isAscii(b)) return distanceOf(u8, allocator, a, b, max, options);
+
+    const ca = try decode(allocator, a);
+    defer allocator.free(ca);
+    const cb = try decode(allocator, b);
+    defer allocator.free(cb);
+    return distanceOf(u21, allocator, ca, cb, max, options);
+}
+
+/// Approximate String.prototype.indexOf: the first occurrence of `search`
+/// in `str` with at most `max_errors` edits
+///
+/// The occurrence that ends first is reported; if extending it lowers the
+/// distance, the extension is taken. Among starts for that end, the one
+/// with the lowest distance (then the earliest) is chosen.
+pub fn indexOfApprox(allocator: Allocator, str: []const u8, search: []const u8, max_errors: usize, options: Options) !?Match {
+    if (search.len == 0) return .{ .index = 0, .length = 0, .distance = 0 };
+
+    if (simd.isAscii(str) and simd.isAscii(search)) {
+        const span = try findOf(u8, allocator, str, search, max_errors, options) orelse return null;
+        return .{ .index = span.start, .length = span.end - span.start, .distance = span.distance };
+    }
+
+    const text = try decode(allocator, str);
+    defer allocator.free(text);
+    const pattern = try decode(allocator, search);
+    defer allocator.free(pattern);
+
+    const span = try findOf(u21, allocator, text, pattern, max_errors, options) orelse return null;
+    const start = utf16Length(text[0..span.start]);
+    return .{
+        .index = start,
+        .length = utf16Length(text[span.start..span.end]),
+        .distance = span.distance,
+    };
+}
+
+fn decode(allocator: Allocator, str: []const u8) ![]u21 {
+    const view = std.unicode.Utf8View.init(str) catch return error.InvalidUtf8;
+    var out = std.ArrayList(u21){};
+    errdefer out.deinit(allocator);
+    try out.ensureTotalCapacity(allocator, str.len);
+
+    var it = view.iterator();
+    while (it.nextCodepoint()) |cp| out.appendAssumeCapacity(cp);
+    return out.toOwnedSlice(allocator);
+}
+
+fn utf16Length(chars: []const u21) usize {
+    var n: usize = 0;
+    for (chars) |c| n += if (c > 0xFFFF) 2 else 1;
+    return n;
+}
+
+fn distanceOf(comptime T: type, allocator: Allocator, a: []const T, b: []const T, max: ?usize, options: Options) !?usize {
+    // Both distances are symmetric; the shorter string is the pattern
+    const pattern = if (a.len <= b.len) a else b;
+    const text = if (a.len <= b.len) b else a;
+
+    if (max) |k| {
+        if (text.len - pattern.len > k) return null;
+    }
+    if (pattern.len == 0) return text.len;
+
+    var state = try Columns(T).init(allocator, pattern, .global, options);
+    defer state.deinit();
+
+    for (text, 1..) |c, j| {
+        state.step(c);
+        // Each remaining column lowers the last row by at most one
+        if (max) |k| {
+            if (state.score > k + (text.len - j)) return null;
+        }
+    }
+    return state.score;
+}
+
+const Span = struct {
+    start: usize,
+    end: usize,
+    distance: usize,
+};
+
+fn findOf(comptime T: type, allocator: Allocator, text: []const T, pattern: []const T, k: usize, options: Options) !?Span {
+    var forward = try Columns(T).init(allocator, pattern, .search, options);
+    defer forward.deinit();
+
+    // End of the first occurrence, then follow while the distance improves
+    var end: usize = 0;
+    var best = forward.score;
+    if (best > k) {
+        while (end < text.len and best > k) : (end += 1) {
+            forward.step(text[end]);
+            best = forward.score;
+        }
+        if (best > k) return null;
+    }
+    while (end < text.len and best > 0) {
+        forward.step(text[end]);
+        if (forward.score >= best) break;
+        best = forward.score;
+        end += 1;
+    }
+
+    // Pick the start: align the reversed pattern against text ending at `end`
+    const reversed = try allocator.dupe(T, pattern);
+    defer allocator.free(reversed);
+    std.mem.reverse(T, reversed);
+
+    var backward = try Columns(T).init(allocator, reversed, .global, options);
+    defer backward.deinit();
+
+    var best_len: usize = 0;
+    var best_score = backward.score;
+    const max_len = @min(end, pattern.len + k);
+    for (1..max_len + 1) |x| {
+        backward.step(text[end - x]);
+        if (backward.score <= best_score) {
+            best_score = backward.score;
+            best_len = x;
+        }
+    }
+    return .{ .start = end - best_len, .end = end, .distance = best_score };
+}
+
+const Mode = enum {
+    /// D[0][j] = j: the whole text is aligned (edit distance)
+    global,
+    /// D[0][j] = 0: the pattern may start anywhere in the text (search)
+    search,
+};
+
+/// Last row of the edit-distance matrix, advanced one text character at a
+/// time
+///
+/// Bit-parallel for every case except transpositions on patterns longer
+/// than one machine word, which use a plain three-row DP instead.
+fn Columns(comptime T: type) type {
+    return struct {
+        const Self = @This();
+
+        allocator: Allocator,
+        pattern: []const T,
+        mode: Mode,
+        transpositions: bool,
+        /// D[m][j] for the last processed column
+        score: usize,
+
+        // Bit-parallel state: vertical +1/-1 deltas, one bit per pattern row
+        peq: PeqTable(T),
+        vp: []u64,
+        vn: []u64,
+        last_bit: u64,
+        /// Hyyrö transposition state (single word only)
+        d0_prev: u64 = 0,
+        eq_prev: u64 = 0,
+
+        // DP fallback
+        rows: []usize = &.{},
+        column: usize = 0,
+        prev_char: T = 0,
+
+        fn init(allocator: Allocator, pattern: []const T, mode: Mode, options: Options) !Self {
+            const m = pattern.len;
+            const words = (m + 63) / 64;
+
+            var self = Self{
+                .allocator = allocator,
+                .pattern = pattern,
+                .mode = mode,
+                .transpositions = options.transpositions,
+                .score = m,
+                .peq = undefined,
+                .vp = &.{},
+                .vn = &.{},
+                .last_bit = @as(u64, 1) << @intCast((m -| 1) % 64),
+            };
+
+            if (options.transpositions and words > 1) {
+                self.rows = try allocator.alloc(usize, 3 * (m + 1));
+                for (self.rows[m + 1 .. 2 * (m + 1)], 0..) |*r, i| r.* = i;
+                self.peq = PeqTable(T).empty;
+                return self;
+            }
+
+            self.peq = try PeqTable(T).init(allocator, pattern, words);
+            errdefer self.peq.deinit(allocator);
+            self.vp = try allocator.alloc(u64, words);
+            errdefer allocator.free(self.vp);
+            self.vn = try allocator.alloc(u64, words);
+            @memset(self.vp, ~@as(u64, 0));
+            @memset(self.vn, 0);
+            return self;
+        }
+
+        fn deinit(self: *Self) void {
+            self.peq.deinit(self.allocator);
+            self.allocator.free(self.vp);
+            self.allocator.free(self.vn);
+            self.allocator.free(self.rows);
+            self.* = undefined;
+        }
+
+        fn step(self: *Self, c: T) void {
+            if (self.rows.len > 0) {
+                self.stepDp(c);
+            } else if (self.vp.len == 1) {
+                self.stepWord(self.peq.get(c)[0]);
+            } else {
+                self.stepBlocks(self.peq.get(c));
+            }
+        }
+
+        /// Myers/Hyyrö, pattern of at most 64 characters
+        inline fn stepWord(self: *Self, eq: u64) void {
+            const vp = self.vp[0];
+            const vn = self.vn[0];
+
+            const tr = if (self.transpositions) (((~self.d0_prev) & eq) << 1) & self.eq_prev else 0;
+            const d0 = (((eq & vp) +% vp) ^ vp) | eq | vn | tr;
+            const hp = vn | ~(d0 | vp);
+            const hn = vp & d0;
+
+            if (hp & self.last_bit != 0) {
+                self.score += 1;
+            } else if (hn & self.last_bit != 0) {
+                self.score -= 1;
+            }
+
+            const x = (hp << 1) | @intFromBool(self.mode == .global);
+            self.vp[0] = (hn << 1) | ~(x | d0);
+            self.vn[0] = x & d0;
+            self.d0_prev = d0;
+            self.eq_prev = eq;
+        }
+
+        /// Myers' block algorithm: each 64-row block passes its horizontal
+        /// delta (-1, 0, +1) at the bottom row to the block below
+        fn stepBlocks(self: *Self, eq_words: []const u64) void {
+            const high: u64 = 1 << 63;
+            const last_block = self.vp.len - 1;
+            var hin: i2 = if (self.mode == .global) 1 else 0;
+
+            for (self.vp, self.vn, eq_words, 0..) |*pv, *mv, eq_word, b| {
+                var eq = eq_word;
+                const xv = eq | mv.*;
+                if (hin < 0) eq |= 1;
+                const xh = (((eq & pv.*) +% pv.*) ^ pv.*) | eq;
+                var ph = mv.* | ~(xh | pv.*);
+                var mh = pv.* & xh;
+
+                if (b == last_block) {
+                    if (ph & self.last_bit != 0) {
+                        self.score += 1;
+                    } else if (mh & self.last_bit != 0) {
+                        self.score -= 1;
+                    }
+                }
+
+                var hout: i2 = 0;
+                if (ph & high != 0) hout = 1;
+                if (mh & high != 0) hout = -1;
+
+                ph <<= 1;
+                mh <<= 1;
+                if (hin < 0) {
+                    mh |= 1;
+                } else if (hin > 0) {
+                    ph |= 1;
+                }
+                pv.* = mh | ~(xv | ph);
+                mv.* = ph & xv;
+                hin = hout;
+            }
+        }
+
+        /// Optimal string alignment DP over three rows
+        fn stepDp(self: *Self, c: T) void {
+            const n = self.pattern.len + 1;
+            const prev2 = self.rows[0..n];
+            const prev = self.rows[n .. 2 * n];
+            const cur = self.rows[2 * n .. 3 * n];
+            self.column += 1;
+
+            cur[0] = if (self.mode == .global) self.column else 0;
+            for (1..n) |i| {
+                const p = self.pattern[i - 1];
+                var d = @min(prev[i] + 1, cur[i - 1] + 1, prev[i - 1] + @intFromBool(p != c));
+                if (i > 1 and self.column > 1 and p == self.prev_char and self.pattern[i - 2] == c) {
+                    d = @min(d, prev2[i - 2] + 1);
+                }
+                cur[i] = d;
+            }
+            self.score = cur[n - 1];
+            self.prev_char = c;
+
+            // Rotate: prev2 <- prev <- cur
+            std.mem.rotate(usize, self.rows, n);
+        }
+    };
+}
+
+/// Pattern-match bitmasks: for each character, the pattern rows holding it
+fn PeqTable(comptime T: type) type {
+    return struct {
+        const Self = @This();
+
+        words: usize,
+        /// Row masks per symbol id (`words` u64 each); id 0 is all zero
+        masks: []u64,
+        ids: if (T == u8) void else std.AutoHashMapUnmanaged(u21, u32),
+
+        const empty = Self{ .words = 0, .masks = &.{}, .ids = if (T == u8) {} else .{} };
+
+        fn init(allocator: Allocator, pattern: []const T, words: usize) !Self {
+            var self = empty;
+            self.words = words;
+
+            if (T == u8) {
+                // Bytes index the table directly
+                self.masks = try allocator.alloc(u64, 256 * words);
+                @memset(self.masks, 0);
+                for (pattern, 0..) |c, i| self.masks[@as(usize, c) * words + i / 64] |= @as(u64, 1) << @intCast(i % 64);
+            } else {
+                errdefer self.ids.deinit(allocator);
+                for (pattern) |c| {
+                    const entry = try self.ids.getOrPut(allocator, c);
+                    if (!entry.found_existing) entry.value_ptr.* = self.ids.count();
+                }
+                self.masks = try allocator.alloc(u64, (self.ids.count() + 1) * words);
+                @memset(self.masks, 0);
+                for (pattern, 0..) |c, i| {
+                    const id: usize = self.ids.get(c).?;
+                    self.masks[id * words + i / 64] |= @as(u64, 1) << @intCast(i % 64);
+                }
+            }
+            return self;
+        }
+
+        fn deinit(self: *Self, allocator: Allocator) void {
+            allocator.free(self.masks);
+            if (T != u8) self.ids.deinit(allocator);
+        }
+
+        inline fn get(self: *const Self, c: T) []const u64 {
+            const id: usize = if (T == u8) c else self.ids.get(c) orelse 0;
+            return self.masks[id * self.words ..][0..self.words];
+        }
+    };
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+/// Reference Levenshtein / OSA distance for cross-checking
+fn naiveDistance(allocator: Allocator, a: []const u21, b: []const u21, transpositions: bool) !usize {
+    const w = b.len + 1;
+    const d = try allocator.alloc(usize, (a.len + 1) * w);
+    defer allocator.free(d);
+    for (0..a.len + 1) |i| {
+        for (0..w) |j| {
+            if (i == 0 or j == 0) {
+                d[i * w + j] = i + j;
+                continue;
+            }
+            var v = @min(d[(i - 1) * w + j] + 1, d[i * w + j - 1] + 1, d[(i - 1) * w + j - 1] + @intFromBool(a[i - 1] != b[j - 1]));
+            if (transpositions and i > 1 and j > 1 and a[i - 1] == b[j - 2] and a[i - 2] == b[j - 1]) {
+                v = @min(v, d[(i - 2) * w + j - 2] + 1);
+            }
+            d[i * w + j] = v;
+        }
+    }
+    return d[a.len * w + b.len];
+}
+
+test "distance - Levenshtein basics" {
+    const allocator = std.testing.allocator;
+
+    try std.testing.expectEqual(@as(usize, 3), try distance(allocator, "kitten", "sitting", .{}));
+    try std.testing.expectEqual(@as(usize, 0), try distance(allocator, "same", "same", .{}));
+    try std.testing.expectEqual(@as(usize, 4), try distance(allocator, "", "abcd", .{}));
+    try std.testing.expectEqual(@as(usize, 2), try distance(allocator, "ab", "ba", .{}));
+    try std.testing.expectEqual(@as(usize, 1), try distance(allocator, "ab", "ba", .{ .transpositions = true }));
+    try std.testing.expectEqual(@as(usize, 3), try distance(allocator, "ca", "abc", .{ .transpositions = true }));
+
+    // Code points, not bytes
+    try std.testing.expectEqual(@as(usize, 1), try distance(allocator, "caf\u{e9}", "cafe", .{}));
+    try std.testing.expectEqual(@as(usize, 1), try distance(allocator, "a\u{1F600}b", "ab", .{}));
+    try std.testing.expectError(error.InvalidUtf8, distance(allocator, "\xff", "a", .{}));
+}
+
+test "distance - early exit threshold" {
+    const allocator = std.testing.allocator;
+
+    try std.testing.expectEqual(@as(?usize, 3), try distanceWithin(allocator, "kitten", "sitting", 3, .{}));
+    try std.testing.expectEqual(@as(?usize, null), try distanceWithin(allocator, "kitten", "sitting", 2, .{}));
+    try std.testing.expectEqual(@as(?usize, null), try distanceWithin(allocator, "a", "abcdef", 4, .{}));
+}
+
+test "distance - multi-word patterns match the naive DP" {
+    const allocator = std.testing.allocator;
+
+    var prng = std.Random.DefaultPrng.init(0x5eed);
+    const random = prng.random();
+
+    var a: [200]u21 = undefined;
+    var b: [230]u21 = undefined;
+    var a_utf8: [800]u8 = undefined;
+    var b_utf8: [920]u8 = undefined;
+
+    for (0..20) |round| {
+        const la = random.intRangeAtMost(usize, 1, a.len);
+        const lb = random.intRangeAtMost(usize, 0, b.len);
+        // A small alphabet with one non-ASCII letter forces the decoding path
+        const alphabet = [_]u21{ 'a', 'b', 'c', if (round % 2 == 0) 'd' else 0x3B1 };
+        for (a[0..la]) |*c| c.* = alphabet[random.uintLessThan(usize, alphabet.len)];
+        for (b[0..lb]) |*c| c.* = alphabet[random.uintLessThan(usize, alphabet.len)];
+
+        var na: usize = 0;
+        for (a[0..la]) |c| na += try std.unicode.utf8Encode(c, a_utf8[na..]);
+        var nb: usize = 0;
+        for (b[0..lb]) |c| nb += try std.unicode.utf8Encode(c, b_utf8[nb..]);
+
+        for ([_]bool{ false, true }) |transpositions| {
+            const expected = try naiveDistance(allocator, a[0..la], b[0..lb], transpositions);
+            const actual = try distance(allocator, a_utf8[0..na], b_utf8[0..nb], .{ .transpositions = transpositions });
+            try std.testing.expectEqual(expected, actual);
+        }
+    }
+}
+
+test "indexOfApprox - UTF-16 positions" {
+    const allocator = std.testing.allocator;
+
+    try std.testing.expectEqual(@as(?Match, .{ .index = 6, .length = 5, .distance = 0 }), try indexOfApprox(allocator, "hello world", "world", 1, .{}));
+    try std.testing.expectEqual(@as(?Match, .{ .index = 6, .length = 5, .distance = 2 }), try indexOfApprox(allocator, "hello wrold", "world", 2, .{}));
+    try std.testing.expectEqual(@as(?Match, .{ .index = 6, .length = 5, .distance = 1 }), try indexOfApprox(allocator, "hello wrold", "world", 1, .{ .transpositions = true }));
+    try std.testing.expectEqual(@as(?Match, null), try indexOfApprox(allocator, "hello", "xyz", 1, .{}));
+
+    // Emoji before the match counts as two code units; "caf" already
+    // matches with one edit and "caf\u{e9}" does not improve on it
+    try std.testing.expectEqual(@as(?Match, .{ .index = 3, .length = 3, .distance = 1 }), try indexOfApprox(allocator, "\u{1F600} caf\u{e9}!", "cafe", 1, .{}));
+
+    try std.testing.expectEqual(@as(?Match, .{ .index = 0, .length = 0, .distance = 0 }), try indexOfApprox(allocator, "abc", "", 0, .{}));
+}
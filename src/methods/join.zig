@@ -0,0 +1,206 @@
+const std = @import("std");
+const split = @import("split.zig");
+const Allocator = std.mem.Allocator;
+
+/// Separator used by Array.prototype.join() when none is given
+pub const default_separator = ",";
+
+/// Returns the exact byte length of join(parts, separator)
+pub fn joinLength(parts: []const []const u8, separator: []const u8) usize {
+    if (parts.len == 0) return 0;
+    var total: usize = separator.len * (parts.len - 1);
+    for (parts) |part| {
+        total += part.len;
+    }
+    return total;
+}
+
+/// Writes join(parts, separator) into `buf`
+/// `buf.len` must equal joinLength(parts, separator).
+pub fn joinInto(buf: []u8, parts: []const []const u8, separator: []const u8) void {
+    std.debug.assert(buf.len == joinLength(parts, separator));
+
+    var pos: usize = 0;
+    for (parts, 0..) |part, i| {
+        if (i > 0) {
+            @memcpy(buf[pos .. pos + separator.len], separator);
+            pos += separator.len;
+        }
+        @memcpy(buf[pos .. pos + part.len], part);
+        pos += part.len;
+    }
+}
+
+/// Array.prototype.join(separator)
+/// Spec: https://tc39.es/ecma262/2025/#sec-array.prototype.join
+///
+/// Concatenates `parts` with `separator` between each pair. A null separator
+/// means "," as in JavaScript. The total length is computed up front so the
+/// result is a single exact-size allocation.
+///
+/// Examples:
+///   join(allocator, &.{"a", "b", "c"}, "-") -> "a-b-c"
+///   join(allocator, &.{"a", "b"}, null) -> "a,b"
+///   join(allocator, &.{}, "-") -> ""
+///
+/// The returned string must be freed by the caller.
+pub fn join(allocator: Allocator, parts: []const []const u8, separator: ?[]const u8) ![]u8 {
+    const sep = separator orelse default_separator;
+    const result = try allocator.alloc(u8, joinLength(parts, sep));
+    joinInto(result, parts, sep);
+    return result;
+}
+
+/// Returns the exact byte length of splitMapJoin() for the same arguments
+pub fn splitMapJoinLength(
+    str: []const u8,
+    separator: []const u8,
+    joiner: []const u8,
+    context: anytype,
+    comptime map: fn (@TypeOf(context), []const u8) []const u8,
+) usize {
+    var total: usize = 0;
+    var count: usize = 0;
+    var fields = split.splitIterator(str, separator, null);
+    while (fields.next()) |field| : (count += 1) {
+        total += map(context, field).len;
+    }
+    if (count > 1) total += joiner.len * (count - 1);
+    return total;
+}
+
+/// Writes splitMapJoin() into `buf`
+/// `buf.len` must equal splitMapJoinLength() for the same arguments.
+pub fn splitMapJoinInto(
+    buf: []u8,
+    str: []const u8,
+    separator: []const u8,
+    joiner: []const u8,
+    context: anytype,
+    comptime map: fn (@TypeOf(context), []const u8) []const u8,
+) void {
+    var pos: usize = 0;
+    var first = true;
+    var fields = split.splitIterator(str, separator, null);
+    while (fields.next()) |field| {
+        if (!first) {
+            @memcpy(buf[pos .. pos + joiner.len], joiner);
+            pos += joiner.len;
+        }
+        first = false;
+        const mapped = map(context, field);
+        @memcpy(buf[pos .. pos + mapped.len], mapped);
+        pos += mapped.len;
+    }
+    std.debug.assert(pos == buf.len);
+}
+
+/// Fused split(separator) -> map -> join(joiner)
+///
+/// Equivalent to splitting `str`, passing every field through `map` and
+/// joining the results, but without materializing either intermediate array.
+/// `map` returns a view (typically a sub-slice of the field, or a constant);
+/// it is called twice per field (once to measure, once to copy) and must
+/// return the same result both times. The output is one exact-size
+/// allocation.
+///
+/// Example:
+///   // "a , b,c " -> "a|b|c"
+///   splitMapJoin(allocator, "a , b,c ", ",", "|", {}, trimField)
+///
+/// The returned string must be freed by the caller.
+pub fn splitMapJoin(
+    allocator: Allocator,
+    str: []const u8,
+    separator: []const u8,
+    joiner: []const u8,
+    context: anytype,
+    comptime map: fn (@TypeOf(context), []const u8) []const u8,
+) ![]u8 {
+    const result = try allocator.alloc(u8, splitMapJoinLength(str, separator, joiner, context, map));
+    splitMapJoinInto(result, str, separator, joiner, context, map);
+    return result;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "join - basic functionality" {
+    const allocator = std.testing.allocator;
+
+    const result1 = try join(allocator, &[_][]const u8{ "a", "b", "c" }, "-");
+    defer allocator.free(result1);
+    try std.testing.expectEqualStrings("a-b-c", result1);
+
+    const result2 = try join(allocator, &[_][]const u8{ "a", "b" }, null);
+    defer allocator.free(result2);
+    try std.testing.expectEqualStrings("a,b", result2);
+
+    const result3 = try join(allocator, &[_][]const u8{ "😀", "", "é" }, ", ");
+    defer allocator.free(result3);
+    try std.testing.expectEqualStrings("😀, , é", result3);
+}
+
+test "join - edge cases" {
+    const allocator = std.testing.allocator;
+
+    const empty = try join(allocator, &[_][]const u8{}, "-");
+    defer allocator.free(empty);
+    try std.testing.expectEqualStrings("", empty);
+
+    const single = try join(allocator, &[_][]const u8{"only"}, "-");
+    defer allocator.free(single);
+    try std.testing.expectEqualStrings("only", single);
+
+    try std.testing.expectEqual(@as(usize, 7), joinLength(&[_][]const u8{ "ab", "c", "d" }, "--"));
+}
+
+test "join - inverse of split" {
+    const allocator = std.testing.allocator;
+
+    const input = "one::two::::three";
+    const parts = try split.split(allocator, input, "::", null);
+    defer split.freeSplitResult(allocator, parts);
+
+    var views: [8][]const u8 = undefined;
+    for (parts, 0..) |p, i| views[i] = p;
+
+    const joined = try join(allocator, views[0..parts.len], "::");
+    defer allocator.free(joined);
+    try std.testing.expectEqualStrings(input, joined);
+}
+
+fn trimField(_: void, field: []const u8) []const u8 {
+    return std.mem.trim(u8, field, " ");
+}
+
+test "splitMapJoin - trims fields without intermediate arrays" {
+    const allocator = std.testing.allocator;
+
+    const result = try splitMapJoin(allocator, "a , b,c ", ",", "|", {}, trimField);
+    defer allocator.free(result);
+    try std.testing.expectEqualStrings("a|b|c", result);
+}
+
+test "splitMapJoin - context and code point fields" {
+    const allocator = std.testing.allocator;
+
+    const Prefix = struct {
+        fn first(n: usize, field: []const u8) []const u8 {
+            return field[0..@min(n, field.len)];
+        }
+    };
+
+    const result1 = try splitMapJoin(allocator, "alpha beta gamma", " ", "", @as(usize, 1), Prefix.first);
+    defer allocator.free(result1);
+    try std.testing.expectEqualStrings("abg", result1);
+
+    const result2 = try splitMapJoin(allocator, "h€y", "", ".", {}, trimField);
+    defer allocator.free(result2);
+    try std.testing.expectEqualStrings("h.€.y", result2);
+
+    const result3 = try splitMapJoin(allocator, "", ",", "|", {}, trimField);
+    defer allocator.free(result3);
+    try std.testing.expectEqualStrings("", result3);
+}
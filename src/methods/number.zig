@@ -0,0 +1,530 @@
+const std = @import("std");
+const trimming = @import("trimming.zig");
+const Allocator = std.mem.Allocator;
+
+/// Longest output of formatNumber(): "-1.7976931348623157e+308" plus headroom
+pub const max_decimal_len = 32;
+
+/// Longest output of a radix conversion (radix 2 of the largest/smallest doubles)
+pub const max_radix_len = 2200;
+
+const radix_chars = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+// ============================================================================
+// Number -> String
+// ============================================================================
+
+/// Shortest round-trip decimal digits of a positive finite double
+const Digits = struct {
+    buf: [17]u8,
+    len: usize,
+    /// Decimal exponent of the first digit (value = 0.d1d2... * 10^(exp10 + 1))
+    exp10: i32,
+};
+
+fn shortestDigits(value: f64) Digits {
+    // std's scientific float formatting is Ryu-based and emits the shortest
+    // digit string that round-trips, e.g. "1.2345e2"
+    var tmp: [max_decimal_len]u8 = undefined;
+    const sci = std.fmt.bufPrint(&tmp, "{e}", .{value}) catch unreachable;
+
+    var d = Digits{ .buf = undefined, .len = 0, .exp10 = 0 };
+    var i: usize = 0;
+    while (i < sci.len and sci[i] != 'e') : (i += 1) {
+        if (sci[i] == '.') continue;
+        d.buf[d.len] = sci[i];
+        d.len += 1;
+    }
+    d.exp10 = std.fmt.parseInt(i32, sci[i + 1 ..], 10) catch unreachable;
+
+    while (d.len > 1 and d.buf[d.len - 1] == '0') d.len -= 1;
+    return d;
+}
+
+/// Number::toString(x) with radix 10
+/// Spec: https://tc39.es/ecma262/2025/#sec-numeric-types-number-tostring
+///
+/// Writes the ECMAScript string form of `value` into `buf` and returns the
+/// written slice. Uses the shortest digit string that round-trips, laid out
+/// per the spec: plain notation for exponents in [-7, 21), otherwise
+/// exponential with an explicit sign ("1e+21", "1.5e-7").
+///
+/// Examples:
+///   formatNumber(&buf, 123.456) -> "123.456"
+///   formatNumber(&buf, 0.1 + 0.2) -> "0.30000000000000004"
+///   formatNumber(&buf, 1e21) -> "1e+21"
+///   formatNumber(&buf, -0.0) -> "0"
+pub fn formatNumber(buf: *[max_decimal_len]u8, value: f64) []const u8 {
+    if (std.math.isNan(value)) return copyInto(buf, "NaN");
+    if (value == 0) return copyInto(buf, "0");
+    if (std.math.isInf(value)) return copyInto(buf, if (value < 0) "-Infinity" else "Infinity");
+
+    var pos: usize = 0;
+    if (value < 0) {
+        buf[0] = '-';
+        pos = 1;
+    }
+
+    const d = shortestDigits(@abs(value));
+    const digits = d.buf[0..d.len];
+    const k: i32 = @intCast(d.len);
+    const n: i32 = d.exp10 + 1;
+
+    if (k <= n and n <= 21) {
+        // Integer: digits followed by n - k zeros
+        pos += put(buf, pos, digits);
+        pos += fill(buf, pos, '0', @intCast(n - k));
+    } else if (0 < n and n <= 21) {
+        // Decimal point inside the digits
+        const split: usize = @intCast(n);
+        pos += put(buf, pos, digits[0..split]);
+        pos += put(buf, pos, ".");
+        pos += put(buf, pos, digits[split..]);
+    } else if (-6 < n and n <= 0) {
+        // Leading "0." and -n zeros
+        pos += put(buf, pos, "0.");
+        pos += fill(buf, pos, '0', @intCast(-n));
+        pos += put(buf, pos, digits);
+    } else {
+        // Exponential notation
+        pos += put(buf, pos, digits[0..1]);
+        if (k > 1) {
+            pos += put(buf, pos, ".");
+            pos += put(buf, pos, digits[1..]);
+        }
+        const e = n - 1;
+        pos += put(buf, pos, if (e < 0) "e-" else "e+");
+        var exp_buf: [8]u8 = undefined;
+        const exp_str = std.fmt.bufPrint(&exp_buf, "{d}", .{@abs(e)}) catch unreachable;
+        pos += put(buf, pos, exp_str);
+    }
+
+    return buf[0..pos];
+}
+
+fn copyInto(buf: []u8, s: []const u8) []const u8 {
+    @memcpy(buf[0..s.len], s);
+    return buf[0..s.len];
+}
+
+inline fn put(buf: []u8, pos: usize, s: []const u8) usize {
+    @memcpy(buf[pos .. pos + s.len], s);
+    return s.len;
+}
+
+inline fn fill(buf: []u8, pos: usize, c: u8, count: usize) usize {
+    @memset(buf[pos .. pos + count], c);
+    return count;
+}
+
+/// Number::toString(x, radix) for radix != 10
+///
+/// Writes `value` in the given radix (2..36) into `buf`, including a fraction
+/// when present. Follows the digit generation used by V8 (DoubleToRadixCString):
+/// fraction digits are emitted until they uniquely identify the double, and
+/// the last digit is rounded half-to-even.
+///
+/// Examples:
+///   formatRadix(&buf, 255, 16) -> "ff"
+///   formatRadix(&buf, -3.75, 2) -> "-11.11"
+pub fn formatRadix(buf: *[max_radix_len]u8, value: f64, radix: u8) []const u8 {
+    std.debug.assert(radix >= 2 and radix <= 36);
+    if (std.math.isNan(value)) return copyInto(buf, "NaN");
+    if (std.math.isInf(value)) return copyInto(buf, if (value < 0) "-Infinity" else "Infinity");
+
+    const half = max_radix_len / 2;
+    const r: f64 = @floatFromInt(radix);
+    const magnitude = @abs(value);
+
+    var integer_cursor: usize = half;
+    var fraction_cursor: usize = half;
+    var integer = @floor(magnitude);
+    var fraction = magnitude - integer;
+
+    // Half the distance to the next double; digits below this are noise
+    var delta = 0.5 * (std.math.nextAfter(f64, magnitude, std.math.inf(f64)) - magnitude);
+    delta = @max(std.math.nextAfter(f64, 0.0, 1.0), delta);
+
+    if (fraction >= delta) {
+        buf[fraction_cursor] = '.';
+        fraction_cursor += 1;
+        while (true) {
+            fraction *= r;
+            delta *= r;
+            const digit: usize = @intFromFloat(fraction);
+            buf[fraction_cursor] = radix_chars[digit];
+            fraction_cursor += 1;
+            fraction -= @floatFromInt(digit);
+
+            if (fraction > 0.5 or (fraction == 0.5 and (digit & 1) == 1)) {
+                if (fraction + delta > 1) {
+                    // Round up, propagating the carry leftwards
+                    while (true) {
+                        fraction_cursor -= 1;
+                        if (fraction_cursor == half) {
+                            integer += 1;
+                            break;
+                        }
+                        const c = buf[fraction_cursor];
+                        const d: usize = if (c > '9') c - 'a' + 10 else c - '0';
+                        if (d + 1 < radix) {
+                            buf[fraction_cursor] = radix_chars[d + 1];
+                            fraction_cursor += 1;
+                            break;
+                        }
+                    }
+                    break;
+                }
+            }
+            if (!(fraction >= delta)) break;
+        }
+    }
+
+    // Digits beyond double precision are zeros
+    while (integer / r >= 9007199254740992.0) {
+        integer /= r;
+        integer_cursor -= 1;
+        buf[integer_cursor] = '0';
+    }
+    while (true) {
+        const remainder = @rem(integer, r);
+        const d: usize = @intFromFloat(remainder);
+        integer_cursor -= 1;
+        buf[integer_cursor] = radix_chars[d];
+        integer = (integer - remainder) / r;
+        if (!(integer > 0)) break;
+    }
+
+    if (value < 0) {
+        integer_cursor -= 1;
+        buf[integer_cursor] = '-';
+    }
+
+    return buf[integer_cursor..fraction_cursor];
+}
+
+/// Appends Number.prototype.toString(radix) of `value` to a string builder
+///
+/// Formats directly into the list's spare capacity, so no intermediate
+/// allocation is made. `radix` defaults to 10; values outside 2..36 return
+/// error.InvalidRadix (RangeError in JavaScript).
+///
+/// Example:
+///   var list = std.ArrayList(u8){};
+///   try appendNumber(allocator, &list, 1.5, null);    // "1.5"
+///   try appendNumber(allocator, &list, 255, 16);      // "1.5ff"
+pub fn appendNumber(allocator: Allocator, list: *std.ArrayList(u8), value: f64, radix: ?u8) !void {
+    const base = radix orelse 10;
+    if (base < 2 or base > 36) return error.InvalidRadix;
+
+    if (base == 10) {
+        try list.ensureUnusedCapacity(allocator, max_decimal_len);
+        const written = formatNumber(list.unusedCapacitySlice()[0..max_decimal_len], value);
+        list.items.len += written.len;
+    } else {
+        var buf: [max_radix_len]u8 = undefined;
+        try list.appendSlice(allocator, formatRadix(&buf, value, base));
+    }
+}
+
+/// Number.prototype.toString(radix)
+/// Spec: https://tc39.es/ecma262/2025/#sec-number.prototype.tostring
+///
+/// Examples:
+///   numberToString(allocator, 42, null) -> "42"
+///   numberToString(allocator, 1e-7, null) -> "1e-7"
+///   numberToString(allocator, 255, 2) -> "11111111"
+///
+/// The returned string must be freed by the caller.
+pub fn numberToString(allocator: Allocator, value: f64, radix: ?u8) ![]u8 {
+    var list = std.ArrayList(u8){};
+    errdefer list.deinit(allocator);
+    try appendNumber(allocator, &list, value, radix);
+    return list.toOwnedSlice(allocator);
+}
+
+// ============================================================================
+// String -> Number
+// ============================================================================
+
+/// Returns the byte index of the first non-whitespace character
+fn skipWhitespace(str: []const u8) usize {
+    var i: usize = 0;
+    while (i < str.len) {
+        if (str[i] < 0x80) {
+            if (!trimming.isWhitespace(str[i])) break;
+            i += 1;
+            continue;
+        }
+        const cp_len = std.unicode.utf8ByteSequenceLength(str[i]) catch break;
+        if (i + cp_len > str.len) break;
+        const codepoint = std.unicode.utf8Decode(str[i .. i + cp_len]) catch break;
+        if (!trimming.isWhitespace(codepoint)) break;
+        i += cp_len;
+    }
+    return i;
+}
+
+fn countDigits(str: []const u8, start: usize) usize {
+    var i = start;
+    while (i < str.len and std.ascii.isDigit(str[i])) : (i += 1) {}
+    return i - start;
+}
+
+/// parseFloat(string)
+/// Spec: https://tc39.es/ecma262/2025/#sec-parsefloat-string
+///
+/// Skips leading whitespace and parses the longest prefix that is a
+/// StrDecimalLiteral (sign, digits, fraction, exponent or "Infinity").
+/// Returns NaN when no prefix matches. Conversion is correctly rounded
+/// (std's Eisel-Lemire parser with big-decimal fallback).
+///
+/// Examples:
+///   parseFloat("  3.14abc") -> 3.14
+///   parseFloat("-.5e3x") -> -500
+///   parseFloat("Infinityx") -> inf
+///   parseFloat("abc") -> NaN
+pub fn parseFloat(str: []const u8) f64 {
+    const start = skipWhitespace(str);
+    var i = start;
+
+    var negative = false;
+    if (i < str.len and (str[i] == '+' or str[i] == '-')) {
+        negative = str[i] == '-';
+        i += 1;
+    }
+
+    if (std.mem.startsWith(u8, str[i..], "Infinity")) {
+        return if (negative) -std.math.inf(f64) else std.math.inf(f64);
+    }
+
+    const int_digits = countDigits(str, i);
+    i += int_digits;
+    var frac_digits: usize = 0;
+    if (i < str.len and str[i] == '.') {
+        frac_digits = countDigits(str, i + 1);
+        // "5." and "5.e3" are literals; a lone "." is not
+        if (int_digits + frac_digits > 0) i += 1 + frac_digits;
+    }
+    if (int_digits + frac_digits == 0) return std.math.nan(f64);
+
+    // Exponent only counts when at least one digit follows
+    if (i < str.len and (str[i] == 'e' or str[i] == 'E')) {
+        var j = i + 1;
+        if (j < str.len and (str[j] == '+' or str[j] == '-')) j += 1;
+        const exp_digits = countDigits(str, j);
+        if (exp_digits > 0) i = j + exp_digits;
+    }
+
+    return std.fmt.parseFloat(f64, str[start..i]) catch std.math.nan(f64);
+}
+
+/// parseInt(string, radix)
+/// Spec: https://tc39.es/ecma262/2025/#sec-parseint-string-radix
+///
+/// Skips leading whitespace, accepts an optional sign and parses digits in
+/// `radix` (2..36). A null or 0 radix means 10, or 16 when the digits start
+/// with "0x"/"0X". Returns NaN for an invalid radix or when no digit is found.
+///
+/// Examples:
+///   parseInt("  42px", null) -> 42
+///   parseInt("0x1A", null) -> 26
+///   parseInt("-101", 2) -> -5
+///   parseInt("z", 37) -> NaN
+pub fn parseInt(str: []const u8, radix: ?i32) f64 {
+    var i = skipWhitespace(str);
+
+    var negative = false;
+    if (i < str.len and (str[i] == '+' or str[i] == '-')) {
+        negative = str[i] == '-';
+        i += 1;
+    }
+
+    var base: i32 = radix orelse 0;
+    var strip_prefix = true;
+    if (base != 0) {
+        if (base < 2 or base > 36) return std.math.nan(f64);
+        if (base != 16) strip_prefix = false;
+    } else {
+        base = 10;
+    }
+    if (strip_prefix and i + 1 < str.len and str[i] == '0' and (str[i + 1] == 'x' or str[i + 1] == 'X')) {
+        i += 2;
+        base = 16;
+    }
+
+    const digits_start = i;
+    while (i < str.len) : (i += 1) {
+        _ = std.fmt.charToDigit(str[i], @intCast(base)) catch break;
+    }
+    const digits = str[digits_start..i];
+    if (digits.len == 0) return std.math.nan(f64);
+
+    var result: f64 = 0;
+    if (base == 10) {
+        // Correctly rounded even past 2^53
+        result = std.fmt.parseFloat(f64, digits) catch std.math.nan(f64);
+    } else if (std.math.isPowerOfTwo(base)) {
+        result = parseBinaryDigits(digits, @intCast(base));
+    } else {
+        const r: f64 = @floatFromInt(base);
+        for (digits) |c| {
+            const d = std.fmt.charToDigit(c, @intCast(base)) catch unreachable;
+            result = result * r + @as(f64, @floatFromInt(d));
+        }
+    }
+
+    return if (negative) -result else result;
+}
+
+/// Digits in radix 2, 4, 8, 16 or 32, correctly rounded as the spec requires
+///
+/// Keeps the leading 64 significant bits plus a sticky bit for the rest,
+/// then rounds to 53 bits once (half to even).
+fn parseBinaryDigits(digits: []const u8, base: u8) f64 {
+    const bits_per_digit = std.math.log2_int(u8, base);
+    var mantissa: u64 = 0;
+    var dropped: u64 = 0;
+    var sticky = false;
+
+    for (digits) |c| {
+        const d = std.fmt.charToDigit(c, base) catch unreachable;
+        var bit: u3 = bits_per_digit;
+        while (bit > 0) {
+            bit -= 1;
+            const b: u1 = @truncate(d >> bit);
+            if (mantissa >> 63 == 0) {
+                mantissa = (mantissa << 1) | b;
+            } else {
+                dropped += 1;
+                sticky = sticky or b != 0;
+            }
+        }
+    }
+
+    const significant = 64 - @as(u32, @clz(mantissa));
+    if (significant <= 53) return @floatFromInt(mantissa);
+
+    const shift: u6 = @intCast(significant - 53);
+    const rest = mantissa & ((@as(u64, 1) << shift) - 1);
+    const half = @as(u64, 1) << (shift - 1);
+    var rounded = mantissa >> shift;
+    if (rest > half or (rest == half and (sticky or rounded & 1 == 1))) rounded += 1;
+
+    // Past 2^1024 the result is Infinity regardless of the exact exponent
+    const exponent: i32 = @intCast(@min(dropped + shift, 2048));
+    return std.math.ldexp(@as(f64, @floatFromInt(rounded)), exponent);
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+fn expectFormat(expected: []const u8, value: f64) !void {
+    var buf: [max_decimal_len]u8 = undefined;
+    try std.testing.expectEqualStrings(expected, formatNumber(&buf, value));
+}
+
+test "formatNumber - integers and specials" {
+    try expectFormat("0", 0.0);
+    try expectFormat("0", -0.0);
+    try expectFormat("1", 1.0);
+    try expectFormat("-42", -42.0);
+    try expectFormat("NaN", std.math.nan(f64));
+    try expectFormat("Infinity", std.math.inf(f64));
+    try expectFormat("-Infinity", -std.math.inf(f64));
+    try expectFormat("100000000000000000000", 1e20);
+    try expectFormat("9007199254740992", 9007199254740992.0);
+}
+
+test "formatNumber - fractions use shortest round-trip digits" {
+    try expectFormat("0.1", 0.1);
+    try expectFormat("123.456", 123.456);
+    try expectFormat("0.30000000000000004", 0.1 + 0.2);
+    try expectFormat("0.000001", 0.000001);
+}
+
+test "formatNumber - exponential notation" {
+    try expectFormat("1e+21", 1e21);
+    try expectFormat("1.5e-7", 1.5e-7);
+    try expectFormat("1.23e-18", 123e-20);
+    try expectFormat("5e-324", 5e-324);
+    try expectFormat("1.7976931348623157e+308", std.math.floatMax(f64));
+    try expectFormat("-2.5e+25", -2.5e25);
+}
+
+test "formatRadix - integers and fractions" {
+    var buf: [max_radix_len]u8 = undefined;
+    try std.testing.expectEqualStrings("ff", formatRadix(&buf, 255, 16));
+    try std.testing.expectEqualStrings("-11111111", formatRadix(&buf, -255, 2));
+    try std.testing.expectEqualStrings("11.11", formatRadix(&buf, 3.75, 2));
+    try std.testing.expectEqualStrings("0.1", formatRadix(&buf, 0.5, 2));
+    try std.testing.expectEqualStrings("0", formatRadix(&buf, 0, 36));
+    try std.testing.expectEqualStrings("z", formatRadix(&buf, 35, 36));
+}
+
+test "appendNumber - appends into a builder" {
+    const allocator = std.testing.allocator;
+
+    var list = std.ArrayList(u8){};
+    defer list.deinit(allocator);
+
+    try list.appendSlice(allocator, "x=");
+    try appendNumber(allocator, &list, 1.5, null);
+    try list.appendSlice(allocator, ", y=");
+    try appendNumber(allocator, &list, 255, 16);
+    try std.testing.expectEqualStrings("x=1.5, y=ff", list.items);
+
+    try std.testing.expectError(error.InvalidRadix, appendNumber(allocator, &list, 1, 37));
+}
+
+test "numberToString - allocating form" {
+    const allocator = std.testing.allocator;
+
+    const result = try numberToString(allocator, -0.5, null);
+    defer allocator.free(result);
+    try std.testing.expectEqualStrings("-0.5", result);
+}
+
+test "parseFloat - prefixes and specials" {
+    try std.testing.expectEqual(@as(f64, 3.14), parseFloat("  3.14abc"));
+    try std.testing.expectEqual(@as(f64, -500), parseFloat("-.5e3x"));
+    try std.testing.expectEqual(@as(f64, 5), parseFloat("5.e"));
+    try std.testing.expectEqual(@as(f64, 5), parseFloat("5."));
+    try std.testing.expectEqual(@as(f64, 5000), parseFloat("5.e3"));
+    try std.testing.expectEqual(@as(f64, 1e21), parseFloat("1e21"));
+    try std.testing.expectEqual(@as(f64, 0.1), parseFloat("\u{00A0}\n0.1"));
+    try std.testing.expect(std.math.isPositiveInf(parseFloat("Infinityx")));
+    try std.testing.expect(std.math.isNegativeInf(parseFloat("-Infinity")));
+    try std.testing.expect(std.math.isNan(parseFloat("abc")));
+    try std.testing.expect(std.math.isNan(parseFloat(".")));
+    try std.testing.expect(std.math.isNan(parseFloat("")));
+    try std.testing.expect(std.math.signbit(parseFloat("-0")));
+}
+
+test "parseFloat - round trips with formatNumber" {
+    const values = [_]f64{ 0.1, 1.0 / 3.0, 123456789.125, 5e-324, 1.7976931348623157e308, 2.2250738585072014e-308 };
+    for (values) |v| {
+        var buf: [max_decimal_len]u8 = undefined;
+        try std.testing.expectEqual(v, parseFloat(formatNumber(&buf, v)));
+    }
+}
+
+test "parseInt - radix handling" {
+    try std.testing.expectEqual(@as(f64, 42), parseInt("  42px", null));
+    try std.testing.expectEqual(@as(f64, 26), parseInt("0x1A", null));
+    try std.testing.expectEqual(@as(f64, 26), parseInt("0x1A", 16));
+    try std.testing.expectEqual(@as(f64, 0), parseInt("0x1A", 10));
+    try std.testing.expectEqual(@as(f64, -5), parseInt("-101", 2));
+    try std.testing.expectEqual(@as(f64, 35), parseInt("z", 36));
+    try std.testing.expectEqual(@as(f64, 12345678901234567890), parseInt("12345678901234567890", null));
+    try std.testing.expect(std.math.isNan(parseInt("z", 37)));
+
+    // Power-of-two radices round once, not per digit
+    try std.testing.expectEqual(@as(f64, 1152921504606847232), parseInt("1000000000000081", 16));
+    try std.testing.expectEqual(@as(f64, 1152921504606847232), parseInt("0x1000000000000081", null));
+    try std.testing.expectEqual(@as(f64, 9007199254740992), parseInt("100000000000000000000000000000000000000000000000000001", 2));
+    try std.testing.expect(std.math.isPositiveInf(parseInt("f" ** 300, 16)));
+    try std.testing.expect(std.math.isNan(parseInt("0x", null)));
+    try std.testing.expect(std.math.isNan(parseInt("", null)));
+}
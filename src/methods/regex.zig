@@ -176,6 +176,156 @@ pub fn matchAll(allocator: Allocator, str: []const u8, pattern: []const u8) ![]M
     return try matches.toOwnedSlice(allocator);
 }
 
+/// Lazy matchAll(): one search per next() call, results borrowed from
+/// the input
+///
+/// Each search runs on the input after the previous match. Patterns that
+/// look behind the search position (`^`, `\b`, `\B`, lookbehind) would see
+/// that position as the start of input, so for those the first next()
+/// finds every match of the whole input at once, exactly as matchAll().
+pub const MatchIterator = struct {
+    re: zregexp.Regex,
+    allocator: Allocator,
+    str: []const u8,
+    /// Input bytes up to the end of the last match returned
+    pos: usize = 0,
+    /// UTF-16 offset of `pos`
+    pos_utf16: usize = 0,
+    done: bool = false,
+    /// Set when the pattern needs the text before each search (see
+    /// needsContext)
+    whole_input: bool = false,
+    /// Matches found up front when `whole_input` is set
+    found: ?[]Match = null,
+    returned: usize = 0,
+
+    pub const Match = struct {
+        /// The matched text, borrowed from the input
+        text: []const u8,
+        /// UTF-16 index of the match
+        index: usize,
+        /// Capture groups 1-15 (null if not captured), borrowed
+        groups: [15]?[]const u8,
+    };
+
+    pub fn deinit(self: *MatchIterator) void {
+        if (self.found) |found| self.allocator.free(found);
+        self.re.deinit();
+    }
+
+    /// Returns the next match, or null after the last one
+    ///
+    /// A search that fails (out of memory, or the engine's step limit)
+    /// returns error.OutOfMemory or error.RegexMatchFailed and ends the
+    /// iteration, rather than passing for the end of the matches.
+    pub fn next(self: *MatchIterator) error{ OutOfMemory, RegexMatchFailed }!?Match {
+        if (self.done) return null;
+        if (self.whole_input) return self.nextFound();
+
+        const rest = self.str[self.pos..];
+        const result = self.re.find(rest) catch |err| {
+            self.done = true;
+            return searchError(err);
+        };
+        const found = result orelse {
+            self.done = true;
+            return null;
+        };
+        defer found.deinit();
+
+        var groups: [15]?[]const u8 = undefined;
+        for (&groups, 1..) |*group, i| group.* = found.getCapture(i, rest);
+        const text = found.group(rest);
+        const start = self.pos + found.start;
+        self.pos_utf16 += utf16.lengthUtf16(self.str[self.pos..start]);
+        const index = self.pos_utf16;
+
+        // Step over one code point after an empty match so the search moves
+        var end = start + text.len;
+        if (text.len == 0) {
+            if (end >= self.str.len) {
+                self.done = true;
+            } else {
+                end += std.unicode.utf8ByteSequenceLength(self.str[end]) catch 1;
+                end = @min(end, self.str.len);
+            }
+        }
+        self.pos_utf16 += utf16.lengthUtf16(self.str[start..end]);
+        self.pos = end;
+
+        return .{ .text = text, .index = index, .groups = groups };
+    }
+
+    fn nextFound(self: *MatchIterator) error{ OutOfMemory, RegexMatchFailed }!?Match {
+        const found = self.found orelse try self.findAll();
+        if (self.returned == found.len) {
+            self.done = true;
+            return null;
+        }
+        const m = found[self.returned];
+        self.returned += 1;
+        self.pos = @intFromPtr(m.text.ptr) - @intFromPtr(self.str.ptr) + m.text.len;
+        self.pos_utf16 = m.index + utf16.lengthUtf16(m.text);
+        return m;
+    }
+
+    fn findAll(self: *MatchIterator) error{ OutOfMemory, RegexMatchFailed }![]Match {
+        errdefer self.done = true;
+        var results = self.re.findAll(self.str) catch |err| return searchError(err);
+        defer {
+            for (results.items) |m| m.deinit();
+            results.deinit(self.allocator);
+        }
+
+        const found = try self.allocator.alloc(Match, results.items.len);
+        var index: usize = 0;
+        var counted: usize = 0;
+        for (results.items, found) |m, *out| {
+            index += utf16.lengthUtf16(self.str[counted..m.start]);
+            counted = m.start;
+            out.* = .{ .text = m.group(self.str), .index = index, .groups = undefined };
+            for (&out.groups, 1..) |*group, i| group.* = m.getCapture(i, self.str);
+        }
+        self.found = found;
+        return found;
+    }
+};
+
+fn searchError(err: anyerror) error{ OutOfMemory, RegexMatchFailed } {
+    return if (err == error.OutOfMemory) error.OutOfMemory else error.RegexMatchFailed;
+}
+
+/// True if a match of `pattern` can depend on the text before the point
+/// where a search starts: `^`, `\b`, `\B` and lookbehind outside a
+/// character class. Errs on the side of true.
+fn needsContext(pattern: []const u8) bool {
+    var in_class = false;
+    var i: usize = 0;
+    while (i < pattern.len) : (i += 1) {
+        switch (pattern[i]) {
+            '\\' => {
+                i += 1;
+                if (!in_class and i < pattern.len and (pattern[i] == 'b' or pattern[i] == 'B')) return true;
+            },
+            '[' => in_class = true,
+            ']' => in_class = false,
+            '^' => if (!in_class) return true,
+            '(' => if (!in_class and (std.mem.startsWith(u8, pattern[i..], "(?<=") or std.mem.startsWith(u8, pattern[i..], "(?<!"))) return true,
+            else => {},
+        }
+    }
+    return false;
+}
+
+/// Compiles `pattern` for lazy matchAll() over `str`
+///
+/// Returns error.InvalidPattern if the pattern does not compile. Call
+/// deinit() on the iterator.
+pub fn matchIterator(allocator: Allocator, str: []const u8, pattern: []const u8) !MatchIterator {
+    const re = zregexp.Regex.compile(allocator, pattern) catch return error.InvalidPattern;
+    return .{ .re = re, .allocator = allocator, .str = str, .whole_input = needsContext(pattern) };
+}
+
 /// Free the result of matchAll
 pub fn freeMatchAll(allocator: Allocator, matches: []MatchArray) void {
     for (matches) |match_array| {
@@ -355,6 +505,40 @@ test "match: not found" {
     try std.testing.expect(result == null);
 }
 
+test "matchIterator: same matches as matchAll" {
+    const allocator = std.testing.allocator;
+    const all = try matchAll(allocator, "a1 b22 c333", "\\d+");
+    defer freeMatchAll(allocator, all);
+
+    var it = try matchIterator(allocator, "a1 b22 c333", "\\d+");
+    defer it.deinit();
+    for (all) |m| {
+        const lazy = (try it.next()).?;
+        try std.testing.expectEqualStrings(m.match, lazy.text);
+        try std.testing.expectEqual(m.index, lazy.index);
+    }
+    try std.testing.expect((try it.next()) == null);
+}
+
+test "matchIterator: anchors see the whole input" {
+    const allocator = std.testing.allocator;
+    try std.testing.expect(needsContext("^a"));
+    try std.testing.expect(needsContext("\\bfoo"));
+    try std.testing.expect(needsContext("(?<=x)y"));
+    try std.testing.expect(!needsContext("[^a]\\d+"));
+
+    const all = try matchAll(allocator, "foofoo foo", "\\bfoo");
+    defer freeMatchAll(allocator, all);
+
+    var it = try matchIterator(allocator, "foofoo foo", "\\bfoo");
+    defer it.deinit();
+    for (all) |m| {
+        const lazy = (try it.next()).?;
+        try std.testing.expectEqual(m.index, lazy.index);
+    }
+    try std.testing.expect((try it.next()) == null);
+}
+
 test "matchAll: multiple matches" {
     const result = try matchAll(std.testing.allocator, "test test test", "test");
     defer freeMatchAll(std.testing.allocator, result);
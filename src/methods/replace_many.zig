@@ -0,0 +1,432 @@
+const std = @import("std");
+const simd = @import("../core/simd.zig");
+const Allocator = std.mem.Allocator;
+
+/// A literal search/replacement pair for replaceMany()
+pub const Pair = struct {
+    from: []const u8,
+    to: []const u8,
+};
+
+/// Compiled multi-literal replacer
+///
+/// Compiles a list of literal pairs once into a leftmost-longest matcher and
+/// applies it to any number of strings. Each application scans the input once
+/// and writes the result into a single exact-size allocation.
+///
+/// Matching rules:
+/// - At every position the longest matching key wins
+/// - Among keys of equal length, the one listed first wins
+/// - Replaced text is never re-scanned
+/// - Empty keys are ignored
+///
+/// When every key is a single ASCII byte, candidate positions are located with
+/// a vectorized byte-set scan; when every replacement is also a single byte,
+/// the replacer degrades to a plain byte translation table (`tr`).
+///
+/// Example:
+///   var rep = try Replacer.init(allocator, &.{
+///       .{ .from = "&", .to = "&amp;" },
+///       .{ .from = "<", .to = "&lt;" },
+///   });
+///   defer rep.deinit();
+///   const out = try rep.replace(allocator, "a < b & c");
+///   defer allocator.free(out);
+pub const Replacer = struct {
+    allocator: Allocator,
+    /// Owned copy of all key and replacement bytes
+    storage: []u8,
+    /// Pairs grouped by first key byte, longest key first within a group
+    pairs: []Pair,
+    /// pairs[bucket_start[b]..bucket_start[b + 1]] holds the keys starting with byte b
+    bucket_start: [257]u32,
+    /// First bytes of all keys, used to skip to candidate positions
+    first_bytes: simd.ByteSet,
+    /// Byte translation table, set when all keys and replacements are single bytes
+    byte_table: ?ByteMap,
+
+    /// Compiles the pairs into a replacer
+    /// Key and replacement bytes are copied; `pairs` need not outlive the replacer.
+    pub fn init(allocator: Allocator, pairs: []const Pair) !Replacer {
+        var storage_len: usize = 0;
+        var count: usize = 0;
+        for (pairs) |pair| {
+            if (pair.from.len == 0) continue;
+            storage_len += pair.from.len + pair.to.len;
+            count += 1;
+        }
+
+        const storage = try allocator.alloc(u8, storage_len);
+        errdefer allocator.free(storage);
+        const sorted = try allocator.alloc(Pair, count);
+        errdefer allocator.free(sorted);
+
+        // Copy pairs into owned storage
+        var pos: usize = 0;
+        var n: usize = 0;
+        for (pairs) |pair| {
+            if (pair.from.len == 0) continue;
+            const from = storage[pos .. pos + pair.from.len];
+            @memcpy(from, pair.from);
+            pos += pair.from.len;
+            const to = storage[pos .. pos + pair.to.len];
+            @memcpy(to, pair.to);
+            pos += pair.to.len;
+            sorted[n] = .{ .from = from, .to = to };
+            n += 1;
+        }
+
+        // Stable sort keeps declaration order among equal-length keys
+        std.mem.sort(Pair, sorted, {}, pairLessThan);
+
+        var self = Replacer{
+            .allocator = allocator,
+            .storage = storage,
+            .pairs = sorted,
+            .bucket_start = undefined,
+            .first_bytes = .{},
+            .byte_table = null,
+        };
+
+        var all_single_ascii = true;
+        var all_single_out = true;
+        var next: usize = 0;
+        for (0..256) |b| {
+            self.bucket_start[b] = @intCast(next);
+            while (next < sorted.len and sorted[next].from[0] == b) : (next += 1) {
+                self.first_bytes.add(@intCast(b));
+                if (sorted[next].from.len != 1 or b >= 0x80) all_single_ascii = false;
+                if (sorted[next].to.len != 1) all_single_out = false;
+            }
+        }
+        self.bucket_start[256] = @intCast(next);
+
+        if (all_single_ascii and all_single_out) {
+            var table: [256]u8 = undefined;
+            for (&table, 0..) |*entry, b| entry.* = @intCast(b);
+            // First pair in each bucket is the winner for duplicated keys
+            for (0..256) |b| {
+                if (self.bucket_start[b] != self.bucket_start[b + 1]) {
+                    table[b] = sorted[self.bucket_start[b]].to[0];
+                }
+            }
+            self.byte_table = ByteMap.fromTable(table);
+        }
+
+        return self;
+    }
+
+    /// Frees the compiled replacer
+    pub fn deinit(self: *Replacer) void {
+        self.allocator.free(self.pairs);
+        self.allocator.free(self.storage);
+        self.* = undefined;
+    }
+
+    /// Applies all replacements to `str` in a single pass
+    ///
+    /// The returned string must be freed by the caller.
+    pub fn replace(self: *const Replacer, allocator: Allocator, str: []const u8) ![]u8 {
+        if (self.byte_table) |*map| {
+            const result = try allocator.alloc(u8, str.len);
+            map.apply(result, str);
+            return result;
+        }
+
+        const out_len = self.rewrite(str, null);
+        const result = try allocator.alloc(u8, out_len);
+        _ = self.rewrite(str, result);
+        return result;
+    }
+
+    /// Returns the byte length replace() would produce for `str`
+    pub fn resultLength(self: *const Replacer, str: []const u8) usize {
+        if (self.byte_table != null) return str.len;
+        return self.rewrite(str, null);
+    }
+
+    /// Returns the pair matching at `pos`, preferring the longest key
+    fn matchAt(self: *const Replacer, str: []const u8, pos: usize) ?Pair {
+        const b: usize = str[pos];
+        for (self.pairs[self.bucket_start[b]..self.bucket_start[b + 1]]) |pair| {
+            if (std.mem.startsWith(u8, str[pos..], pair.from)) return pair;
+        }
+        return null;
+    }
+
+    /// Walks `str` once, copying clean runs and replacements into `out`
+    /// When `out` is null only the output length is computed.
+    fn rewrite(self: *const Replacer, str: []const u8, out: ?[]u8) usize {
+        var written: usize = 0;
+        var copied_to: usize = 0;
+        var search_from: usize = 0;
+
+        while (self.first_bytes.indexOf(str, search_from)) |pos| {
+            const pair = self.matchAt(str, pos) orelse {
+                search_from = pos + 1;
+                continue;
+            };
+            written += emit(out, written, str[copied_to..pos]);
+            written += emit(out, written, pair.to);
+            copied_to = pos + pair.from.len;
+            search_from = copied_to;
+        }
+        written += emit(out, written, str[copied_to..]);
+
+        return written;
+    }
+};
+
+/// Compiled byte-to-byte translation table
+///
+/// Only ASCII bytes are remapped. The 128 ASCII entries form eight 16-byte
+/// groups, one per high nibble; a vector is translated with one lookup16()
+/// per group that remaps anything, blended in by high nibble. Bytes in
+/// untouched groups, including all non-ASCII bytes, pass through.
+pub const ByteMap = struct {
+    table: [256]u8,
+    /// table16() of each high-nibble group that remaps at least one byte
+    groups: [8]simd.Vec,
+    /// High nibble of each entry in `groups`
+    group_nibbles: [8]u8,
+    group_count: usize,
+
+    const nibble_shift: @Vector(simd.lanes, u3) = @splat(4);
+
+    /// Builds the map from parallel byte lists
+    /// Every byte in `from` must be ASCII; the first entry for a byte wins.
+    pub fn init(from: []const u8, to: []const u8) !ByteMap {
+        if (from.len != to.len) return error.InvalidArgument;
+
+        var table: [256]u8 = undefined;
+        for (&table, 0..) |*entry, b| entry.* = @intCast(b);
+        var mapped = [_]bool{false} ** 128;
+        for (from, to) |f, t| {
+            if (f >= 0x80) return error.InvalidArgument;
+            if (mapped[f]) continue;
+            mapped[f] = true;
+            table[f] = t;
+        }
+        return fromTable(table);
+    }
+
+    /// Wraps a full table whose non-ASCII entries are the identity
+    pub fn fromTable(table: [256]u8) ByteMap {
+        var self = ByteMap{
+            .table = table,
+            .groups = undefined,
+            .group_nibbles = undefined,
+            .group_count = 0,
+        };
+        for (0..8) |g| {
+            const group = table[g * 16 ..][0..16];
+            for (group, g * 16..) |entry, b| {
+                if (entry == b) continue;
+                self.groups[self.group_count] = simd.table16(group.*);
+                self.group_nibbles[self.group_count] = @intCast(g);
+                self.group_count += 1;
+                break;
+            }
+        }
+        return self;
+    }
+
+    /// Translates `src` into `dest`, which must have the same length
+    pub fn apply(self: *const ByteMap, dest: []u8, src: []const u8) void {
+        std.debug.assert(dest.len == src.len);
+        if (self.group_count == 0) {
+            @memcpy(dest, src);
+            return;
+        }
+
+        const groups = self.groups[0..self.group_count];
+        const nibbles = self.group_nibbles[0..self.group_count];
+        var i: usize = 0;
+        while (i + simd.lanes <= src.len) : (i += simd.lanes) {
+            const v = simd.load(src, i);
+            const lo = v & simd.splat(0x0F);
+            const hi = v >> nibble_shift;
+            var out = v;
+            for (groups, nibbles) |group, nibble| {
+                out = @select(u8, hi == simd.splat(nibble), simd.lookup16(group, lo), out);
+            }
+            dest[i..][0..simd.lanes].* = out;
+        }
+        while (i < src.len) : (i += 1) {
+            dest[i] = self.table[src[i]];
+        }
+    }
+};
+
+fn pairLessThan(_: void, a: Pair, b: Pair) bool {
+    if (a.from[0] != b.from[0]) return a.from[0] < b.from[0];
+    return a.from.len > b.from.len;
+}
+
+inline fn emit(out: ?[]u8, at: usize, bytes: []const u8) usize {
+    if (out) |buf| @memcpy(buf[at .. at + bytes.len], bytes);
+    return bytes.len;
+}
+
+/// Replaces every occurrence of each key with its replacement in one pass
+///
+/// Equivalent to compiling a Replacer and applying it once. When the same
+/// pairs are applied to many strings, compile a Replacer instead.
+///
+/// Unlike a chain of replaceAll() calls, replacement text is never re-scanned,
+/// so "&" -> "&amp;" followed by "<" -> "&lt;" behaves as expected.
+///
+/// Examples:
+///   replaceMany("a<b>&c", &.{ .{"<", "&lt;"}, .{">", "&gt;"}, .{"&", "&amp;"} })
+///     -> "a&lt;b&gt;&amp;c"
+///   replaceMany("foobar", &.{ .{"foo", "1"}, .{"foobar", "2"} }) -> "2" (longest wins)
+///
+/// The returned string must be freed by the caller.
+pub fn replaceMany(allocator: Allocator, str: []const u8, pairs: []const Pair) ![]u8 {
+    var replacer = try Replacer.init(allocator, pairs);
+    defer replacer.deinit();
+    return replacer.replace(allocator, str);
+}
+
+/// Byte translation (`tr`)
+///
+/// Replaces every byte from[i] in `str` with to[i]. Both sets must have the
+/// same length and contain only ASCII bytes so the result stays valid UTF-8.
+/// If a byte appears in `from` more than once, its first entry wins.
+///
+/// Examples:
+///   translate("hello", "lo", "01") -> "he001"
+///   translate("a-b_c", "-_", "  ") -> "a b c"
+///
+/// The returned string must be freed by the caller.
+pub fn translate(allocator: Allocator, str: []const u8, from: []const u8, to: []const u8) ![]u8 {
+    if (!simd.isAscii(to)) return error.InvalidArgument;
+    const map = try ByteMap.init(from, to);
+
+    const result = try allocator.alloc(u8, str.len);
+    map.apply(result, str);
+    return result;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "replaceMany - HTML escaping in one pass" {
+    const allocator = std.testing.allocator;
+
+    const result = try replaceMany(allocator, "a<b>&c", &.{
+        .{ .from = "<", .to = "&lt;" },
+        .{ .from = ">", .to = "&gt;" },
+        .{ .from = "&", .to = "&amp;" },
+    });
+    defer allocator.free(result);
+    try std.testing.expectEqualStrings("a&lt;b&gt;&amp;c", result);
+}
+
+test "replaceMany - leftmost longest" {
+    const allocator = std.testing.allocator;
+
+    const result1 = try replaceMany(allocator, "foobar foo", &.{
+        .{ .from = "foo", .to = "1" },
+        .{ .from = "foobar", .to = "2" },
+    });
+    defer allocator.free(result1);
+    try std.testing.expectEqualStrings("2 1", result1);
+
+    // Equal length: first listed pair wins
+    const result2 = try replaceMany(allocator, "ab", &.{
+        .{ .from = "ab", .to = "X" },
+        .{ .from = "ab", .to = "Y" },
+    });
+    defer allocator.free(result2);
+    try std.testing.expectEqualStrings("X", result2);
+}
+
+test "replaceMany - replacements are not re-scanned" {
+    const allocator = std.testing.allocator;
+
+    const result = try replaceMany(allocator, "ab", &.{
+        .{ .from = "a", .to = "b" },
+        .{ .from = "b", .to = "c" },
+    });
+    defer allocator.free(result);
+    try std.testing.expectEqualStrings("bc", result);
+}
+
+test "replaceMany - no match and empty inputs" {
+    const allocator = std.testing.allocator;
+
+    const result1 = try replaceMany(allocator, "hello world", &.{.{ .from = "xyz", .to = "!" }});
+    defer allocator.free(result1);
+    try std.testing.expectEqualStrings("hello world", result1);
+
+    const result2 = try replaceMany(allocator, "", &.{.{ .from = "a", .to = "b" }});
+    defer allocator.free(result2);
+    try std.testing.expectEqualStrings("", result2);
+
+    // Empty keys are ignored
+    const result3 = try replaceMany(allocator, "abc", &.{.{ .from = "", .to = "-" }});
+    defer allocator.free(result3);
+    try std.testing.expectEqualStrings("abc", result3);
+}
+
+test "replaceMany - Unicode keys and deletions" {
+    const allocator = std.testing.allocator;
+
+    const result = try replaceMany(allocator, "café 😀 thé", &.{
+        .{ .from = "é", .to = "e" },
+        .{ .from = "😀", .to = "" },
+    });
+    defer allocator.free(result);
+    try std.testing.expectEqualStrings("cafe  the", result);
+}
+
+test "Replacer - reuse and byte table fast path" {
+    const allocator = std.testing.allocator;
+
+    var rep = try Replacer.init(allocator, &.{
+        .{ .from = "-", .to = "_" },
+        .{ .from = " ", .to = "+" },
+    });
+    defer rep.deinit();
+    try std.testing.expect(rep.byte_table != null);
+
+    const long_input = "a long-enough input string with - and spaces in several places";
+    const result1 = try rep.replace(allocator, long_input);
+    defer allocator.free(result1);
+    try std.testing.expectEqualStrings("a+long_enough+input+string+with+_+and+spaces+in+several+places", result1);
+
+    const result2 = try rep.replace(allocator, "x-y");
+    defer allocator.free(result2);
+    try std.testing.expectEqualStrings("x_y", result2);
+    try std.testing.expectEqual(@as(usize, 3), rep.resultLength("x-y"));
+}
+
+test "translate - tr semantics" {
+    const allocator = std.testing.allocator;
+
+    const result = try translate(allocator, "hello", "lo", "01");
+    defer allocator.free(result);
+    try std.testing.expectEqualStrings("he001", result);
+
+    try std.testing.expectError(error.InvalidArgument, translate(allocator, "x", "ab", "c"));
+    try std.testing.expectError(error.InvalidArgument, translate(allocator, "x", "é", "ab"));
+}
+
+test "translate - long sets and several nibble groups" {
+    const allocator = std.testing.allocator;
+
+    // More than 128 entries: nothing past the first 128 may be dropped
+    const from = "a" ** 129 ++ "b";
+    const to = "x" ** 129 ++ "y";
+    const result1 = try translate(allocator, "abc", from, to);
+    defer allocator.free(result1);
+    try std.testing.expectEqualStrings("xyc", result1);
+
+    // Remaps in three groups, across full vectors and the scalar tail
+    const input = "Hello, World! 0123456789 café hello, world! 9876543210 end";
+    const result2 = try translate(allocator, input, "lo!0", "LO?_");
+    defer allocator.free(result2);
+    try std.testing.expectEqualStrings("HeLLO, WOrLd? _123456789 café heLLO, wOrLd? 987654321_ end", result2);
+}
@@ -1,5 +1,6 @@
 const std = @import("std");
 const utf16 = @import("../core/utf16.zig");
+const simd = @import("../core/simd.zig");
 const Allocator = std.mem.Allocator;
 
 /// String.prototype.split(separator, limit)
@@ -28,97 +29,252 @@ pub fn split(allocator: Allocator, str: []const u8, separator: ?[]const u8, limi
 
     // If separator is null, return array with whole string
     if (separator == null) {
-        const copy = try allocator.dupe(u8, str);
-        try result.append(allocator, copy);
+        try result.ensureUnusedCapacity(allocator, 1);
+        result.appendAssumeCapacity(try allocator.dupe(u8, str));
         return result.toOwnedSlice(allocator);
     }
 
-    const sep = separator.?;
+    var fields = splitIterator(str, separator.?, limit);
+    while (fields.next()) |field| {
+        // Reserve first so a failed append cannot strand the copy
+        try result.ensureUnusedCapacity(allocator, 1);
+        result.appendAssumeCapacity(try allocator.dupe(u8, field));
+    }
+    return result.toOwnedSlice(allocator);
+}
 
-    // If limit is 0, return empty array
-    if (limit != null and limit.? == 0) {
-        return result.toOwnedSlice(allocator);
+/// Helper function to free the result of split()
+pub fn freeSplitResult(allocator: Allocator, result: [][]u8) void {
+    for (result) |item| {
+        allocator.free(item);
     }
+    allocator.free(result);
+}
 
-    // If string is empty
-    if (str.len == 0) {
-        if (sep.len == 0) {
-            // "".split("") -> []
-            return result.toOwnedSlice(allocator);
-        } else {
-            // "".split("x") -> [""]
-            const empty = try allocator.alloc(u8, 0);
-            try result.append(allocator, empty);
-            return result.toOwnedSlice(allocator);
-        }
+/// Lazy split(separator, limit): yields the same fields as split(), as
+/// slices of the input, one per next() call
+///
+/// This is the one field scanner behind split(), splitMapJoin(), the C
+/// split iterator and resumable split jobs. With an empty separator each
+/// code point is a field; a byte that does not start a complete UTF-8
+/// sequence is a field of its own, so no input is dropped.
+pub const SplitIterator = struct {
+    str: []const u8,
+    separator: []const u8,
+    limit: usize = std.math.maxInt(usize),
+    /// Start of the next field
+    pos: usize = 0,
+    count: usize = 0,
+    done: bool = false,
+    /// Bytes before this offset hold no separator start (nextWithin())
+    searched: usize = 0,
+
+    /// Returns the next field, or null after the last one
+    pub fn next(self: *SplitIterator) ?[]const u8 {
+        return self.nextWithin(self.str.len);
     }
 
-    // If separator is empty, split into individual UTF-16 code units
-    if (sep.len == 0) {
-        var i: usize = 0;
-        while (i < str.len) {
-            if (limit) |lim| {
-                if (result.items.len >= lim) break;
+    /// next(), scanning no further than byte `end` of the input
+    ///
+    /// Returns null either once finished (see isDone()) or when the next
+    /// field does not end before `end`; call again with a larger bound.
+    /// Bytes already scanned are not scanned again.
+    pub fn nextWithin(self: *SplitIterator, end: usize) ?[]const u8 {
+        if (self.isDone()) return null;
+        const start = self.pos;
+
+        if (self.separator.len == 0) {
+            if (start >= self.str.len) {
+                self.done = true;
+                return null;
             }
+            if (start >= end) return null;
+            const cp_len = std.unicode.utf8ByteSequenceLength(self.str[start]) catch 1;
+            const field_end = if (start + cp_len <= self.str.len) start + cp_len else start + 1;
+            self.pos = field_end;
+            self.count += 1;
+            return self.str[start..field_end];
+        }
 
-            const cp_len = std.unicode.utf8ByteSequenceLength(str[i]) catch break;
-            if (i + cp_len > str.len) break;
-
-            const char = try allocator.dupe(u8, str[i .. i + cp_len]);
-            try result.append(allocator, char);
-
-            i += cp_len;
+        const from = @max(start, self.searched);
+        if (std.mem.indexOfPos(u8, self.str[0..@min(end, self.str.len)], from, self.separator)) |i| {
+            self.pos = i + self.separator.len;
+            self.searched = self.pos;
+            self.count += 1;
+            return self.str[start..i];
         }
-        return result.toOwnedSlice(allocator);
+        if (end < self.str.len) {
+            self.searched = @max(from, (end + 1) -| self.separator.len);
+            return null;
+        }
+        self.done = true;
+        self.count += 1;
+        return self.str[start..];
     }
 
-    // Regular split with separator
-    var start_pos: usize = 0;
-    var search_pos: usize = 0;
+    /// True once every field has been returned
+    pub fn isDone(self: *const SplitIterator) bool {
+        return self.done or self.count >= self.limit;
+    }
+};
+
+/// Iterates over the fields split() would return, without allocating
+///
+/// Stopping early skips the rest of the scan, so taking the first few
+/// fields of a huge string costs only as much as those fields.
+pub fn splitIterator(str: []const u8, separator: []const u8, limit: ?usize) SplitIterator {
+    return .{ .str = str, .separator = separator, .limit = limit orelse std.math.maxInt(usize) };
+}
+
+// ============================================================================
+// Lines
+// ============================================================================
 
-    while (search_pos <= str.len) {
-        // Check if we've reached the limit
-        if (limit) |lim| {
-            if (result.items.len >= lim) break;
+/// A line yielded by LineIterator
+pub const Line = struct {
+    /// The line without its terminator, borrowed from the input
+    text: []const u8,
+    /// Zero-based line number
+    number: usize,
+    /// Byte offset of the line in the input
+    start: usize,
+    /// UTF-16 offset of the line (0 unless track_utf16 is set)
+    index: usize,
+};
+
+pub const LinesOptions = struct {
+    /// Fill in Line.index; costs a UTF-16 count of every line
+    track_utf16: bool = false,
+};
+
+/// Bytes that can start a line terminator: \n, \r, and 0xE2, the lead
+/// byte of U+2028 / U+2029 (E2 80 A8 / E2 80 A9)
+const TerminatorStart = struct {
+    pub inline fn vector(v: simd.Vec) simd.Vec {
+        return simd.eq(v, '\n') | simd.eq(v, '\r') | simd.eq(v, 0xE2);
+    }
+    pub inline fn scalar(b: u8) bool {
+        return b == '\n' or b == '\r' or b == 0xE2;
+    }
+};
+
+/// Byte range of a line terminator
+const Terminator = struct { start: usize, end: usize };
+
+fn findTerminator(str: []const u8, from: usize) ?Terminator {
+    var i = from;
+    while (simd.indexOfClass(TerminatorStart, str, i)) |p| {
+        switch (str[p]) {
+            '\n' => return .{ .start = p, .end = p + 1 },
+            '\r' => {
+                const crlf = p + 1 < str.len and str[p + 1] == '\n';
+                return .{ .start = p, .end = if (crlf) p + 2 else p + 1 };
+            },
+            else => {
+                // Other E2 sequences (dashes, quotes, ...) are not terminators
+                if (p + 2 < str.len and str[p + 1] == 0x80 and (str[p + 2] == 0xA8 or str[p + 2] == 0xA9)) {
+                    return .{ .start = p, .end = p + 3 };
+                }
+                i = p + 1;
+            },
         }
+    }
+    return null;
+}
 
-        // Look for separator at current position
-        if (search_pos + sep.len <= str.len and
-            std.mem.eql(u8, str[search_pos .. search_pos + sep.len], sep))
-        {
-            // Found separator - add substring before it
-            const substring = try allocator.dupe(u8, str[start_pos..search_pos]);
-            try result.append(allocator, substring);
-
-            // Move past the separator
-            search_pos += sep.len;
-            start_pos = search_pos;
+/// Zero-copy iterator over the lines of a string; see lines()
+pub const LineIterator = struct {
+    str: []const u8,
+    pos: usize = 0,
+    number: usize = 0,
+    index: usize = 0,
+    track_utf16: bool = false,
+    done: bool = false,
+
+    /// Returns the next line, or null after the last one
+    pub fn next(self: *LineIterator) ?Line {
+        if (self.done) return null;
+
+        const start = self.pos;
+        var end = self.str.len;
+        if (findTerminator(self.str, start)) |t| {
+            end = t.start;
+            self.pos = t.end;
         } else {
-            search_pos += 1;
+            self.pos = self.str.len;
+            self.done = true;
         }
-    }
 
-    // Add remaining substring if we haven't hit the limit
-    if (limit == null or result.items.len < limit.?) {
-        const substring = try allocator.dupe(u8, str[start_pos..]);
-        try result.append(allocator, substring);
+        const line = Line{
+            .text = self.str[start..end],
+            .number = self.number,
+            .start = start,
+            .index = self.index,
+        };
+        self.number += 1;
+        if (self.track_utf16) {
+            const consumed = self.str[start..self.pos];
+            self.index += if (simd.isAscii(consumed)) consumed.len else utf16.lengthUtf16(consumed);
+        }
+        return line;
     }
+};
 
-    return result.toOwnedSlice(allocator);
-}
-
-/// Helper function to free the result of split()
-pub fn freeSplitResult(allocator: Allocator, result: [][]u8) void {
-    for (result) |item| {
-        allocator.free(item);
-    }
-    allocator.free(result);
+/// Iterates over the lines of `str` without allocating
+///
+/// Lines end at the ECMAScript line terminators: \n, \r, \r\n (one
+/// terminator), U+2028 and U+2029. Terminators are found with a vector
+/// scan. Like str.split(/\r\n|[\n\r\u2028\u2029]/), a trailing
+/// terminator yields a final empty line and "" yields one empty line.
+///
+/// Example:
+///   var it = lines("a\r\nb\u{2028}c", .{});
+///   it.next().?.text -> "a", then "b", then "c"
+pub fn lines(str: []const u8, options: LinesOptions) LineIterator {
+    return .{ .str = str, .track_utf16 = options.track_utf16 };
 }
 
 // ============================================================================
 // Tests
 // ============================================================================
 
+test "splitIterator - matches split()" {
+    const allocator = std.testing.allocator;
+    const cases = [_]struct { str: []const u8, sep: []const u8, limit: ?usize }{
+        .{ .str = "a,b,,c,", .sep = ",", .limit = null },
+        .{ .str = "a::b::c", .sep = "::", .limit = 2 },
+        .{ .str = "", .sep = "x", .limit = null },
+        .{ .str = "", .sep = "", .limit = null },
+        .{ .str = "h\u{e9}\u{1F600}", .sep = "", .limit = null },
+        .{ .str = "abc", .sep = ",", .limit = 0 },
+    };
+    for (cases) |c| {
+        const expected = try split(allocator, c.str, c.sep, c.limit);
+        defer freeSplitResult(allocator, expected);
+
+        var it = splitIterator(c.str, c.sep, c.limit);
+        for (expected) |field| try std.testing.expectEqualStrings(field, it.next().?);
+        try std.testing.expect(it.next() == null);
+    }
+}
+
+test "splitIterator - bounded scans and invalid UTF-8" {
+    // A separator straddling the bound is found on the next call
+    var it = splitIterator("ab::cd", "::", null);
+    try std.testing.expect(it.nextWithin(3) == null);
+    try std.testing.expect(!it.isDone());
+    try std.testing.expectEqualStrings("ab", it.nextWithin(4).?);
+    try std.testing.expect(it.nextWithin(5) == null);
+    try std.testing.expectEqualStrings("cd", it.nextWithin(6).?);
+    try std.testing.expect(it.isDone());
+
+    // Stray bytes are fields of their own rather than ending the scan
+    const expected = [_][]const u8{ "a", "\xff", "b", "\xe2" };
+    var bytes = splitIterator("a\xffb\xe2", "", null);
+    for (expected) |want| try std.testing.expectEqualStrings(want, bytes.next().?);
+    try std.testing.expect(bytes.next() == null);
+}
+
 test "split - basic functionality" {
     const allocator = std.testing.allocator;
 
@@ -285,3 +441,53 @@ test "split - Emoji with empty separator" {
     try std.testing.expectEqualStrings("😀", result[1]);
     try std.testing.expectEqualStrings("b", result[2]);
 }
+
+test "lines - terminators" {
+    var it = lines("a\nb\r\nc\rd\u{2028}e\u{2029}f", .{});
+    const expected = [_][]const u8{ "a", "b", "c", "d", "e", "f" };
+    for (expected, 0..) |want, n| {
+        const line = it.next().?;
+        try std.testing.expectEqualStrings(want, line.text);
+        try std.testing.expectEqual(n, line.number);
+    }
+    try std.testing.expect(it.next() == null);
+}
+
+test "lines - empty lines and trailing terminator" {
+    var it = lines("\n\nx\n", .{});
+    try std.testing.expectEqualStrings("", it.next().?.text);
+    try std.testing.expectEqualStrings("", it.next().?.text);
+    try std.testing.expectEqualStrings("x", it.next().?.text);
+    try std.testing.expectEqualStrings("", it.next().?.text);
+    try std.testing.expect(it.next() == null);
+
+    var empty = lines("", .{});
+    try std.testing.expectEqualStrings("", empty.next().?.text);
+    try std.testing.expect(empty.next() == null);
+}
+
+test "lines - other E2 sequences and long lines" {
+    // em dash (E2 80 94) and curly quotes share the lead byte
+    var it = lines("a\u{2014}b \u{201C}q\u{201D}\nnext", .{});
+    try std.testing.expectEqualStrings("a\u{2014}b \u{201C}q\u{201D}", it.next().?.text);
+    try std.testing.expectEqualStrings("next", it.next().?.text);
+
+    const long = "x" ** 100 ++ "\r\n" ++ "y" ** 70;
+    var it2 = lines(long, .{});
+    try std.testing.expectEqual(@as(usize, 100), it2.next().?.text.len);
+    const last = it2.next().?;
+    try std.testing.expectEqual(@as(usize, 102), last.start);
+    try std.testing.expectEqual(@as(usize, 70), last.text.len);
+    try std.testing.expect(it2.next() == null);
+}
+
+test "lines - UTF-16 tracking" {
+    var it = lines("😀a\r\ncafé\u{2028}z", .{ .track_utf16 = true });
+    try std.testing.expectEqual(@as(usize, 0), it.next().?.index);
+    // "😀a" is 3 units, "\r\n" 2
+    try std.testing.expectEqual(@as(usize, 5), it.next().?.index);
+    // "café" 4, U+2028 1
+    const last = it.next().?;
+    try std.testing.expectEqual(@as(usize, 10), last.index);
+    try std.testing.expectEqual(@as(usize, 2), last.number);
+}
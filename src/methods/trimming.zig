@@ -13,7 +13,7 @@ const Allocator = std.mem.Allocator;
 /// - U+FEFF (BOM - Zero Width No-Break Space)
 /// - Line terminators: U+000A (LF), U+000D (CR), U+2028 (LS), U+2029 (PS)
 /// - Unicode category Zs (Space Separator)
-fn isWhitespace(codepoint: u21) bool {
+pub fn isWhitespace(codepoint: u21) bool {
     return switch (codepoint) {
         // White space characters
         0x0009, // TAB
@@ -62,8 +62,13 @@ fn isWhitespace(codepoint: u21) bool {
 ///   trim("\t\n  abc  \r\n") -> "abc"
 ///   trim("   ") -> ""
 pub fn trim(allocator: Allocator, str: []const u8) ![]u8 {
+    return allocator.dupe(u8, trimmedSlice(str));
+}
+
+/// Returns the sub-slice of `str` that trim() would copy, without allocating
+pub fn trimmedSlice(str: []const u8) []const u8 {
     if (str.len == 0) {
-        return allocator.alloc(u8, 0);
+        return str[0..0];
     }
 
     // Find first non-whitespace character
@@ -92,7 +97,7 @@ pub fn trim(allocator: Allocator, str: []const u8) ![]u8 {
 
     // If entire string is whitespace
     if (i >= str.len) {
-        return allocator.alloc(u8, 0);
+        return str[0..0];
     }
 
     // Find last non-whitespace character (scan backwards)
@@ -119,8 +124,8 @@ pub fn trim(allocator: Allocator, str: []const u8) ![]u8 {
         i = char_start;
     }
 
-    // Return the trimmed string
-    return allocator.dupe(u8, str[start_byte..end_byte]);
+    // Return the trimmed range
+    return str[start_byte..end_byte];
 }
 
 /// String.prototype.trimStart() / trimLeft()
@@ -0,0 +1,266 @@
+const std = @import("std");
+const simd = @import("../core/simd.zig");
+const engine = @import("../core/rewrite.zig");
+const ZString = @import("../core/string.zig").ZString;
+const Allocator = std.mem.Allocator;
+const Step = engine.Step;
+
+/// Errors reported by the URI functions (the JavaScript URIError cases)
+pub const UriError = error{
+    /// Input is not valid UTF-8
+    InvalidUtf8,
+    /// Input contains a lone surrogate (WTF-8), which cannot be encoded
+    InvalidCodePoint,
+    /// A percent escape is truncated, not hex, or decodes to invalid UTF-8
+    MalformedUri,
+};
+
+// Marks kept unescaped by encodeURIComponent (besides ASCII letters and digits)
+// Spec: https://tc39.es/ecma262/2025/#sec-encodeuricomponent-encodeduricomponent
+const unreserved_marks = "-_.!~*'()";
+
+// Additionally kept by encodeURI, and never decoded by decodeURI
+// Spec: https://tc39.es/ecma262/2025/#sec-encodeuri-uri
+const reserved = ";/?:@&=+$,#";
+
+const upper_hex = "0123456789ABCDEF";
+
+fn isKept(comptime keep: []const u8, b: u8) bool {
+    const table = comptime blk: {
+        var t = [_]bool{false} ** 256;
+        for ('a'..'z' + 1) |c| t[c] = true;
+        for ('A'..'Z' + 1) |c| t[c] = true;
+        for ('0'..'9' + 1) |c| t[c] = true;
+        for (keep) |c| t[c] = true;
+        break :blk t;
+    };
+    return table[b];
+}
+
+fn hexValue(c: u8) ?u8 {
+    return switch (c) {
+        '0'...'9' => c - '0',
+        'a'...'f' => c - 'a' + 10,
+        'A'...'F' => c - 'A' + 10,
+        else => null,
+    };
+}
+
+/// Encoder codec: bytes outside `keep` (and outside [A-Za-z0-9]) are escaped
+fn Encoder(comptime keep: []const u8) type {
+    return struct {
+        fn vector(v: simd.Vec) simd.Vec {
+            var kept = simd.inRange(v, 'a', 'z') | simd.inRange(v, 'A', 'Z') | simd.inRange(v, '0', '9');
+            inline for (keep) |c| kept |= simd.eq(v, c);
+            return ~kept;
+        }
+
+        fn scalar(b: u8) bool {
+            return !isKept(keep, b);
+        }
+
+        fn step(str: []const u8, pos: usize, buf: *[engine.step_buf_len]u8) UriError!Step {
+            const len: usize = if (str[pos] < 0x80) 1 else blk: {
+                const n = std.unicode.utf8ByteSequenceLength(str[pos]) catch return error.InvalidUtf8;
+                if (pos + n > str.len) return error.InvalidUtf8;
+                _ = std.unicode.utf8Decode(str[pos .. pos + n]) catch |err| {
+                    return if (err == error.Utf8EncodesSurrogateHalf) error.InvalidCodePoint else error.InvalidUtf8;
+                };
+                break :blk n;
+            };
+
+            for (str[pos .. pos + len], 0..) |b, k| {
+                buf[k * 3] = '%';
+                buf[k * 3 + 1] = upper_hex[b >> 4];
+                buf[k * 3 + 2] = upper_hex[b & 0xF];
+            }
+            return .{ .bytes = buf[0 .. len * 3], .consumed = len };
+        }
+    };
+}
+
+/// Decoder codec: escapes that decode to a byte in `preserve` are kept as-is
+fn Decoder(comptime preserve: []const u8) type {
+    return struct {
+        fn vector(v: simd.Vec) simd.Vec {
+            return simd.eq(v, '%');
+        }
+
+        fn scalar(b: u8) bool {
+            return b == '%';
+        }
+
+        fn step(str: []const u8, pos: usize, buf: *[engine.step_buf_len]u8) UriError!Step {
+            const lead = try escapedByte(str, pos);
+
+            if (lead < 0x80) {
+                if (std.mem.indexOfScalar(u8, preserve, lead) != null) {
+                    return .{ .bytes = str[pos .. pos + 3], .consumed = 3 };
+                }
+                buf[0] = lead;
+                return .{ .bytes = buf[0..1], .consumed = 3 };
+            }
+
+            const n: usize = std.unicode.utf8ByteSequenceLength(lead) catch return error.MalformedUri;
+            buf[0] = lead;
+            for (1..n) |k| {
+                buf[k] = try escapedByte(str, pos + k * 3);
+            }
+
+            // Rejects bad continuations, overlong forms and surrogates
+            _ = std.unicode.utf8Decode(buf[0..n]) catch return error.MalformedUri;
+            return .{ .bytes = buf[0..n], .consumed = n * 3 };
+        }
+
+        fn escapedByte(str: []const u8, pos: usize) UriError!u8 {
+            if (pos + 3 > str.len or str[pos] != '%') return error.MalformedUri;
+            const hi = hexValue(str[pos + 1]) orelse return error.MalformedUri;
+            const lo = hexValue(str[pos + 2]) orelse return error.MalformedUri;
+            return (hi << 4) | lo;
+        }
+    };
+}
+
+/// encodeURIComponent(uriComponent)
+/// Spec: https://tc39.es/ecma262/2025/#sec-encodeuricomponent-encodeduricomponent
+///
+/// Percent-encodes every byte except ASCII letters, digits and - _ . ! ~ * ' ( ).
+/// Returns error.InvalidCodePoint for lone surrogates (URIError in JavaScript)
+/// and error.InvalidUtf8 for malformed input.
+///
+/// Returns the input as a borrowed ZString when nothing needs encoding,
+/// otherwise an owned ZString. Always call deinit() on the result.
+///
+/// Examples:
+///   encodeURIComponent("a b&c") -> "a%20b%26c"
+///   encodeURIComponent("café") -> "caf%C3%A9"
+pub fn encodeURIComponent(allocator: Allocator, str: []const u8) !ZString {
+    return engine.apply(Encoder(unreserved_marks), allocator, str);
+}
+
+/// encodeURI(uri)
+/// Spec: https://tc39.es/ecma262/2025/#sec-encodeuri-uri
+///
+/// Like encodeURIComponent() but also keeps the URI reserved characters
+/// ; / ? : @ & = + $ , and #.
+///
+/// Examples:
+///   encodeURI("http://x.y/a b?q=1&r=é") -> "http://x.y/a%20b?q=1&r=%C3%A9"
+pub fn encodeURI(allocator: Allocator, str: []const u8) !ZString {
+    return engine.apply(Encoder(unreserved_marks ++ reserved), allocator, str);
+}
+
+/// decodeURIComponent(encodedURIComponent)
+/// Spec: https://tc39.es/ecma262/2025/#sec-decodeuricomponent-encodeduricomponent
+///
+/// Decodes every percent escape. Multi-byte escapes must form valid UTF-8;
+/// otherwise error.MalformedUri is returned (URIError in JavaScript).
+///
+/// Returns the input as a borrowed ZString when it contains no '%',
+/// otherwise an owned ZString. Always call deinit() on the result.
+///
+/// Examples:
+///   decodeURIComponent("a%20b%26c") -> "a b&c"
+///   decodeURIComponent("%E2%82%AC") -> "€"
+///   decodeURIComponent("%E2%82") -> error.MalformedUri
+pub fn decodeURIComponent(allocator: Allocator, str: []const u8) !ZString {
+    return engine.apply(Decoder(""), allocator, str);
+}
+
+/// decodeURI(encodedURI)
+/// Spec: https://tc39.es/ecma262/2025/#sec-decodeuri-encodeduri
+///
+/// Like decodeURIComponent() but escapes that decode to a reserved character
+/// (; / ? : @ & = + $ , #) are left encoded.
+///
+/// Examples:
+///   decodeURI("a%20b%26c") -> "a b%26c"
+pub fn decodeURI(allocator: Allocator, str: []const u8) !ZString {
+    return engine.apply(Decoder(reserved), allocator, str);
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "encodeURIComponent - ASCII and reserved characters" {
+    const allocator = std.testing.allocator;
+
+    var result = try encodeURIComponent(allocator, "a b&c=d/e?f#g");
+    defer result.deinit();
+    try std.testing.expectEqualStrings("a%20b%26c%3Dd%2Fe%3Ff%23g", result.data);
+
+    var marks = try encodeURIComponent(allocator, "-_.!~*'()");
+    defer marks.deinit();
+    try std.testing.expectEqualStrings("-_.!~*'()", marks.data);
+    try std.testing.expect(!marks.isOwned());
+}
+
+test "encodeURIComponent - UTF-8 sequences" {
+    const allocator = std.testing.allocator;
+
+    var result = try encodeURIComponent(allocator, "café 😀");
+    defer result.deinit();
+    try std.testing.expectEqualStrings("caf%C3%A9%20%F0%9F%98%80", result.data);
+}
+
+test "encodeURIComponent - invalid input" {
+    const allocator = std.testing.allocator;
+
+    // Lone surrogate U+D800 (WTF-8)
+    try std.testing.expectError(error.InvalidCodePoint, encodeURIComponent(allocator, "\xED\xA0\x80"));
+    try std.testing.expectError(error.InvalidUtf8, encodeURIComponent(allocator, "\xFF"));
+    try std.testing.expectError(error.InvalidUtf8, encodeURIComponent(allocator, "abc\xC3"));
+}
+
+test "encodeURI - keeps reserved characters" {
+    const allocator = std.testing.allocator;
+
+    var result = try encodeURI(allocator, "http://x.y/a b?q=1&r=é#frag");
+    defer result.deinit();
+    try std.testing.expectEqualStrings("http://x.y/a%20b?q=1&r=%C3%A9#frag", result.data);
+}
+
+test "decodeURIComponent - basic and multi-byte" {
+    const allocator = std.testing.allocator;
+
+    var result = try decodeURIComponent(allocator, "a%20b%26c%e2%82%ac%F0%9F%98%80");
+    defer result.deinit();
+    try std.testing.expectEqualStrings("a b&c€😀", result.data);
+
+    var plain = try decodeURIComponent(allocator, "nothing-to-decode");
+    defer plain.deinit();
+    try std.testing.expect(!plain.isOwned());
+}
+
+test "decodeURIComponent - malformed escapes" {
+    const allocator = std.testing.allocator;
+
+    try std.testing.expectError(error.MalformedUri, decodeURIComponent(allocator, "%"));
+    try std.testing.expectError(error.MalformedUri, decodeURIComponent(allocator, "%G0"));
+    try std.testing.expectError(error.MalformedUri, decodeURIComponent(allocator, "%E2%82"));
+    try std.testing.expectError(error.MalformedUri, decodeURIComponent(allocator, "%80"));
+    // Overlong encoding of '/'
+    try std.testing.expectError(error.MalformedUri, decodeURIComponent(allocator, "%C0%AF"));
+    // Encoded surrogate U+D800
+    try std.testing.expectError(error.MalformedUri, decodeURIComponent(allocator, "%ED%A0%80"));
+}
+
+test "decodeURI - preserves reserved escapes" {
+    const allocator = std.testing.allocator;
+
+    var result = try decodeURI(allocator, "a%20b%26c%2Fd%C3%A9");
+    defer result.deinit();
+    try std.testing.expectEqualStrings("a b%26c%2Fdé", result.data);
+}
+
+test "encodeURIComponent/decodeURIComponent - round trip" {
+    const allocator = std.testing.allocator;
+
+    const input = "key=value & more: 你好, 😀 (ok)";
+    var encoded = try encodeURIComponent(allocator, input);
+    defer encoded.deinit();
+    var decoded = try decodeURIComponent(allocator, encoded.data);
+    defer decoded.deinit();
+    try std.testing.expectEqualStrings(input, decoded.data);
+}
@@ -0,0 +1,782 @@
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const simd = @import("../core/simd.zig");
+
+// Terminal display width
+//
+// Widths follow wcwidth conventions: East Asian Wide and Fullwidth
+// characters and emoji with emoji presentation take two columns,
+// combining marks, format characters and controls take none, everything
+// else takes one. Emoji sequences are measured as the single glyph a
+// terminal draws: ZWJ-joined pictographs and skin-tone modifiers add
+// nothing, VS16 widens a text-style pictograph, and a pair of regional
+// indicators is one flag.
+//
+// The per-code-point widths live in a two-stage table (256-entry blocks of
+// 2-bit widths, identical uniform blocks shared) generated at compile time
+// from the range lists below.
+
+const Interval = struct { lo: u21, hi: u21 };
+
+/// East Asian Width W and F, excluding emoji (Unicode 15.1)
+const east_asian_wide = [_]Interval{
+    .{ .lo = 0x1100, .hi = 0x115F },   .{ .lo = 0x2329, .hi = 0x232A },   .{ .lo = 0x2E80, .hi = 0x2E99 },
+    .{ .lo = 0x2E9B, .hi = 0x2EF3 },   .{ .lo = 0x2F00, .hi = 0x2FD5 },   .{ .lo = 0x2FF0, .hi = 0x303E },
+    .{ .lo = 0x3041, .hi = 0x3096 },   .{ .lo = 0x3099, .hi = 0x30FF },   .{ .lo = 0x3105, .hi = 0x312F },
+    .{ .lo = 0x3131, .hi = 0x318E },   .{ .lo = 0x3190, .hi = 0x31E3 },   .{ .lo = 0x31EF, .hi = 0x321E },
+    .{ .lo = 0x3220, .hi = 0x3247 },   .{ .lo = 0x3250, .hi = 0x4DBF },   .{ .lo = 0x4E00, .hi = 0xA48C },
+    .{ .lo = 0xA490, .hi = 0xA4C6 },   .{ .lo = 0xA960, .hi = 0xA97C },   .{ .lo = 0xAC00, .hi = 0xD7A3 },
+    .{ .lo = 0xF900, .hi = 0xFAFF },   .{ .lo = 0xFE10, .hi = 0xFE19 },   .{ .lo = 0xFE30, .hi = 0xFE52 },
+    .{ .lo = 0xFE54, .hi = 0xFE66 },   .{ .lo = 0xFE68, .hi = 0xFE6B },   .{ .lo = 0xFF01, .hi = 0xFF60 },
+    .{ .lo = 0xFFE0, .hi = 0xFFE6 },   .{ .lo = 0x16FE0, .hi = 0x16FE4 }, .{ .lo = 0x16FF0, .hi = 0x16FF1 },
+    .{ .lo = 0x17000, .hi = 0x187F7 }, .{ .lo = 0x18800, .hi = 0x18CD5 }, .{ .lo = 0x18D00, .hi = 0x18D08 },
+    .{ .lo = 0x1AFF0, .hi = 0x1AFF3 }, .{ .lo = 0x1AFF5, .hi = 0x1AFFB }, .{ .lo = 0x1AFFD, .hi = 0x1AFFE },
+    .{ .lo = 0x1B000, .hi = 0x1B122 }, .{ .lo = 0x1B132, .hi = 0x1B132 }, .{ .lo = 0x1B150, .hi = 0x1B152 },
+    .{ .lo = 0x1B155, .hi = 0x1B155 }, .{ .lo = 0x1B164, .hi = 0x1B167 }, .{ .lo = 0x1B170, .hi = 0x1B2FB },
+    .{ .lo = 0x1F200, .hi = 0x1F202 }, .{ .lo = 0x1F210, .hi = 0x1F23B }, .{ .lo = 0x1F240, .hi = 0x1F248 },
+    .{ .lo = 0x1F250, .hi = 0x1F251 }, .{ .lo = 0x1F260, .hi = 0x1F265 }, .{ .lo = 0x20000, .hi = 0x2FFFD },
+    .{ .lo = 0x30000, .hi = 0x3FFFD },
+};
+
+/// Emoji_Presentation=Yes (Unicode 15.1), minus regional indicators, which
+/// are paired up by Scanner
+const emoji_presentation = [_]Interval{
+    .{ .lo = 0x231A, .hi = 0x231B },   .{ .lo = 0x23E9, .hi = 0x23EC },   .{ .lo = 0x23F0, .hi = 0x23F0 },
+    .{ .lo = 0x23F3, .hi = 0x23F3 },   .{ .lo = 0x25FD, .hi = 0x25FE },   .{ .lo = 0x2614, .hi = 0x2615 },
+    .{ .lo = 0x2648, .hi = 0x2653 },   .{ .lo = 0x267F, .hi = 0x267F },   .{ .lo = 0x2693, .hi = 0x2693 },
+    .{ .lo = 0x26A1, .hi = 0x26A1 },   .{ .lo = 0x26AA, .hi = 0x26AB },   .{ .lo = 0x26BD, .hi = 0x26BE },
+    .{ .lo = 0x26C4, .hi = 0x26C5 },   .{ .lo = 0x26CE, .hi = 0x26CE },   .{ .lo = 0x26D4, .hi = 0x26D4 },
+    .{ .lo = 0x26EA, .hi = 0x26EA },   .{ .lo = 0x26F2, .hi = 0x26F3 },   .{ .lo = 0x26F5, .hi = 0x26F5 },
+    .{ .lo = 0x26FA, .hi = 0x26FA },   .{ .lo = 0x26FD, .hi = 0x26FD },   .{ .lo = 0x2705, .hi = 0x2705 },
+    .{ .lo = 0x270A, .hi = 0x270B },   .{ .lo = 0x2728, .hi = 0x2728 },   .{ .lo = 0x274C, .hi = 0x274C },
+    .{ .lo = 0x274E, .hi = 0x274E },   .{ .lo = 0x2753, .hi = 0x2755 },   .{ .lo = 0x2757, .hi = 0x2757 },
+    .{ .lo = 0x2795, .hi = 0x2797 },   .{ .lo = 0x27B0, .hi = 0x27B0 },   .{ .lo = 0x27BF, .hi = 0x27BF },
+    .{ .lo = 0x2B1B, .hi = 0x2B1C },   .{ .lo = 0x2B50, .hi = 0x2B50 },   .{ .lo = 0x2B55, .hi = 0x2B55 },
+    .{ .lo = 0x1F004, .hi = 0x1F004 }, .{ .lo = 0x1F0CF, .hi = 0x1F0CF }, .{ .lo = 0x1F18E, .hi = 0x1F18E },
+    .{ .lo = 0x1F191, .hi = 0x1F19A }, .{ .lo = 0x1F201, .hi = 0x1F201 }, .{ .lo = 0x1F21A, .hi = 0x1F21A },
+    .{ .lo = 0x1F22F, .hi = 0x1F22F }, .{ .lo = 0x1F232, .hi = 0x1F236 }, .{ .lo = 0x1F238, .hi = 0x1F23A },
+    .{ .lo = 0x1F250, .hi = 0x1F251 }, .{ .lo = 0x1F300, .hi = 0x1F320 }, .{ .lo = 0x1F32D, .hi = 0x1F335 },
+    .{ .lo = 0x1F337, .hi = 0x1F37C }, .{ .lo = 0x1F37E, .hi = 0x1F393 }, .{ .lo = 0x1F3A0, .hi = 0x1F3CA },
+    .{ .lo = 0x1F3CF, .hi = 0x1F3D3 }, .{ .lo = 0x1F3E0, .hi = 0x1F3F0 }, .{ .lo = 0x1F3F4, .hi = 0x1F3F4 },
+    .{ .lo = 0x1F3F8, .hi = 0x1F43E }, .{ .lo = 0x1F440, .hi = 0x1F440 }, .{ .lo = 0x1F442, .hi = 0x1F4FC },
+    .{ .lo = 0x1F4FF, .hi = 0x1F53D }, .{ .lo = 0x1F54B, .hi = 0x1F54E }, .{ .lo = 0x1F550, .hi = 0x1F567 },
+    .{ .lo = 0x1F57A, .hi = 0x1F57A }, .{ .lo = 0x1F595, .hi = 0x1F596 }, .{ .lo = 0x1F5A4, .hi = 0x1F5A4 },
+    .{ .lo = 0x1F5FB, .hi = 0x1F64F }, .{ .lo = 0x1F680, .hi = 0x1F6C5 }, .{ .lo = 0x1F6CC, .hi = 0x1F6CC },
+    .{ .lo = 0x1F6D0, .hi = 0x1F6D2 }, .{ .lo = 0x1F6D5, .hi = 0x1F6D7 }, .{ .lo = 0x1F6DC, .hi = 0x1F6DF },
+    .{ .lo = 0x1F6EB, .hi = 0x1F6EC }, .{ .lo = 0x1F6F4, .hi = 0x1F6FC }, .{ .lo = 0x1F7E0, .hi = 0x1F7EB },
+    .{ .lo = 0x1F7F0, .hi = 0x1F7F0 }, .{ .lo = 0x1F90C, .hi = 0x1F93A }, .{ .lo = 0x1F93C, .hi = 0x1F945 },
+    .{ .lo = 0x1F947, .hi = 0x1F9FF }, .{ .lo = 0x1FA70, .hi = 0x1FA7C }, .{ .lo = 0x1FA80, .hi = 0x1FA88 },
+    .{ .lo = 0x1FA90, .hi = 0x1FABD }, .{ .lo = 0x1FABF, .hi = 0x1FAC5 }, .{ .lo = 0x1FACE, .hi = 0x1FADB },
+    .{ .lo = 0x1FAE0, .hi = 0x1FAE8 }, .{ .lo = 0x1FAF0, .hi = 0x1FAF8 },
+};
+
+/// Zero width: controls, nonspacing and enclosing marks, Hangul medial
+/// and final jamo, format characters, variation selectors and tags
+/// (takes precedence over the wide tables)
+const zero_width = [_]Interval{
+    .{ .lo = 0x0000, .hi = 0x001F },   .{ .lo = 0x007F, .hi = 0x009F },   .{ .lo = 0x0300, .hi = 0x036F },
+    .{ .lo = 0x0483, .hi = 0x0489 },   .{ .lo = 0x0591, .hi = 0x05BD },   .{ .lo = 0x05BF, .hi = 0x05BF },
+    .{ .lo = 0x05C1, .hi = 0x05C2 },   .{ .lo = 0x05C4, .hi = 0x05C5 },   .{ .lo = 0x05C7, .hi = 0x05C7 },
+    .{ .lo = 0x0610, .hi = 0x061A },   .{ .lo = 0x061C, .hi = 0x061C },   .{ .lo = 0x064B, .hi = 0x065F },
+    .{ .lo = 0x0670, .hi = 0x0670 },   .{ .lo = 0x06D6, .hi = 0x06DC },   .{ .lo = 0x06DF, .hi = 0x06E4 },
+    .{ .lo = 0x06E7, .hi = 0x06E8 },   .{ .lo = 0x06EA, .hi = 0x06ED },   .{ .lo = 0x0711, .hi = 0x0711 },
+    .{ .lo = 0x0730, .hi = 0x074A },   .{ .lo = 0x07A6, .hi = 0x07B0 },   .{ .lo = 0x07EB, .hi = 0x07F3 },
+    .{ .lo = 0x07FD, .hi = 0x07FD },   .{ .lo = 0x0816, .hi = 0x0819 },   .{ .lo = 0x081B, .hi = 0x0823 },
+    .{ .lo = 0x0825, .hi = 0x0827 },   .{ .lo = 0x0829, .hi = 0x082D },   .{ .lo = 0x0859, .hi = 0x085B },
+    .{ .lo = 0x0898, .hi = 0x089F },   .{ .lo = 0x08CA, .hi = 0x08E1 },   .{ .lo = 0x08E3, .hi = 0x0902 },
+    .{ .lo = 0x093A, .hi = 0x093A },   .{ .lo = 0x093C, .hi = 0x093C },   .{ .lo = 0x0941, .hi = 0x0948 },
+    .{ .lo = 0x094D, .hi = 0x094D },   .{ .lo = 0x0951, .hi = 0x0957 },   .{ .lo = 0x0962, .hi = 0x0963 },
+    .{ .lo = 0x0981, .hi = 0x0981 },   .{ .lo = 0x09BC, .hi = 0x09BC },   .{ .lo = 0x09C1, .hi = 0x09C4 },
+    .{ .lo = 0x09CD, .hi = 0x09CD },   .{ .lo = 0x09E2, .hi = 0x09E3 },   .{ .lo = 0x09FE, .hi = 0x09FE },
+    .{ .lo = 0x0A01, .hi = 0x0A02 },   .{ .lo = 0x0A3C, .hi = 0x0A3C },   .{ .lo = 0x0A41, .hi = 0x0A42 },
+    .{ .lo = 0x0A47, .hi = 0x0A48 },   .{ .lo = 0x0A4B, .hi = 0x0A4D },   .{ .lo = 0x0A51, .hi = 0x0A51 },
+    .{ .lo = 0x0A70, .hi = 0x0A71 },   .{ .lo = 0x0A75, .hi = 0x0A75 },   .{ .lo = 0x0A81, .hi = 0x0A82 },
+    .{ .lo = 0x0ABC, .hi = 0x0ABC },   .{ .lo = 0x0AC1, .hi = 0x0AC5 },   .{ .lo = 0x0AC7, .hi = 0x0AC8 },
+    .{ .lo = 0x0ACD, .hi = 0x0ACD },   .{ .lo = 0x0AE2, .hi = 0x0AE3 },   .{ .lo = 0x0AFA, .hi = 0x0AFF },
+    .{ .lo = 0x0B01, .hi = 0x0B01 },   .{ .lo = 0x0B3C, .hi = 0x0B3C },   .{ .lo = 0x0B3F, .hi = 0x0B3F },
+    .{ .lo = 0x0B41, .hi = 0x0B44 },   .{ .lo = 0x0B4D, .hi = 0x0B4D },   .{ .lo = 0x0B55, .hi = 0x0B56 },
+    .{ .lo = 0x0B62, .hi = 0x0B63 },   .{ .lo = 0x0B82, .hi = 0x0B82 },   .{ .lo = 0x0BC0, .hi = 0x0BC0 },
+    .{ .lo = 0x0BCD, .hi = 0x0BCD },   .{ .lo = 0x0C00, .hi = 0x0C00 },   .{ .lo = 0x0C04, .hi = 0x0C04 },
+    .{ .lo = 0x0C3C, .hi = 0x0C3C },   .{ .lo = 0x0C3E, .hi = 0x0C40 },   .{ .lo = 0x0C46, .hi = 0x0C48 },
+    .{ .lo = 0x0C4A, .hi = 0x0C4D },   .{ .lo = 0x0C55, .hi = 0x0C56 },   .{ .lo = 0x0C62, .hi = 0x0C63 },
+    .{ .lo = 0x0C81, .hi = 0x0C81 },   .{ .lo = 0x0CBC, .hi = 0x0CBC },   .{ .lo = 0x0CBF, .hi = 0x0CBF },
+    .{ .lo = 0x0CC6, .hi = 0x0CC6 },   .{ .lo = 0x0CCC, .hi = 0x0CCD },   .{ .lo = 0x0CE2, .hi = 0x0CE3 },
+    .{ .lo = 0x0D00, .hi = 0x0D01 },   .{ .lo = 0x0D3B, .hi = 0x0D3C },   .{ .lo = 0x0D41, .hi = 0x0D44 },
+    .{ .lo = 0x0D4D, .hi = 0x0D4D },   .{ .lo = 0x0D62, .hi = 0x0D63 },   .{ .lo = 0x0D81, .hi = 0x0D81 },
+    .{ .lo = 0x0DCA, .hi = 0x0DCA },   .{ .lo = 0x0DD2, .hi = 0x0DD4 },   .{ .lo = 0x0DD6, .hi = 0x0DD6 },
+    .{ .lo = 0x0E31, .hi = 0x0E31 },   .{ .lo = 0x0E34, .hi = 0x0E3A },   .{ .lo = 0x0E47, .hi = 0x0E4E },
+    .{ .lo = 0x0EB1, .hi = 0x0EB1 },   .{ .lo = 0x0EB4, .hi = 0x0EBC },   .{ .lo = 0x0EC8, .hi = 0x0ECE },
+    .{ .lo = 0x0F18, .hi = 0x0F19 },   .{ .lo = 0x0F35, .hi = 0x0F35 },   .{ .lo = 0x0F37, .hi = 0x0F37 },
+    .{ .lo = 0x0F39, .hi = 0x0F39 },   .{ .lo = 0x0F71, .hi = 0x0F7E },   .{ .lo = 0x0F80, .hi = 0x0F84 },
+    .{ .lo = 0x0F86, .hi = 0x0F87 },   .{ .lo = 0x0F8D, .hi = 0x0F97 },   .{ .lo = 0x0F99, .hi = 0x0FBC },
+    .{ .lo = 0x0FC6, .hi = 0x0FC6 },   .{ .lo = 0x102D, .hi = 0x1030 },   .{ .lo = 0x1032, .hi = 0x1037 },
+    .{ .lo = 0x1039, .hi = 0x103A },   .{ .lo = 0x103D, .hi = 0x103E },   .{ .lo = 0x1058, .hi = 0x1059 },
+    .{ .lo = 0x105E, .hi = 0x1060 },   .{ .lo = 0x1071, .hi = 0x1074 },   .{ .lo = 0x1082, .hi = 0x1082 },
+    .{ .lo = 0x1085, .hi = 0x1086 },   .{ .lo = 0x108D, .hi = 0x108D },   .{ .lo = 0x109D, .hi = 0x109D },
+    .{ .lo = 0x1160, .hi = 0x11FF },   .{ .lo = 0x135D, .hi = 0x135F },   .{ .lo = 0x1712, .hi = 0x1714 },
+    .{ .lo = 0x1732, .hi = 0x1733 },   .{ .lo = 0x1752, .hi = 0x1753 },   .{ .lo = 0x1772, .hi = 0x1773 },
+    .{ .lo = 0x17B4, .hi = 0x17B5 },   .{ .lo = 0x17B7, .hi = 0x17BD },   .{ .lo = 0x17C6, .hi = 0x17C6 },
+    .{ .lo = 0x17C9, .hi = 0x17D3 },   .{ .lo = 0x17DD, .hi = 0x17DD },   .{ .lo = 0x180B, .hi = 0x180F },
+    .{ .lo = 0x1885, .hi = 0x1886 },   .{ .lo = 0x18A9, .hi = 0x18A9 },   .{ .lo = 0x1920, .hi = 0x1922 },
+    .{ .lo = 0x1927, .hi = 0x1928 },   .{ .lo = 0x1932, .hi = 0x1932 },   .{ .lo = 0x1939, .hi = 0x193B },
+    .{ .lo = 0x1A17, .hi = 0x1A18 },   .{ .lo = 0x1A1B, .hi = 0x1A1B },   .{ .lo = 0x1A56, .hi = 0x1A56 },
+    .{ .lo = 0x1A58, .hi = 0x1A5E },   .{ .lo = 0x1A60, .hi = 0x1A60 },   .{ .lo = 0x1A62, .hi = 0x1A62 },
+    .{ .lo = 0x1A65, .hi = 0x1A6C },   .{ .lo = 0x1A73, .hi = 0x1A7C },   .{ .lo = 0x1A7F, .hi = 0x1A7F },
+    .{ .lo = 0x1AB0, .hi = 0x1ACE },   .{ .lo = 0x1B00, .hi = 0x1B03 },   .{ .lo = 0x1B34, .hi = 0x1B34 },
+    .{ .lo = 0x1B36, .hi = 0x1B3A },   .{ .lo = 0x1B3C, .hi = 0x1B3C },   .{ .lo = 0x1B42, .hi = 0x1B42 },
+    .{ .lo = 0x1B6B, .hi = 0x1B73 },   .{ .lo = 0x1B80, .hi = 0x1B81 },   .{ .lo = 0x1BA2, .hi = 0x1BA5 },
+    .{ .lo = 0x1BA8, .hi = 0x1BA9 },   .{ .lo = 0x1BAB, .hi = 0x1BAD },   .{ .lo = 0x1BE6, .hi = 0x1BE6 },
+    .{ .lo = 0x1BE8, .hi = 0x1BE9 },   .{ .lo = 0x1BED, .hi = 0x1BED },   .{ .lo = 0x1BEF, .hi = 0x1BF1 },
+    .{ .lo = 0x1C2C, .hi = 0x1C33 },   .{ .lo = 0x1C36, .hi = 0x1C37 },   .{ .lo = 0x1CD0, .hi = 0x1CD2 },
+    .{ .lo = 0x1CD4, .hi = 0x1CE0 },   .{ .lo = 0x1CE2, .hi = 0x1CE8 },   .{ .lo = 0x1CED, .hi = 0x1CED },
+    .{ .lo = 0x1CF4, .hi = 0x1CF4 },   .{ .lo = 0x1CF8, .hi = 0x1CF9 },   .{ .lo = 0x1DC0, .hi = 0x1DFF },
+    .{ .lo = 0x200B, .hi = 0x200F },   .{ .lo = 0x202A, .hi = 0x202E },   .{ .lo = 0x2060, .hi = 0x206F },
+    .{ .lo = 0x20D0, .hi = 0x20F0 },   .{ .lo = 0x2CEF, .hi = 0x2CF1 },   .{ .lo = 0x2D7F, .hi = 0x2D7F },
+    .{ .lo = 0x2DE0, .hi = 0x2DFF },   .{ .lo = 0x302A, .hi = 0x302D },   .{ .lo = 0x3099, .hi = 0x309A },
+    .{ .lo = 0xA66F, .hi = 0xA672 },   .{ .lo = 0xA674, .hi = 0xA67D },   .{ .lo = 0xA69E, .hi = 0xA69F },
+    .{ .lo = 0xA6F0, .hi = 0xA6F1 },   .{ .lo = 0xA802, .hi = 0xA802 },   .{ .lo = 0xA806, .hi = 0xA806 },
+    .{ .lo = 0xA80B, .hi = 0xA80B },   .{ .lo = 0xA825, .hi = 0xA826 },   .{ .lo = 0xA82C, .hi = 0xA82C },
+    .{ .lo = 0xA8C4, .hi = 0xA8C5 },   .{ .lo = 0xA8E0, .hi = 0xA8F1 },   .{ .lo = 0xA8FF, .hi = 0xA8FF },
+    .{ .lo = 0xA926, .hi = 0xA92D },   .{ .lo = 0xA947, .hi = 0xA951 },   .{ .lo = 0xA980, .hi = 0xA982 },
+    .{ .lo = 0xA9B3, .hi = 0xA9B3 },   .{ .lo = 0xA9B6, .hi = 0xA9B9 },   .{ .lo = 0xA9BC, .hi = 0xA9BD },
+    .{ .lo = 0xA9E5, .hi = 0xA9E5 },   .{ .lo = 0xAA29, .hi = 0xAA2E },   .{ .lo = 0xAA31, .hi = 0xAA32 },
+    .{ .lo = 0xAA35, .hi = 0xAA36 },   .{ .lo = 0xAA43, .hi = 0xAA43 },   .{ .lo = 0xAA4C, .hi = 0xAA4C },
+    .{ .lo = 0xAA7C, .hi = 0xAA7C },   .{ .lo = 0xAAB0, .hi = 0xAAB0 },   .{ .lo = 0xAAB2, .hi = 0xAAB4 },
+    .{ .lo = 0xAAB7, .hi = 0xAAB8 },   .{ .lo = 0xAABE, .hi = 0xAABF },   .{ .lo = 0xAAC1, .hi = 0xAAC1 },
+    .{ .lo = 0xAAEC, .hi = 0xAAED },   .{ .lo = 0xAAF6, .hi = 0xAAF6 },   .{ .lo = 0xABE5, .hi = 0xABE5 },
+    .{ .lo = 0xABE8, .hi = 0xABE8 },   .{ .lo = 0xABED, .hi = 0xABED },   .{ .lo = 0xD7B0, .hi = 0xD7FF },
+    .{ .lo = 0xFB1E, .hi = 0xFB1E },   .{ .lo = 0xFE00, .hi = 0xFE0F },   .{ .lo = 0xFE20, .hi = 0xFE2F },
+    .{ .lo = 0xFEFF, .hi = 0xFEFF },   .{ .lo = 0xFFF9, .hi = 0xFFFB },   .{ .lo = 0x101FD, .hi = 0x101FD },
+    .{ .lo = 0x102E0, .hi = 0x102E0 }, .{ .lo = 0x10376, .hi = 0x1037A }, .{ .lo = 0x10A01, .hi = 0x10A03 },
+    .{ .lo = 0x10A05, .hi = 0x10A06 }, .{ .lo = 0x10A0C, .hi = 0x10A0F }, .{ .lo = 0x10A38, .hi = 0x10A3A },
+    .{ .lo = 0x10A3F, .hi = 0x10A3F }, .{ .lo = 0x10AE5, .hi = 0x10AE6 }, .{ .lo = 0x10D24, .hi = 0x10D27 },
+    .{ .lo = 0x10EAB, .hi = 0x10EAC }, .{ .lo = 0x10F46, .hi = 0x10F50 }, .{ .lo = 0x11001, .hi = 0x11001 },
+    .{ .lo = 0x11038, .hi = 0x11046 }, .{ .lo = 0x1107F, .hi = 0x11081 }, .{ .lo = 0x110B3, .hi = 0x110B6 },
+    .{ .lo = 0x110B9, .hi = 0x110BA }, .{ .lo = 0x11100, .hi = 0x11102 }, .{ .lo = 0x11127, .hi = 0x1112B },
+    .{ .lo = 0x1112D, .hi = 0x11134 }, .{ .lo = 0x11173, .hi = 0x11173 }, .{ .lo = 0x11180, .hi = 0x11181 },
+    .{ .lo = 0x111B6, .hi = 0x111BE }, .{ .lo = 0x1122F, .hi = 0x11231 }, .{ .lo = 0x11234, .hi = 0x11234 },
+    .{ .lo = 0x11236, .hi = 0x11237 }, .{ .lo = 0x112DF, .hi = 0x112DF }, .{ .lo = 0x112E3, .hi = 0x112EA },
+    .{ .lo = 0x11300, .hi = 0x11301 }, .{ .lo = 0x1133B, .hi = 0x1133C }, .{ .lo = 0x11340, .hi = 0x11340 },
+    .{ .lo = 0x11366, .hi = 0x1136C }, .{ .lo = 0x11370, .hi = 0x11374 }, .{ .lo = 0x11438, .hi = 0x1143F },
+    .{ .lo = 0x11442, .hi = 0x11444 }, .{ .lo = 0x11446, .hi = 0x11446 }, .{ .lo = 0x1145E, .hi = 0x1145E },
+    .{ .lo = 0x114B3, .hi = 0x114B8 }, .{ .lo = 0x114BA, .hi = 0x114BA }, .{ .lo = 0x114BF, .hi = 0x114C0 },
+    .{ .lo = 0x114C2, .hi = 0x114C3 }, .{ .lo = 0x115B2, .hi = 0x115B5 }, .{ .lo = 0x115BC, .hi = 0x115BD },
+    .{ .lo = 0x115BF, .hi = 0x115C0 }, .{ .lo = 0x11633, .hi = 0x1163A }, .{ .lo = 0x1163D, .hi = 0x1163D },
+    .{ .lo = 0x1163F, .hi = 0x11640 }, .{ .lo = 0x116AB, .hi = 0x116AB }, .{ .lo = 0x116AD, .hi = 0x116AD },
+    .{ .lo = 0x116B0, .hi = 0x116B5 }, .{ .lo = 0x116B7, .hi = 0x116B7 }, .{ .lo = 0x1171D, .hi = 0x1171F },
+    .{ .lo = 0x11722, .hi = 0x11725 }, .{ .lo = 0x11727, .hi = 0x1172B }, .{ .lo = 0x16AF0, .hi = 0x16AF4 },
+    .{ .lo = 0x16B30, .hi = 0x16B36 }, .{ .lo = 0x16F4F, .hi = 0x16F4F }, .{ .lo = 0x16F8F, .hi = 0x16F92 },
+    .{ .lo = 0x16FE4, .hi = 0x16FE4 }, .{ .lo = 0x1BC9D, .hi = 0x1BC9E }, .{ .lo = 0x1BCA0, .hi = 0x1BCA3 },
+    .{ .lo = 0x1CF00, .hi = 0x1CF2D }, .{ .lo = 0x1CF30, .hi = 0x1CF46 }, .{ .lo = 0x1D167, .hi = 0x1D169 },
+    .{ .lo = 0x1D173, .hi = 0x1D182 }, .{ .lo = 0x1D185, .hi = 0x1D18B }, .{ .lo = 0x1D1AA, .hi = 0x1D1AD },
+    .{ .lo = 0x1D242, .hi = 0x1D244 }, .{ .lo = 0x1DA00, .hi = 0x1DA36 }, .{ .lo = 0x1DA3B, .hi = 0x1DA6C },
+    .{ .lo = 0x1DA75, .hi = 0x1DA75 }, .{ .lo = 0x1DA84, .hi = 0x1DA84 }, .{ .lo = 0x1DA9B, .hi = 0x1DA9F },
+    .{ .lo = 0x1DAA1, .hi = 0x1DAAF }, .{ .lo = 0x1E000, .hi = 0x1E006 }, .{ .lo = 0x1E008, .hi = 0x1E018 },
+    .{ .lo = 0x1E01B, .hi = 0x1E021 }, .{ .lo = 0x1E023, .hi = 0x1E024 }, .{ .lo = 0x1E026, .hi = 0x1E02A },
+    .{ .lo = 0x1E08F, .hi = 0x1E08F }, .{ .lo = 0x1E130, .hi = 0x1E136 }, .{ .lo = 0x1E2AE, .hi = 0x1E2AE },
+    .{ .lo = 0x1E2EC, .hi = 0x1E2EF }, .{ .lo = 0x1E4EC, .hi = 0x1E4EF }, .{ .lo = 0x1E8D0, .hi = 0x1E8D6 },
+    .{ .lo = 0x1E944, .hi = 0x1E94A }, .{ .lo = 0xE0001, .hi = 0xE0001 }, .{ .lo = 0xE0020, .hi = 0xE007F },
+    .{ .lo = 0xE0100, .hi = 0xE01EF },
+};
+
+// ============================================================================
+// Lookup table
+// ============================================================================
+
+const block_shift = 8;
+const block_len = 1 << block_shift;
+const block_count = 0x110000 >> block_shift;
+
+/// 256 widths packed four to a byte
+const Block = [block_len / 4]u8;
+
+fn uniformBlock(w: u2) Block {
+    return @splat(@as(u8, w) * 0x55);
+}
+
+fn setWidth(block: *Block, offset: usize, w: u2) void {
+    const shift: u3 = @intCast((offset & 3) * 2);
+    block[offset >> 2] = (block[offset >> 2] & ~(@as(u8, 3) << shift)) | (@as(u8, w) << shift);
+}
+
+/// Paints the parts of `ranges` that overlap the block starting at `base`
+/// `ranges` is sorted; `cursor` skips ranges that ended in earlier blocks.
+fn paint(block: *Block, base: u21, ranges: []const Interval, cursor: *usize, w: u2) void {
+    const last = base + (block_len - 1);
+    while (cursor.* < ranges.len and ranges[cursor.*].hi < base) cursor.* += 1;
+
+    var i = cursor.*;
+    while (i < ranges.len and ranges[i].lo <= last) : (i += 1) {
+        const lo = @max(ranges[i].lo, base);
+        const hi = @min(ranges[i].hi, last);
+        if (lo == base and hi == last) {
+            block.* = uniformBlock(w);
+            continue;
+        }
+        var cp = lo;
+        while (cp <= hi) : (cp += 1) setWidth(block, cp - base, w);
+    }
+}
+
+fn isUniform(block: *const Block) bool {
+    const b = block[0];
+    if (b != 0x00 and b != 0x55 and b != 0xAA) return false;
+    for (block) |x| {
+        if (x != b) return false;
+    }
+    return true;
+}
+
+const Tables = struct {
+    /// Block number for each 256-code-point block
+    index: [block_count]u16,
+    blocks: []const Block,
+};
+
+const tables: Tables = blk: {
+    @setEvalBranchQuota(20_000_000);
+
+    var index: [block_count]u16 = undefined;
+    var blocks: [block_count + 3]Block = undefined;
+    // Blocks 0..2 are the uniform width-0/1/2 blocks
+    blocks[0] = uniformBlock(0);
+    blocks[1] = uniformBlock(1);
+    blocks[2] = uniformBlock(2);
+    var count: usize = 3;
+
+    var wide_cursor: usize = 0;
+    var emoji_cursor: usize = 0;
+    var zero_cursor: usize = 0;
+    for (0..block_count) |bi| {
+        const base: u21 = @intCast(bi << block_shift);
+        var block = uniformBlock(1);
+        paint(&block, base, &east_asian_wide, &wide_cursor, 2);
+        paint(&block, base, &emoji_presentation, &emoji_cursor, 2);
+        paint(&block, base, &zero_width, &zero_cursor, 0);
+
+        if (isUniform(&block)) {
+            index[bi] = block[0] / 0x55;
+        } else {
+            blocks[count] = block;
+            index[bi] = count;
+            count += 1;
+        }
+    }
+
+    const final_index = index;
+    const final_blocks = blocks[0..count].*;
+    break :blk .{ .index = final_index, .blocks = &final_blocks };
+};
+
+/// Width of a single code point, without context (0, 1 or 2)
+pub fn codepointWidth(cp: u21) u2 {
+    if (cp < 0x7F) return if (cp >= 0x20) 1 else 0;
+    if (cp > 0x10FFFF) return 1;
+    const block = &tables.blocks[tables.index[cp >> block_shift]];
+    const offset = cp & (block_len - 1);
+    const shift: u3 = @intCast((offset & 3) * 2);
+    return @truncate(block[offset >> 2] >> shift);
+}
+
+/// Extended_Pictographic, approximately: code points that can start an
+/// emoji sequence
+fn isPictographic(cp: u21) bool {
+    return switch (cp) {
+        0x00A9, 0x00AE, 0x203C, 0x2049, 0x2122, 0x2139, 0x2194...0x2199, 0x21A9, 0x21AA => true,
+        0x231A...0x23FF, 0x24C2, 0x25AA...0x25FE, 0x2600...0x27BF, 0x2934, 0x2935 => true,
+        0x2B05...0x2B55, 0x3030, 0x303D, 0x3297, 0x3299, 0x1F000...0x1FAFF => true,
+        else => false,
+    };
+}
+
+/// Tracks emoji sequences so each code point can be given its width in
+/// context
+const Scanner = struct {
+    /// Last code point was an emoji that ZWJ and modifiers extend
+    emoji: bool = false,
+    /// Last code point was a narrow pictograph that VS16 widens
+    text_emoji: bool = false,
+    /// Last code point was a ZWJ following an emoji
+    joined: bool = false,
+    /// An unpaired regional indicator precedes
+    flag: bool = false,
+
+    fn next(self: *Scanner, cp: u21) usize {
+        if (self.joined) {
+            self.joined = false;
+            if (isPictographic(cp)) return 0;
+        }
+        switch (cp) {
+            0x200D => {
+                self.joined = self.emoji;
+                return 0;
+            },
+            0xFE0F => {
+                if (!self.text_emoji) return 0;
+                self.text_emoji = false;
+                self.emoji = true;
+                return 1;
+            },
+            0x1F3FB...0x1F3FF => if (self.emoji) return 0,
+            0x1F1E6...0x1F1FF => {
+                if (self.flag) {
+                    self.flag = false;
+                    return 0;
+                }
+                self.* = .{ .flag = true, .emoji = true };
+                return 2;
+            },
+            else => {},
+        }
+
+        const w = codepointWidth(cp);
+        if (w == 0) return 0;
+        self.* = .{
+            .emoji = w == 2 and isPictographic(cp),
+            .text_emoji = w == 1 and isPictographic(cp),
+        };
+        return w;
+    }
+
+    /// Resets after a run of graphic ASCII ending in `last`
+    fn ascii(self: *Scanner, last: u8) void {
+        // '#', '*' and digits start keycap sequences
+        const keycap = last == '#' or last == '*' or (last >= '0' and last <= '9');
+        self.* = .{ .text_emoji = keycap };
+    }
+};
+
+/// Bytes outside graphic ASCII (0x21..0x7E)
+const NotGraphicAscii = struct {
+    pub inline fn vector(v: simd.Vec) simd.Vec {
+        return ~simd.inRange(v, 0x21, 0x7E);
+    }
+    pub inline fn scalar(b: u8) bool {
+        return b < 0x21 or b > 0x7E;
+    }
+};
+
+/// Splits a string into runs of graphic ASCII (width = byte length) and
+/// single code points measured in context
+const Walker = struct {
+    str: []const u8,
+    pos: usize = 0,
+    scanner: Scanner = .{},
+
+    const Step = struct {
+        start: usize,
+        end: usize,
+        width: usize,
+        /// Run of graphic ASCII; any byte boundary inside it is a valid cut
+        ascii: bool,
+        /// The code point (0 for ASCII runs)
+        cp: u21,
+    };
+
+    fn next(self: *Walker) ?Step {
+        const str = self.str;
+        if (self.pos >= str.len) return null;
+        const start = self.pos;
+        const b = str[start];
+
+        if (b > 0x20 and b < 0x7F) {
+            const end = simd.indexOfClass(NotGraphicAscii, str, start + 1) orelse str.len;
+            self.pos = end;
+            self.scanner.ascii(str[end - 1]);
+            return .{ .start = start, .end = end, .width = end - start, .ascii = true, .cp = 0 };
+        }
+
+        // Invalid UTF-8 counts as one column per byte
+        var cp: u21 = b;
+        var cp_len: usize = 1;
+        if (b >= 0x80) invalid: {
+            const seq_len = std.unicode.utf8ByteSequenceLength(b) catch break :invalid;
+            if (start + seq_len > str.len) break :invalid;
+            cp = std.unicode.utf8Decode(str[start..][0..seq_len]) catch break :invalid;
+            cp_len = seq_len;
+        }
+        self.pos = start + cp_len;
+
+        const w = if (cp_len == 1 and b >= 0x80) blk: {
+            self.scanner = .{};
+            break :blk 1;
+        } else self.scanner.next(cp);
+        return .{ .start = start, .end = self.pos, .width = w, .ascii = false, .cp = cp };
+    }
+};
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+/// Display width of `str` in terminal columns
+///
+/// Runs of printable ASCII are counted by length without decoding.
+pub fn width(str: []const u8) usize {
+    var walker = Walker{ .str = str };
+    var total: usize = 0;
+    while (walker.next()) |step| total += step.width;
+    return total;
+}
+
+/// The longest prefix of `str` that fits in `max` columns
+pub const Prefix = struct {
+    /// Byte length of the prefix
+    len: usize,
+    /// Its display width
+    width: usize,
+};
+
+/// Returns the longest prefix of `str` no wider than `max` columns
+/// Zero-width code points following the last one that fits are included,
+/// so combining marks and emoji sequences are never split.
+pub fn prefixForWidth(str: []const u8, max: usize) Prefix {
+    var walker = Walker{ .str = str };
+    var result = Prefix{ .len = 0, .width = 0 };
+    while (walker.next()) |step| {
+        if (result.width + step.width <= max) {
+            result.len = step.end;
+            result.width += step.width;
+        } else {
+            if (step.ascii) {
+                result.len = step.start + (max - result.width);
+                result.width = max;
+            }
+            break;
+        }
+    }
+    return result;
+}
+
+pub const Side = enum {
+    /// Pad before the text (like padStart)
+    start,
+    /// Pad after the text (like padEnd)
+    end,
+    /// Split the padding, the extra column going after the text
+    both,
+};
+
+pub const PadOptions = struct {
+    side: Side = .end,
+    /// Repeated to fill the gap; if a wide character would overshoot the
+    /// target, the remainder is filled with spaces
+    fill: []const u8 = " ",
+};
+
+/// Pads `str` to at least `target` display columns
+///
+/// Unlike padStart()/padEnd(), which count UTF-16 code units, this aligns
+/// text containing CJK and emoji in a terminal. Strings already at least
+/// `target` wide are copied unchanged.
+///
+/// The returned string must be freed by the caller.
+pub fn padToWidth(allocator: Allocator, str: []const u8, target: usize, options: PadOptions) ![]u8 {
+    const current = width(str);
+    const fill_width = width(options.fill);
+    if (current >= target or fill_width == 0) return allocator.dupe(u8, str);
+
+    const needed = target - current;
+    const before = switch (options.side) {
+        .start => needed,
+        .end => 0,
+        .both => needed / 2,
+    };
+    const after = needed - before;
+
+    const before_len = padLength(options.fill, fill_width, before);
+    const after_len = padLength(options.fill, fill_width, after);
+    const result = try allocator.alloc(u8, before_len + str.len + after_len);
+    writePad(result[0..before_len], options.fill, fill_width, before);
+    @memcpy(result[before_len..][0..str.len], str);
+    writePad(result[before_len + str.len ..], options.fill, fill_width, after);
+    return result;
+}
+
+/// Byte length of `columns` columns of padding made from `fill`
+fn padLength(fill: []const u8, fill_width: usize, columns: usize) usize {
+    const rest = prefixForWidth(fill, columns % fill_width);
+    return (columns / fill_width) * fill.len + rest.len + (columns % fill_width - rest.width);
+}
+
+fn writePad(out: []u8, fill: []const u8, fill_width: usize, columns: usize) void {
+    var pos: usize = 0;
+    for (0..columns / fill_width) |_| {
+        @memcpy(out[pos..][0..fill.len], fill);
+        pos += fill.len;
+    }
+    const rest = prefixForWidth(fill, columns % fill_width);
+    @memcpy(out[pos..][0..rest.len], fill[0..rest.len]);
+    pos += rest.len;
+    @memset(out[pos..], ' ');
+}
+
+/// Shortens `str` to at most `max` display columns, ending it with
+/// `ellipsis` when anything was cut
+///
+/// Runs in a single pass that stops at the first column past `max`.
+/// If `ellipsis` alone is wider than `max`, the text is cut without it.
+///
+/// The returned string must be freed by the caller.
+pub fn truncateToWidth(allocator: Allocator, str: []const u8, max: usize, ellipsis: []const u8) ![]u8 {
+    const ellipsis_width = width(ellipsis);
+    const marker = if (ellipsis_width <= max) ellipsis else "";
+    const budget = max - width(marker);
+
+    var walker = Walker{ .str = str };
+    var total: usize = 0;
+    var keep: usize = 0;
+    var keep_done = false;
+    while (walker.next()) |step| {
+        if (!keep_done) {
+            if (total + step.width <= budget) {
+                keep = step.end;
+            } else {
+                if (step.ascii) keep = step.start + (budget - total);
+                keep_done = true;
+            }
+        }
+        total += step.width;
+        if (total > max) return std.mem.concat(allocator, u8, &.{ str[0..keep], marker });
+    }
+    return allocator.dupe(u8, str);
+}
+
+fn isLineBreak(cp: u21) bool {
+    return cp == '\n' or cp == '\r' or cp == 0x2028 or cp == 0x2029;
+}
+
+/// Word-wraps `str` into lines at most `max` columns wide
+///
+/// Lines break at spaces and between wide (CJK) characters; a word wider
+/// than `max` is broken where it overflows. Existing line breaks are kept.
+/// Spaces at a break are dropped, leading spaces are kept.
+///
+/// Returns slices of `str`; the caller frees only the outer slice.
+pub fn wrapToWidth(allocator: Allocator, str: []const u8, max: usize) ![][]const u8 {
+    const Break = struct {
+        /// End of the line if broken here (before the spaces)
+        end: usize,
+        /// Start of the next line
+        resume_at: usize,
+        /// Line width up to `resume_at`
+        width: usize,
+    };
+
+    var lines = std.ArrayList([]const u8){};
+    errdefer lines.deinit(allocator);
+
+    var walker = Walker{ .str = str };
+    var line_start: usize = 0;
+    var line_width: usize = 0;
+    var space_start: ?usize = null;
+    var brk: ?Break = null;
+    var prev_wide = false;
+
+    while (walker.next()) |step| {
+        if (!step.ascii and isLineBreak(step.cp)) {
+            var end = step.end;
+            if (step.cp == '\r' and end < str.len and str[end] == '\n') {
+                end += 1;
+                walker.pos = end;
+            }
+            try lines.append(allocator, str[line_start .. space_start orelse step.start]);
+            line_start = end;
+            line_width = 0;
+            space_start = null;
+            brk = null;
+            prev_wide = false;
+            continue;
+        }
+        if (!step.ascii and step.cp == ' ') {
+            if (space_start == null) space_start = step.start;
+            // Spaces may hang past the margin
+            line_width += step.width;
+            continue;
+        }
+        if (step.width == 0) continue;
+
+        if (space_start) |s| {
+            brk = .{ .end = s, .resume_at = step.start, .width = line_width };
+            space_start = null;
+        } else if (step.width == 2 or prev_wide) {
+            brk = .{ .end = step.start, .resume_at = step.start, .width = line_width };
+        }
+        prev_wide = step.width == 2;
+
+        if (line_width + step.width > max) {
+            if (brk) |b| {
+                if (b.end > line_start) {
+                    try lines.append(allocator, str[line_start..b.end]);
+                    line_start = b.resume_at;
+                    line_width -= b.width;
+                }
+                brk = null;
+            }
+            if (line_width > 0 and line_width + step.width > max) {
+                try lines.append(allocator, str[line_start..step.start]);
+                line_start = step.start;
+                line_width = 0;
+            }
+            if (step.ascii) {
+                // Hard-break an ASCII word longer than a whole line
+                var s = step.start;
+                while (line_width + (step.end - s) > max) {
+                    const take = @max(max - line_width, 1);
+                    try lines.append(allocator, str[line_start .. s + take]);
+                    s += take;
+                    line_start = s;
+                    line_width = 0;
+                }
+                line_width += step.end - s;
+                continue;
+            }
+        }
+        line_width += step.width;
+    }
+
+    try lines.append(allocator, str[line_start .. space_start orelse str.len]);
+    return lines.toOwnedSlice(allocator);
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "codepointWidth - table" {
+    try std.testing.expectEqual(@as(u2, 1), codepointWidth('a'));
+    try std.testing.expectEqual(@as(u2, 0), codepointWidth(0x07));
+    try std.testing.expectEqual(@as(u2, 0), codepointWidth(0x0301)); // combining acute
+    try std.testing.expectEqual(@as(u2, 1), codepointWidth(0x00E9)); // é
+    try std.testing.expectEqual(@as(u2, 2), codepointWidth(0x4E2D)); // 中
+    try std.testing.expectEqual(@as(u2, 2), codepointWidth(0xAC00)); // 가
+    try std.testing.expectEqual(@as(u2, 0), codepointWidth(0x1160)); // Hangul medial jamo
+    try std.testing.expectEqual(@as(u2, 2), codepointWidth(0xFF21)); // Ａ
+    try std.testing.expectEqual(@as(u2, 2), codepointWidth(0x1F600)); // 😀
+    try std.testing.expectEqual(@as(u2, 1), codepointWidth(0x2764)); // ❤ (text presentation)
+    try std.testing.expectEqual(@as(u2, 0), codepointWidth(0x200B));
+    try std.testing.expectEqual(@as(u2, 0), codepointWidth(0x3099)); // combining, inside a wide range
+    try std.testing.expectEqual(@as(u2, 2), codepointWidth(0x20000));
+    try std.testing.expectEqual(@as(u2, 1), codepointWidth(0x10400));
+}
+
+test "width - ASCII, CJK and combining marks" {
+    try std.testing.expectEqual(@as(usize, 0), width(""));
+    try std.testing.expectEqual(@as(usize, 11), width("hello world"));
+    try std.testing.expectEqual(@as(usize, 4), width("中文"));
+    try std.testing.expectEqual(@as(usize, 7), width("abc中文"));
+    try std.testing.expectEqual(@as(usize, 4), width("cafe\u{0301}"));
+    try std.testing.expectEqual(@as(usize, 3), width("a\tb\nc"));
+}
+
+test "width - emoji sequences" {
+    try std.testing.expectEqual(@as(usize, 2), width("😀"));
+    // Family: man ZWJ woman ZWJ girl
+    try std.testing.expectEqual(@as(usize, 2), width("👨\u{200D}👩\u{200D}👧"));
+    // Thumbs up with skin tone
+    try std.testing.expectEqual(@as(usize, 2), width("👍\u{1F3FD}"));
+    // Heart: text style, then emoji style via VS16
+    try std.testing.expectEqual(@as(usize, 1), width("\u{2764}"));
+    try std.testing.expectEqual(@as(usize, 2), width("\u{2764}\u{FE0F}"));
+    // Flags are pairs of regional indicators
+    try std.testing.expectEqual(@as(usize, 2), width("🇯🇵"));
+    try std.testing.expectEqual(@as(usize, 4), width("🇯🇵🇫🇷"));
+    // Keycap
+    try std.testing.expectEqual(@as(usize, 2), width("1\u{FE0F}\u{20E3}"));
+}
+
+test "prefixForWidth - never splits wide characters or clusters" {
+    const p = prefixForWidth("中文字", 5);
+    try std.testing.expectEqual(@as(usize, 6), p.len);
+    try std.testing.expectEqual(@as(usize, 4), p.width);
+
+    const q = prefixForWidth("abcdef", 4);
+    try std.testing.expectEqual(@as(usize, 4), q.len);
+
+    // The combining mark after the last fitting letter stays attached
+    const r = prefixForWidth("ae\u{0301}x", 2);
+    try std.testing.expectEqualStrings("ae\u{0301}", "ae\u{0301}x"[0..r.len]);
+}
+
+test "padToWidth" {
+    const allocator = std.testing.allocator;
+
+    const end = try padToWidth(allocator, "中文", 6, .{});
+    defer allocator.free(end);
+    try std.testing.expectEqualStrings("中文  ", end);
+
+    const start = try padToWidth(allocator, "ab", 5, .{ .side = .start, .fill = "-" });
+    defer allocator.free(start);
+    try std.testing.expectEqualStrings("---ab", start);
+
+    const both = try padToWidth(allocator, "😀", 7, .{ .side = .both, .fill = "*" });
+    defer allocator.free(both);
+    try std.testing.expectEqualStrings("**😀***", both);
+
+    // A wide fill that would overshoot is completed with a space
+    const wide = try padToWidth(allocator, "x", 4, .{ .fill = "中" });
+    defer allocator.free(wide);
+    try std.testing.expectEqualStrings("x中 ", wide);
+    try std.testing.expectEqual(@as(usize, 4), width(wide));
+
+    const long = try padToWidth(allocator, "already wide", 4, .{});
+    defer allocator.free(long);
+    try std.testing.expectEqualStrings("already wide", long);
+}
+
+test "truncateToWidth" {
+    const allocator = std.testing.allocator;
+
+    const fits = try truncateToWidth(allocator, "short", 5, "…");
+    defer allocator.free(fits);
+    try std.testing.expectEqualStrings("short", fits);
+
+    const cut = try truncateToWidth(allocator, "hello world", 8, "…");
+    defer allocator.free(cut);
+    try std.testing.expectEqualStrings("hello w…", cut);
+
+    // The wide character that does not fit is dropped whole
+    const cjk = try truncateToWidth(allocator, "中文字幕", 6, "...");
+    defer allocator.free(cjk);
+    try std.testing.expectEqualStrings("中...", cjk);
+    try std.testing.expect(width(cjk) <= 6);
+
+    const no_room = try truncateToWidth(allocator, "abcdef", 2, "...");
+    defer allocator.free(no_room);
+    try std.testing.expectEqualStrings("ab", no_room);
+}
+
+test "wrapToWidth - words" {
+    const allocator = std.testing.allocator;
+    const lines = try wrapToWidth(allocator, "the quick brown fox jumps", 10);
+    defer allocator.free(lines);
+    try std.testing.expectEqual(@as(usize, 3), lines.len);
+    try std.testing.expectEqualStrings("the quick", lines[0]);
+    try std.testing.expectEqualStrings("brown fox", lines[1]);
+    try std.testing.expectEqualStrings("jumps", lines[2]);
+}
+
+test "wrapToWidth - long words, CJK and newlines" {
+    const allocator = std.testing.allocator;
+
+    const long = try wrapToWidth(allocator, "abcdefghij xy", 4);
+    defer allocator.free(long);
+    try std.testing.expectEqual(@as(usize, 4), long.len);
+    try std.testing.expectEqualStrings("abcd", long[0]);
+    try std.testing.expectEqualStrings("efgh", long[1]);
+    try std.testing.expectEqualStrings("ij", long[2]);
+    try std.testing.expectEqualStrings("xy", long[3]);
+
+    const cjk = try wrapToWidth(allocator, "中文字幕测试", 5);
+    defer allocator.free(cjk);
+    try std.testing.expectEqual(@as(usize, 3), cjk.len);
+    try std.testing.expectEqualStrings("中文", cjk[0]);
+    try std.testing.expectEqualStrings("字幕", cjk[1]);
+    try std.testing.expectEqualStrings("测试", cjk[2]);
+
+    const paragraphs = try wrapToWidth(allocator, "one two\r\nthree", 20);
+    defer allocator.free(paragraphs);
+    try std.testing.expectEqual(@as(usize, 2), paragraphs.len);
+    try std.testing.expectEqualStrings("one two", paragraphs[0]);
+    try std.testing.expectEqualStrings("three", paragraphs[1]);
+}
@@ -13,7 +13,28 @@ const std = @import("std");
 
 // Core exports
 pub const ZString = @import("core/string.zig").ZString;
+pub const string_buf = @import("core/string_buf.zig");
+pub const ZStringBuf = string_buf.ZStringBuf;
 pub const utf16 = @import("core/utf16.zig");
+pub const column = @import("core/column.zig");
+pub const StringColumn = column.StringColumn;
+pub const LargeStringColumn = column.LargeStringColumn;
+pub const arrow = @import("core/arrow.zig");
+pub const dictionary = @import("core/dictionary.zig");
+pub const DictionaryColumn = dictionary.DictionaryColumn;
+pub const fsst = @import("core/fsst.zig");
+pub const CompressedStrings = fsst.CompressedStrings;
+pub const string_table = @import("core/string_table.zig");
+pub const StringTable = string_table.StringTable;
+pub const ngram = @import("core/ngram.zig");
+pub const NgramIndex = ngram.NgramIndex;
+pub const prefix_set = @import("core/prefix_set.zig");
+pub const PrefixSet = prefix_set.PrefixSet;
+pub const pipeline = @import("core/pipeline.zig");
+pub const job = @import("core/job.zig");
+pub const Job = job.Job;
+pub const executor = @import("core/executor.zig");
+pub const Executor = executor.Executor;
 
 // Method modules
 pub const access = @import("methods/access.zig");
@@ -22,8 +43,19 @@ pub const transform = @import("methods/transform.zig");
 pub const padding = @import("methods/padding.zig");
 pub const trimming = @import("methods/trimming.zig");
 pub const split = @import("methods/split.zig");
+pub const regex = @import("methods/regex.zig");
+pub const join = @import("methods/join.zig");
 pub const case = @import("methods/case.zig");
 pub const utility = @import("methods/utility.zig");
+pub const replace_many = @import("methods/replace_many.zig");
+pub const escape = @import("methods/escape.zig");
+pub const uri = @import("methods/uri.zig");
+pub const number = @import("methods/number.zig");
+pub const fuzzy = @import("methods/fuzzy.zig");
+pub const diff = @import("methods/diff.zig");
+pub const width = @import("methods/width.zig");
+pub const charset = @import("methods/charset.zig");
+pub const CharSet = charset.CharSet;
 
 // Re-export common types
 pub const Allocator = std.mem.Allocator;
@@ -37,6 +69,7 @@ pub const ZStringError = error{
     InvalidCodePoint,
     AllocationFailed,
     NotImplemented,
+    MalformedUri,
 };
 
 // Version info
@@ -51,14 +84,36 @@ test {
     std.testing.refAllDecls(@This());
     std.testing.refAllDecls(ZString);
     std.testing.refAllDecls(utf16);
+    std.testing.refAllDecls(column);
+    std.testing.refAllDecls(arrow);
+    std.testing.refAllDecls(dictionary);
+    std.testing.refAllDecls(fsst);
+    std.testing.refAllDecls(string_table);
+    std.testing.refAllDecls(ngram);
+    std.testing.refAllDecls(prefix_set);
+    std.testing.refAllDecls(pipeline);
+    std.testing.refAllDecls(job);
+    std.testing.refAllDecls(executor);
+    std.testing.refAllDecls(string_buf);
     std.testing.refAllDecls(access);
     std.testing.refAllDecls(search);
     std.testing.refAllDecls(transform);
     std.testing.refAllDecls(padding);
     std.testing.refAllDecls(trimming);
     std.testing.refAllDecls(split);
+    std.testing.refAllDecls(regex);
+    std.testing.refAllDecls(join);
     std.testing.refAllDecls(case);
     std.testing.refAllDecls(utility);
+    std.testing.refAllDecls(replace_many);
+    std.testing.refAllDecls(escape);
+    std.testing.refAllDecls(uri);
+    std.testing.refAllDecls(number);
+    std.testing.refAllDecls(fuzzy);
+    std.testing.refAllDecls(diff);
+    std.testing.refAllDecls(width);
+    std.testing.refAllDecls(charset);
+    _ = @import("core/simd.zig");
 }
 
 // Basic integration test